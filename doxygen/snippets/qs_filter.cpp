@@ -51,6 +51,7 @@ int main() {
     QS_FILTER_SM_OBJ(&philo[3]);      // trace only this state machine object
 
     QS_FILTER_AO_OBJ(&philo[3]);      // trace only this active object
+    QS_FILTER_OBJ_ADD(QP::QS::AO_OBJ, &philo[4]); // ...and also this one
 
     QS_FILTER_MP_OBJ(regSizePoolSto); // trace only this event pool
 
@@ -42,6 +42,10 @@
 #include <termios.h>
 #include <unistd.h>
 
+#ifdef Q_SPY
+    #include "qsdec.h" // QS decoder library from the POSIX port
+#endif
+
 Q_DEFINE_THIS_FILE
 
 //****************************************************************************
@@ -58,7 +62,10 @@ static uint32_t l_rnd; // random seed
 #endif
 
 //............................................................................
-void BSP::init(void) {
+void BSP::init(int argc, char *argv[]) {
+    (void)argc; // unused parameter
+    (void)argv; // unused parameter
+
     printf("Dining Philosopher Problem example"
            "\nQP %s\n"
            "Press p to pause the forks\n"
@@ -162,9 +169,9 @@ extern "C" void Q_onAssert(char const * const module, int loc) {
 //----------------------------------------------------------------------------*/
 #ifdef Q_SPY // define QS callbacks
 
-#include "qspy.h"
-
 static uint8_t l_running;
+static QSpy::CsvExporter l_csv(stdout); // one line of text per QS record
+static QSpy::Decoder l_qsdec(l_csv);
 
 //............................................................................
 static void *idleThread(void *par) { // the expected P-Thread signature
@@ -181,7 +188,7 @@ static void *idleThread(void *par) { // the expected P-Thread signature
         QF_CRIT_EXIT(dummy);
 
         if (block != (uint8_t *)0) {
-            QSPY_parse(block, nBytes);
+            l_qsdec.feed(block, nBytes);
         }
         select(0, 0, 0, 0, &timeout);   // sleep for a while
     }
@@ -190,22 +197,9 @@ static void *idleThread(void *par) { // the expected P-Thread signature
 //............................................................................
 bool QS::onStartup(void const */*arg*/) {
     static uint8_t qsBuf[4*1024]; // 4K buffer for Quantum Spy
+    QS_initTime(); // start the high-resolution QS time source, NOTE01
     initBuf(qsBuf, sizeof(qsBuf));
 
-    QSPY_config(QP_VERSION,         // version
-                QS_OBJ_PTR_SIZE,    // objPtrSize
-                QS_FUN_PTR_SIZE,    // funPtrSize
-                QS_TIME_SIZE,       // tstampSize
-                Q_SIGNAL_SIZE,      // sigSize,
-                QF_EVENT_SIZ_SIZE,  // evtSize
-                QF_EQUEUE_CTR_SIZE, // queueCtrSize
-                QF_MPOOL_CTR_SIZE,  // poolCtrSize
-                QF_MPOOL_SIZ_SIZE,  // poolBlkSize
-                QF_TIMEEVT_CTR_SIZE,// tevtCtrSize
-                (void *)0,          // matFile,
-                (void *)0,
-                (QSPY_CustParseFun)0); // customized parser function
-
     // set up the QS filters...
     QS_FILTER_ON(QS_QEP_STATE_ENTRY);
     QS_FILTER_ON(QS_QEP_STATE_EXIT);
@@ -257,20 +251,20 @@ bool QS::onStartup(void const */*arg*/) {
 //............................................................................
 void QS::onCleanup(void) {
     l_running = (uint8_t)0;
-    QSPY_stop();
+    fflush(stdout);
 }
 //............................................................................
 void QS::onFlush(void) {
     uint16_t nBytes = 1024U;
     uint8_t const *block;
     while ((block = getBlock(&nBytes)) != (uint8_t *)0) {
-        QSPY_parse(block, nBytes);
+        l_qsdec.feed(block, nBytes);
         nBytes = 1024U;
     }
 }
 //............................................................................
 QSTimeCtr QS::onGetTime(void) {
-    return (QSTimeCtr)clock(); // see NOTE01
+    return QS_getTime(); // see NOTE01
 }
 //............................................................................
 //! callback function to reset the target (to be implemented in the BSP)
@@ -288,17 +282,15 @@ void QS::onCommand(uint8_t cmdId, uint32_t param1,
     (void)param3;
     //TBD
 }
-//............................................................................
-void QSPY_onPrintLn(void) {
-    fputs(QSPY_line, stdout);
-    fputc('\n', stdout);
-}
 
 //****************************************************************************
 // NOTE01:
-// clock() is the most portable facility, but might not provide the desired
-// granularity. Other, less-portable alternatives are clock_gettime(),
-// rdtsc(), or gettimeofday().
+// QS_getTime() provided by the POSIX QS port returns the time since
+// QS_initTime() from the TSC or CLOCK_MONOTONIC_RAW. Unlike clock(), it
+// measures the wall time with high resolution and at a low cost. With the
+// default 32-bit time stamps it counts the microseconds, and with the
+// 64-bit time stamps ("make CONF=spy DEFINES=-DQS_TIME_SIZE=8", also for
+// the QP library) the nanoseconds.
 //
 
 #endif // Q_SPY
@@ -40,7 +40,7 @@ class BSP {
 public:
     enum { TICKS_PER_SEC = 100 };
 
-    static void init(void);
+    static void init(int argc, char *argv[]); // command-line arguments
     static void displayPaused(uint8_t const paused);
     static void displayPhilStat(uint8_t const n, char_t const *stat);
     static void terminate(int16_t const result);
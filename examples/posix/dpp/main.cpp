@@ -36,7 +36,7 @@
 #include "bsp.h"
 
 //............................................................................
-int main() {
+int main(int argc, char *argv[]) {
     static QP::QEvt const *tableQueueSto[N_PHILO];
     static QP::QEvt const *philoQueueSto[N_PHILO][N_PHILO];
     static QP::QSubscrList subscrSto[DPP::MAX_PUB_SIG];
@@ -46,7 +46,7 @@ int main() {
 
     QP::QF::init();  // initialize the framework and the underlying RT kernel
 
-    DPP::BSP::init(); // initialize the BSP
+    DPP::BSP::init(argc, argv); // initialize the BSP
 
     // object dictionaries...
     QS_OBJ_DICTIONARY(smlPoolSto);
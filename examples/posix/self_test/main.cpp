@@ -0,0 +1,267 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "qs_pkg.h"    // QS_FRAME, QS_ESC, QS_ESC_XOR, QS_GOOD_CHKSUM
+#include "self_test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <time.h>
+
+Q_DEFINE_THIS_FILE
+
+//****************************************************************************
+namespace SelfTest {
+
+// Local objects -------------------------------------------------------------
+enum {
+    MAX_TESTS = 32,   // the maximum number of registered tests
+    MSG_SIZE  = 256,  // the size of the failure message
+    FRAME_MAX = 4096  // the maximum size of the un-escaped QS frame
+};
+
+struct TestEntry {
+    char const *name;
+    TestFun fun;
+};
+
+static TestEntry l_tests[MAX_TESTS]; // the registered tests
+static uint_fast8_t l_nTests;        // the number of registered tests
+static char const *l_filter;         // glob pattern of the tests to run
+static uint_fast8_t l_nFailed;       // the number of failed tests
+static bool l_testOk;                // no check failed in the current test
+static char l_msg[MSG_SIZE];         // the first failed check of the test
+
+static uint8_t const l_clock_tick = 0U; // QS sender of the clock ticks
+
+//............................................................................
+Test::Test(char const * const name, TestFun const fun) {
+    Q_REQUIRE_ID(100, l_nTests < static_cast<uint_fast8_t>(MAX_TESTS));
+    l_tests[l_nTests].name = name;
+    l_tests[l_nTests].fun  = fun;
+    ++l_nTests;
+}
+//............................................................................
+void check_(bool const ok, char const * const expr,
+            char const * const file, int const line)
+{
+    if ((!ok) && l_testOk) { // the first failed check of the test?
+        snprintf(l_msg, sizeof(l_msg), "%s:%d: %s", file, line, expr);
+        l_testOk = false;
+    }
+}
+//............................................................................
+void sleepMs(uint32_t const ms) {
+    struct timespec ts;
+    ts.tv_sec  = static_cast<time_t>(ms / 1000U);
+    ts.tv_nsec = static_cast<long>((ms % 1000U) * 1000000U);
+    nanosleep(&ts, NULL);
+}
+//............................................................................
+uint32_t readQs(uint8_t * const out, uint32_t const size) {
+    uint32_t len = 0U;
+    for (;;) {
+        uint16_t n = (size - len > 0xFFFFU)
+                     ? static_cast<uint16_t>(0xFFFFU)
+                     : static_cast<uint16_t>(size - len);
+        if (n == 0U) { // no room left?
+            break;
+        }
+        QF_CRIT_ENTRY(dummy);
+        uint8_t const * const block = QP::QS::getBlock(&n);
+        for (uint16_t i = 0U; i < n; ++i) {
+            out[len + i] = block[i];
+        }
+        QF_CRIT_EXIT(dummy);
+        if (n == 0U) {
+            break;
+        }
+        len += n;
+    }
+    return len;
+}
+//............................................................................
+uint_fast16_t parseQs(uint8_t const * const out, uint32_t const len,
+                      FrameFun const fun, void * const par)
+{
+    static uint8_t frame[FRAME_MAX];
+    uint_fast16_t nBad = 0U;
+    uint_fast16_t n = 0U;
+    uint8_t chksum = 0U;
+    bool esc = false;
+    for (uint32_t i = 0U; i < len; ++i) {
+        uint8_t b = out[i];
+        if (b == QP::QS_FRAME) { // end of the frame?
+            if ((n > 2U) && (n <= sizeof(frame))
+                && (chksum == QP::QS_GOOD_CHKSUM) && (!esc))
+            {
+                (*fun)(frame, n - 1U, par); // without the checksum
+            }
+            else {
+                ++nBad;
+            }
+            n = 0U;
+            chksum = 0U;
+            esc = false;
+        }
+        else if (b == QP::QS_ESC) {
+            esc = true;
+        }
+        else {
+            if (esc) {
+                b ^= QP::QS_ESC_XOR;
+                esc = false;
+            }
+            if (n < sizeof(frame)) {
+                frame[n] = b;
+            }
+            ++n;
+            chksum = static_cast<uint8_t>(chksum + b);
+        }
+    }
+    return nBad;
+}
+//............................................................................
+// the "ISR-like" thread running the tests while QF is running
+static void *runner(void * /*arg*/) {
+    uint_fast8_t nRun = 0U;
+    for (uint_fast8_t n = 0U; n < l_nTests; ++n) {
+        if ((l_filter != static_cast<char const *>(0))
+            && (fnmatch(l_filter, l_tests[n].name, 0) != 0))
+        {
+            continue; // the test not selected
+        }
+        l_testOk = true;
+        (*l_tests[n].fun)();
+        ++nRun;
+        if (l_testOk) {
+            printf("[ PASS ] %s\n", l_tests[n].name);
+        }
+        else {
+            printf("[ FAIL ] %s\n         %s\n", l_tests[n].name, l_msg);
+            ++l_nFailed;
+        }
+    }
+    printf("=================== SUMMARY ===================\n"
+           "# tests: %u, # failures: %u\n%s\n",
+           static_cast<unsigned>(nRun), static_cast<unsigned>(l_nFailed),
+           (l_nFailed == 0U) ? "OK" : "FAIL");
+    QP::QF::stop();
+    return static_cast<void *>(0);
+}
+
+} // namespace SelfTest
+
+//............................................................................
+int main(int argc, char *argv[]) {
+    static QF_MPOOL_EL(QP::QEvt) smlPoolSto[8];
+
+    SelfTest::l_filter = (argc > 1) ? argv[1] : static_cast<char *>(0);
+
+    QP::QF::init(); // initialize the framework
+#ifdef ST_TICKLESS
+    QP::QF_setTickless(true); // the suite of the tickless clock
+#endif
+    Q_ALLEGE(QS_INIT(static_cast<void *>(0)));
+    QS_OBJ_DICTIONARY(&SelfTest::l_clock_tick);
+
+    QP::QF::poolInit(smlPoolSto, sizeof(smlPoolSto), sizeof(smlPoolSto[0]));
+
+    (void)QP::QF::run(); // run the tests in the runner thread
+    return (SelfTest::l_nFailed == 0U) ? 0 : 1;
+}
+
+//****************************************************************************
+namespace QP {
+
+//............................................................................
+void QF::onStartup(void) {
+    pthread_attr_t attr;
+    pthread_t runner;
+
+    QF_setTickRate(ST_TICK_RATE); // the tick rate for the time events
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    Q_ALLEGE(pthread_create(&runner, &attr, &SelfTest::runner, 0) == 0);
+    pthread_attr_destroy(&attr);
+}
+//............................................................................
+void QF::onCleanup(void) {
+}
+//............................................................................
+void QF_onClockTick(void) {
+    QF::TICK_X(0U, &SelfTest::l_clock_tick); // process time events, rate 0
+}
+//............................................................................
+extern "C" void Q_onAssert(char const * const module, int loc) {
+    fprintf(stderr, "Assertion failed in %s, location %d\n", module, loc);
+    exit(-1);
+}
+
+//----------------------------------------------------------------------------
+#ifdef Q_SPY
+
+//............................................................................
+bool QS::onStartup(void const * /*arg*/) {
+    static uint8_t qsBuf[16*1024]; // buffer for the QS output of the tests
+    QS_initTime(); // start the high-resolution QS time source
+    initBuf(qsBuf, sizeof(qsBuf));
+    return true;
+}
+//............................................................................
+void QS::onCleanup(void) {
+}
+//............................................................................
+void QS::onFlush(void) {
+    // the tests read the QS output themselves
+}
+//............................................................................
+QSTimeCtr QS::onGetTime(void) {
+    return QS_getTime();
+}
+//............................................................................
+void QS::onReset(void) {
+}
+//............................................................................
+void QS::onCommand(uint8_t /*cmdId*/, uint32_t /*param1*/,
+                   uint32_t /*param2*/, uint32_t /*param3*/)
+{
+}
+
+#endif // Q_SPY
+
+} // namespace QP
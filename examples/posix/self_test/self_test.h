@@ -0,0 +1,90 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#ifndef self_test_h
+#define self_test_h
+
+#ifndef ST_TICK_RATE
+    //! the tick rate of the time events in the tests [Hz]
+    #define ST_TICK_RATE 100U
+#endif
+
+namespace SelfTest {
+
+enum SelfTestSignals {
+    IGNORED_SIG = QP::Q_USER_SIG, // ignored in some states of the test AOs
+    PROBE_SIG,                    // handled by the test AOs
+    BLOCK_SIG,                    // blocks the test AO until released
+    SWITCH_SIG,                   // switches the state of the test AO
+    MAX_SIG                       // the last signal
+};
+
+//! Test function (runs in the "ISR-like" test thread while QF runs)
+typedef void (*TestFun)(void);
+
+//! Registration of a test (a static object), the tests run in the order
+//! of their registration
+class Test {
+public:
+    Test(char const * const name, TestFun const fun);
+};
+
+//! Report the failed check of the @p expr at @p file:@p line (the test
+//! continues and the first failed check is reported)
+void check_(bool const ok, char const * const expr,
+            char const * const file, int const line);
+
+//! Sleep for @p ms milliseconds
+void sleepMs(uint32_t const ms);
+
+//! Move all the QS output available now to @p out of @p size bytes,
+//! returns the number of the bytes moved
+uint32_t readQs(uint8_t * const out, uint32_t const size);
+
+//! QS frame handler, the @p frame of @p n bytes holds the un-escaped
+//! [seq][rec][data...] of a frame with a good checksum
+typedef void (*FrameFun)(uint8_t const * const frame,
+                         uint_fast16_t const n, void * const par);
+
+//! Split the QS output @p out of @p len bytes into the frames and call
+//! @p fun for every good frame, returns the number of the bad frames
+uint_fast16_t parseQs(uint8_t const * const out, uint32_t const len,
+                      FrameFun const fun, void * const par);
+
+} // namespace SelfTest
+
+//! Check the expression in a test
+#define ST_CHECK(expr_) \
+    (SelfTest::check_((expr_), #expr_, __FILE__, __LINE__))
+
+#endif // self_test_h
@@ -0,0 +1,275 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, QS compact encoding
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "qs_pkg.h"      // QS_target_info_()
+#include "qsdec/qsdec.h" // the host-side QS decoder
+#include "self_test.h"
+
+#include <string.h>
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+enum {
+    TEST_SIG = 1000,      // the signal of the records of the batch 0
+    N_BATCH  = 3,         // the number of the batches of the records
+    N_REC    = 200,       // the records in a batch (> QS_TIME_SYNC)
+    N_OBJ    = 24,        // the objects (more than QS_INTERN_SIZE - 1)
+    OUT_SIZE = 64*1024    // the maximum QS output read in a test
+};
+
+//! the test records decoded by the host
+class Collector : public QSpy::Handler {
+public:
+    Collector() {
+        for (uint_fast8_t b = 0U; b < static_cast<uint_fast8_t>(N_BATCH);
+             ++b)
+        {
+            n[b] = 0U;
+        }
+    }
+    virtual void onRecord(QSpy::Decoder const &dec,
+                          QSpy::Record const &rec)
+    {
+        (void)dec;
+        uint32_t const b = rec.sig - static_cast<uint32_t>(TEST_SIG);
+        if ((rec.type == static_cast<uint8_t>(QSpy::QS_QEP_DISPATCH))
+            && (b < static_cast<uint32_t>(N_BATCH))
+            && (n[b] < static_cast<uint_fast16_t>(N_REC)))
+        {
+            time[b][n[b]] = rec.time;
+            obj[b][n[b]]  = rec.obj[0];
+            fun[b][n[b]]  = rec.fun[0];
+            ++n[b];
+        }
+    }
+
+    uint_fast16_t n[N_BATCH];
+    uint64_t time[N_BATCH][N_REC];
+    uint64_t obj[N_BATCH][N_REC];
+    uint64_t fun[N_BATCH][N_REC];
+};
+
+// Local objects -------------------------------------------------------------
+static uint8_t  l_out[OUT_SIZE]; // the QS output read in the test
+static uint8_t  l_obj[N_OBJ];    // the objects (with the dictionaries)
+static uint8_t  l_anon;          // the object without the dictionary
+static uint32_t l_calls;         // the calls of the test functions
+
+//............................................................................
+static void funDict(void) { // the function with the dictionary
+    ++l_calls;
+}
+//............................................................................
+static void funAnon(void) { // the function without the dictionary
+    l_calls += 2U;
+}
+//............................................................................
+// the object of the record @p i: the objects, NULL and l_anon
+static void const *objOf(uint_fast16_t const i) {
+    uint_fast16_t const k = i % static_cast<uint_fast16_t>(N_OBJ + 2);
+    return (k < static_cast<uint_fast16_t>(N_OBJ))
+           ? static_cast<void const *>(&l_obj[k])
+           : ((k == static_cast<uint_fast16_t>(N_OBJ))
+              ? static_cast<void const *>(0)
+              : static_cast<void const *>(&l_anon));
+}
+//............................................................................
+// the function of the record @p i
+static QSPtr funOf(uint_fast16_t const i) {
+    return ((i & 1U) != 0U)
+           ? reinterpret_cast<QSPtr>(&funDict)
+           : reinterpret_cast<QSPtr>(&funAnon);
+}
+//............................................................................
+// the time stamp of the record @p i (small and large deltas, which wrap
+// around the 32-bit time counter)
+static QSTimeCtr timeOf(uint_fast16_t const i) {
+    return static_cast<QSTimeCtr>(0xFFFF0000U + (i * i * i * 37U));
+}
+//............................................................................
+// produce the batch @p b of the test records (as QS_QEP_DISPATCH)
+static void produce(uint_fast8_t const b) {
+    for (uint_fast16_t i = 0U; i < static_cast<uint_fast16_t>(N_REC); ++i) {
+        QF_CRIT_ENTRY(dummy);
+        QS::beginRec(static_cast<uint_fast8_t>(QS_QEP_DISPATCH));
+            QS::time_(timeOf(i));
+            QS_SIG_(static_cast<QSignal>(TEST_SIG + b));
+            QS_OBJ_(objOf(i));
+            QS_FUN_(funOf(i));
+        QS::endRec();
+        QF_CRIT_EXIT(dummy);
+    }
+}
+//............................................................................
+// the number of the records of the batch @p b decoded as expected (with
+// the unknown IDs and time stamps accepted when @p lax is true)
+static uint_fast16_t matches(Collector const &c, uint_fast8_t const b,
+                             bool const lax)
+{
+    uint_fast16_t ok = 0U;
+    for (uint_fast16_t i = 0U; i < c.n[b]; ++i) {
+        uint64_t const obj = reinterpret_cast<QSPtr>(objOf(i));
+        bool const unknown = lax
+            && ((c.obj[b][i] & QSpy::UNKNOWN_ID) != 0U);
+        if (((c.obj[b][i] == obj) || unknown)
+            && (c.fun[b][i] == funOf(i))
+            && ((c.time[b][i] == timeOf(i))
+                || (lax && (c.time[b][i] == QSpy::UNKNOWN_ID))))
+        {
+            ++ok;
+        }
+    }
+    return ok;
+}
+
+//----------------------------------------------------------------------------
+// the pointers (interned, not interned and NULL) and the time stamps of
+// the compact encoding round-trip through the host-side decoder, also for
+// the host attached later, which resolves the IDs after QS::internAll()
+static void test_round_trip(void) {
+    static Collector known; // the host that saw the dictionaries
+    static Collector late;  // the host attached after the dictionaries
+    QSpy::Decoder decKnown(known);
+    QSpy::Decoder decLate(late);
+
+    (void)readQs(l_out, sizeof(l_out)); // discard the previous output
+
+    QF_CRIT_ENTRY(dummy);
+    QS_target_info_(static_cast<uint8_t>(0xFF)); // the host sees a reset
+    QF_CRIT_EXIT(dummy);
+    for (uint_fast16_t k = 0U; k < static_cast<uint_fast16_t>(N_OBJ); ++k) {
+        QS::obj_dict(&l_obj[k], "l_obj");
+    }
+    QS::fun_dict(reinterpret_cast<void (*)(void)>(&funDict), "funDict");
+    ST_CHECK(QS::priv_.nIds == QS_INTERN_SIZE - 1U); // table full
+    produce(0U);
+    uint32_t len = readQs(l_out, sizeof(l_out));
+    ST_CHECK(len < sizeof(l_out));
+    decKnown.feed(l_out, len);
+
+    ST_CHECK(decKnown.targetInfo().compact);
+    ST_CHECK(known.n[0] == static_cast<uint_fast16_t>(N_REC));
+    ST_CHECK(matches(known, 0U, false) == known.n[0]);
+
+    // the late host gets only the Target info
+    QF_CRIT_ENTRY(dummy);
+    QS_target_info_(static_cast<uint8_t>(0));
+    QF_CRIT_EXIT(dummy);
+    produce(1U);
+    QS::internAll();
+    produce(2U);
+    len = readQs(l_out, sizeof(l_out));
+    ST_CHECK(len < sizeof(l_out));
+    decKnown.feed(l_out, len);
+    decLate.feed(l_out, len);
+
+    uint_fast16_t nUnknown = 0U;
+    for (uint_fast16_t i = 0U; i < late.n[1]; ++i) {
+        if ((late.obj[1][i] & QSpy::UNKNOWN_ID) != 0U) {
+            ++nUnknown;
+        }
+    }
+    ST_CHECK(nUnknown != 0U); // the late host cannot resolve the IDs...
+    ST_CHECK(late.n[1] == static_cast<uint_fast16_t>(N_REC));
+    ST_CHECK(matches(late, 1U, true) == late.n[1]);
+    ST_CHECK(late.n[2] == static_cast<uint_fast16_t>(N_REC));
+    ST_CHECK(matches(late, 2U, false) == late.n[2]); // ...until internAll
+
+    ST_CHECK(matches(known, 1U, false) == static_cast<uint_fast16_t>(N_REC));
+    ST_CHECK(matches(known, 2U, false) == static_cast<uint_fast16_t>(N_REC));
+    ST_CHECK(strcmp(decKnown.objName(reinterpret_cast<QSPtr>(&l_obj[0])),
+                    "l_obj") == 0); // the names are kept
+
+    ST_CHECK(decKnown.stats().badSum == 0U);
+    ST_CHECK(decKnown.stats().badLen == 0U);
+    ST_CHECK(decLate.stats().badLen == 0U);
+    ST_CHECK(l_calls == 0U); // the test functions are never called
+}
+static Test const l_roundTrip("Compact encoding round-trips through qsdec",
+                              &test_round_trip);
+//............................................................................
+// the little-endian pointer of @p size bytes at @p p
+static uint64_t rawPtr(uint8_t const * const p, uint_fast8_t const size) {
+    uint64_t v = 0U;
+    for (uint_fast8_t i = size; i > 0U; --i) {
+        v = (v << 8) | p[i - 1U];
+    }
+    return v;
+}
+//............................................................................
+// [seq][rec][1][obj][1][fun] of the QS_QEP_STATE_ENTRY record
+static void onFullPtr(uint8_t const * const frame, uint_fast16_t const n,
+                      void * const par)
+{
+    uint_fast16_t const size = static_cast<uint_fast16_t>(
+        2U + 1U + QS_OBJ_PTR_SIZE + 1U + QS_FUN_PTR_SIZE);
+    uint8_t const * const fun = &frame[2U + 1U + QS_OBJ_PTR_SIZE];
+    if ((frame[1] == static_cast<uint8_t>(QS_QEP_STATE_ENTRY))
+        && (n == size)
+        && (frame[2] == 1U)
+        && (rawPtr(&frame[3], QS_OBJ_PTR_SIZE)
+            == reinterpret_cast<QSPtr>(&l_anon))
+        && (fun[0] == 1U)
+        && (rawPtr(&fun[1], QS_FUN_PTR_SIZE)
+            == reinterpret_cast<QSPtr>(&funAnon)))
+    {
+        ++*static_cast<uint_fast16_t *>(par);
+    }
+}
+
+//----------------------------------------------------------------------------
+// the pointer, which has not been interned, costs one byte more than the
+// full pointer (the tag), regardless of its value
+static void test_full_ptr(void) {
+    (void)readQs(l_out, sizeof(l_out)); // discard the previous output
+
+    QF_CRIT_ENTRY(dummy);
+    QS::beginRec(static_cast<uint_fast8_t>(QS_QEP_STATE_ENTRY));
+        QS_OBJ_(&l_anon);
+        QS_FUN_(&funAnon);
+    QS::endRec();
+    QF_CRIT_EXIT(dummy);
+
+    uint32_t const len = readQs(l_out, sizeof(l_out));
+    uint_fast16_t found = 0U;
+    (void)parseQs(l_out, len, &onFullPtr, &found);
+    ST_CHECK(found == 1U);
+}
+static Test const l_fullPtr("Compact encoding of the full pointers",
+                            &test_full_ptr);
+
+} // namespace SelfTest
@@ -0,0 +1,272 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, QS overrun policies
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "qs_pkg.h"    // QS_FRAME, QS_ESC
+#include "self_test.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+enum {
+    TEST_REC  = QS_USER,     // the test records
+    LONG_SIZE = 300,         // the size of the long strings, blocks, arrays
+    OUT_SIZE  = 4*1024*1024, // the maximum QS output read in a test
+    PIPE_SIZE = 4096         // the capacity of the pipe to the reader
+};
+
+//! the test records and the sequence numbers found in the QS output
+struct Found {
+    uint32_t nRecs;   // the number of the test records
+    uint32_t next;    // the next expected data of the test records
+    uint32_t nSkip;   // the sequence numbers skipped
+    uint8_t  seq;     // the last sequence number
+    bool     anySeq;  // any frame parsed yet
+    bool     dataOk;  // the data of the test records are in order
+};
+
+// Local objects -------------------------------------------------------------
+static uint8_t  l_out[OUT_SIZE];   // the QS output read in the test
+static uint32_t l_outLen;          // the number of bytes in l_out[]
+static char     l_str[LONG_SIZE];  // the long string
+static uint8_t  l_blk[LONG_SIZE];  // the long memory block (with escapes)
+static uint32_t l_arr[LONG_SIZE];  // the long array (with escapes)
+
+//............................................................................
+// read the QS counters, which change in the QS critical section
+static uint32_t qsCounter(uint32_t const * const ctr) {
+    QF_CRIT_ENTRY(dummy);
+    uint32_t const n = *ctr;
+    QF_CRIT_EXIT(dummy);
+    return n;
+}
+//............................................................................
+// fill the long data (the blocks and arrays with the bytes that need
+// escaping, the strings are not escaped)
+static void initLong(void) {
+    for (uint_fast16_t i = 0U; i < static_cast<uint_fast16_t>(LONG_SIZE);
+         ++i)
+    {
+        l_str[i] = static_cast<char>('A' + (i % 26U));
+        l_blk[i] = ((i % 2U) == 0U) ? QS_FRAME : QS_ESC;
+        l_arr[i] = 0x7E7D7E7DU;
+    }
+    l_str[LONG_SIZE - 1] = '\0';
+}
+//............................................................................
+// produce the test record with the data @p k and the long data @p kind
+// (0 none, 1 string, 2 memory block, 3 array)
+static void produce(uint32_t const k, uint_fast8_t const kind) {
+    QS_BEGIN(TEST_REC, static_cast<void *>(0))
+        QS_U32(0, k);
+        if (kind == 1U) {
+            QS_STR(l_str);
+        }
+        else if (kind == 2U) {
+            QS_MEM(l_blk, static_cast<uint8_t>(250U));
+        }
+        else if (kind == 3U) {
+            QS_ARR_U32(l_arr, static_cast<uint16_t>(LONG_SIZE));
+        }
+    QS_END()
+}
+//............................................................................
+// [seq][rec][time][fmt][u32][...]
+static void onFrame(uint8_t const * const frame, uint_fast16_t const n,
+                    void * const par)
+{
+    Found * const f = static_cast<Found *>(par);
+    if (f->anySeq) {
+        f->nSkip += static_cast<uint8_t>(frame[0] - f->seq - 1U);
+    }
+    f->seq = frame[0];
+    f->anySeq = true;
+
+    if ((frame[1] != static_cast<uint8_t>(TEST_REC))
+        || (n < static_cast<uint_fast16_t>(QS_TIME_SIZE + 7)))
+    {
+        return; // not a test record
+    }
+    uint8_t const * const d = &frame[2 + QS_TIME_SIZE];
+    uint32_t const k = static_cast<uint32_t>(d[1])
+                       | (static_cast<uint32_t>(d[2]) << 8)
+                       | (static_cast<uint32_t>(d[3]) << 16)
+                       | (static_cast<uint32_t>(d[4]) << 24);
+    if (k < f->next) {
+        f->dataOk = false; // not in the order produced
+    }
+    f->next = k + 1U; // the dropped records are skipped
+    ++f->nRecs;
+}
+//............................................................................
+// parse l_out[] into @p f
+static void parseOut(Found * const f) {
+    f->nRecs  = 0U;
+    f->next   = 0U;
+    f->nSkip  = 0U;
+    f->anySeq = false;
+    f->dataOk = true;
+    ST_CHECK(parseQs(l_out, l_outLen, &onFrame, f) == 0U);
+}
+
+//----------------------------------------------------------------------------
+// the records, whose strings, memory blocks or arrays do not fit into the
+// nearly full QS buffer, are dropped without overwriting the oldest data
+static void test_drop_long(void) {
+    Found found;
+    initLong();
+    QS_FILTER_ON(TEST_REC);
+    l_outLen = readQs(l_out, static_cast<uint32_t>(sizeof(l_out)));
+    l_outLen = 0U; // discard the earlier output
+
+    uint32_t const lost0 = qsCounter(&QS::priv_.lost);
+    uint32_t const drop0 = qsCounter(&QS::priv_.dropRecs);
+
+    // fill the QS buffer until a short record is dropped
+    uint32_t k = 0U;
+    while (qsCounter(&QS::priv_.dropRecs) == drop0) {
+        produce(k, 0U);
+        ++k;
+    }
+
+    // free some room: the short records fit, but not the long data
+    uint16_t n = 100U;
+    QF_CRIT_ENTRY(dummy);
+    uint8_t const * const block = QS::getBlock(&n);
+    for (uint16_t i = 0U; i < n; ++i) {
+        l_out[i] = block[i];
+    }
+    QF_CRIT_EXIT(dummy);
+    l_outLen = n;
+    ST_CHECK(n == 100U);
+
+    for (uint_fast8_t kind = 1U; kind <= 3U; ++kind) {
+        uint32_t const drop = qsCounter(&QS::priv_.dropRecs);
+        produce(k, kind);
+        ++k;
+        ST_CHECK(qsCounter(&QS::priv_.dropRecs) == drop + 1U);
+    }
+    uint32_t const drop = qsCounter(&QS::priv_.dropRecs);
+    produce(k, 0U); // the short record still fits
+    ++k;
+    ST_CHECK(qsCounter(&QS::priv_.dropRecs) == drop);
+    ST_CHECK(qsCounter(&QS::priv_.lost) == lost0); // no old data lost
+
+    l_outLen += readQs(&l_out[l_outLen],
+                       static_cast<uint32_t>(sizeof(l_out)) - l_outLen);
+    QS_FILTER_OFF(TEST_REC);
+
+    parseOut(&found);
+    uint32_t const dropped = qsCounter(&QS::priv_.dropRecs) - drop0;
+    ST_CHECK(found.dataOk);
+    ST_CHECK(found.next == k); // the last record kept
+    ST_CHECK(found.nRecs + dropped == k);
+    ST_CHECK(found.nSkip == dropped); // the gaps in the sequence numbers
+}
+static Test const l_dropLong("Drop newest keeps the oldest data with "
+                             "long records", &test_drop_long);
+
+#ifdef QS_BLOCK_PRODUCER
+
+static int l_pipe[2]; // the QS output of the flusher
+
+//............................................................................
+// read the pipe slowly until the flusher closes it
+static void *reader(void * /*arg*/) {
+    for (;;) {
+        uint8_t buf[PIPE_SIZE];
+        ssize_t const n = read(l_pipe[0], buf, sizeof(buf));
+        if (n <= 0) {
+            break; // end of the QS output
+        }
+        for (ssize_t i = 0; (i < n) && (l_outLen < sizeof(l_out)); ++i) {
+            l_out[l_outLen++] = buf[i];
+        }
+        sleepMs(1U); // let the producer fill the QS buffer
+    }
+    return static_cast<void *>(0);
+}
+
+//----------------------------------------------------------------------------
+// the producer waits for the slow QS output and the long records, which
+// still do not fit, are dropped without overwriting the oldest data
+static void test_block(void) {
+    pthread_t rd;
+    Found found;
+    initLong();
+    QS_FILTER_ON(TEST_REC);
+    l_outLen = readQs(l_out, static_cast<uint32_t>(sizeof(l_out)));
+    l_outLen = 0U; // discard the earlier output
+
+    uint32_t const lost0  = qsCounter(&QS::priv_.lost);
+    uint32_t const drop0  = qsCounter(&QS::priv_.dropRecs);
+    uint32_t const block0 = qsCounter(&QS::priv_.blocks);
+
+    ST_CHECK(pipe(l_pipe) == 0);
+    ST_CHECK(fcntl(l_pipe[1], F_SETPIPE_SZ, PIPE_SIZE) == PIPE_SIZE);
+    ST_CHECK(pthread_create(&rd, static_cast<pthread_attr_t *>(0),
+                            &reader, static_cast<void *>(0)) == 0);
+    ST_CHECK(QS_startFlusher(l_pipe[1], 1024U, 10U));
+
+    uint32_t const nRecs = 2000U;
+    for (uint32_t k = 0U; k < nRecs; ++k) {
+        produce(k, static_cast<uint_fast8_t>(k % 4U));
+    }
+    QS_FILTER_OFF(TEST_REC);
+
+    QS_stopFlusher(); // the flusher writes the rest of the data
+    (void)close(l_pipe[1]);
+    (void)pthread_join(rd, static_cast<void **>(0));
+    (void)close(l_pipe[0]);
+
+    ST_CHECK(l_outLen < sizeof(l_out));
+    ST_CHECK(qsCounter(&QS::priv_.blocks) != block0); // the producer waited
+    ST_CHECK(qsCounter(&QS::priv_.lost) == lost0);    // no old data lost
+
+    parseOut(&found);
+    uint32_t const dropped = qsCounter(&QS::priv_.dropRecs) - drop0;
+    ST_CHECK(found.dataOk);
+    ST_CHECK(found.nRecs + dropped == nRecs);
+}
+static Test const l_block("Block producer keeps the oldest data",
+                          &test_block);
+
+#endif // QS_BLOCK_PRODUCER
+
+} // namespace SelfTest
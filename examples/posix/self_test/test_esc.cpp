@@ -0,0 +1,178 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, QS bulk escaping
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "qs_pkg.h"    // QS_FRAME, QS_ESC, QS_ESC_XOR
+#include "self_test.h"
+
+#include <string.h>
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+enum {
+    TEST_REC = QS_USER,   // the test records
+    N_REC    = 3000,      // the records in the test
+    MAX_DATA = 600        // the maximum data in a record
+};
+
+// Local objects -------------------------------------------------------------
+static uint8_t  l_data[MAX_DATA];           // the data of the record
+static uint8_t  l_out[2*MAX_DATA + 16];     // the QS output of the record
+static uint8_t  l_ref[2*MAX_DATA + 16];     // the reference output
+static uint32_t l_rnd = 0x12345678U;        // the state of the PRNG
+
+//............................................................................
+// the next pseudo-random number (xorshift32)
+static uint32_t rnd(void) {
+    l_rnd ^= l_rnd << 13;
+    l_rnd ^= l_rnd >> 17;
+    l_rnd ^= l_rnd << 5;
+    return l_rnd;
+}
+//............................................................................
+// fill @p n bytes of the data, with the bytes to escape at the density
+// @p mode (0 none, 1 sparse, 2 dense, 3 all)
+static void fill(uint_fast16_t const n, uint_fast8_t const mode) {
+    for (uint_fast16_t i = 0U; i < n; ++i) {
+        uint32_t const r = rnd();
+        uint8_t b = static_cast<uint8_t>(r >> 8);
+        bool const esc = (mode == 3U)
+                         || ((mode == 2U) && ((r & 1U) != 0U))
+                         || ((mode == 1U) && ((r & 31U) == 0U));
+        if (esc) {
+            b = ((r & 2U) != 0U) ? QS_FRAME : QS_ESC;
+        }
+        else if ((b == QS_FRAME) || (b == QS_ESC)) {
+            b = static_cast<uint8_t>(b + 2U);
+        }
+        else {
+            // keep the random byte
+        }
+        l_data[i] = b;
+    }
+}
+//............................................................................
+// the byte-by-byte HDLC encoder (as before the bulk escaping), returns the
+// new length of the reference output
+static uint_fast16_t refByte(uint_fast16_t len, uint8_t const b,
+                             uint8_t * const sum)
+{
+    *sum = static_cast<uint8_t>(*sum + b);
+    if ((b == QS_FRAME) || (b == QS_ESC)) {
+        l_ref[len++] = QS_ESC;
+        l_ref[len++] = static_cast<uint8_t>(b ^ QS_ESC_XOR);
+    }
+    else {
+        l_ref[len++] = b;
+    }
+    return len;
+}
+//............................................................................
+// the reference frame [seq][rec][hdr][data][checksum][0x7E] of the
+// sequence number @p seq, returns its length
+static uint_fast16_t refFrame(uint8_t const seq,
+                              uint8_t const * const hdr,
+                              uint_fast16_t const nHdr,
+                              uint_fast16_t const n)
+{
+    uint8_t sum = 0U;
+    uint8_t ignored = 0U;
+    uint_fast16_t len = refByte(0U, seq, &sum);
+    len = refByte(len, static_cast<uint8_t>(TEST_REC), &sum);
+    for (uint_fast16_t i = 0U; i < nHdr; ++i) {
+        len = refByte(len, hdr[i], &sum);
+    }
+    for (uint_fast16_t i = 0U; i < n; ++i) {
+        len = refByte(len, l_data[i], &sum);
+    }
+    len = refByte(len, static_cast<uint8_t>(~sum), &ignored);
+    l_ref[len++] = QS_FRAME;
+    return len;
+}
+
+//----------------------------------------------------------------------------
+// QS::mem() and QS::memBlk_() (escaped by QS_escChunk_() in chunks of
+// QS_ESC_CHUNK bytes, scalar, SSE2 or AVX2 depending on the suite) produce
+// the same bytes as the byte-by-byte encoder, for the random data with
+// the bytes to escape at any density and at any position of the chunks,
+// also across the end of the QS buffer
+static void test_esc(void) {
+    uint_fast16_t nBad = 0U;
+    uint_fast16_t nWrap = 0U;
+
+    (void)readQs(l_out, sizeof(l_out)); // discard the previous output
+    for (uint_fast16_t k = 0U; k < static_cast<uint_fast16_t>(N_REC); ++k) {
+        uint_fast8_t const mode = static_cast<uint_fast8_t>(k % 4U);
+        bool const formatted = ((k & 4U) != 0U);
+        uint_fast16_t const n = formatted
+            ? static_cast<uint_fast16_t>(rnd() % 256U)
+            : static_cast<uint_fast16_t>(rnd() % MAX_DATA);
+        fill(n, mode);
+
+        QF_CRIT_ENTRY(dummy);
+        QSCtr const head = QS::priv_.head;
+        uint8_t const seq = static_cast<uint8_t>(QS::priv_.seq + 1U);
+        QS::beginRec(static_cast<uint_fast8_t>(TEST_REC));
+        if (formatted) {
+            QS::mem(l_data, static_cast<uint8_t>(n));
+        }
+        else {
+            QS::memBlk_(l_data, static_cast<QSCtr>(n));
+        }
+        QS::endRec();
+        if (QS::priv_.head < head) {
+            ++nWrap;
+        }
+        QF_CRIT_EXIT(dummy);
+
+        uint8_t const hdr[2] = {
+            static_cast<uint8_t>(QS::MEM_T), static_cast<uint8_t>(n)
+        };
+        uint_fast16_t const len = refFrame(seq, hdr,
+                                           formatted ? 2U : 0U, n);
+        if ((readQs(l_out, sizeof(l_out)) != len)
+            || (memcmp(l_out, l_ref, len) != 0))
+        {
+            ++nBad;
+        }
+    }
+    ST_CHECK(nBad == 0U);
+    ST_CHECK(nWrap > 10U); // the records wrapped around the QS buffer
+}
+static Test const l_esc("Bulk escaping matches the byte encoder",
+                        &test_esc);
+
+} // namespace SelfTest
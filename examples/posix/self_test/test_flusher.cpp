@@ -0,0 +1,196 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, QS flusher
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "qs_pkg.h"    // QS_FRAME, QS_ESC, QS_ESC_XOR, QS_GOOD_CHKSUM
+#include "self_test.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+enum {
+    FLOOD_REC  = QS_USER, // the records overflowing the QS buffer
+    PIPE_SIZE  = 4096,    // the capacity of the pipe to the reader
+    OUT_SIZE   = 256*1024 // the maximum QS output read from the pipe
+};
+
+// Local objects -------------------------------------------------------------
+static int     l_pipe[2];          // the QS output of the flusher
+static sem_t   l_readGo;           // lets the reader drain the pipe
+static uint8_t l_out[OUT_SIZE];    // the QS output read from the pipe
+static size_t  l_outLen;           // the number of bytes in l_out[]
+
+//............................................................................
+// read the pipe until the flusher closes it
+static void *reader(void * /*arg*/) {
+    (void)sem_wait(&l_readGo);
+    for (;;) {
+        uint8_t buf[PIPE_SIZE];
+        ssize_t const n = read(l_pipe[0], buf, sizeof(buf));
+        if (n <= 0) {
+            break; // end of the QS output
+        }
+        for (ssize_t i = 0; (i < n) && (l_outLen < sizeof(l_out)); ++i) {
+            l_out[l_outLen++] = buf[i];
+        }
+    }
+    return static_cast<void *>(0);
+}
+//............................................................................
+// read the QS counters, which change in the QS critical section
+static uint32_t qsCounter(uint32_t const * const ctr) {
+    QF_CRIT_ENTRY(dummy);
+    uint32_t const n = *ctr;
+    QF_CRIT_EXIT(dummy);
+    return n;
+}
+//............................................................................
+// add up the lost bytes of all the QS_OVERRUN records in l_out[]
+static uint32_t reportedLost(uint_fast16_t * const pDicts,
+                             uint_fast16_t * const pReports)
+{
+    static uint8_t frame[64];
+    uint32_t sum = 0U;
+    uint_fast16_t n = 0U;
+    bool esc = false;
+    *pDicts   = 0U;
+    *pReports = 0U;
+    for (size_t i = 0U; i < l_outLen; ++i) {
+        uint8_t b = l_out[i];
+        if (b == QS_FRAME) { // end of the frame?
+            uint8_t chksum = 0U;
+            for (uint_fast16_t k = 0U; k < n; ++k) {
+                chksum = static_cast<uint8_t>(chksum + frame[k]);
+            }
+            // the good frames: [seq][rec][data][chksum]
+            if ((n > 3U) && (n <= sizeof(frame))
+                && (chksum == QS_GOOD_CHKSUM))
+            {
+                if ((frame[1] == static_cast<uint8_t>(QS_USR_DICT))
+                    && (frame[2] == static_cast<uint8_t>(QS_OVERRUN)))
+                {
+                    ++(*pDicts);
+                }
+                // the time stamp and 5 formatted U32 counters
+                else if ((frame[1] == static_cast<uint8_t>(QS_OVERRUN))
+                         && (n == 3U + QS_TIME_SIZE + 5U*5U))
+                {
+                    uint8_t const * const lost = &frame[2 + QS_TIME_SIZE];
+                    ST_CHECK(lost[0] == static_cast<uint8_t>(QS::U32_T));
+                    sum += static_cast<uint32_t>(lost[1])
+                           | (static_cast<uint32_t>(lost[2]) << 8)
+                           | (static_cast<uint32_t>(lost[3]) << 16)
+                           | (static_cast<uint32_t>(lost[4]) << 24);
+                    ++(*pReports);
+                }
+            }
+            n = 0U;
+            esc = false;
+        }
+        else if (b == QS_ESC) {
+            esc = true;
+        }
+        else {
+            if (esc) {
+                b ^= QS_ESC_XOR;
+                esc = false;
+            }
+            if (n < sizeof(frame)) {
+                frame[n] = b;
+            }
+            ++n;
+        }
+    }
+    return sum;
+}
+
+//----------------------------------------------------------------------------
+// the QS_OVERRUN records report all the bytes overwritten in the QS buffer
+// while the flusher is blocked
+static void test_overrun(void) {
+    pthread_t rd;
+    ST_CHECK(pipe(l_pipe) == 0);
+    ST_CHECK(fcntl(l_pipe[1], F_SETPIPE_SZ, PIPE_SIZE) == PIPE_SIZE);
+    (void)sem_init(&l_readGo, 0, 0U);
+    l_outLen = 0U;
+    ST_CHECK(pthread_create(&rd, static_cast<pthread_attr_t *>(0),
+                            &reader, static_cast<void *>(0)) == 0);
+
+    // fill the pipe with the empty frames, so the first write of the
+    // flusher blocks before the flusher produces any QS_OVERRUN record
+    int const fl = fcntl(l_pipe[1], F_GETFL);
+    (void)fcntl(l_pipe[1], F_SETFL, fl | O_NONBLOCK);
+    while (write(l_pipe[1], &QS_FRAME, 1U) == 1) {
+    }
+    (void)fcntl(l_pipe[1], F_SETFL, fl);
+
+    uint32_t const lost0 = qsCounter(&QS::priv_.lostRep); // reported before
+    ST_CHECK(QS_startFlusher(l_pipe[1], 1024U, 10U));
+
+    // overflow the QS buffer several times
+    QS_FILTER_ON(FLOOD_REC);
+    for (uint32_t k = 0U; k < 8000U; ++k) {
+        QS_BEGIN(FLOOD_REC, static_cast<void *>(0))
+            QS_U32(0, k);
+        QS_END()
+    }
+    QS_FILTER_OFF(FLOOD_REC);
+    ST_CHECK(qsCounter(&QS::priv_.lost) != lost0); // QS data lost
+
+    (void)sem_post(&l_readGo); // drain the pipe
+    QS_stopFlusher();          // the flusher writes the rest of the data
+    (void)close(l_pipe[1]);
+    (void)pthread_join(rd, static_cast<void **>(0));
+    (void)close(l_pipe[0]);
+    (void)sem_destroy(&l_readGo);
+
+    uint32_t const lost = qsCounter(&QS::priv_.lost) - lost0;
+    uint_fast16_t nDicts;
+    uint_fast16_t nReports;
+    ST_CHECK(l_outLen < sizeof(l_out));
+    ST_CHECK(reportedLost(&nDicts, &nReports) == lost);
+    ST_CHECK(nReports != 0U);
+    ST_CHECK(nDicts == nReports); // every report is named for QSPY
+    ST_CHECK(qsCounter(&QS::priv_.lostRep) == qsCounter(&QS::priv_.lost));
+}
+static Test const l_overrun("QS flusher reports the overwritten bytes",
+                            &test_overrun);
+
+} // namespace SelfTest
@@ -0,0 +1,120 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, high-resolution time events
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "self_test.h"
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+//! Active object counting the expirations of its high-resolution time event
+class HrTimed : public QActive {
+public:
+    QHrTimeEvt m_hrEvt; // the high-resolution time event of the AO
+    uint32_t m_nExp;    // PROBE_SIG expirations dispatched to the AO
+
+public:
+    HrTimed()
+      : QActive(Q_STATE_CAST(&HrTimed::initial)),
+        m_hrEvt(this, PROBE_SIG)
+    {}
+
+protected:
+    static QState initial(HrTimed * const me, QEvt const * const e);
+    static QState active (HrTimed * const me, QEvt const * const e);
+};
+
+// Local objects -------------------------------------------------------------
+static HrTimed l_hrTimed;
+
+//............................................................................
+QState HrTimed::initial(HrTimed * const me, QEvt const * const e) {
+    (void)e; // unused parameter
+    me->m_nExp = 0U;
+    return Q_TRAN(&HrTimed::active);
+}
+//............................................................................
+QState HrTimed::active(HrTimed * const me, QEvt const * const e) {
+    QState status;
+    switch (e->sig) {
+        case PROBE_SIG: {
+            ++me->m_nExp;
+            status = Q_HANDLED();
+            break;
+        }
+        default: {
+            status = Q_SUPER(&QHsm::top);
+            break;
+        }
+    }
+    return status;
+}
+
+//............................................................................
+// read the expiration counter of the AO, which is updated in its thread
+static uint32_t expirations(void) {
+    QF_CRIT_ENTRY(dummy);
+    uint32_t const n = l_hrTimed.m_nExp;
+    QF_CRIT_EXIT(dummy);
+    return n;
+}
+
+//----------------------------------------------------------------------------
+// the time events are delivered by the thread started on the first arming
+// (the end of QF::run() joins the thread)
+static void test_expire(void) {
+    static QEvt const *queueSto[4];
+    l_hrTimed.start(2U, queueSto, Q_DIM(queueSto),
+                    static_cast<void *>(0), 0U);
+
+    // one-shot
+    l_hrTimed.m_hrEvt.armX(2000000U); // 2 ms
+    ST_CHECK(l_hrTimed.m_hrEvt.currDeadline() != 0U);
+    sleepMs(50U);
+    ST_CHECK(expirations() == 1U);
+    ST_CHECK(l_hrTimed.m_hrEvt.currDeadline() == 0U);
+
+    // periodic, rearmed while the thread runs
+    l_hrTimed.m_hrEvt.armX(2000000U, 20000000U); // 2 ms, then every 20 ms
+    sleepMs(72U); // expirations at 2, 22, 42 and 62 ms
+    ST_CHECK(l_hrTimed.m_hrEvt.disarm());
+    sleepMs(20U);
+    ST_CHECK(expirations() == 1U + 4U);
+    ST_CHECK(!l_hrTimed.m_hrEvt.disarm());
+}
+static Test const l_expire("HrTimeEvt one-shot and periodic expiration",
+                           &test_expire);
+
+} // namespace SelfTest
@@ -0,0 +1,106 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, latency histograms
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "self_test.h"
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+//----------------------------------------------------------------------------
+// the small values are counted exactly, one value per bucket
+static void test_exact(void) {
+    for (uint_fast16_t i = 0U; i < (1U << QF_LATENCY_SUB_BITS); ++i) {
+        ST_CHECK(QLatencyHist::binOf(static_cast<QFLatencyTime>(i)) == i);
+        ST_CHECK(QLatencyHist::binMax(i) == static_cast<QFLatencyTime>(i));
+    }
+}
+static Test const l_exact("Latency exact buckets", &test_exact);
+
+//----------------------------------------------------------------------------
+// every bucket ends right before the next one and the buckets cover the
+// whole 32-bit range
+static void test_buckets(void) {
+    for (uint_fast16_t i = 0U; i < (QF_LATENCY_BINS - 1U); ++i) {
+        QFLatencyTime const t = QLatencyHist::binMax(i);
+        ST_CHECK(QLatencyHist::binOf(t) == i);
+        ST_CHECK(QLatencyHist::binOf(t + 1U) == i + 1U);
+    }
+    ST_CHECK(QLatencyHist::binOf(0U) == 0U);
+    ST_CHECK(QLatencyHist::binOf(0xFFFFFFFFU) == QF_LATENCY_BINS - 1U);
+    ST_CHECK(QLatencyHist::binMax(QF_LATENCY_BINS - 1U) == 0xFFFFFFFFU);
+}
+static Test const l_buckets("Latency bucket boundaries", &test_buckets);
+
+//----------------------------------------------------------------------------
+// the upper end of the bucket exceeds the value by less than the resolution
+// 2^-QF_LATENCY_SUB_BITS of the value
+static void test_error(void) {
+    for (uint_fast8_t bit = 0U; bit < 32U; ++bit) {
+        QFLatencyTime const p = static_cast<QFLatencyTime>(1U) << bit;
+        QFLatencyTime const ts[] = { p - 1U, p, p + 1U, p + (p >> 1) };
+        for (uint_fast8_t n = 0U; n < Q_DIM(ts); ++n) {
+            QFLatencyTime const t = ts[n];
+            QFLatencyTime const max =
+                QLatencyHist::binMax(QLatencyHist::binOf(t));
+            ST_CHECK(max >= t);
+            ST_CHECK((max - t) <= (t >> QF_LATENCY_SUB_BITS));
+        }
+    }
+}
+static Test const l_error("Latency bucket resolution", &test_error);
+
+//----------------------------------------------------------------------------
+// the percentiles are the upper ends of the buckets, limited by the maximum
+static void test_percentiles(void) {
+    QLatencyHist h;
+    h.reset();
+    ST_CHECK(h.getPerMille(500U) == 0U);
+
+    for (QFLatencyTime t = 1U; t <= 1000U; ++t) {
+        h.record(t);
+    }
+    ST_CHECK(h.getCount() == 1000U);
+    ST_CHECK(h.getMax() == 1000U);
+    ST_CHECK(h.getBin(QLatencyHist::binOf(7U)) == 1U);
+    ST_CHECK(h.getPerMille(500U)
+             == QLatencyHist::binMax(QLatencyHist::binOf(500U)));
+    ST_CHECK(h.getPerMille(900U)
+             == QLatencyHist::binMax(QLatencyHist::binOf(900U)));
+    ST_CHECK(h.getPerMille(1000U) == 1000U); // limited by the maximum
+}
+static Test const l_percentiles("Latency percentiles", &test_percentiles);
+
+} // namespace SelfTest
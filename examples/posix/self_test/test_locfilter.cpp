@@ -0,0 +1,202 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, local QS filters
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "self_test.h"
+
+#include <pthread.h>
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+enum {
+    N_OBJS = 512 // candidate objects (every one with a distinct hash key)
+};
+
+// Local objects -------------------------------------------------------------
+static uint64_t l_objs[N_OBJS]; // the objects in the local filters
+static bool     l_churn;        // the churn thread keeps running
+
+//............................................................................
+// the slot of the object in the table of the local filters (or -1)
+static int slotOf(void const * const obj) {
+    QF_CRIT_ENTRY(dummy);
+    int slot = -1;
+    for (uint_fast16_t i = 0U; i < QS_LOC_FILTER_SIZE; ++i) {
+        if (QS::priv_.locObj[i] == obj) {
+            slot = static_cast<int>(i);
+        }
+    }
+    QF_CRIT_EXIT(dummy);
+    return slot;
+}
+//............................................................................
+// find @p n objects, which hash to the last slot of the table, so their
+// probe sequence wraps around to the first slots
+static uint_fast16_t findLast(void const *objs[], uint_fast16_t const n) {
+    uint_fast16_t found = 0U;
+    for (uint_fast16_t k = 0U; (k < N_OBJS) && (found < n); ++k) {
+        QS::locFilterAdd(QS::AP_OBJ, &l_objs[k]); // alone in the table
+        if (slotOf(&l_objs[k]) == static_cast<int>(QS_LOC_FILTER_SIZE - 1U)) {
+            objs[found] = &l_objs[k];
+            ++found;
+        }
+        QS::locFilterRemove(QS::AP_OBJ, &l_objs[k]);
+    }
+    return found;
+}
+//............................................................................
+// the objects, which no other test should find in the filters
+static bool tableEmpty(void) {
+    bool empty = (QS::priv_.locNum == 0U);
+    for (uint_fast8_t k = 0U; k <= QS::MAX_OBJ; ++k) {
+        empty = empty && (QS::priv_.locFilterN[k] == 0U);
+    }
+    return empty;
+}
+
+//----------------------------------------------------------------------------
+// the objects of several kinds are added and removed one by one
+static void test_add_remove(void) {
+    ST_CHECK(tableEmpty());
+
+    for (uint_fast16_t k = 0U; k < 20U; ++k) {
+        QS::locFilterAdd(QS::AP_OBJ, &l_objs[k]);
+        QS::locFilterAdd(QS::AP_OBJ, &l_objs[k]); // added only once
+    }
+    QS::locFilterAdd(QS::SM_OBJ, &l_objs[0]);    // another kind
+    ST_CHECK(QS::priv_.locFilterN[QS::AP_OBJ] == 20U);
+    ST_CHECK(QS::priv_.locFilterN[QS::SM_OBJ] == 1U);
+    ST_CHECK(QS::priv_.locNum == 20U);
+    for (uint_fast16_t k = 0U; k < 20U; ++k) {
+        ST_CHECK(QS::locFilterHas_(QS::AP_OBJ, &l_objs[k]));
+    }
+    ST_CHECK(!QS::locFilterHas_(QS::AP_OBJ, &l_objs[20]));
+    ST_CHECK(QS::locFilterHas_(QS::SM_OBJ, &l_objs[0]));
+    ST_CHECK(!QS::locFilterHas_(QS::SM_OBJ, &l_objs[1]));
+
+    // removing one kind keeps the object in the filter of the other kind
+    QS::locFilterRemove(QS::AP_OBJ, &l_objs[0]);
+    ST_CHECK(!QS::locFilterHas_(QS::AP_OBJ, &l_objs[0]));
+    ST_CHECK(QS::locFilterHas_(QS::SM_OBJ, &l_objs[0]));
+    QS::locFilterRemove(QS::SM_OBJ, &l_objs[0]);
+    ST_CHECK(QS::priv_.locNum == 19U);
+
+    // the remaining objects are found after every removal
+    for (uint_fast16_t k = 1U; k < 20U; k += 2U) {
+        QS::locFilterRemove(QS::AP_OBJ, &l_objs[k]);
+    }
+    for (uint_fast16_t k = 1U; k < 20U; ++k) {
+        ST_CHECK(QS::locFilterHas_(QS::AP_OBJ, &l_objs[k])
+                 == ((k & 1U) == 0U));
+    }
+    for (uint_fast16_t k = 2U; k < 20U; k += 2U) {
+        QS::locFilterRemove(QS::AP_OBJ, &l_objs[k]);
+    }
+    ST_CHECK(tableEmpty());
+}
+static Test const l_addRemove("LocFilter add and remove objects",
+                              &test_add_remove);
+
+//----------------------------------------------------------------------------
+// removing the object from the end of the table moves back the objects,
+// which wrapped around to the start of the table
+static void test_wrap(void) {
+    void const *objs[3];
+    ST_CHECK(findLast(objs, 3U) == 3U);
+
+    for (uint_fast8_t n = 0U; n < 3U; ++n) {
+        QS::locFilterAdd(QS::AP_OBJ, objs[n]);
+    }
+    ST_CHECK(slotOf(objs[0]) == static_cast<int>(QS_LOC_FILTER_SIZE - 1U));
+    ST_CHECK(slotOf(objs[1]) == 0);
+    ST_CHECK(slotOf(objs[2]) == 1);
+
+    QS::locFilterRemove(QS::AP_OBJ, objs[0]);
+    ST_CHECK(!QS::locFilterHas_(QS::AP_OBJ, objs[0]));
+    ST_CHECK(slotOf(objs[1]) == static_cast<int>(QS_LOC_FILTER_SIZE - 1U));
+    ST_CHECK(slotOf(objs[2]) == 0);
+    ST_CHECK(QS::priv_.locObj[1] == static_cast<void const *>(0));
+    ST_CHECK(QS::locFilterHas_(QS::AP_OBJ, objs[1]));
+    ST_CHECK(QS::locFilterHas_(QS::AP_OBJ, objs[2]));
+
+    QS::locFilterRemove(QS::AP_OBJ, objs[1]);
+    QS::locFilterRemove(QS::AP_OBJ, objs[2]);
+    ST_CHECK(tableEmpty());
+}
+static Test const l_wrap("LocFilter removal wraps around the table",
+                         &test_wrap);
+
+//............................................................................
+// add and remove the objects colliding with the observed object
+static void *churn(void *arg) {
+    void const * const * const objs = static_cast<void const **>(arg);
+    while (__atomic_load_n(&l_churn, __ATOMIC_ACQUIRE)) {
+        QS::locFilterAdd(QS::AP_OBJ, objs[0]);
+        QS::locFilterAdd(QS::AP_OBJ, objs[2]);
+        QS::locFilterRemove(QS::AP_OBJ, objs[0]);
+        QS::locFilterRemove(QS::AP_OBJ, objs[2]);
+    }
+    return static_cast<void *>(0);
+}
+
+//----------------------------------------------------------------------------
+// the object stays in the filter while the other objects move around it
+static void test_concurrent(void) {
+    static void const *objs[3];
+    ST_CHECK(findLast(objs, 3U) == 3U);
+
+    QS::locFilterAdd(QS::AP_OBJ, objs[1]); // observed by the test
+    __atomic_store_n(&l_churn, true, __ATOMIC_RELEASE);
+    pthread_t thr;
+    ST_CHECK(pthread_create(&thr, static_cast<pthread_attr_t *>(0), &churn,
+                            static_cast<void *>(objs)) == 0);
+    uint32_t nMiss = 0U;
+    for (uint32_t n = 0U; n < 200000U; ++n) {
+        if (!QS_LOC_FILTER_(QS::AP_OBJ, objs[1])) {
+            ++nMiss;
+        }
+    }
+    __atomic_store_n(&l_churn, false, __ATOMIC_RELEASE);
+    (void)pthread_join(thr, static_cast<void **>(0));
+    ST_CHECK(nMiss == 0U);
+
+    QS::locFilterRemove(QS::AP_OBJ, objs[1]);
+    ST_CHECK(tableEmpty());
+}
+static Test const l_concurrent("LocFilter probing during removals",
+                               &test_concurrent);
+
+} // namespace SelfTest
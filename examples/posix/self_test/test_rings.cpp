@@ -0,0 +1,296 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, per-thread QS rings
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "self_test.h"
+
+#include <pthread.h>
+#include <semaphore.h>
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+enum {
+    TEST_REC   = QS_USER,     // the records of the producer threads
+    N_THREADS  = 4,           // the number of the concurrent producers
+    N_RECS     = 2000,        // the records of every concurrent producer
+    N_FLOOD    = 1000,        // the records overflowing a ring
+    OUT_SIZE   = 512*1024,    // the maximum QS output read in a test
+    HELD_IDX   = 8,           // the producer held back by HELD_IDX + 1
+    BUSY_IDX   = HELD_IDX + 1 // the producer preempted inside its record
+};
+
+//! the test records and the sequence numbers found in the QS output
+struct Found {
+    uint32_t nRecs;             // the number of the test records
+    uint32_t next[BUSY_IDX + 1];// the next expected data of every producer
+    uint8_t  first[2];          // the producers of the first two records
+    uint8_t  seq;               // the last sequence number
+    bool     anySeq;            // any frame parsed yet
+    bool     seqOk;             // the sequence numbers are consecutive
+    bool     dataOk;            // the data of every producer are in order
+};
+
+// Local objects -------------------------------------------------------------
+static uint8_t  l_out[OUT_SIZE];  // the QS output read in the test
+static uint32_t l_outLen;         // the number of bytes in l_out[]
+static uint32_t l_nDone;          // the number of the finished producers
+static sem_t    l_started;        // the preempted producer began its record
+static sem_t    l_go;             // lets the preempted producer finish
+
+//............................................................................
+// produce the test records of the producer @p idx with the data from
+// @p first to @p last
+static void produce(uint8_t const idx,
+                    uint32_t const first, uint32_t const last)
+{
+    for (uint32_t k = first; k <= last; ++k) {
+        QS_BEGIN(TEST_REC, static_cast<void *>(0))
+            QS_U8(0, idx);
+            QS_U32(0, k);
+        QS_END()
+    }
+}
+//............................................................................
+static void *producer(void *arg) {
+    uint8_t const idx = static_cast<uint8_t>(
+        reinterpret_cast<uintptr_t>(arg));
+    for (uint32_t k = 0U; k < static_cast<uint32_t>(N_RECS); k += 100U) {
+        produce(idx, k, k + 99U);
+        sleepMs(1U); // let the consumer keep up with the producers
+    }
+    __atomic_add_fetch(&l_nDone, 1U, __ATOMIC_RELEASE);
+    return static_cast<void *>(0);
+}
+//............................................................................
+// the producer preempted in the middle of its record
+static void *preempted(void * /*arg*/) {
+    QS_BEGIN(TEST_REC, static_cast<void *>(0))
+        QS_U8(0, static_cast<uint8_t>(BUSY_IDX));
+        (void)sem_post(&l_started);
+        (void)sem_wait(&l_go);
+        QS_U32(0, 0U);
+    QS_END()
+    return static_cast<void *>(0);
+}
+//............................................................................
+static void *flooder(void * /*arg*/) {
+    produce(0U, 0U, static_cast<uint32_t>(N_FLOOD) - 1U);
+    return static_cast<void *>(0);
+}
+//............................................................................
+// append all the QS output available now to l_out[]
+static void readOut(void) {
+    l_outLen += readQs(&l_out[l_outLen],
+                       static_cast<uint32_t>(sizeof(l_out)) - l_outLen);
+}
+//............................................................................
+// [seq][rec][time][fmt][u8][fmt][u32]
+static void onFrame(uint8_t const * const frame, uint_fast16_t const n,
+                    void * const par)
+{
+    Found * const f = static_cast<Found *>(par);
+    if (f->anySeq && (frame[0] != static_cast<uint8_t>(f->seq + 1U))) {
+        f->seqOk = false;
+    }
+    f->seq = frame[0];
+    f->anySeq = true;
+
+    if ((frame[1] != static_cast<uint8_t>(TEST_REC))
+        || (n != static_cast<uint_fast16_t>(QS_TIME_SIZE + 9)))
+    {
+        return; // not a test record
+    }
+    uint8_t const * const d = &frame[2 + QS_TIME_SIZE];
+    uint8_t const idx = d[1];
+    uint32_t const k = static_cast<uint32_t>(d[3])
+                       | (static_cast<uint32_t>(d[4]) << 8)
+                       | (static_cast<uint32_t>(d[5]) << 16)
+                       | (static_cast<uint32_t>(d[6]) << 24);
+    if ((idx > static_cast<uint8_t>(BUSY_IDX)) || (k < f->next[idx])) {
+        f->dataOk = false; // not in the order produced by the thread
+        return;
+    }
+    f->next[idx] = k + 1U; // records lost in a full ring can be skipped
+    if (f->nRecs < 2U) {
+        f->first[f->nRecs] = idx;
+    }
+    ++f->nRecs;
+}
+//............................................................................
+// parse l_out[] into @p f
+static void parseOut(Found * const f) {
+    f->nRecs  = 0U;
+    f->anySeq = false;
+    f->seqOk  = true;
+    f->dataOk = true;
+    for (uint_fast8_t i = 0U; i <= static_cast<uint_fast8_t>(BUSY_IDX); ++i)
+    {
+        f->next[i] = 0U;
+    }
+    ST_CHECK(parseQs(l_out, l_outLen, &onFrame, f) == 0U);
+}
+//............................................................................
+// the number of the per-thread rings
+static uint_fast16_t nRings(void) {
+    uint_fast16_t n = 0U;
+    for (QS::QSRing *r = __atomic_load_n(&QS::rings_, __ATOMIC_ACQUIRE);
+         r != static_cast<QS::QSRing *>(0);
+         r = r->next)
+    {
+        ++n;
+    }
+    return n;
+}
+
+//----------------------------------------------------------------------------
+// the records of the concurrent producers are merged into a stream of good
+// frames with consecutive sequence numbers, in the order of every producer
+static void test_merge(void) {
+    pthread_t th[N_THREADS];
+    Found found;
+
+    QS_FILTER_ON(TEST_REC);
+    l_outLen = 0U;
+    readOut();
+    l_outLen = 0U; // discard the earlier output
+
+    uint32_t const lost = QS::getRingLost();
+    l_nDone = 0U;
+    for (uint_fast8_t i = 0U; i < static_cast<uint_fast8_t>(N_THREADS); ++i) {
+        ST_CHECK(pthread_create(&th[i], static_cast<pthread_attr_t *>(0),
+                     &producer, reinterpret_cast<void *>(i)) == 0);
+    }
+    // consume the records concurrently with the producers
+    while (__atomic_load_n(&l_nDone, __ATOMIC_ACQUIRE)
+           < static_cast<uint32_t>(N_THREADS))
+    {
+        readOut();
+    }
+    for (uint_fast8_t i = 0U; i < static_cast<uint_fast8_t>(N_THREADS); ++i) {
+        (void)pthread_join(th[i], static_cast<void **>(0));
+    }
+    readOut();
+    QS_FILTER_OFF(TEST_REC);
+
+    parseOut(&found);
+    ST_CHECK(found.seqOk);
+    ST_CHECK(found.dataOk);
+    ST_CHECK(found.nRecs + (QS::getRingLost() - lost)
+             == static_cast<uint32_t>(N_THREADS * N_RECS));
+}
+static Test const l_merge("Rings merge the records of the threads",
+                          &test_merge);
+
+//----------------------------------------------------------------------------
+// a record younger than a record still being written by another thread
+// is merged only after that record
+static void test_hold_back(void) {
+    pthread_t th;
+    Found found;
+
+    QS_FILTER_ON(TEST_REC);
+    l_outLen = 0U;
+    readOut();
+    l_outLen = 0U; // discard the earlier output
+
+    (void)sem_init(&l_started, 0, 0U);
+    (void)sem_init(&l_go, 0, 0U);
+    ST_CHECK(pthread_create(&th, static_cast<pthread_attr_t *>(0),
+                            &preempted, static_cast<void *>(0)) == 0);
+    (void)sem_wait(&l_started); // the older record is being written
+
+    produce(static_cast<uint8_t>(HELD_IDX), 0U, 0U); // the younger record
+    readOut();
+    parseOut(&found);
+    ST_CHECK(found.nRecs == 0U); // the younger record held back
+
+    (void)sem_post(&l_go);
+    (void)pthread_join(th, static_cast<void **>(0));
+    readOut();
+    QS_FILTER_OFF(TEST_REC);
+
+    parseOut(&found);
+    ST_CHECK(found.seqOk);
+    ST_CHECK(found.nRecs == 2U);
+    ST_CHECK(found.first[0] == static_cast<uint8_t>(BUSY_IDX));
+    ST_CHECK(found.first[1] == static_cast<uint8_t>(HELD_IDX));
+
+    (void)sem_destroy(&l_started);
+    (void)sem_destroy(&l_go);
+}
+static Test const l_holdBack("Rings hold back the records younger than "
+                             "a record in progress", &test_hold_back);
+
+//----------------------------------------------------------------------------
+// the records lost in a full ring are counted, and the ring of an exited
+// thread is freed (with its lost records) after all its records are merged
+static void test_overflow(void) {
+    pthread_t th;
+    Found found;
+
+    QS_FILTER_ON(TEST_REC);
+    l_outLen = 0U;
+    readOut();
+    readOut(); // free the rings of the threads exited earlier
+    l_outLen = 0U; // discard the earlier output
+
+    uint_fast16_t const rings = nRings();
+    uint32_t const lost = QS::getRingLost();
+
+    // the flooder overflows its ring and exits before any merge
+    ST_CHECK(pthread_create(&th, static_cast<pthread_attr_t *>(0),
+                            &flooder, static_cast<void *>(0)) == 0);
+    (void)pthread_join(th, static_cast<void **>(0));
+    ST_CHECK(nRings() == rings + 1U); // the ring still has the records
+    uint32_t const flooded = QS::getRingLost() - lost;
+    ST_CHECK(flooded > 0U);
+
+    readOut();
+    QS_FILTER_OFF(TEST_REC);
+    parseOut(&found);
+    ST_CHECK(found.seqOk);
+    ST_CHECK(found.dataOk);
+    ST_CHECK(found.nRecs + flooded == static_cast<uint32_t>(N_FLOOD));
+
+    readOut(); // free the ring merged completely
+    ST_CHECK(nRings() == rings);
+    ST_CHECK(QS::getRingLost() - lost == flooded); // kept after the free
+}
+static Test const l_overflow("Rings count the lost records and free "
+                             "the rings of the exited threads",
+                             &test_overflow);
+
+} // namespace SelfTest
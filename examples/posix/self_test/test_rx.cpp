@@ -0,0 +1,301 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, QS-RX block parser
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "qs_pkg.h"    // QS_FRAME, QS_ESC, QS_ESC_XOR
+#include "self_test.h"
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+enum {
+    IN_SIZE   = 2048,  // the maximum size of the QS-RX input
+    OUT_SIZE  = 8192,  // the maximum QS output of one parsing
+    MEM_SIZE  = 512,   // the Target memory poked by the QS-RX frames
+    LONG_POKE = 255    // the items of the poke longer than the frame buffer
+};
+
+//! the QS output and the Target memory after parsing the QS-RX input
+struct Result {
+    uint8_t  out[OUT_SIZE]; // the normalized QS output
+    uint32_t len;           // the number of bytes in out[]
+    uint8_t  mem[MEM_SIZE]; // the Target memory
+};
+
+// Local objects -------------------------------------------------------------
+static uint8_t  l_in[IN_SIZE];     // the escaped QS-RX input
+static uint32_t l_inLen;           // the number of bytes in l_in[]
+static uint8_t  l_frm[IN_SIZE];    // the frame being encoded
+static uint_fast16_t l_frmLen;     // the number of bytes in l_frm[]
+static uint8_t  l_seq;             // the sequence number of the frames
+static uint8_t  l_rxBuf[IN_SIZE + 1U]; // the QS-RX buffer of the byte path
+static uint8_t  l_qs[OUT_SIZE];    // the raw QS output of one parsing
+static uint8_t  l_mem[MEM_SIZE];   // the Target memory (QS_RX_POKE/FILL)
+static Result   l_ref;             // the result of the byte path
+static Result   l_blk;             // the result of the block path
+
+//............................................................................
+// begin the QS-RX frame of the record @p rec (with @p skip sequence numbers
+// skipped)
+static void frmBegin(uint8_t const rec, uint8_t const skip) {
+    l_seq = static_cast<uint8_t>(l_seq + 1U + skip);
+    l_frm[0] = l_seq;
+    l_frm[1] = rec;
+    l_frmLen = 2U;
+}
+//............................................................................
+// add the little-endian @p v of @p n bytes to the frame
+static void frmAdd(uint32_t v, uint_fast8_t n) {
+    for (; n != 0U; --n) {
+        l_frm[l_frmLen] = static_cast<uint8_t>(v);
+        ++l_frmLen;
+        v >>= 8;
+    }
+}
+//............................................................................
+// end the frame with the checksum (@p bad checksum) and the escaping
+static void frmEnd(bool const bad) {
+    uint8_t sum = 0U;
+    for (uint_fast16_t i = 0U; i < l_frmLen; ++i) {
+        sum = static_cast<uint8_t>(sum + l_frm[i]);
+    }
+    l_frm[l_frmLen] = static_cast<uint8_t>(~sum + (bad ? 1U : 0U));
+    ++l_frmLen;
+    for (uint_fast16_t i = 0U; i < l_frmLen; ++i) {
+        uint8_t const b = l_frm[i];
+        if ((b == QS_FRAME) || (b == QS_ESC)) {
+            l_in[l_inLen] = QS_ESC;
+            ++l_inLen;
+            l_in[l_inLen] = static_cast<uint8_t>(b ^ QS_ESC_XOR);
+        }
+        else {
+            l_in[l_inLen] = b;
+        }
+        ++l_inLen;
+    }
+    l_in[l_inLen] = QS_FRAME;
+    ++l_inLen;
+}
+//............................................................................
+// the QS-RX input with the frames taking both the fast and the byte path
+// (many of the bytes need escaping)
+static void encodeInput(void) {
+    l_inLen = 0U;
+    l_seq = 0U;
+
+    frmBegin(QS_RX_CURR_OBJ, 0U); // the Target memory is the AP object
+    frmAdd(static_cast<uint32_t>(QS::AP_OBJ), 1U);
+    frmAdd(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(l_mem)), 4U);
+    frmAdd(static_cast<uint32_t>(
+               static_cast<uint64_t>(reinterpret_cast<uintptr_t>(l_mem))
+               >> 32), QS_OBJ_PTR_SIZE - 4U);
+    frmEnd(false);
+
+    frmBegin(QS_RX_POKE, 0U);
+    frmAdd(0U, 2U);   // offset
+    frmAdd(1U, 1U);   // size
+    frmAdd(4U, 1U);   // num
+    frmAdd(0x22117D7EU, 4U);
+    frmEnd(false);
+
+    frmBegin(QS_RX_FILL, 0U);
+    frmAdd(8U, 2U);   // offset
+    frmAdd(4U, 1U);   // size
+    frmAdd(2U, 1U);   // num
+    frmAdd(0x7D7E7D7EU, 4U);
+    frmEnd(false);
+
+    frmBegin(QS_RX_COMMAND, 0U);
+    frmAdd(0x7EU, 1U);
+    frmAdd(0x7D7E0001U, 4U);
+    frmAdd(2U, 4U);
+    frmAdd(3U, 4U);
+    frmEnd(false);
+
+    frmBegin(QS_RX_TICK, 0U);
+    frmAdd(0U, 1U);
+    frmEnd(false);
+
+    frmBegin(QS_RX_EVENT, 0U); // dispatched to no current SM object
+    frmAdd(255U, 1U); // prio
+    frmAdd(0x7EU, Q_SIGNAL_SIZE);
+    frmAdd(0U, 2U);   // len
+    frmEnd(false);
+
+    frmBegin(QS_RX_COMMAND, 0U); // bad checksum
+    frmAdd(1U, 1U);
+    frmAdd(1U, 4U);
+    frmAdd(2U, 4U);
+    frmAdd(3U, 4U);
+    frmEnd(true);
+
+    frmBegin(QS_RX_EVENT, 0U); // bad checksum (the event is recycled)
+    frmAdd(255U, 1U);
+    frmAdd(0x7DU, Q_SIGNAL_SIZE);
+    frmAdd(0U, 2U);
+    frmEnd(true);
+
+    frmBegin(QS_RX_POKE, 0U); // longer than the frame buffer
+    frmAdd(16U, 2U);
+    frmAdd(1U, 1U);
+    frmAdd(static_cast<uint32_t>(LONG_POKE), 1U);
+    for (uint_fast16_t i = 0U; i < static_cast<uint_fast16_t>(LONG_POKE);
+         ++i)
+    {
+        frmAdd(((i % 3U) == 0U) ? 0x7EU : (0x7DU ^ i), 1U);
+    }
+    frmEnd(false);
+
+    frmBegin(QS_RX_TICK, 1U); // sequence number skipped
+    frmAdd(0U, 1U);
+    frmEnd(false);
+
+    frmBegin(QS_RX_POKE, 0U); // less data than declared
+    frmAdd(300U, 2U);
+    frmAdd(1U, 1U);
+    frmAdd(3U, 1U);
+    frmAdd(0x7E7DU, 2U);
+    frmEnd(false);
+
+    frmBegin(QS_RX_COMMAND, 0U); // back-to-back frames
+    frmAdd(4U, 1U);
+    frmAdd(0x7E7E7E7EU, 4U);
+    frmAdd(0x7D7D7D7DU, 4U);
+    frmAdd(0U, 4U);
+    frmEnd(false);
+    frmBegin(QS_RX_TICK, 0U);
+    frmAdd(0U, 1U);
+    frmEnd(false);
+}
+//............................................................................
+// [seq][rec][data...] stored as [n][rec][data...] without the time stamps
+static void onFrame(uint8_t const * const frame, uint_fast16_t const n,
+                    void * const par)
+{
+    Result * const r = static_cast<Result *>(par);
+    if ((r->len + n + 1U) > sizeof(r->out)) {
+        r->len = sizeof(r->out); // overflow, reported by the test
+        return;
+    }
+    r->out[r->len] = static_cast<uint8_t>(n);
+    ++r->len;
+    for (uint_fast16_t i = 1U; i < n; ++i) {
+        bool const time = (frame[1] == static_cast<uint8_t>(QS_TARGET_DONE))
+                          && (i >= 2U) && (i < 2U + QS_TIME_SIZE);
+        r->out[r->len] = time ? 0U : frame[i];
+        ++r->len;
+    }
+}
+//............................................................................
+// parse the QS-RX input byte by byte (@p split == 0) or in the blocks of
+// @p split bytes and store the result in @p r
+static void parseInput(uint32_t const split, Result * const r) {
+    for (uint_fast16_t i = 0U; i < static_cast<uint_fast16_t>(MEM_SIZE);
+         ++i)
+    {
+        l_mem[i] = 0U;
+    }
+    QS::rxInitBuf(l_rxBuf, static_cast<uint16_t>(sizeof(l_rxBuf)));
+    (void)readQs(l_qs, static_cast<uint32_t>(sizeof(l_qs))); // discard
+
+    if (split == 0U) {
+        for (uint32_t i = 0U; i < l_inLen; ++i) {
+            QS::rxPut(l_in[i]);
+        }
+        QS::rxParse();
+    }
+    else {
+        for (uint32_t i = 0U; i < l_inLen; i += split) {
+            uint32_t const n = ((l_inLen - i) < split) ? (l_inLen - i)
+                                                       : split;
+            QS::rxParseBlock(&l_in[i], static_cast<uint16_t>(n));
+        }
+    }
+
+    uint32_t const len = readQs(l_qs, static_cast<uint32_t>(sizeof(l_qs)));
+    ST_CHECK(len < sizeof(l_qs));
+    r->len = 0U;
+    ST_CHECK(parseQs(l_qs, len, &onFrame, r) == 0U);
+    ST_CHECK(r->len < sizeof(r->out));
+    for (uint_fast16_t i = 0U; i < static_cast<uint_fast16_t>(MEM_SIZE);
+         ++i)
+    {
+        r->mem[i] = l_mem[i];
+    }
+}
+//............................................................................
+// the results are the same
+static bool sameResult(Result const * const a, Result const * const b) {
+    bool same = (a->len == b->len);
+    for (uint32_t i = 0U; same && (i < a->len); ++i) {
+        same = (a->out[i] == b->out[i]);
+    }
+    for (uint_fast16_t i = 0U;
+         same && (i < static_cast<uint_fast16_t>(MEM_SIZE)); ++i)
+    {
+        same = (a->mem[i] == b->mem[i]);
+    }
+    return same;
+}
+
+//----------------------------------------------------------------------------
+// the block parser takes the same actions and produces the same QS-RX
+// responses as the byte parser, however the input is split into blocks
+// (escapes and frames split at the block boundaries)
+static void test_block(void) {
+    encodeInput();
+    ST_CHECK(l_inLen < sizeof(l_in));
+
+    parseInput(0U, &l_ref);
+    ST_CHECK(l_ref.mem[0] == 0x7EU); // the frames took effect
+    ST_CHECK(l_ref.mem[3] == 0x22U);
+    ST_CHECK(l_ref.mem[8] == 0x7EU);
+    ST_CHECK(l_ref.mem[16] == 0x7EU);
+    ST_CHECK(l_ref.mem[16 + 252] == 0x7EU); // the last item of 0x7E
+    ST_CHECK(l_ref.len > 40U); // the QS-RX responses
+
+    parseInput(l_inLen, &l_blk); // the whole input at once
+    ST_CHECK(sameResult(&l_ref, &l_blk));
+    for (uint32_t split = 1U; split <= 40U; ++split) {
+        parseInput(split, &l_blk);
+        ST_CHECK(sameResult(&l_ref, &l_blk));
+    }
+    parseInput(100U, &l_blk);
+    ST_CHECK(sameResult(&l_ref, &l_blk));
+}
+static Test const l_block("QS-RX block parser matches the byte parser",
+                          &test_block);
+
+} // namespace SelfTest
@@ -0,0 +1,291 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, QS sampling
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "qs_pkg.h"      // QS_target_info_()
+#include "qsdec/qsdec.h" // the host-side QS decoder
+#include "self_test.h"
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+enum {
+    TEST_REC = QS_USER,   // the test records (with the call number)
+    SIG_A    = 1000,      // the signal sampled 1 in 5
+    SIG_B,                // the signal sampled 1 in 2 (all signals)
+    MAX_REC  = 128,       // the maximum number of the decoded records
+    OUT_SIZE = 64*1024    // the maximum QS output read at once
+};
+
+//! the sampled records decoded by the host
+class Sampled : public QSpy::Handler {
+public:
+    Sampled() : n(0U), sum(0U) {}
+    virtual void onRecord(QSpy::Decoder const &dec,
+                          QSpy::Record const &rec)
+    {
+        uint64_t k = 0U; // the call number of the test record
+        if (rec.type == static_cast<uint8_t>(TEST_REC)) {
+            uint8_t const *p = rec.data;
+            QSpy::Item item;
+            if (dec.nextItem(&p, rec.data + rec.len, &item)) {
+                k = item.u;
+            }
+        }
+        else if ((rec.type != static_cast<uint8_t>(QSpy::QS_QEP_DISPATCH))
+                 || ((rec.sig != static_cast<uint32_t>(SIG_A))
+                     && (rec.sig != static_cast<uint32_t>(SIG_B))))
+        {
+            return; // not a test record
+        }
+        if (n < static_cast<uint_fast16_t>(MAX_REC)) {
+            call[n] = k;
+            skip[n] = rec.skip;
+            time[n] = rec.time;
+            sig[n]  = rec.sig;
+            ++n;
+        }
+        sum += static_cast<uint32_t>(rec.skip) + 1U; // the host's scaling
+    }
+
+    //! the host's estimate of the records of the signal @p s
+    uint32_t sumOf(uint32_t const s) const {
+        uint32_t total = 0U;
+        for (uint_fast16_t i = 0U; i < n; ++i) {
+            if (sig[i] == s) {
+                total += static_cast<uint32_t>(skip[i]) + 1U;
+            }
+        }
+        return total;
+    }
+
+    uint_fast16_t n;      // the number of the decoded test records
+    uint32_t sum;         // the sum of (skip + 1) of all test records
+    uint64_t call[MAX_REC];
+    uint16_t skip[MAX_REC];
+    uint64_t time[MAX_REC];
+    uint32_t sig[MAX_REC];
+};
+
+// Local objects -------------------------------------------------------------
+static uint8_t l_out[OUT_SIZE]; // the QS output read in the test
+static uint8_t l_sm;            // the "state machine" of the dispatches
+
+//............................................................................
+// start the QS output for a new host (the Target info after the reset)
+static void startHost(void) {
+    (void)readQs(l_out, sizeof(l_out)); // discard the previous output
+    QF_CRIT_ENTRY(dummy);
+    QS_target_info_(static_cast<uint8_t>(0xFF));
+    QF_CRIT_EXIT(dummy);
+}
+//............................................................................
+// decode the QS output available now
+static void decode(QSpy::Decoder &dec) {
+    uint32_t const len = readQs(l_out, sizeof(l_out));
+    ST_CHECK(len < sizeof(l_out));
+    dec.feed(l_out, len);
+}
+//............................................................................
+// the call @p k of the test record (through the QS_BEGIN gate)
+static void produce(uint32_t const k) {
+    QS_BEGIN(TEST_REC, static_cast<void *>(0))
+        QS_U32(0, k);
+    QS_END()
+}
+//............................................................................
+// the dispatch of the signal @p sig (through the QS_BEGIN_SIG_ gate)
+static void dispatch(QSignal const sig) {
+    QS_CRIT_STAT_
+    QS_BEGIN_SIG_(QS_QEP_DISPATCH, sig, QS::SM_OBJ, &l_sm)
+        QS_TIME_();
+        QS_SIG_(sig);
+        QS_OBJ_(&l_sm);
+        QS_FUN_(static_cast<QStateHandler>(0));
+    QS_END_()
+}
+
+//----------------------------------------------------------------------------
+// 1 in n records pass, each with the n - 1 records skipped before it, so
+// that the host's scaling sum(skip + 1) gives back all the records, and
+// the records after the sampling stops carry no skip count
+static void test_one_in_n(void) {
+    static Sampled s;
+    QSpy::Decoder dec(s);
+
+    startHost();
+    QS_FILTER_ON(TEST_REC);
+    QS::sample(TEST_REC, 0, 4U, 0U);
+    for (uint32_t k = 0U; k <= 100U; ++k) {
+        produce(k);
+    }
+    QS::sample(TEST_REC, 0, 0U, 0U); // stop the sampling
+    for (uint32_t k = 101U; k <= 103U; ++k) {
+        produce(k);
+    }
+    QS_FILTER_OFF(TEST_REC);
+    decode(dec);
+
+    ST_CHECK(s.n == 26U + 3U);
+    bool ok = true;
+    for (uint_fast16_t i = 0U; i < 26U; ++i) {
+        ok = ok && (s.call[i] == 4U*i)
+                && (s.skip[i] == ((i == 0U) ? 0U : 3U));
+    }
+    for (uint_fast16_t i = 26U; i < s.n; ++i) {
+        ok = ok && (s.call[i] == 101U + (i - 26U)) && (s.skip[i] == 0U);
+    }
+    ST_CHECK(ok);
+    ST_CHECK(s.sum == 104U); // the host's estimate is exact
+    ST_CHECK(dec.stats().badLen == 0U);
+}
+static Test const l_oneInN("Sampling 1 in n records", &test_one_in_n);
+
+//----------------------------------------------------------------------------
+// the sampling of one signal takes precedence over the sampling of all
+// signals of the record type (configured first, so it comes first in the
+// table), and each keeps its own count
+static void test_signal(void) {
+    static Sampled s;
+    QSpy::Decoder dec(s);
+
+    startHost();
+    QS_FILTER_ON(QS_QEP_DISPATCH);
+    QS::sample(QS_QEP_DISPATCH, 0, 2U, 0U);
+    QS::sample(QS_QEP_DISPATCH, SIG_A, 5U, 0U);
+    for (uint_fast16_t i = 0U; i < 51U; ++i) {
+        dispatch(static_cast<QSignal>(SIG_A));
+        dispatch(static_cast<QSignal>(SIG_B));
+    }
+    QS::sample(QS_QEP_DISPATCH, SIG_A, 0U, 0U);
+    QS::sample(QS_QEP_DISPATCH, 0, 0U, 0U);
+    QS_FILTER_OFF(QS_QEP_DISPATCH);
+    decode(dec);
+
+    uint_fast16_t nA = 0U;
+    uint_fast16_t nB = 0U;
+    bool ok = true;
+    for (uint_fast16_t i = 0U; i < s.n; ++i) {
+        if (s.sig[i] == static_cast<uint32_t>(SIG_A)) {
+            ok = ok && (s.skip[i] == ((nA == 0U) ? 0U : 4U));
+            ++nA;
+        }
+        else {
+            ok = ok && (s.skip[i] == ((nB == 0U) ? 0U : 1U));
+            ++nB;
+        }
+    }
+    ST_CHECK(ok);
+    ST_CHECK(nA == 11U); // 1 in 5 of 51
+    ST_CHECK(nB == 26U); // 1 in 2 of 51
+    ST_CHECK(s.sumOf(SIG_A) == 51U);
+    ST_CHECK(s.sumOf(SIG_B) == 51U);
+    ST_CHECK(dec.stats().badLen == 0U);
+}
+static Test const l_signal("Sampling of a signal over all signals",
+                           &test_signal);
+
+//----------------------------------------------------------------------------
+// at most one record per interval of the QS time (QS_getTime() counts
+// the microseconds) passes, and the skip counts still add up to all the
+// records
+static void test_interval(void) {
+    static Sampled s;
+    QSpy::Decoder dec(s);
+    QSTimeCtr const interval = static_cast<QSTimeCtr>(200U); // [us]
+
+    startHost();
+    QS_FILTER_ON(TEST_REC);
+    QS::sample(TEST_REC, 0, 0U, interval);
+    QSTimeCtr const t0 = QS::onGetTime();
+    uint32_t k = 0U;
+    while (static_cast<QSTimeCtr>(QS::onGetTime() - t0) < 20U*interval) {
+        produce(k);
+        ++k;
+    }
+    sleepMs(1U); // longer than the interval...
+    produce(k);  // ...so the last record passes
+    ++k;
+    QS::sample(TEST_REC, 0, 0U, 0U);
+    QS_FILTER_OFF(TEST_REC);
+    decode(dec);
+
+    ST_CHECK((s.n >= 2U) && (s.n <= 22U));
+    ST_CHECK(s.call[s.n - 1U] == k - 1U);
+    bool ok = true;
+    for (uint_fast16_t i = 1U; i < s.n; ++i) {
+        ok = ok && (static_cast<QSTimeCtr>(s.time[i] - s.time[i - 1U])
+                    >= interval*9U/10U);
+    }
+    ST_CHECK(ok);
+    ST_CHECK(s.sum == k); // the host's estimate is exact
+}
+static Test const l_interval("Sampling at most 1 record per interval",
+                             &test_interval);
+
+//----------------------------------------------------------------------------
+// the skip count saturates at 0xFFFF, so the host's estimate is only the
+// lower bound of the records
+static void test_saturation(void) {
+    static Sampled s;
+    QSpy::Decoder dec(s);
+    QSTimeCtr const interval = static_cast<QSTimeCtr>(500000U); // [us]
+    uint32_t const nSkip = 70000U;
+
+    startHost();
+    QS_FILTER_ON(TEST_REC);
+    QS::sample(TEST_REC, 0, 0U, interval);
+    QSTimeCtr const t0 = QS::onGetTime();
+    for (uint32_t k = 0U; k <= nSkip; ++k) { // the first one passes
+        produce(k);
+    }
+    // all the other records came before the end of the interval
+    ST_CHECK(static_cast<QSTimeCtr>(QS::onGetTime() - t0) < interval);
+    sleepMs(510U);
+    produce(nSkip + 1U);
+    QS::sample(TEST_REC, 0, 0U, 0U);
+    QS_FILTER_OFF(TEST_REC);
+    decode(dec);
+
+    ST_CHECK(s.n == 2U);
+    ST_CHECK(s.call[1] == nSkip + 1U);
+    ST_CHECK(s.skip[1] == 0xFFFFU);  // saturated
+    ST_CHECK(s.sum == 1U + 0x10000U);
+    ST_CHECK(s.sum < nSkip + 2U);    // the lower bound
+}
+static Test const l_saturation("Sampling skip count saturates",
+                               &test_saturation);
+
+} // namespace SelfTest
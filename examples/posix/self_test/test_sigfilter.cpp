@@ -0,0 +1,226 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, masks of ignored signals
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "self_test.h"
+
+#include <semaphore.h>
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+//! Active object ignoring IGNORED_SIG in the "filtering" state
+class Filtered : public QActive {
+public:
+    uint32_t m_nIgnored; // IGNORED_SIG events dispatched to the AO
+    uint32_t m_nProbes;  // PROBE_SIG events dispatched to the AO
+
+public:
+    Filtered() : QActive(Q_STATE_CAST(&Filtered::initial)) {}
+
+protected:
+    static QState initial (Filtered * const me, QEvt const * const e);
+    static QState filtering(Filtered * const me, QEvt const * const e);
+    static QState accepting(Filtered * const me, QEvt const * const e);
+};
+
+// Local objects -------------------------------------------------------------
+static Filtered l_filtered;
+static QSigMask l_mask;       // the signals ignored in Filtered::filtering
+static sem_t l_release;       // releases the AO blocked by BLOCK_SIG
+static uint8_t const l_sender = 0U; // QS sender of the test events
+
+//............................................................................
+QState Filtered::initial(Filtered * const me, QEvt const * const e) {
+    (void)e; // unused parameter
+    me->m_nIgnored = 0U;
+    me->m_nProbes  = 0U;
+    return Q_TRAN(&Filtered::filtering);
+}
+//............................................................................
+QState Filtered::filtering(Filtered * const me, QEvt const * const e) {
+    QState status;
+    switch (e->sig) {
+        case Q_ENTRY_SIG: {
+            me->setIgnoredSigs(&l_mask);
+            status = Q_HANDLED();
+            break;
+        }
+        case Q_EXIT_SIG: {
+            me->setIgnoredSigs(static_cast<QSigMask const *>(0));
+            status = Q_HANDLED();
+            break;
+        }
+        case IGNORED_SIG: { // counted to detect the events not discarded
+            ++me->m_nIgnored;
+            status = Q_HANDLED();
+            break;
+        }
+        case PROBE_SIG: {
+            ++me->m_nProbes;
+            status = Q_HANDLED();
+            break;
+        }
+        case BLOCK_SIG: { // stay in this RTC step until released
+            (void)sem_wait(&l_release);
+            status = Q_HANDLED();
+            break;
+        }
+        case SWITCH_SIG: {
+            status = Q_TRAN(&Filtered::accepting);
+            break;
+        }
+        default: {
+            status = Q_SUPER(&QHsm::top);
+            break;
+        }
+    }
+    return status;
+}
+//............................................................................
+QState Filtered::accepting(Filtered * const me, QEvt const * const e) {
+    QState status;
+    switch (e->sig) {
+        case IGNORED_SIG: {
+            ++me->m_nIgnored;
+            status = Q_HANDLED();
+            break;
+        }
+        case SWITCH_SIG: {
+            status = Q_TRAN(&Filtered::filtering);
+            break;
+        }
+        default: {
+            status = Q_SUPER(&QHsm::top);
+            break;
+        }
+    }
+    return status;
+}
+
+//............................................................................
+// start the test AO on the first use
+static Filtered *filtered(void) {
+    static QEvt const *queueSto[8];
+    static bool isStarted = false;
+    if (!isStarted) {
+        l_mask.clear();
+        l_mask.insert(IGNORED_SIG);
+        (void)sem_init(&l_release, 0, 0U);
+        l_filtered.start(1U, queueSto, Q_DIM(queueSto),
+                         static_cast<void *>(0), 0U);
+        isStarted = true;
+    }
+    return &l_filtered;
+}
+//............................................................................
+// wait until the AO waits for events with an empty queue
+static bool waitIdle(QActive const * const a) {
+    for (uint_fast16_t n = 0U; n < 1000U; ++n) {
+        QF_CRIT_ENTRY(dummy);
+        bool const idle = a->m_isIdle && a->m_eQueue.isEmpty();
+        QF_CRIT_EXIT(dummy);
+        if (idle) {
+            return true;
+        }
+        sleepMs(1U);
+    }
+    return false;
+}
+//............................................................................
+// read a counter of the AO, which is updated in its thread
+static uint32_t counter(uint32_t const * const ctr) {
+    QF_CRIT_ENTRY(dummy);
+    uint32_t const n = *ctr;
+    QF_CRIT_EXIT(dummy);
+    return n;
+}
+
+//----------------------------------------------------------------------------
+// an ignored signal posted to an idle AO is discarded and recycled
+static void test_idle(void) {
+    Filtered * const ao = filtered();
+    ST_CHECK(waitIdle(ao));
+
+    uint32_t const ctr0 = ao->getIgnoredCtr();
+
+    // more events than the pool holds, so any leaked event fails Q_NEW()
+    for (uint_fast8_t n = 0U; n < 20U; ++n) {
+        ST_CHECK(ao->POST(Q_NEW(QEvt, IGNORED_SIG), &l_sender));
+    }
+    ST_CHECK(ao->getIgnoredCtr() == ctr0 + 20U);
+
+    // the other signals are delivered
+    ST_CHECK(ao->POST(Q_NEW(QEvt, PROBE_SIG), &l_sender));
+    ST_CHECK(waitIdle(ao));
+    ST_CHECK(counter(&ao->m_nProbes) == 1U);
+    ST_CHECK(counter(&ao->m_nIgnored) == 0U);
+}
+static Test const l_idle("SigFilter idle AO discards ignored events",
+                         &test_idle);
+
+//----------------------------------------------------------------------------
+// an ignored signal is queued while the AO is busy or without the mask
+static void test_busy(void) {
+    Filtered * const ao = filtered();
+    ST_CHECK(waitIdle(ao));
+
+    uint32_t const ctr0 = ao->getIgnoredCtr();
+    uint32_t const ign0 = counter(&ao->m_nIgnored);
+
+    // the AO in the middle of an RTC step can still change its state
+    ST_CHECK(ao->POST(Q_NEW(QEvt, BLOCK_SIG), &l_sender));
+    sleepMs(10U);
+    ST_CHECK(ao->POST(Q_NEW(QEvt, IGNORED_SIG), &l_sender));
+    (void)sem_post(&l_release);
+    ST_CHECK(waitIdle(ao));
+    ST_CHECK(ao->getIgnoredCtr() == ctr0);
+    ST_CHECK(counter(&ao->m_nIgnored) == ign0 + 1U);
+
+    // the state without the mask gets all the events
+    ST_CHECK(ao->POST(Q_NEW(QEvt, SWITCH_SIG), &l_sender));
+    ST_CHECK(waitIdle(ao));
+    ST_CHECK(ao->POST(Q_NEW(QEvt, IGNORED_SIG), &l_sender));
+    ST_CHECK(waitIdle(ao));
+    ST_CHECK(ao->getIgnoredCtr() == ctr0);
+    ST_CHECK(counter(&ao->m_nIgnored) == ign0 + 2U);
+
+    ST_CHECK(ao->POST(Q_NEW(QEvt, SWITCH_SIG), &l_sender)); // back
+    ST_CHECK(waitIdle(ao));
+}
+static Test const l_busy("SigFilter busy AO keeps ignored events",
+                         &test_busy);
+
+} // namespace SelfTest
@@ -0,0 +1,135 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, QS static filter
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "self_test.h"
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+// the suite removes QS_QF_CRIT_ENTRY and QS_QF_CRIT_EXIT at compile time
+// (QS_STATIC_FILTER1=0xFFFFFE7FU) and keeps all the other records
+Q_ASSERT_COMPILE(!QS_STATIC_FILTER_(QS_QF_CRIT_ENTRY));
+Q_ASSERT_COMPILE(!QS_STATIC_FILTER_(QS_QF_CRIT_EXIT));
+Q_ASSERT_COMPILE(QS_STATIC_FILTER_(QS_QF_ISR_ENTRY));
+Q_ASSERT_COMPILE(QS_STATIC_FILTER_(QS_QF_TIMEEVT_ARM));
+
+//! never defined, so the self-test links only when the records calling
+//! it are removed by the compiler
+void staticFilterLeak(void);
+
+// Local objects -------------------------------------------------------------
+static uint8_t l_out[4096]; // the QS output read in the test
+
+//............................................................................
+// count the frames of the record type *par
+static void onFrame(uint8_t const * const frame, uint_fast16_t const n,
+                    void * const par)
+{
+    uint_fast16_t * const cnt = static_cast<uint_fast16_t *>(par);
+    if ((n >= 2U) && (frame[1] == static_cast<uint8_t>(cnt[0]))) {
+        ++cnt[1];
+    }
+}
+//............................................................................
+// the number of the frames of the record type @p rec in the QS output
+static uint_fast16_t countRecs(uint_fast8_t const rec) {
+    uint_fast16_t cnt[2] = { rec, 0U };
+    uint32_t const len = readQs(l_out, sizeof(l_out));
+    ST_CHECK(parseQs(l_out, len, &onFrame, cnt) == 0U);
+    return cnt[1];
+}
+//............................................................................
+// the ISR entry record (enabled at compile time)
+static void isrEntry(void) {
+    QS_CRIT_STAT_
+    QS_BEGIN_(QS_QF_ISR_ENTRY, QS::AP_OBJ, static_cast<void *>(0))
+        QS_TIME_();
+        QS_U8_(static_cast<uint8_t>(1)); // nesting
+        QS_U8_(static_cast<uint8_t>(0)); // priority
+    QS_END_()
+}
+
+//----------------------------------------------------------------------------
+// the records removed by the static filter are not produced even with the
+// global filter on, and their code is gone (it refers to an undefined
+// function, so the self-test would not link otherwise)
+static void test_compiled_out(void) {
+    QS_CRIT_STAT_
+
+    (void)readQs(l_out, sizeof(l_out)); // discard the previous output
+    QS_FILTER_ON(QS_QF_CRIT_ENTRY);
+    QS_FILTER_ON(QS_QF_CRIT_EXIT);
+    QS_BEGIN_(QS_QF_CRIT_ENTRY, QS::AP_OBJ, static_cast<void *>(0))
+        staticFilterLeak();
+        QS_TIME_();
+        QS_U8_(static_cast<uint8_t>(1));
+    QS_END_()
+    QS_BEGIN_(QS_QF_CRIT_EXIT, QS::AP_OBJ, static_cast<void *>(0))
+        staticFilterLeak();
+        QS_TIME_();
+        QS_U8_(static_cast<uint8_t>(0));
+    QS_END_()
+    QS_FILTER_OFF(QS_QF_CRIT_ENTRY);
+    QS_FILTER_OFF(QS_QF_CRIT_EXIT);
+
+    ST_CHECK(countRecs(QS_QF_CRIT_ENTRY) == 0U);
+    ST_CHECK(countRecs(QS_QF_CRIT_EXIT) == 0U);
+}
+static Test const l_compiledOut("Static filter removes the records",
+                                &test_compiled_out);
+
+//----------------------------------------------------------------------------
+// the records kept by the static filter are still subject to the global
+// filter at run time
+static void test_runtime(void) {
+    (void)readQs(l_out, sizeof(l_out)); // discard the previous output
+    QS_FILTER_OFF(QS_QF_ISR_ENTRY);
+    isrEntry();
+    ST_CHECK(countRecs(QS_QF_ISR_ENTRY) == 0U);
+
+    QS_FILTER_ON(QS_QF_ISR_ENTRY);
+    isrEntry();
+    isrEntry();
+    QS_FILTER_OFF(QS_QF_ISR_ENTRY);
+    ST_CHECK(countRecs(QS_QF_ISR_ENTRY) == 2U);
+
+    isrEntry();
+    ST_CHECK(countRecs(QS_QF_ISR_ENTRY) == 0U);
+}
+static Test const l_runtime("Static filter keeps the runtime filter",
+                            &test_runtime);
+
+} // namespace SelfTest
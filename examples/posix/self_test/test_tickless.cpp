@@ -0,0 +1,180 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, tickless clock
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "self_test.h"
+
+#include <semaphore.h>
+#include <time.h>
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+enum {
+    PERIOD_NS = 1000000000 / ST_TICK_RATE, // the tick period [ns]
+    MS_TICKS  = ST_TICK_RATE / 1000        // the ticks in 1 ms
+};
+
+//! Active object recording the expiration time of its time event
+class Timed : public QActive {
+public:
+    QTimeEvt m_timeEvt; // the time event under test
+    QTimeEvt m_longEvt; // another time event armed far in the future
+    uint64_t m_expTime; // the time [ns] of the last PROBE_SIG expiration
+
+public:
+    Timed()
+      : QActive(Q_STATE_CAST(&Timed::initial)),
+        m_timeEvt(this, PROBE_SIG, 0U),
+        m_longEvt(this, SWITCH_SIG, 0U)
+    {}
+
+protected:
+    static QState initial(Timed * const me, QEvt const * const e);
+    static QState active (Timed * const me, QEvt const * const e);
+};
+
+// Local objects -------------------------------------------------------------
+static Timed l_timed;
+static sem_t l_expired; // posted by the AO on every PROBE_SIG expiration
+
+//............................................................................
+static uint64_t nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000000U)
+           + static_cast<uint64_t>(ts.tv_nsec);
+}
+//............................................................................
+QState Timed::initial(Timed * const me, QEvt const * const e) {
+    (void)e; // unused parameter
+    me->m_expTime = 0U;
+    return Q_TRAN(&Timed::active);
+}
+//............................................................................
+QState Timed::active(Timed * const me, QEvt const * const e) {
+    QState status;
+    switch (e->sig) {
+        case PROBE_SIG: {
+            uint64_t const t = nowNs();
+            QF_CRIT_ENTRY(dummy);
+            me->m_expTime = t;
+            QF_CRIT_EXIT(dummy);
+            (void)sem_post(&l_expired);
+            status = Q_HANDLED();
+            break;
+        }
+        case SWITCH_SIG: { // the long time event must not expire
+            status = Q_HANDLED();
+            break;
+        }
+        default: {
+            status = Q_SUPER(&QHsm::top);
+            break;
+        }
+    }
+    return status;
+}
+
+//............................................................................
+// start the test AO on the first use
+static Timed *timed(void) {
+    static QEvt const *queueSto[4];
+    static bool isStarted = false;
+    if (!isStarted) {
+        (void)sem_init(&l_expired, 0, 0U);
+        l_timed.start(1U, queueSto, Q_DIM(queueSto),
+                      static_cast<void *>(0), 0U);
+        isStarted = true;
+    }
+    return &l_timed;
+}
+//............................................................................
+// arm the time event for @p ms milliseconds and return the time [ns] from
+// arming until the expiration (0 when it did not expire within 1 s)
+static uint64_t expiresAfter(uint32_t const ms) {
+    Timed * const ao = timed();
+    uint64_t const t0 = nowNs();
+    ao->m_timeEvt.armX(static_cast<QTimeEvtCtr>(ms * MS_TICKS));
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += 1;
+    if (sem_timedwait(&l_expired, &ts) != 0) {
+        (void)ao->m_timeEvt.disarm();
+        return 0U;
+    }
+    QF_CRIT_ENTRY(dummy);
+    uint64_t const t = ao->m_expTime;
+    QF_CRIT_EXIT(dummy);
+    return t - t0;
+}
+
+//----------------------------------------------------------------------------
+// a time event armed after an idle longer than the QTimeEvtCtr range
+// expires after the requested time, not right away
+static void test_long_idle(void) {
+    (void)timed();
+    ST_CHECK(sizeof(QTimeEvtCtr) == 2U); // the suite's 16-bit counters
+
+    sleepMs(1000U); // 100000 ticks with no time events armed
+    uint64_t const dt = expiresAfter(10U);
+    ST_CHECK(dt + PERIOD_NS >= 10000000U);
+    ST_CHECK(dt < 100000000U);
+
+    sleepMs(700U); // more than 65536 ticks again
+    uint64_t const dt2 = expiresAfter(20U);
+    ST_CHECK(dt2 + PERIOD_NS >= 20000000U);
+    ST_CHECK(dt2 < 110000000U);
+}
+static Test const l_longIdle("Tickless arming after a long idle",
+                             &test_long_idle);
+
+//----------------------------------------------------------------------------
+// a sooner time event armed while another one is armed expires after
+// the requested time (the ticks elapsed so far are accounted for)
+static void test_sooner(void) {
+    Timed * const ao = timed();
+    ao->m_longEvt.armX(static_cast<QTimeEvtCtr>(600U * MS_TICKS));
+
+    sleepMs(300U); // about a half of the long time event
+    uint64_t const dt = expiresAfter(10U);
+    ST_CHECK(dt + PERIOD_NS >= 10000000U);
+    ST_CHECK(dt < 100000000U);
+    ST_CHECK(ao->m_longEvt.disarm()); // did not expire yet
+}
+static Test const l_sooner("Tickless sooner deadline", &test_sooner);
+
+} // namespace SelfTest
@@ -0,0 +1,271 @@
+//****************************************************************************
+// Product: QP/C++ self-test of the POSIX port, QS trace triggers
+// Last updated for version 6.0.3
+// Last updated on  2018-01-20
+//
+//                    Q u a n t u m     L e a P s
+//                    ---------------------------
+//                    innovating embedded systems
+//
+// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+//
+// This program is open source software: you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Alternatively, this program may be distributed and modified under the
+// terms of Quantum Leaps commercial licenses, which expressly supersede
+// the GNU General Public License and are specifically designed for
+// licensees interested in retaining the proprietary status of their code.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+//
+// Contact information:
+// https://state-machine.com
+// mailto:info@state-machine.com
+//****************************************************************************
+#include "qpcpp.h"
+#include "qs_pkg.h"    // QS_FRAME, QS_ESC, QS_ESC_XOR, QS_GOOD_CHKSUM
+#include "self_test.h"
+
+using namespace QP;
+
+//****************************************************************************
+namespace SelfTest {
+
+enum {
+    TEST_REC  = QS_USER,     // the records around the trigger
+    FIRE_REC  = QS_USER + 1, // the record firing the TRG_REC trigger
+    PRE_SIZE  = 200,         // the pre-trigger window (bytes)
+    POST_SIZE = 150,         // the post-trigger window (bytes)
+    REC_MAX   = 32,          // the maximum size of the records (bytes)
+    OUT_SIZE  = 1024,        // the maximum size of the capture (bytes)
+    RECS_MAX  = 64           // the maximum number of the captured records
+};
+
+//! a record parsed from the capture
+struct CapRec {
+    uint32_t data; // U32 of the test records, trigger value of the marker
+    size_t   offs; // offset of the record in the capture
+    uint8_t  seq;  // sequence number of the record
+    uint8_t  type; // type of the record
+    uint8_t  arg;  // first data byte (index of the trigger, dict. record)
+};
+
+// Local objects -------------------------------------------------------------
+static uint8_t l_out[OUT_SIZE];     // the capture read from the QS buffer
+static size_t  l_outLen;            // the number of bytes in l_out[]
+static CapRec  l_recs[RECS_MAX];    // the records parsed from l_out[]
+static uint_fast8_t l_nRecs;        // the number of records in l_recs[]
+
+//............................................................................
+// move all the QS data available for the output to l_out[]
+static void readOut(void) {
+    l_outLen = 0U;
+    for (;;) {
+        uint16_t n = static_cast<uint16_t>(sizeof(l_out) - l_outLen);
+        QF_CRIT_ENTRY(dummy);
+        uint8_t const * const block = QS::getBlock(&n);
+        for (uint16_t i = 0U; i < n; ++i) {
+            l_out[l_outLen + i] = block[i];
+        }
+        QF_CRIT_EXIT(dummy);
+        if (n == 0U) {
+            break;
+        }
+        l_outLen += n;
+    }
+}
+//............................................................................
+// the state of the trace capture, which changes in the QS critical section
+static uint8_t trgState(void) {
+    QF_CRIT_ENTRY(dummy);
+    uint8_t const state = QS::priv_.trgState;
+    QF_CRIT_EXIT(dummy);
+    return state;
+}
+//............................................................................
+// produce the test records with the data from @p first to @p last
+static void produce(uint_fast8_t const rec,
+                    uint32_t const first, uint32_t const last)
+{
+    for (uint32_t k = first; k <= last; ++k) {
+        QS_BEGIN(rec, static_cast<void *>(0))
+            QS_U32(0, k);
+        QS_END()
+    }
+}
+//............................................................................
+// parse the frames in l_out[] into l_recs[]
+static void parse(void) {
+    static uint8_t frame[REC_MAX];
+    uint_fast16_t n = 0U;
+    size_t offs = 0U;
+    bool esc = false;
+    l_nRecs = 0U;
+    for (size_t i = 0U; i < l_outLen; ++i) {
+        uint8_t b = l_out[i];
+        if (b == QS_FRAME) { // end of the frame?
+            uint8_t chksum = 0U;
+            for (uint_fast16_t k = 0U; (k < n) && (k < sizeof(frame)); ++k) {
+                chksum = static_cast<uint8_t>(chksum + frame[k]);
+            }
+            ST_CHECK((n > 3U) && (n <= sizeof(frame))
+                     && (chksum == QS_GOOD_CHKSUM));
+            ST_CHECK(l_nRecs < static_cast<uint_fast8_t>(RECS_MAX));
+            if (l_nRecs < static_cast<uint_fast8_t>(RECS_MAX)) {
+                CapRec * const r = &l_recs[l_nRecs];
+                r->offs = offs;
+                r->seq  = frame[0];
+                r->type = frame[1];
+                r->arg  = frame[2];
+                r->data = 0U;
+                // [seq][rec][time][fmt][u32][chksum]
+                uint8_t const *d = &frame[2 + QS_TIME_SIZE + 1];
+                if (r->type == static_cast<uint8_t>(QS_TRG_FIRED)) {
+                    // [seq][rec][time][fmt][u8][fmt][u32][chksum]
+                    r->arg = d[0];
+                    d = &d[2];
+                }
+                if (r->type != static_cast<uint8_t>(QS_USR_DICT)) {
+                    r->data = static_cast<uint32_t>(d[0])
+                              | (static_cast<uint32_t>(d[1]) << 8)
+                              | (static_cast<uint32_t>(d[2]) << 16)
+                              | (static_cast<uint32_t>(d[3]) << 24);
+                }
+                ++l_nRecs;
+            }
+            n = 0U;
+            offs = i + 1U;
+            esc = false;
+        }
+        else if (b == QS_ESC) {
+            esc = true;
+        }
+        else {
+            if (esc) {
+                b ^= QS_ESC_XOR;
+                esc = false;
+            }
+            if (n < sizeof(frame)) {
+                frame[n] = b;
+            }
+            ++n;
+        }
+    }
+}
+//............................................................................
+// check the capture around the marker of the trigger @p idx that fired at
+// @p value: the pre-trigger records end with @p lastPre, and the marker is
+// followed by @p nFire FIRE_REC records and the records from @p firstPost
+static void checkCapture(uint8_t const idx, uint32_t const value,
+                         uint32_t const lastPre, uint_fast8_t const nFire,
+                         uint32_t const firstPost)
+{
+    readOut();
+    parse();
+
+    // the output is a contiguous part of the trace
+    ST_CHECK(l_nRecs > 2U);
+    for (uint_fast8_t i = 1U; i < l_nRecs; ++i) {
+        ST_CHECK(l_recs[i].seq
+                 == static_cast<uint8_t>(l_recs[i - 1U].seq + 1U));
+    }
+
+    // the marker (after its dictionary) and the pre-trigger window
+    uint_fast8_t m = 0U;
+    while ((m < l_nRecs)
+           && (l_recs[m].type != static_cast<uint8_t>(QS_TRG_FIRED)))
+    {
+        ++m;
+    }
+    ST_CHECK((m > 1U) && (m < l_nRecs));
+    if ((m <= 1U) || (m >= l_nRecs)) {
+        return; // no marker to check the capture around
+    }
+    ST_CHECK(l_recs[m].arg == idx);
+    ST_CHECK(l_recs[m].data == value);
+    ST_CHECK(l_recs[m - 1U].type == static_cast<uint8_t>(QS_USR_DICT));
+    ST_CHECK(l_recs[m - 1U].arg == static_cast<uint8_t>(QS_TRG_FIRED));
+
+    size_t const pre = l_recs[m - 1U].offs; // the bytes before the trigger
+    ST_CHECK((pre <= PRE_SIZE) && (pre + REC_MAX > PRE_SIZE));
+    for (uint_fast8_t i = 0U; i < m - 1U; ++i) {
+        ST_CHECK(l_recs[i].type == static_cast<uint8_t>(TEST_REC));
+        ST_CHECK(l_recs[i].data == lastPre - (m - 2U) + i);
+    }
+
+    // the post-trigger window, after which QS freezes
+    size_t const post = l_outLen - pre; // the bytes since the trigger
+    ST_CHECK((post >= POST_SIZE) && (post < POST_SIZE + REC_MAX));
+    uint_fast8_t i = m + 1U;
+    for (uint_fast8_t k = 0U; k < nFire; ++k, ++i) {
+        ST_CHECK((i < l_nRecs)
+                 && (l_recs[i].type == static_cast<uint8_t>(FIRE_REC)));
+    }
+    ST_CHECK(i < l_nRecs);
+    for (uint32_t k = firstPost; i < l_nRecs; ++k, ++i) {
+        ST_CHECK(l_recs[i].type == static_cast<uint8_t>(TEST_REC));
+        ST_CHECK(l_recs[i].data == k);
+    }
+    ST_CHECK(trgState() == static_cast<uint8_t>(QS::TRG_DONE));
+    produce(TEST_REC, 2000U, 2009U); // frozen QS drops these records
+    readOut();
+    ST_CHECK(l_outLen == 0U);
+}
+
+//----------------------------------------------------------------------------
+// the trigger fired by the application releases the records before it
+// and captures the records after it
+static void test_fire(void) {
+    QS_FILTER_ON(TEST_REC);
+    QS::trgArm(PRE_SIZE, POST_SIZE);
+    produce(TEST_REC, 0U, 99U); // overflow the pre-trigger window
+    readOut();
+    ST_CHECK(l_outLen == 0U); // the output is held while armed
+
+    QS::trgFire();
+    ST_CHECK(trgState() == static_cast<uint8_t>(QS::TRG_POST));
+    produce(TEST_REC, 1000U, 1099U); // overflow the post-trigger window
+    checkCapture(0xFFU, 0U, 99U, 0U, 1000U);
+
+    QS::trgDisarm(); // restore the filters
+    QS_FILTER_OFF(TEST_REC);
+    readOut();
+}
+static Test const l_fire("QS trigger fired by the application",
+                         &test_fire);
+
+//----------------------------------------------------------------------------
+// the TRG_REC trigger fires before its record, which is the first record
+// after the marker
+static void test_rec(void) {
+    QS_FILTER_ON(TEST_REC);
+    QS_FILTER_ON(FIRE_REC);
+    QS::trgSet(0U, QS::TRG_REC, FIRE_REC, 0, static_cast<void *>(0), 0U);
+    QS::trgArm(PRE_SIZE, POST_SIZE);
+    produce(TEST_REC, 0U, 49U);
+    ST_CHECK(trgState() == static_cast<uint8_t>(QS::TRG_ARMED));
+
+    produce(FIRE_REC, 500U, 500U); // fires the trigger
+    ST_CHECK(trgState() == static_cast<uint8_t>(QS::TRG_POST));
+    produce(FIRE_REC, 501U, 501U); // the trigger does not fire again
+    produce(TEST_REC, 1000U, 1099U);
+    checkCapture(0U, static_cast<uint32_t>(FIRE_REC), 49U, 2U, 1000U);
+
+    QS::trgSet(0U, QS::TRG_NONE, 0U, 0, static_cast<void *>(0), 0U);
+    QS::trgDisarm();
+    QS_FILTER_OFF(TEST_REC);
+    QS_FILTER_OFF(FIRE_REC);
+    readOut();
+}
+static Test const l_rec("QS trigger fired by a record", &test_rec);
+
+} // namespace SelfTest
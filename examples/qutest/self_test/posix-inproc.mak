@@ -0,0 +1,206 @@
+##############################################################################
+# Product: Makefile for QUTEST self-test; QP/C on POSIX host, in-process
+# Last updated for version 6.0.3
+# Last updated on  2018-01-20
+#
+#                    Q u a n t u m     L e a P s
+#                    ---------------------------
+#                    innovating embedded systems
+#
+# Copyright (C) Quantum Leaps, LLC. All rights reserved.
+#
+# This program is open source software: you can redistribute it and/or
+# modify it under the terms of the GNU General Public License as published
+# by the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# Alternatively, this program may be distributed and modified under the
+# terms of Quantum Leaps commercial licenses, which expressly supersede
+# the GNU General Public License and are specifically designed for
+# licensees interested in retaining the proprietary status of their code.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+# Contact information:
+# https://state-machine.com
+# mailto:info@state-machine.com
+##############################################################################
+#
+# examples of invoking this Makefile:
+# make -f posix-inproc.mak  # make and run the tests in test_inproc.cpp
+# make -f posix-inproc.mak TESTS="Peek*"  # make and run the selected tests
+# make -f posix-inproc.mak QUTEST_JOBS=1  # run the tests in one process
+# make -f posix-inproc.mak norun   # only make but not run the tests
+# make -f posix-inproc.mak clean   # cleanup the build
+#
+# NOTE: the QP/C++ library must be built with the in-process harness:
+# make -C $(QPCPP)/ports/posix-qutest HARNESS=inproc
+#
+
+#-----------------------------------------------------------------------------
+# project name
+#
+PROJECT := test_qutest
+
+#-----------------------------------------------------------------------------
+# project directories
+#
+
+# location of the QP/C++ framework (if not provided in an environemnt var.)
+ifeq ($(QPCPP),)
+QPCPP := ../../..
+endif
+
+
+# QP port used in this project
+QP_PORT_DIR := $(QPCPP)/ports/posix-qutest
+
+# list of all source directories used by this project
+VPATH = \
+	. \
+	..
+
+# list of all include directories needed by this project
+INCLUDES  = \
+	-I. \
+	-I.. \
+	-I$(QPCPP)/include
+
+#-----------------------------------------------------------------------------
+# files
+#
+
+# C source files...
+C_SRCS :=
+
+# C++ source files...
+CPP_SRCS := \
+	test_qutest.cpp \
+	test_inproc.cpp
+
+LIB_DIRS  :=
+LIBS      :=
+
+# defines...
+# QP_API_VERSION controls the QP API compatibility; 9999 means the latest API
+DEFINES   :=
+
+#-----------------------------------------------------------------------------
+# GNU toolset
+#
+CC    := gcc
+CPP   := g++
+#LINK  := gcc    # for C programs
+LINK  := g++   # for C++ programs
+
+# basic utilities
+
+MKDIR  := mkdir -p
+RM     := rm -f
+
+
+#============================================================================
+# Typically you should not need to change anything below this line
+
+#-----------------------------------------------------------------------------
+# build options
+#
+
+BIN_DIR := posix-inproc
+
+CFLAGS = -g -O -Wall -Wstrict-prototypes -W $(INCLUDES) $(DEFINES) \
+	-DQ_SPY -DQ_UTEST -DQ_HOST
+
+CPPFLAGS = -g -O -Wall -W -fno-rtti -fno-exceptions $(INCLUDES) $(DEFINES) \
+	-DQ_SPY -DQ_UTEST -DQ_HOST
+
+LINKFLAGS := -Wl,-Map,$(BIN_DIR)/$(PROJECT).map,--cref,--gc-sections
+
+#-----------------------------------------------------------------------------
+# combine all the soruces...
+INCLUDES  += -I$(QP_PORT_DIR)
+LIB_DIRS  += -L$(QP_PORT_DIR)/$(BIN_DIR)
+LIBS      += -lqp -lpthread
+
+C_OBJS       := $(patsubst %.c,%.o,   $(C_SRCS))
+CPP_OBJS     := $(patsubst %.cpp,%.o, $(CPP_SRCS))
+
+TARGET_EXE   := $(BIN_DIR)/$(PROJECT)
+C_OBJS_EXT   := $(addprefix $(BIN_DIR)/, $(C_OBJS))
+C_DEPS_EXT   := $(patsubst %.o,%.d, $(C_OBJS_EXT))
+CPP_OBJS_EXT := $(addprefix $(BIN_DIR)/, $(CPP_OBJS))
+CPP_DEPS_EXT := $(patsubst %.o,%.d, $(CPP_OBJS_EXT))
+
+# create $(BIN_DIR) if it does not exist
+ifeq ("$(wildcard $(BIN_DIR))","")
+$(shell $(MKDIR) $(BIN_DIR))
+endif
+
+#-----------------------------------------------------------------------------
+# rules
+#
+
+.PHONY : run norun
+
+ifeq ($(MAKECMDGOALS),norun)
+all : $(TARGET_EXE)
+norun : all
+else
+all : $(TARGET_EXE) run
+endif
+
+$(TARGET_EXE) : $(C_OBJS_EXT) $(CPP_OBJS_EXT)
+	$(CPP) $(CPPFLAGS) -c $(QPCPP)/include/qstamp.cpp -o $(BIN_DIR)/qstamp.o
+	$(LINK) $(LINKFLAGS) $(LIB_DIRS) -o $@ $^ $(BIN_DIR)/qstamp.o $(LIBS)
+
+run : $(TARGET_EXE)
+	$(TARGET_EXE) $(TESTS)
+
+$(BIN_DIR)/%.d : %.cpp
+	$(CPP) -MM -MT $(@:.d=.o) $(CPPFLAGS) $< > $@
+
+$(BIN_DIR)/%.d : %.c
+	$(CC) -MM -MT $(@:.d=.o) $(CFLAGS) $< > $@
+
+$(BIN_DIR)/%.o : %.cpp
+	$(CPP) $(CPPFLAGS) -c $< -o $@
+
+$(BIN_DIR)/%.o : %.c
+	$(CC) $(CFLAGS) -c $< -o $@
+
+.PHONY : clean show norun
+
+# include dependency files only if our goal depends on their existence
+ifneq ($(MAKECMDGOALS),clean)
+  ifneq ($(MAKECMDGOALS),show)
+-include $(C_DEPS_EXT) $(CPP_DEPS_EXT)
+  endif
+endif
+
+clean :
+	-$(RM) $(BIN_DIR)/*.o \
+	$(BIN_DIR)/*.d \
+	$(BIN_DIR)/*.map \
+	$(TARGET_EXE)
+
+show :
+	@echo PROJECT      = $(PROJECT)
+	@echo TESTS        = $(TESTS)
+	@echo TARGET_EXE   = $(TARGET_EXE)
+	@echo CONF         = $(CONF)
+	@echo VPATH        = $(VPATH)
+	@echo C_SRCS       = $(C_SRCS)
+	@echo CPP_SRCS     = $(CPP_SRCS)
+	@echo C_OBJS_EXT   = $(C_OBJS_EXT)
+	@echo C_DEPS_EXT   = $(C_DEPS_EXT)
+	@echo CPP_DEPS_EXT = $(CPP_DEPS_EXT)
+	@echo CPP_OBJS_EXT = $(CPP_OBJS_EXT)
+	@echo LIB_DIRS     = $(LIB_DIRS)
+	@echo LIBS         = $(LIBS)
+	@echo DEFINES      = $(DEFINES)
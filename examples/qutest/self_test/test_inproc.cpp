@@ -0,0 +1,214 @@
+/// @file
+/// @brief In-process QUTEST self-test (the tests of the *.tcl scripts)
+/// @ingroup qs
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+
+#include "qpcpp.h"         // for QUTEST
+#include "qutest_inproc.h" // in-process QUTest harness
+
+using namespace QP;
+
+//----------------------------------------------------------------------------
+// preamble...
+static void on_setup(void) {
+    QUTest::expect("ON_TEST_SETUP");
+}
+static void on_teardown(void) {
+    QUTest::expect("ON_TEST_TEARDOWN");
+}
+static QUTest::Preamble const l_onSetup(QUTest::ON_SETUP, &on_setup);
+static QUTest::Preamble const l_onTeardown(QUTest::ON_TEARDOWN,
+                                           &on_teardown);
+
+//----------------------------------------------------------------------------
+// test_command.tcl
+static void test_command(void) {
+    QUTest::command("COMMAND_X", 1U, 2U, 3U);
+    QUTest::expect("COMMAND_X 0");
+    QUTest::expect("Trg-Done QS_RX_COMMAND");
+}
+static QUTest::Test const l_command("Command", &test_command);
+
+//----------------------------------------------------------------------------
+// test_peek-poke.tcl
+static void test_peek_poke_u8(void) {
+    static uint8_t const data[] = { 0xB1U, 0xC1U, 0xD1U, 0xE1U };
+    QUTest::currObj(QS::AP_OBJ, "buffer");
+    QUTest::fill(0U, 1U, 100U, 0x1AU);
+    QUTest::peek(0U, 1U, 5U);
+    QUTest::expect("Trg-Peek Offs=0,Size=1,Num=5,Data=<1A,1A,1A,1A,1A>");
+    QUTest::peek(95U, 1U, 5U);
+    QUTest::expect("Trg-Peek Offs=95,Size=1,Num=5,Data=<1A,1A,1A,1A,1A>");
+    QUTest::fill(2U, 1U, 95U, 0x1BU);
+    QUTest::peek(0U, 1U, 5U);
+    QUTest::expect("Trg-Peek Offs=0,Size=1,Num=5,Data=<1A,1A,1B,1B,1B>");
+    QUTest::peek(95U, 1U, 5U);
+    QUTest::expect("Trg-Peek Offs=95,Size=1,Num=5,Data=<1B,1B,1A,1A,1A>");
+    QUTest::fill(0U, 1U, 100U, 0xA1U);
+    QUTest::poke(2U, 1U, data, 4U);
+    QUTest::peek(0U, 1U, 7U);
+    QUTest::expect(
+        "Trg-Peek Offs=0,Size=1,Num=7,Data=<A1,A1,B1,C1,D1,E1,A1>");
+}
+static QUTest::Test const l_peekPokeU8("Peek/Poke/Fill uint8_t",
+                                       &test_peek_poke_u8);
+
+static void test_peek_poke_u16(void) {
+    static uint16_t const data[] = { 0xB2C2U, 0xD2E2U };
+    QUTest::fill(0U, 2U, 50U, 0x2A2BU);
+    QUTest::peek(0U, 2U, 3U);
+    QUTest::expect("Trg-Peek Offs=0,Size=2,Num=3,Data=<2A2B,2A2B,2A2B>");
+    QUTest::peek(94U, 2U, 3U);
+    QUTest::expect("Trg-Peek Offs=94,Size=2,Num=3,Data=<2A2B,2A2B,2A2B>");
+    QUTest::fill(2U, 2U, 48U, 0x2C2DU);
+    QUTest::peek(0U, 2U, 3U);
+    QUTest::expect("Trg-Peek Offs=0,Size=2,Num=3,Data=<2A2B,2C2D,2C2D>");
+    QUTest::peek(94U, 2U, 3U);
+    QUTest::expect("Trg-Peek Offs=94,Size=2,Num=3,Data=<2C2D,2C2D,2A2B>");
+    QUTest::fill(0U, 2U, 50U, 0xA2B2U);
+    QUTest::poke(2U, 2U, data, 2U);
+    QUTest::peek(0U, 2U, 4U);
+    QUTest::expect(
+        "Trg-Peek Offs=0,Size=2,Num=4,Data=<A2B2,B2C2,D2E2,A2B2>");
+}
+static QUTest::Test const l_peekPokeU16("Peek/Poke/Fill uint16_t",
+                                        &test_peek_poke_u16, true);
+
+static void test_peek_poke_u32(void) {
+    static uint32_t const data[] = { 0xB4C4D4E4U, 0xB5C5D5E5U };
+    QUTest::fill(0U, 4U, 25U, 0x4A4B4C4DU);
+    QUTest::peek(0U, 4U, 3U);
+    QUTest::expect("Trg-Peek Offs=0,Size=4,Num=3,"
+                   "Data=<4A4B4C4D,4A4B4C4D,4A4B4C4D>");
+    QUTest::peek(88U, 4U, 3U);
+    QUTest::expect("Trg-Peek Offs=88,Size=4,Num=3,"
+                   "Data=<4A4B4C4D,4A4B4C4D,4A4B4C4D>");
+    QUTest::fill(4U, 4U, 23U, 0x4C4D4E4FU);
+    QUTest::peek(0U, 4U, 3U);
+    QUTest::expect("Trg-Peek Offs=0,Size=4,Num=3,"
+                   "Data=<4A4B4C4D,4C4D4E4F,4C4D4E4F>");
+    QUTest::peek(88U, 4U, 3U);
+    QUTest::expect("Trg-Peek Offs=88,Size=4,Num=3,"
+                   "Data=<4C4D4E4F,4C4D4E4F,4A4B4C4D>");
+    QUTest::fill(0U, 4U, 25U, 0xA4B4C4D4U);
+    QUTest::poke(4U, 4U, data, 2U);
+    QUTest::peek(0U, 4U, 4U);
+    QUTest::expect("Trg-Peek Offs=0,Size=4,Num=4,"
+                   "Data=<A4B4C4D4,B4C4D4E4,B5C5D5E5,A4B4C4D4>");
+}
+static QUTest::Test const l_peekPokeU32("Peek/Poke/Fill uint32_t",
+                                        &test_peek_poke_u32, true);
+
+//----------------------------------------------------------------------------
+// test_probe.tcl
+static void test_single_probe(void) {
+    QUTest::command("COMMAND_X");
+    QUTest::expect("COMMAND_X 0");
+    QUTest::expect("Trg-Done QS_RX_COMMAND");
+    QUTest::probe("myFun", 1U);
+    QUTest::command("COMMAND_X");
+    QUTest::expect("TstProbe Fun=myFun,Data=1");
+    QUTest::expect("COMMAND_X 1");
+    QUTest::expect("Trg-Done QS_RX_COMMAND");
+    QUTest::command("COMMAND_X");
+    QUTest::expect("COMMAND_X 0");
+    QUTest::expect("Trg-Done QS_RX_COMMAND");
+}
+static QUTest::Test const l_singleProbe("Single Test Probe",
+                                        &test_single_probe);
+
+static void test_multiple_probes(void) {
+    QUTest::probe("myFun", 100022U);
+    QUTest::probe("myFun", 200033U);
+    QUTest::command("COMMAND_X");
+    QUTest::expect("TstProbe Fun=myFun,Data=100022");
+    QUTest::expect("COMMAND_X 100022");
+    QUTest::expect("Trg-Done QS_RX_COMMAND");
+    QUTest::command("COMMAND_X");
+    QUTest::expect("TstProbe Fun=myFun,Data=200033");
+    QUTest::expect("COMMAND_X 200033");
+    QUTest::expect("Trg-Done QS_RX_COMMAND");
+    QUTest::command("COMMAND_X");
+    QUTest::expect("COMMAND_X 0");
+    QUTest::expect("Trg-Done QS_RX_COMMAND");
+}
+static QUTest::Test const l_multipleProbes("Multiple Test Probes",
+                                           &test_multiple_probes, true);
+
+//----------------------------------------------------------------------------
+// batched event injection (QS_RX_EVENTS)
+static void test_events_publish(void) {
+    static QUTest::BatchEvt const batch[] = {
+        { 0U, 0U, Q_USER_SIG,     static_cast<void *>(0), 0U },
+        { 0U, 2U, Q_USER_SIG + 1, static_cast<void *>(0), 0U }
+    };
+    QUTest::events(batch, static_cast<uint_fast8_t>(Q_DIM(batch)));
+    QUTest::expect("QF-New   Sig=4,Size=4");
+    QUTest::expect("MP-Get   Obj=*,Free=9,Min=9");
+    QUTest::expect("QF-Pub   Sdr=QS_RX,Evt<Sig=4,Pool=1,Ref=0>");
+    QUTest::expect("QF-gc    Evt<Sig=4,Pool=1,Ref=1>");
+    QUTest::expect("MP-Put   Obj=*,Free=10");
+    QUTest::expect("QF-New   Sig=5,Size=4");
+    QUTest::expect("MP-Get   Obj=*,Free=9,Min=9");
+    QUTest::expect("QF-Pub   Sdr=QS_RX,Evt<Sig=5,Pool=1,Ref=0>");
+    QUTest::expect("QF-gc    Evt<Sig=5,Pool=1,Ref=1>");
+    QUTest::expect("MP-Put   Obj=*,Free=10");
+    QUTest::expect("Trg-Done QS_RX_EVENTS");
+}
+static QUTest::Test const l_eventsPublish("Batched events published",
+                                          &test_events_publish);
+
+static void test_events_no_ao(void) {
+    // QF_MAX_ACTIVE is a valid priority, but no AO runs at it
+    static QUTest::BatchEvt const batch[] = {
+        { 0U, 0U, Q_USER_SIG, static_cast<void *>(0), 0U },
+        { static_cast<uint8_t>(QF_MAX_ACTIVE), 1U, Q_USER_SIG + 1,
+          static_cast<void *>(0), 0U }
+    };
+    QUTest::events(batch, static_cast<uint_fast8_t>(Q_DIM(batch)));
+    QUTest::expect("QF-New   Sig=4,Size=4");
+    QUTest::expect("MP-Get   Obj=*,Free=9,Min=9");
+    QUTest::expect("QF-Pub   Sdr=QS_RX,Evt<Sig=4,Pool=1,Ref=0>");
+    QUTest::expect("QF-gc    Evt<Sig=4,Pool=1,Ref=1>");
+    QUTest::expect("MP-Put   Obj=*,Free=10");
+    QUTest::expect("QF-New   Sig=5,Size=4");
+    QUTest::expect("MP-Get   Obj=*,Free=9,Min=9");
+    QUTest::expect("QF-gc    Evt<Sig=5,Pool=1,Ref=0>");
+    QUTest::expect("MP-Put   Obj=*,Free=10");
+    QUTest::expect("Trg-ERR QS_RX_EVENTS");
+}
+static QUTest::Test const l_eventsNoAo("Batched events without the AO",
+                                       &test_events_no_ao, true);
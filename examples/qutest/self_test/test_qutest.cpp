@@ -54,11 +54,21 @@ enum {
     MY_RECORD,
 };
 
+enum {
+    MAX_PUB_SIG = Q_USER_SIG + 4 // the signals of the injected events
+};
+
 //----------------------------------------------------------------------------
 int main(int argc, char *argv[]) {
     QF::init();  // initialize the framework and the underlying RT kernel
     Q_ALLEGE(QS_INIT(argc <= 1 ? (void *)0 : argv[1]));
 
+    // publish-subscribe and the event pool for the injected events
+    static QSubscrList subscrSto[MAX_PUB_SIG];
+    QF::psInit(subscrSto, Q_DIM(subscrSto));
+    static QF_MPOOL_EL(QEvt) smlPoolSto[10];
+    QF::poolInit(smlPoolSto, sizeof(smlPoolSto), sizeof(smlPoolSto[0]));
+
     // global filter
     QS_FILTER_ON(QS_ALL_RECORDS); // enable all maskable filters
 
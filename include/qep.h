@@ -284,6 +284,103 @@ QState const Q_RET_TRAN_HIST = static_cast<QState>(11);
 QState const Q_RET_TRAN_XP   = static_cast<QState>(12);
 
 
+#ifdef QEP_PROFILE
+
+#ifndef QEP_PROF_TIME
+    #error "QEP_PROF_TIME() must be defined in qep_port.h for QEP_PROFILE"
+#endif
+
+#ifndef QEP_PROF_TIME_SIZE
+    //! The size (in bytes) of the QEP profiling timestamp. Valid values:
+    //! 4 or 8; default 4
+    #define QEP_PROF_TIME_SIZE 4
+#endif
+
+#if (QEP_PROF_TIME_SIZE == 4)
+    //! type of the QEP profiling timestamps and accumulated durations,
+    //! which are provided by the port-specific macro QEP_PROF_TIME()
+    typedef uint32_t QEPProfTime;
+#elif (QEP_PROF_TIME_SIZE == 8)
+    typedef uint64_t QEPProfTime;
+#else
+    #error "QEP_PROF_TIME_SIZE defined incorrectly, expected 4 or 8"
+#endif
+
+//! generic function pointer used as the key of the QEP profile entries
+typedef void (*QEPProfFun)(void);
+
+//! kinds of the QEP profile entries
+enum QEPProfKind {
+    QEP_PROF_EVT,   //!< state handler processing an event (incl. guards)
+    QEP_PROF_ENTRY, //!< entry action of a state
+    QEP_PROF_EXIT,  //!< exit action of a state
+    QEP_PROF_INIT,  //!< initial transition (also the top-most one)
+    QEP_PROF_ACT,   //!< transition action (QMsm only)
+    QEP_PROF_TRAN   //!< whole transition (exit, actions, entry) from source
+};
+
+//****************************************************************************
+//! Per-state-machine execution profile
+/// @description
+/// QP::QSmProfile accumulates the number of calls and the execution time
+/// (measured by the port-specific macro QEP_PROF_TIME()) of the state
+/// handlers and actions invoked by QP::QHsm::init(), QP::QHsm::dispatch(),
+/// QP::QMsm::init() and QP::QMsm::dispatch(). The entries are kept in an application-supplied
+/// array organized as an open-addressed hash table keyed by the function
+/// and the kind of the measurement (see QP::QEPProfKind).
+///
+/// @note
+/// The QEP_PROF_TRAN entries are attributed to the transition source and
+/// include the time of the exit, entry and initial actions, which are also
+/// accounted separately.
+///
+class QSmProfile {
+public:
+    //! single entry of the profile
+    struct Entry {
+        QEPProfFun  fun;   //!< the state handler or action handler
+        QEPProfTime total; //!< accumulated execution time
+        QEPProfTime max;   //!< maximum execution time of a single call
+        uint32_t    calls; //!< number of calls
+        uint8_t     kind;  //!< kind of the entry (QP::QEPProfKind)
+    };
+
+    //! initialize the profile with the storage for @p len entries
+    void init(Entry * const sto, uint_fast16_t const len);
+
+    //! clear all entries of the profile
+    void reset(void);
+
+    //! record a single measurement (used inside QEP)
+    void record(QEPProfFun const fun, uint_fast8_t const kind,
+                QEPProfTime const dt);
+
+    //! report all non-empty entries as user QS records @p rec
+    void report(void const * const sm, enum_t const rec) const;
+
+    //! access the entries (by index 0..getLen()-1, some might be empty)
+    Entry const *getEntry(uint_fast16_t const i) const {
+        return &m_sto[i];
+    }
+
+    //! the number of entries in the profile storage
+    uint_fast16_t getLen(void) const {
+        return m_mask + static_cast<uint_fast16_t>(1);
+    }
+
+    //! number of measurements lost because the storage was full
+    uint32_t getLost(void) const {
+        return m_lost;
+    }
+
+private:
+    Entry *m_sto;          //!< storage for the entries (hash table)
+    uint_fast16_t m_mask;  //!< mask of the storage index (length - 1)
+    uint32_t m_lost;       //!< number of measurements lost
+};
+
+#endif // QEP_PROFILE
+
 //****************************************************************************
 //! Hierarchical State Machine base class
 ///
@@ -310,6 +407,10 @@ class QHsm {
     QHsmAttr m_state;  //!< current active state (state-variable)
     QHsmAttr m_temp;   //!< temporary: transition chain, target state, etc.
 
+#ifdef QEP_PROFILE
+    QSmProfile *m_prof; //!< execution profile (NULL if not profiled)
+#endif
+
 public:
     //! virtual destructor
     virtual ~QHsm();
@@ -340,6 +441,18 @@ public:
     //! @note used in the QM code generation
     QStateHandler childState(QStateHandler const parent);
 
+#ifdef QEP_PROFILE
+    //! Attach the execution profile to this state machine (NULL to detach)
+    void setProfile(QSmProfile * const prof) {
+        m_prof = prof;
+    }
+
+    //! Obtain the execution profile attached to this state machine
+    QSmProfile *getProfile(void) const {
+        return m_prof;
+    }
+#endif
+
 protected:
     //! Protected constructor of QHsm.
     QHsm(QStateHandler const initial);
@@ -467,6 +580,18 @@ private:
     //! internal helper function to take a transition
     int_fast8_t hsm_tran(QStateHandler (&path)[MAX_NEST_DEPTH_]);
 
+#ifdef QEP_PROFILE
+    //! internal helper function to call a state handler with profiling
+    QState profTrig_(QStateHandler const s, QEvt const * const e,
+                     uint_fast8_t const kind);
+
+    //! internal helper function to call an action handler with profiling
+    QState profAct_(QActionHandler const act, uint_fast8_t const kind);
+
+    //! internal helper function to record the duration of a transition
+    void profTran_(QStateHandler const s, QEPProfTime const start);
+#endif
+
     friend class QMsm;
     friend class QActive;
     friend class QMActive;
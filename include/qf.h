@@ -112,6 +112,173 @@ namespace QP {
 
 class QEQueue; // forward declaration
 
+#ifdef QF_SIG_FILTER_SIZE
+
+#if ((QF_SIG_FILTER_SIZE % 8) != 0)
+    #error "QF_SIG_FILTER_SIZE defined incorrectly, expected multiple of 8"
+#endif
+
+//****************************************************************************
+//! Set of signals ignored by an active object in a given state
+/// @description
+/// QP::QSigMask is a bitmask covering the signals 0..#QF_SIG_FILTER_SIZE-1.
+/// A state that ignores (silently discards) some signals can provide a
+/// constant QSigMask and install it with QP::QActive::setIgnoredSigs() in
+/// its entry action. QF then discards such events already at the time of
+/// posting, so they don't occupy queue slots, pool blocks, or dispatch time.
+/// Signals outside the mask range are never discarded.
+///
+/// @note
+/// The mask must contain only signals that the state (including all its
+/// superstates) really ignores. Otherwise the application behavior changes.
+///
+class QSigMask {
+public:
+    //! the bits of the mask, bit n set means that signal n is ignored
+    uint8_t m_bits[QF_SIG_FILTER_SIZE / 8];
+
+    //! clear the whole mask (no signals ignored)
+    void clear(void) {
+        uint_fast8_t i;
+        for (i = static_cast<uint_fast8_t>(sizeof(m_bits)); i > 0U; --i) {
+            m_bits[i - 1U] = static_cast<uint8_t>(0);
+        }
+    }
+
+    //! mark the signal @p sig as ignored
+    void insert(enum_t const sig) {
+        if (static_cast<uint_fast16_t>(sig)
+            < static_cast<uint_fast16_t>(QF_SIG_FILTER_SIZE))
+        {
+            m_bits[static_cast<uint_fast16_t>(sig) >> 3] |=
+                static_cast<uint8_t>(1U << (static_cast<uint_fast8_t>(sig)
+                                            & static_cast<uint_fast8_t>(7)));
+        }
+    }
+
+    //! remove the signal @p sig from the ignored signals
+    void remove(enum_t const sig) {
+        if (static_cast<uint_fast16_t>(sig)
+            < static_cast<uint_fast16_t>(QF_SIG_FILTER_SIZE))
+        {
+            m_bits[static_cast<uint_fast16_t>(sig) >> 3] &=
+                static_cast<uint8_t>(~(1U << (static_cast<uint_fast8_t>(sig)
+                                            & static_cast<uint_fast8_t>(7))));
+        }
+    }
+
+    //! test whether the signal @p sig is ignored
+    bool hasSig(QSignal const sig) const {
+        return (static_cast<uint_fast16_t>(sig)
+                < static_cast<uint_fast16_t>(QF_SIG_FILTER_SIZE))
+               && ((m_bits[static_cast<uint_fast16_t>(sig) >> 3]
+                    & static_cast<uint8_t>(1U << (static_cast<uint_fast8_t>(sig)
+                                         & static_cast<uint_fast8_t>(7))))
+                   != static_cast<uint8_t>(0));
+    }
+};
+
+//! Internal macro to mark the end of the RTC step of the active object
+//! @p a_, after which its state is stable (used in the QF ports and kernels
+//! that do not block in QP::QActive::get_(), such as QV, QK and QXK)
+#define QF_SIG_FILTER_IDLE_(a_) ((a_)->m_isIdle = true)
+
+#else
+
+#define QF_SIG_FILTER_IDLE_(a_) ((void)0)
+
+#endif // QF_SIG_FILTER_SIZE
+
+#ifdef QF_LATENCY
+
+#ifndef QF_LATENCY_TIME_
+    #error "QF_LATENCY requires QF_LATENCY_TIME_() in the QF port"
+#endif
+
+#ifndef QF_LATENCY_QLEN
+    //! The maximum length of the event queue of an active object with
+    //! the latency measurement (checked in QP::QActive::start())
+    #define QF_LATENCY_QLEN     64U
+#endif
+
+#ifndef QF_LATENCY_SUB_BITS
+    //! The number of bits of the sub-buckets of every power of two in the
+    //! latency histograms (the resolution is 2^-QF_LATENCY_SUB_BITS)
+    #define QF_LATENCY_SUB_BITS 3U
+#endif
+
+//! The number of buckets in a latency histogram (QP::QLatencyHist)
+#define QF_LATENCY_BINS \
+    ((33U - QF_LATENCY_SUB_BITS) << QF_LATENCY_SUB_BITS)
+
+//! The time stamps of the latency measurement (in the units of the port's
+//! QF_LATENCY_TIME_(), e.g., nanoseconds)
+typedef uint32_t QFLatencyTime;
+
+//****************************************************************************
+//! Log-linear histogram of latencies
+/// @description
+/// The values below 2^#QF_LATENCY_SUB_BITS are counted exactly. Above that,
+/// every power of two is split into 2^#QF_LATENCY_SUB_BITS buckets of equal
+/// width, so the relative error of the reported percentiles is bounded
+/// (12.5% for the default 3 bits), while the histogram covers the whole
+/// 32-bit range in a fixed number of buckets (#QF_LATENCY_BINS).
+///
+/// @sa QP::QActive::getWaitHist(), QP::QActive::getDispatchHist()
+///
+class QLatencyHist {
+private:
+    //! the counters of the buckets
+    uint32_t m_bins[QF_LATENCY_BINS];
+
+    //! the number of recorded values
+    uint32_t m_count;
+
+    //! the maximum recorded value
+    QFLatencyTime m_max;
+
+public:
+    //! clear the histogram
+    void reset(void);
+
+    //! add the value @p t to the histogram
+    void record(QFLatencyTime const t);
+
+    //! the number of recorded values
+    uint32_t getCount(void) const {
+        return m_count;
+    }
+
+    //! the maximum recorded value
+    QFLatencyTime getMax(void) const {
+        return m_max;
+    }
+
+    //! the value, which @p pm per mille of the recorded values don't exceed
+    QFLatencyTime getPerMille(uint_fast16_t const pm) const;
+
+    //! the counter of the bucket @p i (0..#QF_LATENCY_BINS-1)
+    uint32_t getBin(uint_fast16_t const i) const {
+        return m_bins[i];
+    }
+
+    //! the highest value counted in the bucket @p i
+    static QFLatencyTime binMax(uint_fast16_t const i);
+
+    //! the bucket, which counts the value @p t
+    static uint_fast16_t binOf(QFLatencyTime const t);
+};
+
+//! Internal macro to record the end of the RTC step of the active object
+//! @p a_ (used in the QF ports and kernels after dispatching an event)
+#define QF_LATENCY_DISPATCHED_(a_) ((a_)->dispatched_())
+
+#else
+
+#define QF_LATENCY_DISPATCHED_(a_) ((void)0)
+
+#endif // QF_LATENCY
+
 //****************************************************************************
 //! QActive active object (based on QP::QHsm implementation)
 /// @description
@@ -181,6 +348,34 @@ public: // for access from extern "C" functions
     uint8_t m_startPrio;
 #endif
 
+#ifdef QF_SIG_FILTER_SIZE
+    //! signals ignored in the current state (NULL if none)
+    QSigMask const *m_ignoredSigs;
+
+    //! number of events discarded at posting because they were ignored
+    uint32_t m_ignoredCtr;
+
+    //! true when the AO waits for events (its state is stable)
+    bool m_isIdle;
+#endif
+
+#ifdef QF_LATENCY
+    //! histogram of the times that the events wait in the queue
+    QLatencyHist m_waitHist;
+
+    //! histogram of the durations of the RTC steps
+    QLatencyHist m_dispHist;
+
+    //! the time when the event at the front of the queue was posted
+    QFLatencyTime m_latFront;
+
+    //! the time when the current RTC step started
+    QFLatencyTime m_latStart;
+
+    //! the times when the events in the ring buffer were posted
+    /// @note the indices mirror the ring buffer of the event queue
+    QFLatencyTime m_latRing[QF_LATENCY_QLEN];
+#endif
 
 protected:
     //! protected constructor (abstract class)
@@ -263,6 +458,34 @@ public:
     //! Get an event from the event queue of an active object.
     QEvt const *get_(void);
 
+#ifdef QF_SIG_FILTER_SIZE
+    //! Install the mask of signals ignored in the current state.
+    void setIgnoredSigs(QSigMask const * const mask);
+
+    //! Get the number of events discarded because they were ignored.
+    uint32_t getIgnoredCtr(void) const {
+        return m_ignoredCtr;
+    }
+#endif
+
+#ifdef QF_LATENCY
+    //! Get the histogram of the times that the events waited in the queue
+    QLatencyHist const &getWaitHist(void) const {
+        return m_waitHist;
+    }
+
+    //! Get the histogram of the durations of the RTC steps
+    QLatencyHist const &getDispatchHist(void) const {
+        return m_dispHist;
+    }
+
+    //! Clear both latency histograms of the active object
+    void resetLatency(void);
+
+    //! Record the end of the RTC step (used in the QF ports and kernels)
+    void dispatched_(void);
+#endif
+
     friend class QF;
     friend class QTimeEvt;
     friend class QTicker;
@@ -541,6 +764,15 @@ public:
     //! any time event is active.
     static bool noTimeEvtsActiveX(uint_fast8_t const tickRate);
 
+    //! Returns the number of clock ticks until the earliest expiration of
+    //! a time event at the given tick rate (0 if no time event is armed).
+    static QTimeEvtCtr ticksToNextX(uint_fast8_t const tickRate);
+
+    //! Advances all time events at the given tick rate by @p nTicks
+    //! clock ticks, none of which may expire a time event.
+    static void skipTicksX(uint_fast8_t const tickRate,
+                           QTimeEvtCtr const nTicks);
+
 
     //! This function returns the minimum of free entries of the given
     //! event pool.
@@ -576,6 +808,12 @@ public:
     //! Clear a specified region of memory to zero.
     static void bzero(void * const start, uint_fast16_t len);
 
+#ifdef QF_LATENCY
+    //! Produce the QS records with the latency percentiles of all
+    //! active objects
+    static void latencyReport(enum_t const rec);
+#endif
+
 // to be used in QF ports only...
 private:
 
@@ -104,7 +104,7 @@ enum QSpyRecords {
     QS_QF_MPOOL_GET,      //!< a memory block was removed from memory pool
     QS_QF_MPOOL_PUT,      //!< a memory block was returned to memory pool
     QS_QF_PUBLISH,        //!< an event was published
-    QS_QF_RESERVED8,
+    QS_QF_ACTIVE_POST_IGNORED, //!< an ignored event was discarded at post
     QS_QF_NEW,            //!< new event creation
     QS_QF_GC_ATTEMPT,     //!< garbage collection attempt
     QS_QF_GC,             //!< garbage collection
@@ -150,12 +150,19 @@ enum QSpyRecords {
     QS_TARGET_INFO,       //!< reports the Target information
     QS_TARGET_DONE,       //!< reports completion of a user callback
     QS_RX_STATUS,         //!< reports QS data receive status
-    QS_MSC_RESERVED1,
+    QS_SAMPLE_CFG,        //!< QS record sampling was configured
     QS_PEEK_DATA,         //!< reports the data from the PEEK query
     QS_ASSERT_FAIL,       //!< assertion failed in the code
 
     // [70] Application-specific (User) QS records
-    QS_USER               //!< the first record available to QS users
+    QS_USER,              //!< the first record available to QS users
+
+    // [123] trace trigger fired (not maskable, so the QS_USER records
+    // available to the application are 70..122)
+    QS_TRG_FIRED = QS_USER + 53, //!< marks the fired trace trigger
+
+    // [124] QS data loss report (not maskable, the last User record)
+    QS_OVERRUN = QS_USER + 54 //!< reports the QS data lost since last report
 };
 
 //! QS record groups for QS_FILTER_ON() and QS_FILTER_OFF()
@@ -192,8 +199,8 @@ enum QSpyUserRecords {
     #define QS_TIME_()   (QP::QS::u16_(QP::QS::onGetTime()))
 #elif (QS_TIME_SIZE == 4)
 
-    //! The size (in bytes) of the QS time stamp. Valid values: 1, 2, or 4;
-    //! default 4.
+    //! The size (in bytes) of the QS time stamp. Valid values: 1, 2, 4,
+    //! or 8; default 4.
     ///
     /// @description
     /// This macro can be defined in the QS port file (qs_port.h) to
@@ -203,13 +210,195 @@ enum QSpyUserRecords {
 
     //! Internal macro to output time stamp to a QS record
     #define QS_TIME_()   (QP::QS::u32_(QP::QS::onGetTime()))
+#elif (QS_TIME_SIZE == 8)
+    typedef uint64_t QSTimeCtr;
+    #define QS_TIME_()   (QP::QS::u64_(QP::QS::onGetTime()))
 #else
-    #error "QS_TIME_SIZE defined incorrectly, expected 1, 2, or 4"
+    #error "QS_TIME_SIZE defined incorrectly, expected 1, 2, 4, or 8"
+#endif
+
+// Compact QS encoding (define QS_COMPACT in the QS port to enable).
+// The object and function pointers in the QS records (#QS_OBJ_, #QS_FUN_)
+// are replaced by small IDs, which are assigned ("interned") when the
+// object or function dictionary is produced. The time stamps (#QS_TIME_)
+// are LEB128 varints of the difference from the previous time stamp, with
+// an absolute time stamp every #QS_TIME_SYNC time stamps, so that the host
+// can resynchronize after lost records. The Target info record reports the
+// compact encoding in the bit 7 of the time-stamp size. Every pointer and
+// time stamp is encoded as an unsigned LEB128 varint v:
+// - pointer: v == 0 is NULL, even v is the interned ID (v >> 1), and
+//   v == 1 is followed by the full (#QS_OBJ_PTR_SIZE or #QS_FUN_PTR_SIZE)
+//   pointer that has not been interned. The dictionary records contain the
+//   ID (0 when the table is full) followed by the full pointer.
+// - time stamp: even v is the delta (v >> 1) from the previous time stamp,
+//   and odd v is the absolute time stamp (v >> 1).
+// The IDs are defined only by the dictionary records, so a host attached
+// to a running Target (or after lost dictionary records) cannot resolve
+// them. QP::QS::internAll() re-sends all the ID mappings as the dictionary
+// records with an empty name, which the host uses only to map the IDs.
+// QS-RX calls it after the Target info requested by the host, and the
+// application can call it also periodically.
+#ifdef QS_COMPACT
+
+    #ifdef QS_THREAD_RINGS
+        #error "QS_COMPACT cannot be combined with QS_THREAD_RINGS"
+    #endif
+
+    #ifndef QS_INTERN_SIZE
+        //! The size of the table of interned object and function pointers
+        //! (power of 2, at most 0x8000), see #QS_COMPACT
+        #define QS_INTERN_SIZE 256U
+    #endif
+
+    #ifndef QS_TIME_SYNC
+        //! The number of time stamps between the absolute time stamps,
+        //! see #QS_COMPACT
+        #define QS_TIME_SYNC   64U
+    #endif
+
+    #undef QS_TIME_
+    //! Internal macro to output the compact time stamp (delta from the
+    //! previous time stamp) to a QS record
+    #define QS_TIME_()   (QP::QS::time_(QP::QS::onGetTime()))
+
+#endif // QS_COMPACT
+
+// Statistical sampling of QS records (define QS_SAMPLING in the QS port
+// to enable). QP::QS::sample() configures a record type, optionally
+// narrowed to one signal, to produce only 1 in n records or at most one
+// record per time interval (in QP::QS::onGetTime() units). The decision
+// is taken at the QS_BEGIN gate (#QS_SMPL_BEGIN_), inside the critical
+// section, after the global and local filters passed. Every record of a
+// sampled type carries a uint16_t count of the records skipped before it
+// right after the record ID, so the host can scale the counts back. The
+// QP::QS_SAMPLE_CFG record announces each (re)configuration:
+// rec (u8), sig (signal), n (u16), and interval (u32).
+#ifdef QS_SAMPLING
+
+    #ifdef QS_THREAD_RINGS
+        #error "QS_SAMPLING cannot be combined with QS_THREAD_RINGS"
+    #endif
+
+    #ifndef QS_SAMPLE_MAX
+        //! The maximum number of sampling configurations,
+        //! see QP::QS::sample()
+        #define QS_SAMPLE_MAX 8U
+    #endif
+
+#endif // QS_SAMPLING
+
+// Lazy dictionaries (define QS_LAZY_DICT in the QS port to enable).
+// QP::QS::obj_dict(), QP::QS::fun_dict() and QP::QS::sig_dict() only
+// register the name (which must be a static string, as produced by
+// #QS_OBJ_DICTIONARY and friends) in a table of #QS_DICT_SIZE entries,
+// so the startup does not produce any dictionary records. The dictionary
+// record is produced right after the first QS record, in which the object,
+// function or signal appears (#QS_OBJ_, #QS_FUN_, #QS_SIG_), and for all
+// the registered entries at the QP::QS_RX_DICT request from the host (see
+// QP::QS::dictAll()). When the table is full, the dictionary records are
+// produced immediately, as without QS_LAZY_DICT. Until all the registered
+// dictionaries are produced, every QS_OBJ_/QS_FUN_/QS_SIG_ checks the
+// slot of the table, to which its key hashes, and probes the table only
+// when a dictionary hashed to this slot is still to be produced.
+#ifdef QS_LAZY_DICT
+
+    #ifdef QS_THREAD_RINGS
+        #error "QS_LAZY_DICT cannot be combined with QS_THREAD_RINGS"
+    #endif
+
+    #ifndef QS_DICT_SIZE
+        //! The size of the table of the lazy dictionaries
+        //! (power of 2, at most 0x8000), see #QS_LAZY_DICT
+        #define QS_DICT_SIZE   512U
+    #endif
+
+#endif // QS_LAZY_DICT
+
+// Trace triggers (define QS_TRIGGER in the QS port to enable).
+// QP::QS::trgArm() switches the QS buffer to the capture mode, in which
+// the buffer is not output, but overwritten like a flight recorder. The
+// first trigger that fires (see QP::QS::trgSet() and QP::QS::trgFire())
+// releases the last pre-trigger bytes (aligned to a whole record) for the
+// output, and the capture ends after the post-trigger bytes, at which
+// point QS freezes (all global filters off) until QP::QS::trgArm() or
+// QP::QS::trgDisarm(). The fired trigger is marked in the capture by the
+// QP::QS_TRG_FIRED record between the pre- and post-trigger data. The
+// triggers are checked at the QS_BEGIN gate, so they see only the records
+// that passed the filters, and the queue and RTC-step triggers are checked
+// right where the measured values change.
+// The host sets up the triggers with the QP::QS_RX_TRIGGER record.
+#ifdef QS_TRIGGER
+
+    #ifdef QS_THREAD_RINGS
+        #error "QS_TRIGGER cannot be combined with QS_THREAD_RINGS"
+    #endif
+
+    #ifndef QS_TRG_MAX
+        //! The maximum number of the trace triggers, see QP::QS::trgSet()
+        #define QS_TRG_MAX 4U
+    #endif
+
+#endif // QS_TRIGGER
+
+// Overrun policy of the QS buffer. By default, the newest records
+// overwrite the oldest ones that the QS output did not send in time.
+// With QS_DROP_NEWEST defined in the QS port, a record that begins when
+// less than #QS_DROP_RESERVE bytes are free in the QS buffer is dropped
+// instead, so the oldest data is kept. The fixed-size data of a record
+// must fit into the reserve, while every string, memory block or array
+// drops the whole record when it would not leave the reserve free (the
+// blocks are checked as if all their bytes needed escaping). The dropped
+// records still take their sequence numbers, so the host sees where they
+// were dropped. With QS_BLOCK_PRODUCER defined, the QS_BEGIN gates
+// outside of critical sections first wait for the QS output to free some
+// room (see #QS_BLOCK_HOOK_), and the records that still do not fit (or
+// that are produced inside critical sections) are dropped. The overwritten
+// bytes, the dropped records and bytes and the waits are reported in the
+// QP::QS_OVERRUN record, see QP::QS::overrunReport(). The non-maskable
+// records and QP::QS_OVERRUN are never dropped (they use the reserve).
+#ifdef QS_BLOCK_PRODUCER
+    #ifndef QS_DROP_NEWEST
+        #define QS_DROP_NEWEST
+    #endif
+#endif // QS_BLOCK_PRODUCER
+
+#ifdef QS_DROP_NEWEST
+
+    #ifdef QS_THREAD_RINGS
+        #error "QS_DROP_NEWEST cannot be combined with QS_THREAD_RINGS"
+    #endif
+
+    #ifndef QS_DROP_RESERVE
+        //! The free bytes in the QS buffer needed to begin a record,
+        //! see #QS_DROP_NEWEST
+        #define QS_DROP_RESERVE 64U
+    #endif
+
+#endif // QS_DROP_NEWEST
+
+#ifndef QS_RX_FRAME_SIZE
+    //! The longest escaped QS-RX frame that QP::QS::rxParseBlock() decodes
+    //! at once (the longer frames are parsed byte by byte)
+    #define QS_RX_FRAME_SIZE 256U
+#endif
+
+#ifndef QS_LOC_FILTER_SIZE
+    //! The size of the table of the objects in the local QS filters
+    //! (power of 2, at most 0x8000), see QP::QS::locFilterAdd()
+    #define QS_LOC_FILTER_SIZE 64U
 #endif
 
 //! QS ring buffer counter and offset type
 typedef unsigned int QSCtr;
 
+#if (QS_OBJ_PTR_SIZE == 8) || (QS_FUN_PTR_SIZE == 8)
+    //! object or function pointer as an integer (local filters, compact
+    //! encoding and lazy dictionaries)
+    typedef uint64_t QSPtr;
+#else
+    typedef uint32_t QSPtr;
+#endif
+
 //! Constant representing End-Of-Data condition returned from the
 //! QP::QS::getByte() function.
 uint16_t const QS_EOD  = static_cast<uint16_t>(0xFFFF);
@@ -235,6 +424,28 @@ public:
     //! Turn the global Filter off for a given record type @p rec.
     static void filterOff(uint_fast8_t const rec);
 
+    //! Set the local filter of the @p kind of objects to the object @p obj
+    static void locFilter(uint_fast8_t const kind, void const * const obj);
+
+    //! Add the object @p obj to the local filter of the @p kind of objects
+    static void locFilterAdd(uint_fast8_t const kind,
+                             void const * const obj);
+
+    //! Remove the object @p obj from the local filter of the @p kind
+    //! of objects
+    static void locFilterRemove(uint_fast8_t const kind,
+                                void const * const obj);
+
+    //! Check whether the object @p obj is in the local filter of the
+    //! @p kind of objects (used only in #QS_LOC_FILTER_)
+    static bool locFilterHas_(uint_fast8_t const kind,
+                              void const * const obj);
+
+    //! Same as QP::QS::locFilterHas_(), but inside a critical section
+    //! (used only in #QS_LOC_FILTER_NOCRIT_)
+    static bool locFilterHasNoCrit_(uint_fast8_t const kind,
+                                    void const * const obj);
+
     //! Mark the begin of a QS record @p rec
     static void beginRec(uint_fast8_t const rec);
 
@@ -258,6 +469,27 @@ public:
     //! Output zero-terminated ASCII string element without format information
     static void str_(char_t const *s);
 
+    //! Output escaped block of bytes without format information
+    static void memBlk_(uint8_t const *blk, QSCtr n);
+
+#ifdef QS_COMPACT
+    //! Re-send the IDs of all the interned pointers (see #QS_COMPACT)
+    static void internAll(void);
+
+    //! Output an object or function pointer in the compact encoding
+    static bool ptr_(QSPtr const p);
+
+    //! Output a time stamp in the compact encoding
+    static void time_(QSTimeCtr const t);
+
+    //! Output an unsigned LEB128 variable-length integer
+    static void varint_(uint64_t v);
+
+    //! Find (or add for the dictionary record @p kind) the interned ID
+    //! of pointer @p p
+    static uint_fast16_t intern_(QSPtr const p, uint_fast8_t const kind);
+#endif // QS_COMPACT
+
 
     // formatted data elements output ........................................
 
@@ -282,13 +514,17 @@ public:
     //! Output memory block of up to 255-bytes with format information
     static void mem(uint8_t const *blk, uint8_t size);
 
-#if (QS_OBJ_PTR_SIZE == 8) || (QS_FUN_PTR_SIZE == 8)
+    //! Output large memory block or typed array with format information
+    static void arr(uint8_t const elemType, void const * const data,
+                    uint16_t n);
+
+#if (QS_OBJ_PTR_SIZE == 8) || (QS_FUN_PTR_SIZE == 8) || (QS_TIME_SIZE == 8)
     //! Output uint64_t data element without format information
     static void u64_(uint64_t d);
 
     //! Output uint64_t data element with format information
     static void u64(uint8_t format, uint64_t d);
-#endif  // (QS_OBJ_PTR_SIZE == 8) || (QS_FUN_PTR_SIZE == 8)
+#endif  // (QS_OBJ_PTR_SIZE == 8) || ... || (QS_TIME_SIZE == 8)
 
     //! Output signal dictionary record
     static void sig_dict(enum_t const sig, void const * const obj,
@@ -306,12 +542,66 @@ public:
     static void usr_dict(enum_t const rec,
                          char_t const *name);
 
+#ifdef QS_SAMPLING
+    //! Configure sampling of the QS records @p rec with the signal @p sig
+    static void sample(uint_fast8_t const rec, enum_t const sig,
+                       uint16_t const n, QSTimeCtr const interval);
+
+    //! Decide whether the sampled QS record @p rec is produced
+    static bool sample_(uint_fast8_t const rec, QSignal const sig);
+#endif // QS_SAMPLING
+
+#ifdef QS_LAZY_DICT
+    //! Produce the dictionary records of all the registered dictionaries
+    static void dictAll(void);
+
+    //! Note the use of the object, function or signal @p key in a record
+    static void dictUse_(uint_fast8_t const kind, QSPtr const key);
+#endif // QS_LAZY_DICT
+
+#ifdef QS_TRIGGER
+    //! Configure the trace trigger number @p idx
+    static void trgSet(uint_fast8_t const idx, uint_fast8_t const kind,
+                       uint_fast8_t const rec, enum_t const sig,
+                       void const * const obj, uint32_t const thresh);
+
+    //! Start capturing the trace with the @p pre and @p post trigger
+    //! windows (in bytes)
+    static void trgArm(QSCtr const pre, QSCtr const post);
+
+    //! Stop capturing the trace and resume the normal output
+    static void trgDisarm(void);
+
+    //! Fire the trigger manually (if the capture is armed)
+    static void trgFire(void);
+
+    //! Check the record triggers for the record @p rec (used only in the
+    //! QS_BEGIN gates)
+    static void trgRec_(uint_fast8_t const rec, QSignal const sig,
+                        void const * const obj);
+
+    //! Check the triggers of the @p kind for the @p value of the
+    //! object @p obj (must be called inside a critical section)
+    static void trgValue_(uint_fast8_t const kind, void const * const obj,
+                          uint32_t const value);
+#endif // QS_TRIGGER
+
+#ifdef QS_BLOCK_PRODUCER
+    //! Wait for the QS output to free some room in the QS buffer (used
+    //! only in the QS_BEGIN gates, see #QS_BLOCK_PRODUCER)
+    static void block_(void);
+#endif // QS_BLOCK_PRODUCER
+
     //! Initialize the QS RX data buffer
     static void rxInitBuf(uint8_t sto[], uint16_t const stoSize);
 
     //! Parse all bytes present in the QS RX data buffer
     static void rxParse(void);
 
+    //! Parse a block of the received bytes a whole frame at a time
+    static void rxParseBlock(uint8_t const * const block,
+                             uint16_t const nBytes);
+
     //! Obtain the number of free bytes in the QS RX data buffer
     static uint16_t rxGetNfree(void);
 
@@ -338,6 +628,18 @@ public:
     //! Block-oriented interface to the QS data buffer.
     static uint8_t const *getBlock(uint16_t * const pNbytes);
 
+    //! Zero-copy interface to the QS data buffer (peek up to two blocks)
+    static uint_fast8_t peekBlocks(uint8_t const *blk[2], QSCtr len[2]);
+
+    //! Free the @p n bytes at the tail of the QS data buffer
+    static void freeBlocks(QSCtr const n);
+
+    //! Set the number of used bytes that triggers #QS_WMARK_HOOK_
+    static void setWatermark(QSCtr const wmark);
+
+    //! Produce the QP::QS_OVERRUN record, if any QS data has been lost
+    static bool overrunReport(void);
+
     // platform-dependent callback functions to be implemented by clients ....
 
     //! Callback to startup the QS facility
@@ -400,6 +702,43 @@ public:
         U32_HEX_T     //!< unsigned 32-bit integer in hex format
     };
 
+    //! Element types of the large memory blocks and typed arrays
+    /// @description
+    /// The element type is encoded in the upper nibble of the
+    /// QP::QS::MEM_T format byte (which is 0 for the memory blocks of up
+    /// to 255 bytes from QS_MEM()), followed by the number of elements
+    /// (uint16_t) and the elements in the little-endian byte order.
+    enum QSArrType {
+        ARR_U8_T = 1, //!< bytes (large memory block)
+        ARR_U16_T,    //!< unsigned 16-bit integer elements
+        ARR_U32_T,    //!< unsigned 32-bit integer elements
+        ARR_F32_T,    //!< 32-bit floating point elements
+        ARR_F64_T     //!< 64-bit floating point elements
+    };
+
+    //! Kinds of the lazy dictionaries (see #QS_LAZY_DICT)
+    enum QSDictKind {
+        DICT_OBJ = 1, //!< object dictionary
+        DICT_FUN,     //!< function dictionary
+        DICT_SIG      //!< signal dictionary
+    };
+
+    //! Kinds of the trace triggers (see #QS_TRIGGER)
+    enum QSTrgKind {
+        TRG_NONE,     //!< unused trigger
+        TRG_REC,      //!< QS record, optionally with the signal and object
+        TRG_QMIN,     //!< minimum of free queue entries below the threshold
+        TRG_RTC       //!< RTC step longer than the threshold (QF_LATENCY)
+    };
+
+    //! States of the trace capture (see #QS_TRIGGER)
+    enum QSTrgState {
+        TRG_OFF,      //!< no capture, normal output
+        TRG_ARMED,    //!< capturing, output held until a trigger fires
+        TRG_POST,     //!< trigger fired, capturing the post-trigger bytes
+        TRG_DONE      //!< capture complete, QS frozen
+    };
+
     //! Kinds of objects used in QS
     enum QSpyObjKind {
         SM_OBJ,       //!< state machine object for QEP
@@ -408,7 +747,8 @@ public:
         EQ_OBJ,       //!< raw queue object
         TE_OBJ,       //!< time event object
         AP_OBJ,       //!< generic Application-specific object
-        MAX_OBJ
+        MAX_OBJ,
+        NO_OBJ = MAX_OBJ //!< records not subject to any local filter
     };
 
     //! template for forcing cast of member functions for function
@@ -424,7 +764,14 @@ public:
 
     // private QS attributes .................................................
     uint8_t glbFilter[16];          //!< global on/off QS filter
-    void const *locFilter[MAX_OBJ]; //!< local QS filters
+    //! number of the objects in the local QS filters (the last one for
+    //! QP::QS::NO_OBJ always stays 0)
+    uint16_t locFilterN[MAX_OBJ + 1];
+
+    //! objects in the local QS filters (open addressing)
+    void const *locObj[QS_LOC_FILTER_SIZE];
+    uint8_t  locKinds[QS_LOC_FILTER_SIZE]; //!< kinds of filters of locObj
+    uint16_t locNum;  //!< number of the objects in locObj[]
     uint8_t *buf;     //!< pointer to the start of the ring buffer
     QSCtr    end;     //!< offset of the end of the ring buffer
     QSCtr    head;    //!< offset to where next byte will be inserted
@@ -432,12 +779,168 @@ public:
     QSCtr    used;    //!< number of bytes currently in the ring buffer
     uint8_t  seq;     //!< the record sequence number
     uint8_t  chksum;  //!< the checksum of the current record
-    uint8_t  full;    //!< the ring buffer is temporarily full
+    uint8_t  full;    //!< the current (or last) record is dropped
+    QSCtr   *headCopy; //!< published copy of the head (flight recorder)
+    QSCtr    wmark;   //!< used bytes that trigger #QS_WMARK_HOOK_
+    uint32_t lost;    //!< bytes of old records overwritten in the buffer
+    uint32_t lostRep; //!< lost bytes already reported in QP::QS_OVERRUN
+    uint32_t ringRep; //!< lost ring records already reported (rings)
+
+#ifdef QS_DROP_NEWEST
+    QSCtr    dropLevel; //!< used bytes above which the records are dropped
+    uint8_t *dropBuf;   //!< QS buffer saved while a record is dropped
+    QSCtr    dropEnd;   //!< end of the buffer saved while dropping
+    QSCtr    dropHead;  //!< head saved while a record is dropped
+    QSCtr    dropUsed;  //!< used bytes saved while a record is dropped
+#ifdef QS_COMPACT
+    QSTimeCtr dropTime; //!< QS::lastTime saved while a record is dropped
+    uint8_t  dropSync;  //!< QS::timeSync saved while a record is dropped
+#endif // QS_COMPACT
+    uint8_t  dropOk;    //!< the current record can be dropped
+    uint32_t dropRecs;  //!< # records dropped
+    uint32_t dropBytes; //!< # bytes of the dropped records
+    uint32_t dropRep;   //!< dropped records already reported
+    uint32_t dropBRep;  //!< dropped bytes already reported
+    uint32_t blocks;    //!< # waits for the QS output (QS_BLOCK_PRODUCER)
+    uint32_t blockRep;  //!< waits already reported
+#endif // QS_DROP_NEWEST
 
     uint_fast8_t critNest; //!< critical section nesting level
 
+#ifdef QS_SAMPLING
+    //! Sampling of the QS records of one type (and optionally one signal)
+    struct QSSample {
+        QSignal   sig;      //!< the sampled signal (0 for any signal)
+        uint8_t   rec;      //!< the sampled record type (0 for unused)
+        uint16_t  n;        //!< produce 1 in n records (0 or 1 for time)
+        uint16_t  ctr;      //!< records left until the next produced one
+        uint16_t  skip;     //!< records skipped since the last produced
+        QSTimeCtr interval; //!< minimum time between produced records
+        QSTimeCtr last;     //!< time of the last produced record
+    };
+    uint8_t  smplFilter[16];        //!< record types that are sampled
+    QSSample smpl[QS_SAMPLE_MAX];   //!< the sampling configuration
+    uint16_t smplSkip;  //!< skip count reported in the current record
+#endif // QS_SAMPLING
+
+#ifdef QS_LAZY_DICT
+    //! Registered (lazy) dictionary, see #QS_LAZY_DICT
+    struct QSDict {
+        QSPtr key;               //!< object, function or signal
+        union {
+            void const *obj;     //!< the object (or object of the signal)
+            void (*fun)(void);   //!< the function
+        } ptr;
+        char_t const *name;      //!< the name (static string)
+        uint8_t kind;            //!< QP::QS::QSDictKind (0 for unused)
+        uint8_t state;           //!< not produced, pending or produced
+        uint16_t homeLeft;       //!< dictionaries hashed to this slot
+                                 //!< not produced yet
+    };
+    QSDict   dict[QS_DICT_SIZE]; //!< registered dictionaries (open addr.)
+    uint16_t dictNum;     //!< number of the registered dictionaries
+    uint16_t dictLeft;    //!< registered dictionaries not produced yet
+    uint16_t dictPend[8]; //!< dictionaries to produce after the record
+    uint8_t  dictNPend;   //!< number of the dictionaries in dictPend[]
+#endif // QS_LAZY_DICT
+
+#ifdef QS_TRIGGER
+    //! Trace trigger, see QP::QS::trgSet()
+    struct QSTrg {
+        void const *obj;  //!< the object (0 for any object)
+        uint32_t thresh;  //!< the threshold of TRG_QMIN and TRG_RTC
+        QSignal  sig;     //!< the signal of TRG_REC (0 for any signal)
+        uint8_t  kind;    //!< QP::QS::QSTrgKind
+        uint8_t  rec;     //!< the record of TRG_REC
+    };
+    QSTrg    trg[QS_TRG_MAX]; //!< the trace triggers
+    uint8_t  trgRecs[16];  //!< records with armed TRG_REC triggers
+    uint8_t  trgArmed;     //!< kinds of the armed triggers (bit mask)
+    uint8_t  trgState;     //!< QP::QS::QSTrgState
+    uint8_t  trgFilter[16]; //!< global filters saved while frozen
+    QSCtr    trgPre;       //!< pre-trigger window (bytes)
+    QSCtr    trgPost;      //!< post-trigger window (bytes)
+    QSCtr    trgHead;      //!< head of the buffer when the trigger fired
+    QSCtr    trgDist;      //!< bytes produced since the trigger fired
+#endif // QS_TRIGGER
+
+#ifdef QS_COMPACT
+    QSPtr    ptrs[QS_INTERN_SIZE]; //!< interned pointers (open addressing)
+    uint16_t ids[QS_INTERN_SIZE];  //!< IDs of the interned pointers
+                                   //!< (bit 15 set for the functions)
+    uint16_t nIds;       //!< number of interned pointers
+    QSTimeCtr lastTime;  //!< the previous time stamp
+    uint8_t  timeSync;   //!< time stamps left until the absolute one
+#endif // QS_COMPACT
+
     static QS priv_;
 
+#ifdef QS_THREAD_RINGS
+    //! Per-thread lock-free QS ring buffer
+    /// @description
+    /// With #QS_THREAD_RINGS defined in the QS port, every thread that
+    /// produces QS records gets its own ring, allocated at the first record.
+    /// The thread is the only producer and QP::QS::getBlock() (or
+    /// QP::QS::getByte()) is the only consumer of the ring, so recording
+    /// does not need any critical section. Each record in the ring is
+    /// un-escaped and preceded by the monotonic timestamp (see
+    /// #QS_RING_TIME_) and its length. QP::QS::getBlock() merges the records
+    /// from all rings in the timestamp order into the main QS buffer, where
+    /// they obtain the sequence numbers and HDLC framing expected by QSPY.
+    ///
+    /// A record cannot be longer than #QS_RING_REC_MAX. The strings, the
+    /// memory blocks and the arrays are truncated to the room left in the
+    /// record, keeping 64 bytes for the fixed-size data that follows them.
+    /// A record that still gets too long is dropped and counted as lost.
+    /// The ring is freed after the thread exits (see #QS_RING_ATTACH_)
+    /// and all its records are merged.
+    ///
+    /// The timestamp of a record is taken in QP::QS::beginRec(), but the
+    /// record is published only in QP::QS::endRec(). To keep the merged
+    /// records in the timestamp order, every ring also shows the timestamp
+    /// of the record being written (QSRing::busy), and the records younger
+    /// than that are held back until the record is published. A thread
+    /// preempted in the middle of a record thus delays the merge of the
+    /// records of all the other threads.
+    struct QSRing {
+        uint8_t *buf;    //!< where the current record is being written
+        QSCtr    end;    //!< size of the buffer at buf
+        QSCtr    head;   //!< offset to where next byte will be inserted
+        QSCtr    used;   //!< unused, needed by the common output code
+        uint8_t  chksum; //!< unused, needed by the common output code
+        QSCtr    rec;    //!< offset of the current record in the ring
+        QSCtr    pub;    //!< end of the published records (producer)
+        QSCtr    tail;   //!< offset of the next record to merge (consumer)
+        uint8_t *sto;    //!< the ring storage
+        QSCtr    size;   //!< size of the ring storage
+        uint64_t busy;   //!< timestamp of the record being written
+        uint32_t lost;   //!< # records lost because the ring was full
+        uint8_t  dead;   //!< the thread of the ring has exited
+        QSRing  *next;   //!< next ring in the list of all rings
+    };
+
+    //! the ring of the calling thread (0 before the first record)
+    static QS_THREAD_LOCAL QSRing *ring_;
+
+    //! the list of all per-thread rings
+    static QSRing *rings_;
+
+    //! allocate and register the ring of the calling thread
+    static QSRing *ringAlloc_(void);
+
+    //! merge the per-thread rings into the main QS buffer
+    static void ringMerge_(void);
+
+    //! release the ring of an exiting thread (called by the QS port)
+    static void ringExit_(void * const ring);
+
+    //! free the released rings with all their records merged
+    static void ringFree_(void);
+
+    //! the total number of records lost in the full per-thread rings
+    static uint32_t getRingLost(void);
+#endif // QS_THREAD_RINGS
+
     static struct QSrxPriv {
         void *currObj[MAX_OBJ]; //!< current objects
         uint8_t *buf; //!< pointer to the start of the ring buffer
@@ -467,8 +970,10 @@ enum QSpyRxRecords {
     QS_RX_AO_FILTER,  //!< set local AO filter in the Target
     QS_RX_CURR_OBJ,   //!< set the "current-object" in the Target
     QS_RX_TEST_CONTINUE, //!< continue a test after QS_RX_TEST_WAIT()
-    QS_RX_RESERVED1,  //!< reserved for future use
-    QS_RX_EVENT       //!< inject an event to the Target (post/publish)
+    QS_RX_DICT,       //!< produce all the (lazy) dictionaries
+    QS_RX_EVENT,      //!< inject an event to the Target (post/publish)
+    QS_RX_TRIGGER,    //!< set up the trace triggers in the Target
+    QS_RX_EVENTS      //!< inject a batch of events to the Target
 };
 
 } // namespace QP
@@ -535,7 +1040,7 @@ enum QSpyRxRecords {
 ///
 /// @sa Example of using QS filters in #QS_FILTER_ON documentation
 #define QS_FILTER_SM_OBJ(obj_) \
-    (QP::QS::priv_.locFilter[QP::QS::SM_OBJ] = (obj_))
+    (QP::QS::locFilter(QP::QS::SM_OBJ, (obj_)))
 
 //! Local Filter for a given active object @p obj_.
 /// @description
@@ -556,7 +1061,7 @@ enum QSpyRxRecords {
 ///
 /// @sa Example of using QS filters in #QS_FILTER_ON documentation
 #define QS_FILTER_AO_OBJ(obj_) \
-    (QP::QS::priv_.locFilter[QP::QS::AO_OBJ] = (obj_))
+    (QP::QS::locFilter(QP::QS::AO_OBJ, (obj_)))
 
 //! Local Filter for a given memory pool object @p obj_.
 /// @description
@@ -575,7 +1080,7 @@ enum QSpyRxRecords {
 ///
 /// @sa Example of using QS filters in QS_FILTER_ON() documentation
 #define QS_FILTER_MP_OBJ(obj_) \
-    (QP::QS::priv_.locFilter[QP::QS::MP_OBJ] = (obj_))
+    (QP::QS::locFilter(QP::QS::MP_OBJ, (obj_)))
 
 //! Filter for a given event queue object @p obj_.
 /// @description
@@ -595,7 +1100,7 @@ enum QSpyRxRecords {
 ///
 /// @sa Example of using QS filters in #QS_FILTER_ON documentation
 #define QS_FILTER_EQ_OBJ(obj_) \
-    (QP::QS::priv_.locFilter[QP::QS::EQ_OBJ] = (obj_))
+    (QP::QS::locFilter(QP::QS::EQ_OBJ, (obj_)))
 
 //! Local Filter for a given time event object @p obj_.
 /// @description
@@ -615,7 +1120,7 @@ enum QSpyRxRecords {
 ///
 /// @sa Example of using QS filters in #QS_FILTER_ON documentation
 #define QS_FILTER_TE_OBJ(obj_) \
-    (QP::QS::priv_.locFilter[QP::QS::TE_OBJ] = (obj_))
+    (QP::QS::locFilter(QP::QS::TE_OBJ, (obj_)))
 
 //! Local Filter for a generic application object @p obj_.
 /// @description
@@ -631,26 +1136,197 @@ enum QSpyRxRecords {
 ///
 /// @sa Example of using QS filters in #QS_FILTER_ON documentation
 #define QS_FILTER_AP_OBJ(obj_) \
-    (QP::QS::priv_.locFilter[QP::QS::AP_OBJ] = (obj_))
+    (QP::QS::locFilter(QP::QS::AP_OBJ, (obj_)))
+
+//! Add the object @p obj_ to the local filter of the @p kind_ of objects.
+/// @description
+/// This macro provides an indirection layer to call
+/// QP::QS::locFilterAdd() if #Q_SPY is defined, or do nothing if #Q_SPY
+/// is not defined. The @p kind_ is one of QP::QS::QSpyObjKind, such as
+/// QP::QS::AO_OBJ. Unlike the macros #QS_FILTER_SM_OBJ, #QS_FILTER_AO_OBJ,
+/// etc., which trace only the given object, the objects added with this
+/// macro extend the set of the traced objects of the given kind.
+///
+/// @usage
+/// @code
+/// QS_FILTER_AO_OBJ(&l_philo[0]); // trace only Philo[0] ...
+/// QS_FILTER_OBJ_ADD(QP::QS::AO_OBJ, &l_philo[3]); // ...and Philo[3]
+/// QS_FILTER_OBJ_ADD(QP::QS::SM_OBJ, &l_philo[3]);
+/// @endcode
+#define QS_FILTER_OBJ_ADD(kind_, obj_) \
+    (QP::QS::locFilterAdd(static_cast<uint_fast8_t>(kind_), (obj_)))
+
+//! Remove the object @p obj_ from the local filter of the @p kind_ of
+//! objects, see #QS_FILTER_OBJ_ADD
+#define QS_FILTER_OBJ_REMOVE(kind_, obj_) \
+    (QP::QS::locFilterRemove(static_cast<uint_fast8_t>(kind_), (obj_)))
 
 
 //****************************************************************************
 // Macros to generate user QS records
 
+#ifndef QS_STATIC_FILTER0
+    //! Compile-time QS filter for the records 0..31
+    /// @description
+    /// The four macros #QS_STATIC_FILTER0 .. #QS_STATIC_FILTER3 form a
+    /// 128-bit mask, in which the bit (rec & 31) of QS_STATIC_FILTER(rec/32)
+    /// enables the QS record number rec. The QS records disabled in this mask
+    /// are removed by the compiler from every #QS_BEGIN / #QS_BEGIN_ site
+    /// with a constant record number, so they cannot be enabled at run time
+    /// by #QS_FILTER_ON. The enabled records are still subject to the global
+    /// and local filters at run time. By default all records are enabled.
+    /// A QS port or the build (e.g., DEFINES=-DQS_STATIC_FILTER1=0x0U) can
+    /// define any of these macros to remove whole groups of records.
+    #define QS_STATIC_FILTER0   0xFFFFFFFFU
+#endif
+#ifndef QS_STATIC_FILTER1
+    //! Compile-time QS filter for the records 32..63, see #QS_STATIC_FILTER0
+    #define QS_STATIC_FILTER1   0xFFFFFFFFU
+#endif
+#ifndef QS_STATIC_FILTER2
+    //! Compile-time QS filter for the records 64..95, see #QS_STATIC_FILTER0
+    #define QS_STATIC_FILTER2   0xFFFFFFFFU
+#endif
+#ifndef QS_STATIC_FILTER3
+    //! Compile-time QS filter for the records 96..127,
+    //! see #QS_STATIC_FILTER0
+    #define QS_STATIC_FILTER3   0xFFFFFFFFU
+#endif
+
+//! helper macro for checking the compile-time QS filter
+/// @description
+/// For a constant record number @p rec_ this is a constant expression,
+/// so the whole record is eliminated when the record is disabled.
+#define QS_STATIC_FILTER_(rec_) \
+    ((((static_cast<uint8_t>(rec_) < static_cast<uint8_t>(32)) \
+        ? static_cast<uint32_t>(QS_STATIC_FILTER0) \
+        : (static_cast<uint8_t>(rec_) < static_cast<uint8_t>(64)) \
+        ? static_cast<uint32_t>(QS_STATIC_FILTER1) \
+        : (static_cast<uint8_t>(rec_) < static_cast<uint8_t>(96)) \
+        ? static_cast<uint32_t>(QS_STATIC_FILTER2) \
+        : static_cast<uint32_t>(QS_STATIC_FILTER3)) \
+      & (static_cast<uint32_t>(1) \
+         << (static_cast<uint8_t>(rec_) & static_cast<uint8_t>(31)))) \
+     != static_cast<uint32_t>(0))
+
 //! helper macro for checking the global QS filter
+/// @description
+/// Checks the compile-time filter #QS_STATIC_FILTER_ first and only then
+/// the run-time global filter QP::QS::priv_.glbFilter.
 #define QS_GLB_FILTER_(rec_) \
+    (QS_STATIC_FILTER_(rec_) && QS_RT_FILTER_(rec_))
+
+//! helper macro for checking the local QS filter of the @p kind_ of objects
+//! outside of a critical section
+/// @description
+/// The filter passes all objects when no object of the @p kind_ is in the
+/// filter, so QP::QS::locFilterHas_() is called only for active filters.
+#define QS_LOC_FILTER_(kind_, obj_) \
+    ((QP::QS::priv_.locFilterN[kind_] == static_cast<uint16_t>(0)) \
+     || QP::QS::locFilterHas_(static_cast<uint_fast8_t>(kind_), (obj_)))
+
+//! helper macro for checking the local QS filter of the @p kind_ of objects
+//! inside a critical section
+/// @sa #QS_LOC_FILTER_
+#define QS_LOC_FILTER_NOCRIT_(kind_, obj_) \
+    ((QP::QS::priv_.locFilterN[kind_] == static_cast<uint16_t>(0)) \
+     || QP::QS::locFilterHasNoCrit_(static_cast<uint_fast8_t>(kind_), \
+                                    (obj_)))
+
+//! helper macro for checking the run-time global QS filter
+#define QS_RT_FILTER_(rec_) \
     ((static_cast<uint_fast8_t>(QP::QS::priv_.glbFilter[ \
             static_cast<uint8_t>(rec_) >> 3]) \
       & static_cast<uint_fast8_t>(static_cast<uint8_t>(1U << \
                (static_cast<uint8_t>(rec_) & static_cast<uint8_t>(7))))) \
              != static_cast<uint_fast8_t>(0))
 
+#ifdef QS_SAMPLING
+
+    //! helper macro for checking whether the record type is sampled
+    #define QS_SMPL_FILTER_(rec_) \
+        ((static_cast<uint_fast8_t>(QP::QS::priv_.smplFilter[ \
+                static_cast<uint8_t>(rec_) >> 3]) \
+          & static_cast<uint_fast8_t>(static_cast<uint8_t>(1U << \
+                (static_cast<uint8_t>(rec_) & static_cast<uint8_t>(7))))) \
+                 != static_cast<uint_fast8_t>(0))
+
+    //! Internal QS macro opening the block of a QS record that is
+    //! produced only when the sampling of the record lets it through
+    #define QS_SMPL_BEGIN_(rec_, sig_) \
+        if ((!QS_SMPL_FILTER_(rec_)) \
+            || QP::QS::sample_(static_cast<uint_fast8_t>(rec_), \
+                               static_cast<QP::QSignal>(sig_))) {
+
+#else
+
+    //! Internal QS macro opening the block of a QS record (no sampling)
+    #define QS_SMPL_BEGIN_(rec_, sig_) {
+
+#endif // QS_SAMPLING
+
+#ifdef QS_TRIGGER
+
+    //! helper macro for checking whether the record type has armed
+    //! record triggers
+    #define QS_TRG_FILTER_(rec_) \
+        ((static_cast<uint_fast8_t>(QP::QS::priv_.trgRecs[ \
+                static_cast<uint8_t>(rec_) >> 3]) \
+          & static_cast<uint_fast8_t>(static_cast<uint8_t>(1U << \
+                (static_cast<uint8_t>(rec_) & static_cast<uint8_t>(7))))) \
+                 != static_cast<uint_fast8_t>(0))
+
+    //! Internal QS macro to check the record triggers at the QS_BEGIN gate
+    #define QS_TRG_(rec_, sig_, obj_) \
+        if (QS_TRG_FILTER_(rec_)) { \
+            QP::QS::trgRec_(static_cast<uint_fast8_t>(rec_), \
+                            static_cast<QP::QSignal>(sig_), (obj_)); \
+        }
+
+    //! Internal QS macro to check the triggers of the @p kind_ for the
+    //! @p value_ of the object @p obj_ (inside a critical section)
+    #define QS_TRG_VALUE_(kind_, obj_, value_) do { \
+        if ((QP::QS::priv_.trgArmed \
+             & static_cast<uint8_t>(1U << (kind_))) != 0U) \
+        { \
+            QP::QS::trgValue_(static_cast<uint_fast8_t>(kind_), (obj_), \
+                              static_cast<uint32_t>(value_)); \
+        } \
+    } while (false)
+
+#else
+
+    //! Internal QS macro to check the record triggers (no triggers)
+    #define QS_TRG_(rec_, sig_, obj_)
+
+    //! Internal QS macro to check the value triggers (no triggers)
+    #define QS_TRG_VALUE_(kind_, obj_, value_) ((void)0)
+
+#endif // QS_TRIGGER
+
+#ifdef QS_BLOCK_PRODUCER
+
+    //! Internal QS macro to wait for room in the QS buffer at the QS_BEGIN
+    //! gates outside of critical sections (see #QS_BLOCK_PRODUCER)
+    #define QS_BLOCK_() \
+        if (QP::QS::priv_.used > QP::QS::priv_.dropLevel) { \
+            QP::QS::block_(); \
+        }
+
+#else
+
+    //! Internal QS macro to wait for room in the QS buffer (no waiting)
+    #define QS_BLOCK_()
+
+#endif // QS_BLOCK_PRODUCER
+
 //! Begin a QS user record without entering critical section.
 #define QS_BEGIN_NOCRIT(rec_, obj_) \
-    if (QS_GLB_FILTER_(rec_) && \
-        ((QP::QS::priv_.locFilter[QP::QS::AP_OBJ] == static_cast<void *>(0)) \
-            || (QP::QS::priv_.locFilter[QP::QS::AP_OBJ] == (obj_)))) \
+    if (QS_GLB_FILTER_(rec_) \
+        && QS_LOC_FILTER_NOCRIT_(QP::QS::AP_OBJ, (obj_))) \
     { \
+        QS_TRG_(rec_, 0, (obj_)) \
+        QS_SMPL_BEGIN_(rec_, 0) \
         QP::QS::beginRec(static_cast<uint_fast8_t>(rec_)); \
         QS_TIME_();
 
@@ -729,12 +1405,12 @@ enum QSpyRxRecords {
 ///
 /// @include qs_user.cpp
 #define QS_BEGIN(rec_, obj_) \
-    if (QS_GLB_FILTER_(rec_) && \
-        ((QP::QS::priv_.locFilter[QP::QS::AP_OBJ] == static_cast<void *>(0)) \
-            || (QP::QS::priv_.locFilter[QP::QS::AP_OBJ] == (obj_)))) \
-    { \
+    if (QS_GLB_FILTER_(rec_) && QS_LOC_FILTER_(QP::QS::AP_OBJ, (obj_))) { \
         QS_CRIT_STAT_ \
+        QS_BLOCK_() \
         QS_CRIT_ENTRY_(); \
+        QS_TRG_(rec_, 0, (obj_)) \
+        QS_SMPL_BEGIN_(rec_, 0) \
         QP::QS::beginRec(static_cast<uint_fast8_t>(rec_)); \
         QS_TIME_();
 
@@ -749,15 +1425,30 @@ enum QSpyRxRecords {
 // Macros for use inside other macros or internally in the QP code
 
 //! Internal QS macro to begin a QS record with entering critical section.
+/// @description
+/// The record about the object @p obj_ is subject to the local filter of
+/// the @p objKind_ of objects (QP::QS::QSpyObjKind), or to no local
+/// filter for QP::QS::NO_OBJ.
 /// @note
 /// This macro is intended to use only inside QP components and NOT
 /// at the application level. @sa #QS_BEGIN
-#define QS_BEGIN_(rec_, objFilter_, obj_) \
-    if (QS_GLB_FILTER_(rec_) \
-        && (((objFilter_) == static_cast<void *>(0)) \
-            || ((objFilter_) == (obj_)))) \
-    { \
+#define QS_BEGIN_(rec_, objKind_, obj_) \
+    QS_BEGIN_SIG_(rec_, 0, objKind_, obj_)
+
+//! Internal QS macro to begin a QS record about the signal @p sig_ with
+//! entering critical section.
+/// @description
+/// Same as #QS_BEGIN_, but the signal @p sig_ is also used to decide
+/// whether the record is sampled (see QP::QS::sample()).
+/// @note
+/// This macro is intended to use only inside QP components and NOT
+/// at the application level. @sa #QS_BEGIN
+#define QS_BEGIN_SIG_(rec_, sig_, objKind_, obj_) \
+    if (QS_GLB_FILTER_(rec_) && QS_LOC_FILTER_(objKind_, (obj_))) { \
+        QS_BLOCK_() \
         QS_CRIT_ENTRY_(); \
+        QS_TRG_(rec_, sig_, (obj_)) \
+        QS_SMPL_BEGIN_(rec_, sig_) \
         QP::QS::beginRec(static_cast<uint_fast8_t>(rec_));
 
 //! Internal QS macro to end a QS record with exiting critical section.
@@ -765,7 +1456,8 @@ enum QSpyRxRecords {
 /// This macro is intended to use only inside QP components and NOT
 /// at the application level. @sa #QS_END
 #define QS_END_() \
-        QP::QS::endRec(); \
+            QP::QS::endRec(); \
+        } \
         QS_CRIT_EXIT_(); \
     }
 
@@ -773,11 +1465,21 @@ enum QSpyRxRecords {
 /// @note
 /// This macro is intended to use only inside QP components and NOT
 /// at the application level. @sa #QS_BEGIN_NOCRIT
-#define QS_BEGIN_NOCRIT_(rec_, objFilter_, obj_) \
-    if (QS_GLB_FILTER_(rec_) \
-        && (((objFilter_) == static_cast<void *>(0)) \
-            || ((objFilter_) == (obj_)))) \
-    { \
+#define QS_BEGIN_NOCRIT_(rec_, objKind_, obj_) \
+    QS_BEGIN_SIG_NOCRIT_(rec_, 0, objKind_, obj_)
+
+//! Internal QS macro to begin a QS record about the signal @p sig_
+//! without entering critical section.
+/// @description
+/// Same as #QS_BEGIN_NOCRIT_, but the signal @p sig_ is also used to
+/// decide whether the record is sampled (see QP::QS::sample()).
+/// @note
+/// This macro is intended to use only inside QP components and NOT
+/// at the application level. @sa #QS_BEGIN_NOCRIT
+#define QS_BEGIN_SIG_NOCRIT_(rec_, sig_, objKind_, obj_) \
+    if (QS_GLB_FILTER_(rec_) && QS_LOC_FILTER_NOCRIT_(objKind_, (obj_))) { \
+        QS_TRG_(rec_, sig_, (obj_)) \
+        QS_SMPL_BEGIN_(rec_, sig_) \
         QP::QS::beginRec(static_cast<uint_fast8_t>(rec_));
 
 //! Internal QS macro to end a QS record without exiting critical section.
@@ -785,18 +1487,19 @@ enum QSpyRxRecords {
 /// This macro is intended to use only inside QP components and NOT
 /// at the application level. @sa #QS_END_NOCRIT
 #define QS_END_NOCRIT_() \
-        QP::QS::endRec(); \
+            QP::QS::endRec(); \
+        } \
     }
 
 #if (Q_SIGNAL_SIZE == 1)
     //! Internal QS macro to output an unformatted event signal data element
     /// @note
     /// The size of the pointer depends on the macro #Q_SIGNAL_SIZE.
-    #define QS_SIG_(sig_)    (QP::QS::u8_(static_cast<uint8_t>(sig_)))
+    #define QS_SIG_RAW_(sig_) (QP::QS::u8_(static_cast<uint8_t>(sig_)))
 #elif (Q_SIGNAL_SIZE == 2)
-    #define QS_SIG_(sig_)    (QP::QS::u16_(static_cast<uint16_t>(sig_)))
+    #define QS_SIG_RAW_(sig_) (QP::QS::u16_(static_cast<uint16_t>(sig_)))
 #elif (Q_SIGNAL_SIZE == 4)
-    #define QS_SIG_(sig_)    (QP::QS::u32_(static_cast<uint32_t>(sig_)))
+    #define QS_SIG_RAW_(sig_) (QP::QS::u32_(static_cast<uint32_t>(sig_)))
 #endif
 
 //! Internal QS macro to output an unformatted uint8_t data element
@@ -813,42 +1516,91 @@ enum QSpyRxRecords {
 
 
 #if (QS_OBJ_PTR_SIZE == 1)
-    #define QS_OBJ_(obj_)    (QP::QS::u8_(reinterpret_cast<uint8_t>(obj_)))
+    #define QS_OBJ_RAW_(obj_)  (QP::QS::u8_(reinterpret_cast<uint8_t>(obj_)))
 #elif (QS_OBJ_PTR_SIZE == 2)
-    #define QS_OBJ_(obj_)    (QP::QS::u16_(reinterpret_cast<uint16_t>(obj_)))
+    #define QS_OBJ_RAW_(obj_)  (QP::QS::u16_(reinterpret_cast<uint16_t>(obj_)))
 #elif (QS_OBJ_PTR_SIZE == 4)
-    #define QS_OBJ_(obj_)    (QP::QS::u32_(reinterpret_cast<uint32_t>(obj_)))
+    #define QS_OBJ_RAW_(obj_)  (QP::QS::u32_(reinterpret_cast<uint32_t>(obj_)))
 #elif (QS_OBJ_PTR_SIZE == 8)
-    #define QS_OBJ_(obj_)    (QP::QS::u64_(reinterpret_cast<uint64_t>(obj_)))
+    #define QS_OBJ_RAW_(obj_)  (QP::QS::u64_(reinterpret_cast<uint64_t>(obj_)))
 #else
 
     //! Internal QS macro to output an unformatted object pointer
-    //! data element
+    //! data element (always the full pointer)
     /// @note
     /// The size of the pointer depends on the macro #QS_OBJ_PTR_SIZE.
     /// If the size is not defined the size of pointer is assumed 4-bytes.
-    #define QS_OBJ_(obj_)    (QP::QS::u32_(reinterpret_cast<uint32_t>(obj_)))
+    #define QS_OBJ_RAW_(obj_)  (QP::QS::u32_(reinterpret_cast<uint32_t>(obj_)))
 #endif
 
 
 #if (QS_FUN_PTR_SIZE == 1)
-    #define QS_FUN_(fun_)    (QP::QS::u8_(reinterpret_cast<uint8_t>(fun_)))
+    #define QS_FUN_RAW_(fun_)  (QP::QS::u8_(reinterpret_cast<uint8_t>(fun_)))
 #elif (QS_FUN_PTR_SIZE == 2)
-    #define QS_FUN_(fun_)    (QP::QS::u16_(reinterpret_cast<uint16_t>(fun_)))
+    #define QS_FUN_RAW_(fun_)  (QP::QS::u16_(reinterpret_cast<uint16_t>(fun_)))
 #elif (QS_FUN_PTR_SIZE == 4)
-    #define QS_FUN_(fun_)    (QP::QS::u32_(reinterpret_cast<uint32_t>(fun_)))
+    #define QS_FUN_RAW_(fun_)  (QP::QS::u32_(reinterpret_cast<uint32_t>(fun_)))
 #elif (QS_FUN_PTR_SIZE == 8)
-    #define QS_FUN_(fun_)    (QP::QS::u64_(reinterpret_cast<uint64_t>(fun_)))
+    #define QS_FUN_RAW_(fun_)  (QP::QS::u64_(reinterpret_cast<uint64_t>(fun_)))
 #else
 
     //! Internal QS macro to output an unformatted function pointer
-    //! data element
+    //! data element (always the full pointer)
     /// @note
     /// The size of the pointer depends on the macro #QS_FUN_PTR_SIZE.
     /// If the size is not defined the size of pointer is assumed 4-bytes.
-    #define QS_FUN_(fun_)    (QP::QS::u32_(reinterpret_cast<uint32_t>(fun_)))
+    #define QS_FUN_RAW_(fun_)  (QP::QS::u32_(reinterpret_cast<uint32_t>(fun_)))
 #endif
 
+#ifdef QS_COMPACT
+    //! Internal QS macro to output an unformatted object pointer
+    //! data element (interned ID or full pointer in the compact encoding)
+    #define QS_OBJ_PTR_(obj_) \
+        ((void)(QP::QS::ptr_(reinterpret_cast<QP::QSPtr>(obj_)) \
+                && (QS_OBJ_RAW_(obj_), true)))
+
+    //! Internal QS macro to output an unformatted function pointer
+    //! data element (interned ID or full pointer in the compact encoding)
+    #define QS_FUN_PTR_(fun_) \
+        ((void)(QP::QS::ptr_(reinterpret_cast<QP::QSPtr>(fun_)) \
+                && (QS_FUN_RAW_(fun_), true)))
+#else
+    #define QS_OBJ_PTR_(obj_) QS_OBJ_RAW_(obj_)
+    #define QS_FUN_PTR_(fun_) QS_FUN_RAW_(fun_)
+#endif // QS_COMPACT
+
+#ifdef QS_LAZY_DICT
+    //! Internal QS macro to note the use of the object, function or signal
+    //! @p key_ in the current QS record (see #QS_LAZY_DICT)
+    #define QS_DICT_USE_(kind_, key_) \
+        ((QP::QS::priv_.dictLeft != static_cast<uint16_t>(0)) \
+            ? QP::QS::dictUse_(static_cast<uint_fast8_t>(kind_), (key_)) \
+            : static_cast<void>(0))
+
+    //! Internal QS macro to output an unformatted object pointer
+    //! data element
+    #define QS_OBJ_(obj_) \
+        (QS_DICT_USE_(QP::QS::DICT_OBJ, \
+                      reinterpret_cast<QP::QSPtr>(obj_)), \
+         QS_OBJ_PTR_(obj_))
+
+    //! Internal QS macro to output an unformatted function pointer
+    //! data element
+    #define QS_FUN_(fun_) \
+        (QS_DICT_USE_(QP::QS::DICT_FUN, \
+                      reinterpret_cast<QP::QSPtr>(fun_)), \
+         QS_FUN_PTR_(fun_))
+
+    //! Internal QS macro to output an unformatted event signal data element
+    #define QS_SIG_(sig_) \
+        (QS_DICT_USE_(QP::QS::DICT_SIG, static_cast<QP::QSPtr>(sig_)), \
+         QS_SIG_RAW_(sig_))
+#else
+    #define QS_OBJ_(obj_)    QS_OBJ_PTR_(obj_)
+    #define QS_FUN_(fun_)    QS_FUN_PTR_(fun_)
+    #define QS_SIG_(sig_)    QS_SIG_RAW_(sig_)
+#endif // QS_LAZY_DICT
+
 //! Internal QS macro to output a zero-terminated ASCII string
 /// data element
 #define QS_STR_(msg_)        (QP::QS::str_(msg_))
@@ -918,32 +1670,60 @@ enum QSpyRxRecords {
 //! Output formatted memory block of up to 255 bytes to the QS record
 #define QS_MEM(mem_, size_)     (QP::QS::mem((mem_), (size_)))
 
+//! Output formatted memory block of up to 65535 bytes to the QS record
+/// @description
+/// Unlike QS_MEM(), the block is copied into the QS buffer in bulk (see
+/// QP::QS::arr()), so this macro is also faster for the shorter blocks.
+/// Like QS_MEM(), it takes a pointer to any object (e.g., a char buffer).
+#define QS_MEM_BLK(mem_, size_) \
+    (QP::QS::arr(static_cast<uint8_t>(QP::QS::ARR_U8_T), (mem_), (size_)))
+
+//! Output formatted array of @p n_ uint16_t elements to the QS record
+#define QS_ARR_U16(arr_, n_) \
+    (QP::QS::arr(static_cast<uint8_t>(QP::QS::ARR_U16_T), \
+        static_cast<uint16_t const *>(arr_), (n_)))
+
+//! Output formatted array of @p n_ uint32_t elements to the QS record
+#define QS_ARR_U32(arr_, n_) \
+    (QP::QS::arr(static_cast<uint8_t>(QP::QS::ARR_U32_T), \
+        static_cast<uint32_t const *>(arr_), (n_)))
+
+//! Output formatted array of @p n_ float32_t elements to the QS record
+#define QS_ARR_F32(arr_, n_) \
+    (QP::QS::arr(static_cast<uint8_t>(QP::QS::ARR_F32_T), \
+        static_cast<float32_t const *>(arr_), (n_)))
+
+//! Output formatted array of @p n_ float64_t elements to the QS record
+#define QS_ARR_F64(arr_, n_) \
+    (QP::QS::arr(static_cast<uint8_t>(QP::QS::ARR_F64_T), \
+        static_cast<float64_t const *>(arr_), (n_)))
+
 
 #if (QS_OBJ_PTR_SIZE == 1)
-    #define QS_OBJ(obj_)        (QP::QS::u8(QS_OBJ_T, (uint8_t)(obj_)))
+    #define QS_OBJ(obj_)        (QP::QS::u8(QP::QS::OBJ_T, (uint8_t)(obj_)))
 #elif (QS_OBJ_PTR_SIZE == 2)
-    #define QS_OBJ(obj_)        (QP::QS::u16(QS_OBJ_T, (uint16_t)(obj_)))
+    #define QS_OBJ(obj_)        (QP::QS::u16(QP::QS::OBJ_T, (uint16_t)(obj_)))
 #elif (QS_OBJ_PTR_SIZE == 4)
-    #define QS_OBJ(obj_)        (QP::QS::u32(QS_OBJ_T, (uint32_t)(obj_)))
+    #define QS_OBJ(obj_)        (QP::QS::u32(QP::QS::OBJ_T, (uint32_t)(obj_)))
 #elif (QS_OBJ_PTR_SIZE == 8)
-    #define QS_OBJ(obj_)        (QP::QS::u64(QS_OBJ_T, (uint64_t)(obj_)))
+    #define QS_OBJ(obj_)        (QP::QS::u64(QP::QS::OBJ_T, (uint64_t)(obj_)))
 #else
     //! Output formatted object pointer to the QS record
-    #define QS_OBJ(obj_)        (QP::QS::u32(QS_OBJ_T, (uint32_t)(obj_)))
+    #define QS_OBJ(obj_)        (QP::QS::u32(QP::QS::OBJ_T, (uint32_t)(obj_)))
 #endif
 
 
 #if (QS_FUN_PTR_SIZE == 1)
-    #define QS_FUN(fun_)        (QP::QS::u8(QS_FUN_T, (uint8_t)(fun_)))
+    #define QS_FUN(fun_)        (QP::QS::u8(QP::QS::FUN_T, (uint8_t)(fun_)))
 #elif (QS_FUN_PTR_SIZE == 2)
-    #define QS_FUN(fun_)        (QP::QS::u16(QS_FUN_T, (uint16_t)(fun_)))
+    #define QS_FUN(fun_)        (QP::QS::u16(QP::QS::FUN_T, (uint16_t)(fun_)))
 #elif (QS_FUN_PTR_SIZE == 4)
-    #define QS_FUN(fun_)        (QP::QS::u32(QS_FUN_T, (uint32_t)(fun_)))
+    #define QS_FUN(fun_)        (QP::QS::u32(QP::QS::FUN_T, (uint32_t)(fun_)))
 #elif (QS_FUN_PTR_SIZE == 8)
-    #define QS_FUN(fun_)        (QP::QS::u64(QS_FUN_T, (uint64_t)(fun_)))
+    #define QS_FUN(fun_)        (QP::QS::u64(QP::QS::FUN_T, (uint64_t)(fun_)))
 #else
     //! Output formatted function pointer to the QS record
-    #define QS_FUN(fun_)        (QP::QS::u32(QS_FUN_T, (uint32_t)(fun_)))
+    #define QS_FUN(fun_)        (QP::QS::u32(QP::QS::FUN_T, (uint32_t)(fun_)))
 #endif
 
 
@@ -1036,7 +1816,7 @@ enum QSpyRxRecords {
 //! Output the assertion failure trace record
 #define QS_ASSERTION(module_, loc_, delay_) do { \
     QS_BEGIN_NOCRIT_(QP::QS_ASSERT_FAIL, \
-        static_cast<void *>(0), static_cast<void *>(0)) \
+        QP::QS::NO_OBJ, static_cast<void *>(0)) \
         QS_TIME_(); \
         QS_U16_(static_cast<uint16_t>(loc_)); \
         QS_STR_(module_); \
@@ -1058,7 +1838,7 @@ enum QSpyRxRecords {
 //! Output the critical section entry record
 #define QF_QS_CRIT_ENTRY() \
     QS_BEGIN_NOCRIT_(QP::QS_QF_CRIT_ENTRY, \
-        static_cast<void *>(0), static_cast<void *>(0)) \
+        QP::QS::NO_OBJ, static_cast<void *>(0)) \
         QS_TIME_(); \
         QS_U8_((uint8_t)(++QS::priv_.critNest)); \
     QS_END_NOCRIT_()
@@ -1066,7 +1846,7 @@ enum QSpyRxRecords {
 //! Output the critical section exit record
 #define QF_QS_CRIT_EXIT() \
     QS_BEGIN_NOCRIT_(QP::QS_QF_CRIT_EXIT, \
-        static_cast<void *>(0), static_cast<void *>(0)) \
+        QP::QS::NO_OBJ, static_cast<void *>(0)) \
         QS_TIME_(); \
         QS_U8_((uint8_t)(QS::priv_.critNest--)); \
     QS_END_NOCRIT_()
@@ -1074,7 +1854,7 @@ enum QSpyRxRecords {
 //! Output the interrupt entry record
 #define QF_QS_ISR_ENTRY(isrnest_, prio_) \
     QS_BEGIN_NOCRIT_(QP::QS_QF_ISR_ENTRY, \
-        static_cast<void *>(0), static_cast<void *>(0)) \
+        QP::QS::NO_OBJ, static_cast<void *>(0)) \
         QS_TIME_(); \
         QS_U8_(isrnest_); \
         QS_U8_(prio_); \
@@ -1083,7 +1863,7 @@ enum QSpyRxRecords {
 //! Output the interrupt exit record
 #define QF_QS_ISR_EXIT(isrnest_, prio_) \
     QS_BEGIN_NOCRIT_(QP::QS_QF_ISR_EXIT,  \
-        static_cast<void *>(0), static_cast<void *>(0)) \
+        QP::QS::NO_OBJ, static_cast<void *>(0)) \
         QS_TIME_(); \
         QS_U8_(isrnest_); \
         QS_U8_(prio_); \
@@ -55,6 +55,8 @@
 #define QS_FILTER_EQ_OBJ(obj_)          ((void)0)
 #define QS_FILTER_TE_OBJ(obj_)          ((void)0)
 #define QS_FILTER_AP_OBJ(obj_)          ((void)0)
+#define QS_FILTER_OBJ_ADD(kind_, obj_)  ((void)0)
+#define QS_FILTER_OBJ_REMOVE(kind_, obj_) ((void)0)
 
 #define QS_GET_BYTE(pByte_)             (static_cast<uint16_t>(0xFFFFU))
 #define QS_GET_BLOCK(pSize_)            (static_cast<uint8_t *>(0))
@@ -76,6 +78,11 @@
 #define QS_U32_HEX(width_, data_)       ((void)0)
 #define QS_STR(str_)                    ((void)0)
 #define QS_MEM(mem_, size_)             ((void)0)
+#define QS_MEM_BLK(mem_, size_)         ((void)0)
+#define QS_ARR_U16(arr_, n_)            ((void)0)
+#define QS_ARR_U32(arr_, n_)            ((void)0)
+#define QS_ARR_F32(arr_, n_)            ((void)0)
+#define QS_ARR_F64(arr_, n_)            ((void)0)
 #define QS_SIG(sig_, obj_)              ((void)0)
 #define QS_OBJ(obj_)                    ((void)0)
 #define QS_FUN(fun_)                    ((void)0)
@@ -99,6 +106,8 @@
 #define QS_END_()                       }
 #define QS_BEGIN_NOCRIT_(rec_, refObj_, obj_) if (false) {
 #define QS_END_NOCRIT_()                }
+#define QS_BEGIN_SIG_(rec_, sig_, refObj_, obj_) if (false) {
+#define QS_BEGIN_SIG_NOCRIT_(rec_, sig_, refObj_, obj_) if (false) {
 #define QS_U8_(data_)                   ((void)0)
 #define QS_2U8_(data1_, data2_)         ((void)0)
 #define QS_U16_(data_)                  ((void)0)
@@ -113,6 +122,7 @@
 #define QS_MPC_(ctr_)                   ((void)0)
 #define QS_MPS_(size_)                  ((void)0)
 #define QS_TEC_(ctr_)                   ((void)0)
+#define QS_TRG_VALUE_(kind_, obj_, value_) ((void)0)
 
 #define QF_QS_CRIT_ENTRY()              ((void)0)
 #define QF_QS_CRIT_EXIT()               ((void)0)
@@ -0,0 +1,1184 @@
+/// @file
+/// @brief In-process QUTest harness for POSIX (no QSPY, no sockets)
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+///
+
+#ifndef Q_SPY
+    #error "Q_SPY must be defined for QTEST application"
+#endif // Q_SPY
+
+#define QP_IMPL       // this is QP implementation
+#include "qf_port.h"  // QF port
+#include "qassert.h"  // QP embedded systems-friendly assertions
+#include "qs_port.h"  // include QS port
+#include "qutest_inproc.h" // in-process QUTest harness
+#include "qsdec.h"    // QS decoder (ports/posix/qsdec)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <deque>
+
+#define QS_TX_SIZE    (4*1024)
+#define QS_RX_SIZE    1024
+#define QS_CMD_SIZE   (2*QS_RX_SIZE) // the longest escaped command frame
+#define QUTEST_TIMEOUT_S 10          // default timeout of one test [s]
+
+namespace QP {
+
+Q_DEFINE_THIS_MODULE("qutest_inproc")
+
+//****************************************************************************
+// Matcher of the QS records: formats every record produced by the Target as
+// the QSPY text without the time stamp column (see NOTE2) and queues it for
+// QP::QUTest::expect(). It also keeps the names of the objects and
+// functions from the dictionaries for the commands that refer to them.
+class Matcher : public QSpy::Handler {
+public:
+    virtual void onRecord(QSpy::Decoder const &dec,
+                          QSpy::Record const &rec);
+    virtual void onLost(QSpy::Decoder const &dec, uint32_t n);
+
+    std::deque<std::string> recs; //!< the records not matched yet
+    std::map<std::string, uint64_t> names; //!< objects and functions
+
+private:
+    void obj_(QSpy::Decoder const &dec, uint64_t const obj);
+    void fun_(QSpy::Decoder const &dec, uint64_t const fun);
+    void sig_(QSpy::Decoder const &dec, QSpy::Record const &rec);
+    void format_(QSpy::Decoder const &dec, QSpy::Record const &rec,
+                 char const *fmt);
+    void generic_(QSpy::Decoder const &dec, QSpy::Record const &rec);
+
+    std::string m_line; //!< the record being formatted
+};
+
+// the QSPY texts of the QP records, see Matcher::format_() .................
+struct RecFmt {
+    uint8_t type;
+    char const *fmt;
+};
+static RecFmt const l_recFmt[] = {
+    { QS_QEP_STATE_ENTRY, "===RTC===> St-Entry Obj=%o,State=%f" },
+    { QS_QEP_STATE_EXIT,  "===RTC===> St-Exit  Obj=%o,State=%f" },
+    { QS_QEP_STATE_INIT,  "===RTC===> St-Init  Obj=%o,State=%f->%f" },
+    { QS_QEP_INIT_TRAN,   "Init===> Obj=%o,State=%f" },
+    { QS_QEP_INTERN_TRAN, "=>Intern Obj=%o,Sig=%s,State=%f" },
+    { QS_QEP_TRAN,        "===>Tran Obj=%o,Sig=%s,State=%f->%f" },
+    { QS_QEP_IGNORED,     "=>Ignore Obj=%o,Sig=%s,State=%f" },
+    { QS_QEP_DISPATCH,    "Disp===> Obj=%o,Sig=%s,State=%f" },
+    { QS_QEP_UNHANDLED,   "===RTC===> St-Unhnd Obj=%o,Sig=%s,State=%f" },
+    { QS_QEP_TRAN_HIST,   "===RTC===> St-Hist  Obj=%o,State=%f->%f" },
+    { QS_QEP_TRAN_EP,     "===RTC===> St-EP    Obj=%o,State=%f->%f" },
+    { QS_QEP_TRAN_XP,     "===RTC===> St-XP    Obj=%o,State=%f->%f" },
+    { QS_QF_ACTIVE_ADD,   "AO-Add   Obj=%o,Pri=%n" },
+    { QS_QF_ACTIVE_REMOVE, "AO-Rmv   Obj=%o,Pri=%n" },
+    { QS_QF_ACTIVE_SUBSCRIBE,   "AO-Subsc Obj=%o,Sig=%s" },
+    { QS_QF_ACTIVE_UNSUBSCRIBE, "AO-Unsbs Obj=%o,Sig=%s" },
+    { QS_QF_ACTIVE_POST_FIFO,
+      "AO-Post  Sdr=%o,Obj=%o,Evt<Sig=%s,Pool=%n,Ref=%n>,"
+      "Que<Free=%n,Min=%n>" },
+    { QS_QF_ACTIVE_POST_LIFO,
+      "AO-LIFO  Obj=%o,Evt<Sig=%s,Pool=%n,Ref=%n>,Que<Free=%n,Min=%n>" },
+    { QS_QF_ACTIVE_GET,
+      "AO-Get   Obj=%o,Evt<Sig=%s,Pool=%n,Ref=%n>,Que<Free=%n>" },
+    { QS_QF_ACTIVE_GET_LAST,
+      "AO-GetL  Obj=%o,Evt<Sig=%s,Pool=%n,Ref=%n>" },
+    { QS_QF_ACTIVE_POST_ATTEMPT,
+      "AO-PAtt  Sdr=%o,Obj=%o,Evt<Sig=%s,Pool=%n,Ref=%n>,"
+      "Que<Free=%n,Marg=%n>" },
+    { QS_QF_EQUEUE_POST_FIFO,
+      "EQ-Post  Obj=%o,Evt<Sig=%s,Pool=%n,Ref=%n>,Que<Free=%n,Min=%n>" },
+    { QS_QF_EQUEUE_POST_LIFO,
+      "EQ-LIFO  Obj=%o,Evt<Sig=%s,Pool=%n,Ref=%n>,Que<Free=%n,Min=%n>" },
+    { QS_QF_EQUEUE_GET,
+      "EQ-Get   Obj=%o,Evt<Sig=%s,Pool=%n,Ref=%n>,Que<Free=%n>" },
+    { QS_QF_EQUEUE_GET_LAST,
+      "EQ-GetL  Obj=%o,Evt<Sig=%s,Pool=%n,Ref=%n>" },
+    { QS_QF_EQUEUE_POST_ATTEMPT,
+      "EQ-PAtt  Obj=%o,Evt<Sig=%s,Pool=%n,Ref=%n>,Que<Free=%n,Marg=%n>" },
+    { QS_QF_MPOOL_GET,    "MP-Get   Obj=%o,Free=%n,Min=%n" },
+    { QS_QF_MPOOL_PUT,    "MP-Put   Obj=%o,Free=%n" },
+    { QS_QF_MPOOL_GET_ATTEMPT, "MP-GetA  Obj=%o,Free=%n,Marg=%n" },
+    { QS_QF_PUBLISH,      "QF-Pub   Sdr=%o,Evt<Sig=%s,Pool=%n,Ref=%n>" },
+    { QS_QF_NEW,          "QF-New   Sig=%s,Size=%n" },
+    { QS_QF_GC_ATTEMPT,   "QF-gcA   Evt<Sig=%s,Pool=%n,Ref=%n>" },
+    { QS_QF_GC,           "QF-gc    Evt<Sig=%s,Pool=%n,Ref=%n>" },
+    { QS_QF_TICK,         "Tick<%r> Ctr=%n" },
+    { QS_QF_TIMEEVT_ARM,  "TE%r-Arm  Obj=%o,AO=%o,Tim=%n,Int=%n" },
+    { QS_QF_TIMEEVT_AUTO_DISARM,    "TE%r-ADis Obj=%o,AO=%o" },
+    { QS_QF_TIMEEVT_DISARM_ATTEMPT, "TE%r-DisA Obj=%o,AO=%o" },
+    { QS_QF_TIMEEVT_DISARM, "TE%r-Dis  Obj=%o,AO=%o,Tim=%n,Int=%n" },
+    { QS_QF_TIMEEVT_REARM,
+      "TE%r-Rarm Obj=%o,AO=%o,Tim=%n,Int=%n,Was=%n" },
+    { QS_QF_TIMEEVT_POST, "TE%r-Post Obj=%o,Sig=%s,AO=%o" },
+    { QS_TEST_PROBE_GET,  "TstProbe Fun=%f,Data=%n" },
+    { QS_ASSERT_FAIL,     "=ASSERT= Mod=%S,Loc=%n" },
+    { QS_TEST_PAUSED,     "TstPause" }
+};
+
+//! the names of the QS-RX records (QP::QSpyRxRecords)
+static char_t const * const l_rxName[] = {
+    "INFO", "COMMAND", "RESET", "TICK", "PEEK", "POKE", "FILL",
+    "TEST_SETUP", "TEST_TEARDOWN", "TEST_PROBE", "GLB_FILTER",
+    "LOC_FILTER", "AO_FILTER", "CURR_OBJ", "TEST_CONTINUE", "DICT",
+    "EVENT", "TRIGGER", "EVENTS"
+};
+
+//! the names of the groups of QS records (QP::QSpyRecordGroups)
+static char_t const * const l_grpName[] = {
+    "ALL", "SM", "AO", "EQ", "MP", "TE", "QF", "SC",
+    "U0", "U1", "U2", "U3", "U4", "UA"
+};
+
+//! one registered test
+struct TestInfo {
+    char_t const *name;
+    QUTest::TestFun fun;
+    bool noReset;
+};
+
+// local variables ...........................................................
+static QUTest::TestFun l_preamble[QUTest::MAX_PREAMBLE];
+
+static Matcher l_matcher;
+static QSpy::Decoder l_decoder(l_matcher);
+
+// the hand-over between the Target and the driver thread (see NOTE1)
+static pthread_mutex_t l_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  l_cond  = PTHREAD_COND_INITIALIZER;
+static uint8_t  l_cmdBuf[QS_CMD_SIZE]; // the command frame for the Target
+static uint16_t l_cmdLen;  // the length of the command in l_cmdBuf[]
+static bool     l_idle;    // the Target waits in QS::onTestLoop()
+static bool     l_gone;    // the Target has been reset or has ended
+
+// the driver thread (tests of one group) in the child process
+static uint8_t  l_txSeq;   // the sequence number of the command frames
+static jmp_buf  l_testJmp; // return from a failed test
+static std::string l_failMsg; // the reason of the test failure
+static FILE    *l_report;  // the report of the group for the parent
+static uint_fast16_t l_first; // the first test of the group
+static uint_fast16_t l_last;  // one past the last test of the group
+
+// local helper functions ....................................................
+static std::vector<TestInfo> &tests_(void);
+static bool runner_(char_t const *filter);
+static void *driver_(void *arg);
+static void targetGone_(void);
+static void frame_(uint8_t const recId,
+                   uint8_t const *data, uint16_t const len);
+static void ack_(uint8_t const recId);
+static void event_(uint8_t const prio, enum_t const sig,
+                   void const * const par, uint16_t const len);
+static void obj_(uint8_t const recId, uint_fast8_t const kind,
+                 uint64_t const addr);
+static uint64_t lookup_(char_t const * const name);
+static uint8_t *le_(uint8_t *p, uint64_t v, uint_fast8_t const size);
+
+//****************************************************************************
+// QS callbacks for the in-process harness
+//
+bool QS::onStartup(void const *arg) {
+    static uint8_t qsBuf[QS_TX_SIZE];   // buffer for QS-TX channel
+    static uint8_t qsRxBuf[QS_RX_SIZE]; // buffer for QS-RX channel
+    pthread_t driver;
+
+    // the parent process runs the tests in the child processes and exits,
+    // only the children continue as the freshly reset Targets
+    if (!runner_(static_cast<char_t const *>(arg))) {
+        return false;
+    }
+
+    initBuf(qsBuf, sizeof(qsBuf));
+    rxInitBuf(qsRxBuf, sizeof(qsRxBuf));
+
+    return pthread_create(&driver, static_cast<pthread_attr_t *>(0),
+                          &driver_, static_cast<void *>(0)) == 0;
+}
+//............................................................................
+void QS::onCleanup(void) {
+    targetGone_(); // the Target ended (the application returned from main)
+}
+//............................................................................
+void QS::onReset(void) {
+    targetGone_(); // the group continues only until the next command
+}
+//............................................................................
+void QS::onTestLoop() {
+    uint8_t buf[QS_CMD_SIZE]; // the command, see NOTE1
+    uint16_t n;
+
+    onFlush();
+    pthread_mutex_lock(&l_mutex);
+    rxPriv_.inTestLoop = true;
+    while (rxPriv_.inTestLoop) {
+        l_idle = true;
+        pthread_cond_broadcast(&l_cond);
+        while (l_cmdLen == static_cast<uint16_t>(0)) {
+            pthread_cond_wait(&l_cond, &l_mutex);
+        }
+        l_idle = false;
+        n = l_cmdLen;
+        memcpy(buf, l_cmdBuf, n);
+        l_cmdLen = static_cast<uint16_t>(0);
+        pthread_mutex_unlock(&l_mutex);
+
+        rxParseBlock(&buf[0], n); // execute the command
+        onFlush();
+
+        pthread_mutex_lock(&l_mutex);
+    }
+    // set inTestLoop to true in case calls to QS_onTestLoop() nest,
+    // which can happen through the calls to QS_TEST_PAUSE().
+    rxPriv_.inTestLoop = true;
+    pthread_mutex_unlock(&l_mutex);
+}
+//............................................................................
+void QS::onFlush(void) {
+    uint16_t nBytes = QS_TX_SIZE;
+    uint8_t const *data;
+    while ((data = getBlock(&nBytes)) != static_cast<uint8_t *>(0)) {
+        l_decoder.feed(data, nBytes); // matched by Matcher::onRecord()
+        nBytes = QS_TX_SIZE;
+    }
+}
+
+//****************************************************************************
+QUTest::Test::Test(char_t const * const name, TestFun const fun,
+                   bool const noReset)
+{
+    TestInfo const t = { name, fun, noReset };
+    tests_().push_back(t);
+}
+//............................................................................
+QUTest::Preamble::Preamble(enum PreambleKind const kind, TestFun const fun)
+{
+    /// @pre the preamble kind must be in range
+    Q_REQUIRE_ID(100, kind < MAX_PREAMBLE);
+    l_preamble[kind] = fun;
+}
+//............................................................................
+void QUTest::glbFilter(char_t const * const spec) {
+    uint8_t saved[sizeof(QS::priv_.glbFilter)];
+    uint8_t mask[1 + sizeof(QS::priv_.glbFilter)];
+    char_t word[64];
+    char_t const *s = spec;
+
+    // compute the filter with the QS code itself, see NOTE3
+    memcpy(saved, QS::priv_.glbFilter, sizeof(saved));
+    memset(QS::priv_.glbFilter, 0, sizeof(saved));
+    while (*s != '\0') {
+        uint_fast16_t n = 0U;
+        uint_fast16_t rec = 0x100U;
+        bool const off = (*s == '-');
+        if (off) {
+            ++s;
+        }
+        while ((*s != '\0') && (*s != ' ') && (*s != ',')
+               && (n < sizeof(word) - 1U))
+        {
+            word[n++] = *s++;
+        }
+        while ((*s == ' ') || (*s == ',')) {
+            ++s;
+        }
+        word[n] = '\0';
+        if (n == 0U) {
+            continue;
+        }
+        char_t const *name = (strncmp(word, "QS_", 3) == 0)
+                             ? &word[3] : &word[0];
+        for (n = 0U; n < Q_DIM(l_grpName); ++n) {
+            if (strcmp(name, l_grpName[n]) == 0) {
+                rec = static_cast<uint_fast16_t>(QS_ALL_RECORDS) + n;
+            }
+        }
+        for (n = 1U; (rec == 0x100U) && (n < QS_ALL_RECORDS); ++n) {
+            char_t const *r = l_decoder.recName(static_cast<uint8_t>(n));
+            if ((r != static_cast<char_t const *>(0))
+                && (strcmp(name, r) == 0))
+            {
+                rec = n;
+            }
+        }
+        if (rec == 0x100U) {
+            memcpy(QS::priv_.glbFilter, saved, sizeof(saved));
+            l_failMsg = "unknown QS record or group: ";
+            l_failMsg += word;
+            longjmp(l_testJmp, 1);
+        }
+        if (off) {
+            QS::filterOff(static_cast<uint_fast8_t>(rec));
+        }
+        else {
+            QS::filterOn(static_cast<uint_fast8_t>(rec));
+        }
+    }
+    mask[0] = static_cast<uint8_t>(sizeof(saved));
+    memcpy(&mask[1], QS::priv_.glbFilter, sizeof(saved));
+    memcpy(QS::priv_.glbFilter, saved, sizeof(saved));
+
+    frame_(static_cast<uint8_t>(QS_RX_GLB_FILTER), mask,
+           static_cast<uint16_t>(sizeof(mask)));
+    ack_(static_cast<uint8_t>(QS_RX_GLB_FILTER));
+}
+//............................................................................
+void QUTest::locFilter(uint_fast8_t const kind, void const * const obj) {
+    obj_(static_cast<uint8_t>(QS_RX_LOC_FILTER), kind,
+         static_cast<uint64_t>(reinterpret_cast<uintptr_t>(obj)));
+}
+//............................................................................
+void QUTest::locFilter(uint_fast8_t const kind, char_t const * const name) {
+    obj_(static_cast<uint8_t>(QS_RX_LOC_FILTER), kind, lookup_(name));
+}
+//............................................................................
+void QUTest::currObj(uint_fast8_t const kind, void const * const obj) {
+    obj_(static_cast<uint8_t>(QS_RX_CURR_OBJ), kind,
+         static_cast<uint64_t>(reinterpret_cast<uintptr_t>(obj)));
+}
+//............................................................................
+void QUTest::currObj(uint_fast8_t const kind, char_t const * const name) {
+    obj_(static_cast<uint8_t>(QS_RX_CURR_OBJ), kind, lookup_(name));
+}
+//............................................................................
+void QUTest::command(uint8_t const cmdId, uint32_t const param1,
+                     uint32_t const param2, uint32_t const param3)
+{
+    uint8_t data[13];
+    uint8_t *p = &data[0];
+    *p++ = cmdId;
+    p = le_(p, param1, 4U);
+    p = le_(p, param2, 4U);
+    p = le_(p, param3, 4U);
+    frame_(static_cast<uint8_t>(QS_RX_COMMAND), data,
+           static_cast<uint16_t>(p - &data[0]));
+    ack_(static_cast<uint8_t>(QS_RX_COMMAND));
+}
+//............................................................................
+void QUTest::command(char_t const * const cmdName, uint32_t const param1,
+                     uint32_t const param2, uint32_t const param3)
+{
+    uint_fast16_t rec;
+    for (rec = QS_USER; rec < QS_ALL_RECORDS; ++rec) {
+        char_t const *r = l_decoder.recName(static_cast<uint8_t>(rec));
+        if ((r != static_cast<char_t const *>(0))
+            && (strcmp(cmdName, r) == 0))
+        {
+            break;
+        }
+    }
+    if (rec == QS_ALL_RECORDS) {
+        l_failMsg = "unknown command: ";
+        l_failMsg += cmdName;
+        longjmp(l_testJmp, 1);
+    }
+    command(static_cast<uint8_t>(rec), param1, param2, param3);
+}
+//............................................................................
+void QUTest::init(enum_t const sig, void const * const par,
+                  uint16_t const len)
+{
+    event_(static_cast<uint8_t>(254), sig, par, len);
+}
+//............................................................................
+void QUTest::dispatch(enum_t const sig, void const * const par,
+                      uint16_t const len)
+{
+    event_(static_cast<uint8_t>(255), sig, par, len);
+}
+//............................................................................
+void QUTest::post(enum_t const sig, void const * const par,
+                  uint16_t const len)
+{
+    event_(static_cast<uint8_t>(253), sig, par, len);
+}
+//............................................................................
+void QUTest::publishEvt(enum_t const sig, void const * const par,
+                        uint16_t const len)
+{
+    event_(static_cast<uint8_t>(0), sig, par, len);
+}
+//............................................................................
+void QUTest::events(BatchEvt const * const evts, uint_fast8_t const num) {
+    uint8_t buf[QS_RX_SIZE / 2U];
+    uint8_t *p = &buf[0];
+
+    for (uint_fast8_t i = 0U; i < num; ++i) {
+        BatchEvt const * const e = &evts[i];
+
+        /// @pre the whole batch must fit into one QS-RX frame
+        Q_REQUIRE_ID(310, static_cast<size_t>(p - &buf[0])
+                          + 4U + Q_SIGNAL_SIZE + e->len <= sizeof(buf));
+        *p++ = e->prio;
+        *p++ = e->ticks;
+        p = le_(p, static_cast<uint64_t>(e->sig), Q_SIGNAL_SIZE);
+        p = le_(p, e->len, 2U);
+        if (e->len != 0U) {
+            memcpy(p, e->par, e->len);
+            p += e->len;
+        }
+    }
+    frame_(static_cast<uint8_t>(QS_RX_EVENTS), buf,
+           static_cast<uint16_t>(p - &buf[0]));
+    ack_(static_cast<uint8_t>(QS_RX_EVENTS));
+}
+//............................................................................
+void QUTest::tickX(uint_fast8_t const tickRate) {
+    uint8_t const rate = static_cast<uint8_t>(tickRate);
+    frame_(static_cast<uint8_t>(QS_RX_TICK), &rate,
+           static_cast<uint16_t>(1));
+    ack_(static_cast<uint8_t>(QS_RX_TICK));
+}
+//............................................................................
+void QUTest::peek(uint16_t const offs, uint8_t const size,
+                  uint8_t const num)
+{
+    uint8_t data[4];
+    uint8_t *p = le_(&data[0], offs, 2U);
+    *p++ = size;
+    *p++ = num;
+    // no Trg-Ack, the Target responds with the Trg-Peek record
+    frame_(static_cast<uint8_t>(QS_RX_PEEK), data,
+           static_cast<uint16_t>(p - &data[0]));
+}
+//............................................................................
+void QUTest::poke(uint16_t const offs, uint8_t const size,
+                  void const * const data, uint8_t const num)
+{
+    uint8_t buf[4 + (255 * 4)];
+    uint_fast16_t const n = static_cast<uint_fast16_t>(size) * num;
+    uint8_t *p = le_(&buf[0], offs, 2U);
+
+    /// @pre the poked data must fit into one QS-RX frame
+    Q_REQUIRE_ID(200, (size <= 4U) && (4U + n <= QS_RX_SIZE / 2U));
+    *p++ = size;
+    *p++ = num;
+    memcpy(p, data, n);
+    frame_(static_cast<uint8_t>(QS_RX_POKE), buf,
+           static_cast<uint16_t>(4U + n));
+    ack_(static_cast<uint8_t>(QS_RX_POKE));
+}
+//............................................................................
+void QUTest::fill(uint16_t const offs, uint8_t const size,
+                  uint8_t const num, uint32_t const item)
+{
+    uint8_t data[8];
+    uint8_t *p = le_(&data[0], offs, 2U);
+    *p++ = size;
+    *p++ = num;
+    p = le_(p, item, size);
+    frame_(static_cast<uint8_t>(QS_RX_FILL), data,
+           static_cast<uint16_t>(p - &data[0]));
+    ack_(static_cast<uint8_t>(QS_RX_FILL));
+}
+//............................................................................
+void QUTest::probe(char_t const * const funName, uint32_t const data) {
+    uint8_t buf[4 + QS_FUN_PTR_SIZE];
+    uint8_t *p = le_(&buf[0], data, 4U);
+    p = le_(p, lookup_(funName), QS_FUN_PTR_SIZE);
+    frame_(static_cast<uint8_t>(QS_RX_TEST_PROBE), buf,
+           static_cast<uint16_t>(p - &buf[0]));
+    ack_(static_cast<uint8_t>(QS_RX_TEST_PROBE));
+}
+//............................................................................
+void QUTest::testContinue(void) {
+    frame_(static_cast<uint8_t>(QS_RX_TEST_CONTINUE),
+           static_cast<uint8_t const *>(0), static_cast<uint16_t>(0));
+    ack_(static_cast<uint8_t>(QS_RX_TEST_CONTINUE));
+}
+//............................................................................
+void QUTest::expect(char_t const * const pattern) {
+    if (l_matcher.recs.empty()) {
+        l_failMsg = "expected: ";
+        l_failMsg += pattern;
+        l_failMsg += "\n received: (nothing)";
+        longjmp(l_testJmp, 1);
+    }
+    if (fnmatch(pattern, l_matcher.recs.front().c_str(), 0) != 0) {
+        l_failMsg = "expected: ";
+        l_failMsg += pattern;
+        l_failMsg += "\n received: ";
+        l_failMsg += l_matcher.recs.front();
+        longjmp(l_testJmp, 1);
+    }
+    l_matcher.recs.pop_front();
+}
+//............................................................................
+void QUTest::fail(char_t const * const msg) {
+    l_failMsg = msg;
+    longjmp(l_testJmp, 1);
+}
+
+//****************************************************************************
+// the driver thread, see NOTE1
+//
+static void *driver_(void *arg) {
+    bool volatile skip = false; // volatile for setjmp()
+    (void)arg;
+
+    // wait for the Target to get ready for the commands
+    pthread_mutex_lock(&l_mutex);
+    while ((!l_idle) && (!l_gone)) {
+        pthread_cond_wait(&l_cond, &l_mutex);
+    }
+    pthread_mutex_unlock(&l_mutex);
+
+    unsigned timeout = static_cast<unsigned>(QUTEST_TIMEOUT_S);
+    if (getenv("QUTEST_TIMEOUT") != static_cast<char *>(0)) {
+        timeout = static_cast<unsigned>(atoi(getenv("QUTEST_TIMEOUT")));
+    }
+
+    for (uint_fast16_t i = l_first; i < l_last; ++i) {
+        TestInfo const &t = tests_()[i];
+        alarm(timeout); // the Target must finish the test in time
+        if (skip) {
+            fprintf(l_report, "S %s\n", t.name);
+        }
+        else if (setjmp(l_testJmp) == 0) {
+            if ((i == l_first) && (l_preamble[QUTest::ON_RESET] != 0)) {
+                (*l_preamble[QUTest::ON_RESET])();
+            }
+            frame_(static_cast<uint8_t>(QS_RX_TEST_SETUP),
+                   static_cast<uint8_t const *>(0),
+                   static_cast<uint16_t>(0));
+            ack_(static_cast<uint8_t>(QS_RX_TEST_SETUP));
+            if (l_preamble[QUTest::ON_SETUP] != 0) {
+                (*l_preamble[QUTest::ON_SETUP])();
+            }
+
+            (*t.fun)(); // run the test
+
+            if (!l_gone) {
+                frame_(static_cast<uint8_t>(QS_RX_TEST_TEARDOWN),
+                       static_cast<uint8_t const *>(0),
+                       static_cast<uint16_t>(0));
+                ack_(static_cast<uint8_t>(QS_RX_TEST_TEARDOWN));
+                if (l_preamble[QUTest::ON_TEARDOWN] != 0) {
+                    (*l_preamble[QUTest::ON_TEARDOWN])();
+                }
+            }
+            if (!l_matcher.recs.empty()) {
+                QUTest::fail(("unexpected: "
+                              + l_matcher.recs.front()).c_str());
+            }
+            fprintf(l_report, "P %s\n", t.name);
+        }
+        else {
+            // the state of the Target is not known after the failure,
+            // so the rest of the group (the "noreset" tests) is skipped
+            fprintf(l_report, "F %s\n %s\n", t.name, l_failMsg.c_str());
+            skip = true;
+        }
+        fflush(l_report);
+    }
+    _exit(0);
+    return arg;
+}
+//............................................................................
+static void frame_(uint8_t const recId,
+                   uint8_t const *data, uint16_t const len)
+{
+    uint8_t chksum = static_cast<uint8_t>(0);
+    uint16_t n = static_cast<uint16_t>(0);
+    uint8_t b;
+
+    if (l_gone) {
+        l_failMsg = "the Target has been reset";
+        longjmp(l_testJmp, 1);
+    }
+    if (!l_matcher.recs.empty()) {
+        l_failMsg = "unexpected: " + l_matcher.recs.front();
+        longjmp(l_testJmp, 1);
+    }
+
+    // [seq][recId][data...][checksum][QS_FRAME], see qs_rx.cpp
+    for (int_t i = -2; i <= static_cast<int_t>(len); ++i) {
+        if (i == -2) {
+            ++l_txSeq;
+            b = l_txSeq;
+        }
+        else if (i == -1) {
+            b = recId;
+        }
+        else if (i < static_cast<int_t>(len)) {
+            b = data[i];
+        }
+        else {
+            b = static_cast<uint8_t>(~chksum);
+        }
+        chksum = static_cast<uint8_t>(chksum + b);
+        if ((b == static_cast<uint8_t>(0x7E))
+            || (b == static_cast<uint8_t>(0x7D)))
+        {
+            l_cmdBuf[n++] = static_cast<uint8_t>(0x7D);
+            b ^= static_cast<uint8_t>(0x20);
+        }
+        l_cmdBuf[n++] = b;
+    }
+    l_cmdBuf[n++] = static_cast<uint8_t>(0x7E);
+
+    // hand the command over to the Target and wait until it is done
+    pthread_mutex_lock(&l_mutex);
+    l_cmdLen = n;
+    pthread_cond_broadcast(&l_cond);
+    while ((!l_gone)
+           && ((l_cmdLen != static_cast<uint16_t>(0)) || (!l_idle)))
+    {
+        pthread_cond_wait(&l_cond, &l_mutex);
+    }
+    pthread_mutex_unlock(&l_mutex);
+}
+//............................................................................
+static void ack_(uint8_t const recId) {
+    std::string ack("Trg-Ack QS_RX_");
+    ack += l_rxName[recId];
+    if (l_matcher.recs.empty() || (l_matcher.recs.front() != ack)) {
+        l_failMsg = "expected: " + ack + "\n received: "
+            + (l_matcher.recs.empty()
+               ? std::string("(nothing)")
+               : l_matcher.recs.front());
+        longjmp(l_testJmp, 1);
+    }
+    l_matcher.recs.pop_front();
+}
+//............................................................................
+static void event_(uint8_t const prio, enum_t const sig,
+                   void const * const par, uint16_t const len)
+{
+    uint8_t buf[QS_RX_SIZE / 2U];
+    uint8_t *p = &buf[0];
+
+    /// @pre the event parameters must fit into one QS-RX frame
+    Q_REQUIRE_ID(300, len <= sizeof(buf) - 3U - Q_SIGNAL_SIZE);
+    *p++ = prio;
+    p = le_(p, static_cast<uint64_t>(sig), Q_SIGNAL_SIZE);
+    p = le_(p, len, 2U);
+    if (len != 0U) {
+        memcpy(p, par, len);
+        p += len;
+    }
+    frame_(static_cast<uint8_t>(QS_RX_EVENT), buf,
+           static_cast<uint16_t>(p - &buf[0]));
+    ack_(static_cast<uint8_t>(QS_RX_EVENT));
+}
+//............................................................................
+static void obj_(uint8_t const recId, uint_fast8_t const kind,
+                 uint64_t const addr)
+{
+    uint8_t buf[1 + QS_OBJ_PTR_SIZE];
+    uint8_t *p = &buf[0];
+    *p++ = static_cast<uint8_t>(kind);
+    p = le_(p, addr, QS_OBJ_PTR_SIZE);
+    frame_(recId, buf, static_cast<uint16_t>(p - &buf[0]));
+    ack_(recId);
+}
+//............................................................................
+static uint64_t lookup_(char_t const * const name) {
+    std::map<std::string, uint64_t>::const_iterator const it
+        = l_matcher.names.find(name);
+    if (it == l_matcher.names.end()) {
+        l_failMsg = "unknown object or function: ";
+        l_failMsg += name;
+        longjmp(l_testJmp, 1);
+    }
+    return it->second;
+}
+//............................................................................
+static uint8_t *le_(uint8_t *p, uint64_t v, uint_fast8_t const size) {
+    for (uint_fast8_t i = 0U; i < size; ++i) {
+        *p++ = static_cast<uint8_t>(v);
+        v >>= 8;
+    }
+    return p;
+}
+//............................................................................
+static void targetGone_(void) {
+    QS::onFlush();
+    pthread_mutex_lock(&l_mutex);
+    l_gone = true;
+    pthread_cond_broadcast(&l_cond);
+    for (;;) { // the driver thread ends the process
+        pthread_cond_wait(&l_cond, &l_mutex);
+    }
+}
+//............................................................................
+static std::vector<TestInfo> &tests_(void) {
+    static std::vector<TestInfo> tests; // constructed on the first use
+    return tests;
+}
+
+//****************************************************************************
+// the runner in the parent process, see NOTE1
+//
+static bool runner_(char_t const *filter) {
+    struct Group {
+        uint_fast16_t first;
+        uint_fast16_t last;
+        pid_t pid;
+        FILE *report;
+        int status;
+        bool done;
+    };
+    std::vector<TestInfo> const &tests = tests_();
+    std::vector<Group> groups;
+    uint_fast16_t nTests = 0U;
+    uint_fast16_t nFailed = 0U;
+    uint_fast16_t nSkipped = 0U;
+    struct timespec t0;
+    struct timespec t1;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (getenv("QUTEST_JOBS") != static_cast<char *>(0)) {
+        jobs = atol(getenv("QUTEST_JOBS"));
+    }
+    if (jobs < 1) {
+        jobs = 1;
+    }
+
+    // the groups of tests: a test with the reset and its "noreset" tests
+    for (uint_fast16_t i = 0U; i < tests.size(); ++i) {
+        if (groups.empty() || (!tests[i].noReset)) {
+            Group const g = { i, i, 0, 0, 0, false };
+            groups.push_back(g);
+        }
+        ++groups.back().last;
+    }
+    // select the groups with a test matching the filter
+    if (filter != static_cast<char_t const *>(0)) {
+        std::vector<Group> sel;
+        for (uint_fast16_t i = 0U; i < groups.size(); ++i) {
+            for (uint_fast16_t j = groups[i].first; j < groups[i].last; ++j)
+            {
+                if (fnmatch(filter, tests[j].name, 0) == 0) {
+                    sel.push_back(groups[i]);
+                    break;
+                }
+            }
+        }
+        groups.swap(sel);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    fflush(stdout);
+    fflush(stderr);
+
+    uint_fast16_t next = 0U;
+    uint_fast16_t printed = 0U;
+    long running = 0;
+    while (printed < groups.size()) {
+        // start the groups up to the number of jobs
+        while ((running < jobs) && (next < groups.size())) {
+            Group &g = groups[next];
+            g.report = tmpfile();
+            Q_ASSERT_ID(400, g.report != static_cast<FILE *>(0));
+            g.pid = fork();
+            Q_ASSERT_ID(410, g.pid >= 0);
+            if (g.pid == 0) { // the child becomes the Target?
+                l_first  = g.first;
+                l_last   = g.last;
+                l_report = g.report;
+                return true;
+            }
+            ++running;
+            ++next;
+        }
+
+        // wait for any group to finish
+        int status;
+        pid_t const pid = wait(&status);
+        Q_ASSERT_ID(420, pid > 0);
+        for (uint_fast16_t i = 0U; i < next; ++i) {
+            if (groups[i].pid == pid) {
+                groups[i].status = status;
+                groups[i].done = true;
+                --running;
+            }
+        }
+
+        // print the reports of the finished groups in the order of tests
+        while ((printed < groups.size()) && groups[printed].done) {
+            Group &g = groups[printed];
+            uint_fast16_t n = g.first;
+            char line[1024];
+            rewind(g.report);
+            while (fgets(line, sizeof(line), g.report) != 0) {
+                switch (line[0]) {
+                    case 'P':
+                        printf("[ PASS ] %s", &line[2]);
+                        ++n;
+                        break;
+                    case 'F':
+                        printf("[ FAIL ] %s", &line[2]);
+                        ++nFailed;
+                        ++n;
+                        break;
+                    case 'S':
+                        printf("[ SKIP ] %s", &line[2]);
+                        ++nSkipped;
+                        ++n;
+                        break;
+                    default:
+                        printf("        %s", line);
+                        break;
+                }
+            }
+            fclose(g.report);
+            // the tests not reported by a crashed (or hung) Target
+            for (bool first = true; n < g.last; ++n, first = false) {
+                if (first) {
+                    printf("[ FAIL ] %s\n", tests[n].name);
+                    if (WIFSIGNALED(g.status)) {
+                        printf("         the Target %s (signal %d)\n",
+                               (WTERMSIG(g.status) == SIGALRM)
+                               ? "timed out" : "crashed",
+                               WTERMSIG(g.status));
+                    }
+                    else {
+                        printf("         the Target exited (status %d)\n",
+                               WEXITSTATUS(g.status));
+                    }
+                    ++nFailed;
+                }
+                else {
+                    printf("[ SKIP ] %s\n", tests[n].name);
+                    ++nSkipped;
+                }
+            }
+            nTests += g.last - g.first;
+            ++printed;
+        }
+        fflush(stdout);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("=================== SUMMARY ===================\n");
+    printf("# tests: %u, # failures: %u, # skipped: %u "
+           "(%.3fs, %ld jobs)\n",
+           static_cast<unsigned>(nTests), static_cast<unsigned>(nFailed),
+           static_cast<unsigned>(nSkipped),
+           static_cast<double>(t1.tv_sec - t0.tv_sec)
+           + static_cast<double>(t1.tv_nsec - t0.tv_nsec) * 1e-9,
+           jobs);
+    printf("%s\n", (nFailed == 0U) ? "OK" : "FAIL");
+    fflush(stdout);
+    exit((nFailed == 0U) ? 0 : 1);
+    return false;
+}
+
+//****************************************************************************
+void Matcher::onRecord(QSpy::Decoder const &dec, QSpy::Record const &rec) {
+    m_line.clear();
+    switch (rec.type) {
+        case QS_EMPTY:        // intentionally fall through
+        case QS_SIG_DICT:
+        case QS_USR_DICT:
+        case QS_TARGET_INFO:
+        case QS_SAMPLE_CFG:
+            return; // not matched
+        case QS_OBJ_DICT:
+            names[rec.str] = rec.obj[0];
+            return;
+        case QS_FUN_DICT:
+            names[rec.str] = rec.fun[0];
+            return;
+        case QS_RX_STATUS: {
+            uint8_t const s = static_cast<uint8_t>(rec.num[0]);
+            uint8_t const id = static_cast<uint8_t>(s & 0x7FU);
+            m_line = ((s & 0x80U) != 0U) ? "Trg-ERR " : "Trg-Ack ";
+            if (id < Q_DIM(l_rxName)) {
+                m_line += "QS_RX_";
+                m_line += l_rxName[id];
+            }
+            else {
+                QSpy::appendHex(&m_line, id);
+            }
+            break;
+        }
+        case QS_TARGET_DONE: {
+            m_line = "Trg-Done QS_RX_";
+            if (rec.num[0] < Q_DIM(l_rxName)) {
+                m_line += l_rxName[rec.num[0]];
+            }
+            break;
+        }
+        case QS_PEEK_DATA: {
+            char buf[16];
+            uint_fast8_t const size = static_cast<uint_fast8_t>(rec.num[1]);
+            m_line = "Trg-Peek Offs=";
+            QSpy::appendUint(&m_line, rec.num[0]);
+            m_line += ",Size=";
+            QSpy::appendUint(&m_line, size);
+            m_line += ",Num=";
+            QSpy::appendUint(&m_line, rec.num[2]);
+            m_line += ",Data=<";
+            for (size_t i = 0U; (size != 0U) && (i + size <= rec.len);
+                 i += size)
+            {
+                uint64_t v = 0U;
+                for (uint_fast8_t j = size; j > 0U; --j) {
+                    v = (v << 8) | rec.data[i + j - 1U];
+                }
+                snprintf(buf, sizeof(buf), "%s%0*llX",
+                         (i == 0U) ? "" : ",", static_cast<int>(2U * size),
+                         static_cast<unsigned long long>(v));
+                m_line += buf;
+            }
+            m_line += '>';
+            break;
+        }
+        default: {
+            if (rec.type >= QS_USER) {
+                char_t const *name = dec.recName(rec.type);
+                if (name != static_cast<char_t const *>(0)) {
+                    m_line = name;
+                }
+                else {
+                    m_line = "USER+";
+                    QSpy::appendUint(&m_line, rec.type - QS_USER);
+                }
+                dec.formatItems(rec, &m_line);
+                break;
+            }
+            uint_fast8_t i;
+            for (i = 0U; i < Q_DIM(l_recFmt); ++i) {
+                if (l_recFmt[i].type == rec.type) {
+                    break;
+                }
+            }
+            if (i < Q_DIM(l_recFmt)) {
+                format_(dec, rec, l_recFmt[i].fmt);
+            }
+            else {
+                generic_(dec, rec);
+            }
+            break;
+        }
+    }
+    recs.push_back(m_line);
+}
+//............................................................................
+void Matcher::onLost(QSpy::Decoder const &dec, uint32_t n) {
+    (void)dec;
+    m_line = "QS records lost: ";
+    QSpy::appendUint(&m_line, n);
+    recs.push_back(m_line);
+}
+//............................................................................
+void Matcher::obj_(QSpy::Decoder const &dec, uint64_t const obj) {
+    char_t const *name = dec.objName(obj);
+    if (name != static_cast<char_t const *>(0)) {
+        m_line += name;
+    }
+    else if (obj == 0U) {
+        m_line += "NULL";
+    }
+    else {
+        QSpy::appendHex(&m_line, obj);
+    }
+}
+//............................................................................
+void Matcher::fun_(QSpy::Decoder const &dec, uint64_t const fun) {
+    char_t const *name = dec.funName(fun);
+    if (name != static_cast<char_t const *>(0)) {
+        m_line += name;
+    }
+    else if (fun == 0U) {
+        m_line += "NULL";
+    }
+    else {
+        QSpy::appendHex(&m_line, fun);
+    }
+}
+//............................................................................
+void Matcher::sig_(QSpy::Decoder const &dec, QSpy::Record const &rec) {
+    char_t const *name = static_cast<char_t const *>(0);
+    // the signal can be specific to any object in the record
+    for (uint_fast8_t i = 0U;
+         (name == static_cast<char_t const *>(0)) && (i < rec.nObj); ++i)
+    {
+        name = dec.sigName(rec.sig, rec.obj[i]);
+    }
+    if (name == static_cast<char_t const *>(0)) {
+        name = dec.sigName(rec.sig, 0U);
+    }
+    if (name != static_cast<char_t const *>(0)) {
+        m_line += name;
+    }
+    else {
+        QSpy::appendUint(&m_line, rec.sig);
+    }
+}
+//............................................................................
+// %o - next object, %f - next function, %s - signal, %n - next number,
+// %r - the tick rate (not consumed by %n), %S - string
+void Matcher::format_(QSpy::Decoder const &dec, QSpy::Record const &rec,
+                      char const *fmt)
+{
+    uint_fast8_t nObj = 0U;
+    uint_fast8_t nFun = 0U;
+    uint_fast8_t nNum = 0U;
+    uint_fast8_t rate = 0xFFU;
+
+    if (strstr(fmt, "%r") != static_cast<char const *>(0)) {
+        // the tick rate follows the counters of the time events
+        rate = static_cast<uint_fast8_t>(
+            (rec.type == QS_QF_TIMEEVT_REARM) ? 2U : (rec.nNum - 1U));
+    }
+    for (; *fmt != '\0'; ++fmt) {
+        if (*fmt != '%') {
+            m_line += *fmt;
+            continue;
+        }
+        ++fmt;
+        switch (*fmt) {
+            case 'o':
+                obj_(dec, (nObj < rec.nObj) ? rec.obj[nObj] : 0U);
+                ++nObj;
+                break;
+            case 'f':
+                fun_(dec, (nFun < rec.nFun) ? rec.fun[nFun] : 0U);
+                ++nFun;
+                break;
+            case 's':
+                sig_(dec, rec);
+                break;
+            case 'n':
+                if (nNum == rate) {
+                    ++nNum;
+                }
+                QSpy::appendUint(&m_line,
+                                 (nNum < rec.nNum) ? rec.num[nNum] : 0U);
+                ++nNum;
+                break;
+            case 'r':
+                QSpy::appendUint(&m_line,
+                                 (rate < rec.nNum) ? rec.num[rate] : 0U);
+                break;
+            case 'S':
+                m_line += (rec.str != static_cast<char const *>(0))
+                          ? rec.str : "";
+                break;
+            default:
+                m_line += *fmt;
+                break;
+        }
+    }
+}
+//............................................................................
+void Matcher::generic_(QSpy::Decoder const &dec, QSpy::Record const &rec) {
+    char_t const *name = dec.recName(rec.type);
+    if (name != static_cast<char_t const *>(0)) {
+        m_line = name;
+    }
+    else {
+        m_line = "Rec=";
+        QSpy::appendUint(&m_line, rec.type);
+    }
+    for (uint_fast8_t i = 0U; i < rec.nObj; ++i) {
+        m_line += (i == 0U) ? " Obj=" : ",Obj=";
+        obj_(dec, rec.obj[i]);
+    }
+    for (uint_fast8_t i = 0U; i < rec.nFun; ++i) {
+        m_line += " Fun=";
+        fun_(dec, rec.fun[i]);
+    }
+    if (rec.hasSig) {
+        m_line += " Sig=";
+        sig_(dec, rec);
+    }
+    for (uint_fast8_t i = 0U; i < rec.nNum; ++i) {
+        m_line += ' ';
+        QSpy::appendUint(&m_line, rec.num[i]);
+    }
+    if (rec.str != static_cast<char const *>(0)) {
+        m_line += ' ';
+        m_line += rec.str;
+    }
+}
+
+} // namespace QP
+
+//****************************************************************************
+// NOTE1:
+// The harness runs every group of tests (a test with the reset of the Target
+// followed by its "noreset" tests) in a separate child process, forked at
+// the start of the Target, when the application calls QS_INIT(). The child
+// is thus the freshly reset Target, and the groups run in parallel (the
+// number of the processes is set by the QUTEST_JOBS environment variable,
+// by default the number of the CPUs). The parent only collects the reports
+// of the groups, prints them in the order of the tests, and exits with the
+// status 1 if any test failed. The optional argument of QS_INIT() selects
+// the groups with at least one test matching the glob pattern.
+//
+// In the child, the Target keeps the main thread and the tests run in the
+// driver thread. The two threads strictly alternate: the Target waits in
+// QS::onTestLoop() for a command frame, executes it by the same QS-RX parser
+// (QP::QS::rxParseBlock()) that serves the QSPY socket, and signals the
+// driver when it gets back to QS::onTestLoop(). The commands are thus
+// synchronous, and every QS record they produce is already decoded and
+// queued for QP::QUTest::expect() when the command returns. The commands
+// QP::QUTest::testContinue() and QS_TEST_PAUSE() work as with QSPY, because
+// the Target runs the application code between the calls to
+// QS::onTestLoop() in its own thread.
+//
+// A test that fails (QP::QUTest::expect() or an unexpected record) returns
+// to the driver by longjmp(). The tests do not own any resources, so it is
+// safe. A Target that crashes, resets, or does not respond for
+// QUTEST_TIMEOUT seconds (10 by default) fails the test it runs.
+//
+// NOTE2:
+// The records are formatted as the QSPY text without the time stamp column,
+// for the records used in the QUTest scripts (e.g., "Trg-Done QS_RX_EVENT",
+// "===>Tran Obj=the_hsm,Sig=A_SIG,State=s21->s211", or the user records from
+// their dictionaries), so the expectations can be taken over from the
+// scripts by dropping the "%timestamp " prefix. The other QP records are
+// formatted generically as the record name followed by the fields. The
+// dictionaries and the Target info are not matched.
+//
+// NOTE3:
+// The global filter is computed by the same QP::QS::filterOn() and
+// QP::QS::filterOff() as in the Target (on a saved and restored copy of the
+// filter) and then sent as the QS_RX_GLB_FILTER command. This is safe,
+// because the Target waits for the command in QS::onTestLoop().
+//
@@ -0,0 +1,213 @@
+/// @file
+/// @brief In-process QUTest harness for POSIX (no QSPY, no sockets)
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+
+#ifndef qutest_inproc_h
+#define qutest_inproc_h
+
+namespace QP {
+
+//****************************************************************************
+//! In-process QUTest harness
+/// @description
+/// The harness replaces the QUTest port (qutest_port.cpp) together with
+/// QSPY and the Tcl test scripts. The tests are C++ functions linked into
+/// the QUTest application. They send the same QS-RX commands as the
+/// scripts, but the commands are handed directly to QP::QS::rxParseBlock()
+/// and the produced QS records are decoded (QSpy::Decoder) and matched
+/// against the expectations in memory. See NOTE1 in qutest_inproc.cpp.
+///
+/// Every command checks the Target acknowledgement (Trg-Ack) itself. All
+/// other records must be matched by QP::QUTest::expect() in the order of
+/// their production, before the next command and before the end of the
+/// test. The first failed expectation ends the test.
+///
+/// @usage
+/// @code
+/// static void test_dispatch(void) {
+///     QUTest::dispatch(A_SIG);
+///     QUTest::expect("BSP_DISPLAY s21-A;");
+///     QUTest::expect("Trg-Done QS_RX_EVENT");
+/// }
+/// static QUTest::Test const t1("QHsmTst dispatch", &test_dispatch);
+/// @endcode
+///
+class QUTest {
+public:
+    //! Test or preamble function
+    typedef void (*TestFun)(void);
+
+    //! Registration of a test (a static object in the test application)
+    /// @description
+    /// The tests run in the order of their registration. A test without
+    /// @p noReset starts in the freshly reset Target (a new process), and
+    /// the following @p noReset tests continue in the same Target, like the
+    /// "test -noreset" in the QUTest scripts.
+    class Test {
+    public:
+        Test(char_t const * const name, TestFun const fun,
+             bool const noReset = false);
+    };
+
+    //! The kinds of the preamble functions (see QP::QUTest::Preamble)
+    enum PreambleKind {
+        ON_RESET,    //!< after every reset of the Target
+        ON_SETUP,    //!< after the test setup of every test
+        ON_TEARDOWN, //!< after the test teardown of every test
+        MAX_PREAMBLE
+    };
+
+    //! Registration of a preamble function (a static object)
+    /// @description
+    /// The preamble functions correspond to on_reset, on_setup and
+    /// on_teardown procedures of the QUTest scripts.
+    class Preamble {
+    public:
+        Preamble(enum PreambleKind const kind, TestFun const fun);
+    };
+
+    //! The kind of the object for both the SM and AO local filters and
+    //! current objects (in addition to QP::QS::SM_OBJ, QP::QS::AO_OBJ...)
+    enum { SM_AO_OBJ = QS::MAX_OBJ };
+
+    //! Set the global filters (e.g., "SM AO UA" or "ALL -QF")
+    /// @description
+    /// The words are the record groups ALL, SM, AO, QF, TE, EQ, MP, SC,
+    /// U0..U4 and UA, or the names of the records (e.g., QEP_DISPATCH or
+    /// a user record from its dictionary). The '-' prefix excludes the
+    /// records from the filter.
+    static void glbFilter(char_t const * const spec);
+
+    //! Set the local filter of the object @p obj of the @p kind
+    /// (QP::QS::SM_OBJ, QP::QS::AO_OBJ, ...)
+    static void locFilter(uint_fast8_t const kind, void const * const obj);
+
+    //! Set the local filter by the object @p name from the dictionary
+    static void locFilter(uint_fast8_t const kind, char_t const * const name);
+
+    //! Set the current object of the @p kind (QP::QS::SM_OBJ, ...)
+    static void currObj(uint_fast8_t const kind, void const * const obj);
+
+    //! Set the current object by the object @p name from the dictionary
+    static void currObj(uint_fast8_t const kind, char_t const * const name);
+
+    //! Execute the user command QP::QS::onCommand() in the Target
+    static void command(uint8_t const cmdId,
+                        uint32_t const param1 = 0U,
+                        uint32_t const param2 = 0U,
+                        uint32_t const param3 = 0U);
+
+    //! Execute the user command named in the user-record dictionary
+    /// (the same name lookup as in the QUTest scripts)
+    static void command(char_t const * const cmdName,
+                        uint32_t const param1 = 0U,
+                        uint32_t const param2 = 0U,
+                        uint32_t const param3 = 0U);
+
+    //! Take the top-most initial transition of the current SM object
+    static void init(enum_t const sig = 0,
+                     void const * const par = static_cast<void *>(0),
+                     uint16_t const len = 0U);
+
+    //! Dispatch the event to the current SM object
+    static void dispatch(enum_t const sig,
+                         void const * const par = static_cast<void *>(0),
+                         uint16_t const len = 0U);
+
+    //! Post the event to the current AO object
+    static void post(enum_t const sig,
+                     void const * const par = static_cast<void *>(0),
+                     uint16_t const len = 0U);
+
+    //! Publish the event (not publish(), the deprecated macro in qpcpp.h)
+    static void publishEvt(enum_t const sig,
+                           void const * const par = static_cast<void *>(0),
+                           uint16_t const len = 0U);
+
+    //! One event of the batch injected by QP::QUTest::events()
+    struct BatchEvt {
+        uint8_t prio;     //!< 0 to publish, 253 to post to the current AO
+                          //!< object, or the priority of the AO to post to
+        uint8_t ticks;    //!< clock ticks (rate 0) to process before
+        enum_t sig;       //!< signal of the event
+        void const *par;  //!< parameters of the event (or NULL)
+        uint16_t len;     //!< length of the parameters
+    };
+
+    //! Inject the batch of @p num events @p evts in one QS_RX_EVENTS
+    /// frame (a single Trg-Ack and a single Trg-Done or Trg-ERR)
+    static void events(BatchEvt const * const evts,
+                       uint_fast8_t const num);
+
+    //! Process the clock tick of the @p tickRate (not tick(), the
+    //! deprecated macro in qpcpp.h)
+    static void tickX(uint_fast8_t const tickRate = 0U);
+
+    //! Peek @p num items of @p size bytes at @p offs in the current AP
+    /// object (produces the Trg-Peek record)
+    static void peek(uint16_t const offs, uint8_t const size,
+                     uint8_t const num);
+
+    //! Poke @p num items of @p size bytes from @p data at @p offs in the
+    /// current AP object
+    static void poke(uint16_t const offs, uint8_t const size,
+                     void const * const data, uint8_t const num);
+
+    //! Fill @p num items of @p size bytes at @p offs in the current AP
+    /// object with the @p item
+    static void fill(uint16_t const offs, uint8_t const size,
+                     uint8_t const num, uint32_t const item);
+
+    //! Set the Test-Probe @p data for the function @p funName
+    static void probe(char_t const * const funName, uint32_t const data);
+
+    //! Continue the test paused with QS_TEST_PAUSE()
+    static void testContinue(void);
+
+    //! Match the next record produced by the Target with the @p pattern
+    /// @description
+    /// The pattern is matched as the glob pattern ('*' and '?') against
+    /// the whole text of the record, which is formatted without the time
+    /// stamp like in QSPY (e.g., "Trg-Done QS_RX_EVENT" or "COMMAND_X 0").
+    static void expect(char_t const * const pattern);
+
+    //! Fail the current test with the message @p msg
+    static void fail(char_t const * const msg);
+};
+
+} // namespace QP
+
+#endif // qutest_inproc_h
@@ -225,18 +225,9 @@ void QS::onTestLoop() {
             if (FD_ISSET(l_sock, &readSet)) { /* socket ready to read? */
                 uint8_t buf[QS_RX_SIZE];
                 int status = recv(l_sock, (char *)buf, (int)sizeof(buf), 0);
-                while (status > 0) { /* any data received? */
-                    uint8_t *pb;
-                    int i = (int)rxGetNfree();
-                    if (i > status) {
-                        i = status;
-                    }
-                    status -= i;
-                    /* reorder the received bytes into QS-RX buffer */
-                    for (pb = &buf[0]; i > 0; --i, ++pb) {
-                        rxPut(*pb);
-                    }
-                    rxParse(); /* parse all n-bytes of data */
+                if (status > 0) { /* any data received? */
+                    /* parse the received frames in place */
+                    rxParseBlock(&buf[0], (uint16_t)status);
                 }
             }
             if (FD_ISSET(0, &readSet)) { /* console/terminal redy to read? */
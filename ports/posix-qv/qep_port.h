@@ -0,0 +1,72 @@
+/// \file
+/// \brief QEP/C++ port to generic C++ compiler
+/// \cond
+///***************************************************************************
+/// Last updated for version 5.4.0
+/// Last updated on  2015-03-14
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps, www.state-machine.com.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// Web:   www.state-machine.com
+/// Email: info@state-machine.com
+///***************************************************************************
+/// \endcond
+
+#ifndef qep_port_h
+#define qep_port_h
+
+#include <stdint.h>  // exact-width integers, WG14/N843 C99, 7.18.1.1
+
+#ifdef QEP_PROFILE // QEP state-machine profiling enabled?
+
+    // QEP profiling timestamp (CPU cycles on x86, nanoseconds otherwise)
+    #define QEP_PROF_TIME_SIZE 8
+    #define QEP_PROF_TIME()    (QP::QEP_profTime_())
+
+    #if defined(__x86_64__) || defined(__i386__)
+        #include <x86intrin.h> // for __rdtsc()
+    #else
+        #include <time.h>      // for clock_gettime()
+    #endif
+
+namespace QP {
+    inline uint64_t QEP_profTime_(void) {
+    #if defined(__x86_64__) || defined(__i386__)
+        return static_cast<uint64_t>(__rdtsc());
+    #else
+        struct timespec ts;
+        (void)clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return (static_cast<uint64_t>(ts.tv_sec) * 1000000000U)
+               + static_cast<uint64_t>(ts.tv_nsec);
+    #endif
+    }
+} // namespace QP
+
+#endif // QEP_PROFILE
+
+#include "qep.h"     // QEP platform-independent public interface
+
+#endif // qep_port_h
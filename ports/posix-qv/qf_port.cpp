@@ -0,0 +1,729 @@
+/// @file
+/// @brief QF/C++ port to POSIX with cooperative QV scheduler (posix-qv)
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps, www.state-machine.com.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+
+#define QP_IMPL           // this is QP implementation
+#include "qf_port.h"      // QF port
+#include "qf_pkg.h"       // QF package-scope interface
+#include "qassert.h"      // QP embedded systems-friendly assertions
+#ifdef Q_SPY              // QS software tracing enabled?
+    #include "qs_port.h"  // include QS port
+#else
+    #include "qs_dummy.h" // disable the QS software tracing
+#endif // Q_SPY
+
+#include <time.h>         // for nanosleep()
+#ifdef QF_JOURNAL
+    #include <stdio.h>    // for fopen()/fwrite()/fread()
+    #include <stdlib.h>   // for calloc()/free()
+
+    #ifndef QF_JOURNAL_BUF_SIZE
+        // the journal bytes collected in the critical sections, see NOTE4
+        #define QF_JOURNAL_BUF_SIZE 4096U
+    #endif
+#endif // QF_JOURNAL
+
+namespace QP {
+
+Q_DEFINE_THIS_MODULE("qf_port")
+
+// Global-scope objects ------------------------------------------------------
+pthread_mutex_t QF_pThreadMutex_; // mutex for QF critical section
+QPSet QV_readySet_;               // QV-ready set of active objects
+pthread_cond_t QV_condVar_;       // cond. var. to signal events
+
+// Local-scope objects -------------------------------------------------------
+static bool l_isRunning;      // flag indicating when QF is running
+static bool l_isVirtual;      // flag indicating the virtual time
+static uint32_t l_virtualTime; // ticks elapsed in the virtual time
+static uint_fast8_t l_armedRates;  // rates with armed time evts, see NOTE01
+static uint_fast8_t l_tickedRates; // rates ticked by QF_onClockTick()
+static struct timespec l_tick;
+enum { NANOSLEEP_NSEC_PER_SEC = 1000000000 }; // see NOTE02
+
+static void *ticker_thread(void *arg);
+static bool advanceVirtualTime(void);
+
+#ifdef QF_JOURNAL
+__thread uint_fast8_t QF_journalNest_; // nesting of non-input code
+
+enum {
+    JRNL_VERSION  = 1, // version of the journal format (qf_port.h)
+    JRNL_HDR_SIZE = 8  // the size of the journal file header
+};
+
+//! the requested sizes of the events in the blocks of an event pool
+struct JrnlPool {
+    uint8_t const *sto;  // the storage of the event pool
+    uint16_t *size;      // the requested sizes of the events in the blocks
+    uint_fast16_t block; // the size of the blocks
+};
+
+//! entry of the journal being replayed (without the event payload)
+struct ReplayEntry {
+    uint32_t step; // the RTC steps started before the input
+    QSignal  sig;  // the signal of the event
+    uint16_t len;  // the length of the event payload
+    uint8_t  kind; // the kind of the input (QF_JournalKind)
+    uint8_t  arg;  // the priority of the target AO or the tick rate
+};
+
+uint_fast16_t QF_journalPend_; // the journal bytes not written yet
+
+static FILE *l_jrnlFile;      // the journal being recorded
+static FILE *l_jrnlOut;       // the journal being written (l_jrnlWriter)
+static pthread_mutex_t l_jrnlWriter = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t l_jrnlBuf[QF_JOURNAL_BUF_SIZE]; // the bytes to write
+static uint_fast16_t l_jrnlHead; // the next free byte in l_jrnlBuf[]
+static JrnlPool l_jrnlPool[QF_MAX_EPOOL]; // the sizes of the events
+static FILE *l_replayFile;    // the journal being replayed
+static ReplayEntry l_replay;  // the next input to replay
+static bool l_replayPending;  // is l_replay valid?
+static uint32_t l_rtcSteps;   // the RTC steps started so far
+static uint8_t const l_replayer = static_cast<uint8_t>(0); // QS sender
+
+static void jrnlTick(uint_fast8_t const tickRate);
+static void jrnlHeader(uint8_t hdr[], uint_fast8_t const kind);
+static void jrnlPut(uint8_t const * const data, uint_fast16_t const n);
+static void jrnlWrite(void);
+static void replayRead(void);
+static void replayNext(void);
+#endif // QF_JOURNAL
+
+//............................................................................
+void QF::init(void) {
+    // init the global mutex with the default non-recursive initializer
+    pthread_mutex_init(&QF_pThreadMutex_, NULL);
+
+    // init the condition variable to signal the QV event-loop
+    pthread_cond_init(&QV_condVar_, NULL);
+
+    // clear the internal QF variables, so that the framework can (re)start
+    // correctly even if the startup code is not called to clear the
+    // uninitialized data (as is required by the C++ Standard).
+    extern uint_fast8_t QF_maxPool_;
+    QF_maxPool_ = static_cast<uint_fast8_t>(0);
+    bzero(&QF::timeEvtHead_[0],
+          static_cast<uint_fast16_t>(sizeof(QF::timeEvtHead_)));
+    bzero(&active_[0], static_cast<uint_fast16_t>(sizeof(active_)));
+    QV_readySet_.setEmpty();
+
+    l_virtualTime = static_cast<uint32_t>(0);
+#ifdef QF_JOURNAL
+    l_rtcSteps = static_cast<uint32_t>(0);
+#endif // QF_JOURNAL
+    l_tick.tv_sec = 0;
+    l_tick.tv_nsec = NANOSLEEP_NSEC_PER_SEC/100L; // default clock tick
+}
+//............................................................................
+int_t QF::run(void) {
+    onStartup(); // application-specific startup callback
+
+    l_isRunning = true; // QF is running
+
+#ifdef QF_JOURNAL
+    bool const isTicker = (!l_isVirtual) && (l_replayFile == (FILE *)0);
+#else
+    bool const isTicker = !l_isVirtual;
+#endif // QF_JOURNAL
+
+    pthread_t ticker;
+    if (isTicker) { // real time?
+        // the ticker thread calls QF_onClockTick() in real time
+        Q_ALLEGE_ID(310, pthread_create(&ticker, NULL, &ticker_thread,
+                                        static_cast<void *>(0)) == 0);
+    }
+
+    // the combined event-loop and background-loop of the QV kernel
+    QF_INT_DISABLE();
+    while (__atomic_load_n(&l_isRunning, __ATOMIC_ACQUIRE)) {
+
+#ifdef QF_JOURNAL
+        // is the next recorded input due before the next RTC step?
+        if (l_replayPending
+            && ((l_replay.step <= l_rtcSteps) || QV_readySet_.isEmpty()))
+        {
+            replayNext(); // feed the input to the active objects
+            continue;
+        }
+#endif // QF_JOURNAL
+
+        if (QV_readySet_.notEmpty()) {
+            uint_fast8_t p = QV_readySet_.findMax();
+            QActive *a = active_[p];
+#ifdef QF_JOURNAL
+            ++l_rtcSteps; // the logical time of the inputs, see NOTE03
+#endif // QF_JOURNAL
+            QF_INT_ENABLE();
+
+            // the active object 'a' must still be registered in QF
+            // (e.g., it must not be stopped)
+            Q_ASSERT_ID(320, a != static_cast<QActive *>(0));
+
+            // perform the run-to-completion (RTC) step...
+            // 1. retrieve the event from the AO's event queue, which by this
+            //    time must be non-empty and the QV kernel asserts it.
+            // 2. dispatch the event to the AO's state machine.
+            // 3. determine if event is garbage and collect it if so
+            //
+            QEvt const *e = a->get_();
+            QF_JOURNAL_ENTER_(); // the posts of the AOs are not inputs
+            a->dispatch(e);
+            QF_JOURNAL_EXIT_();
+            QF_LATENCY_DISPATCHED_(a);
+            gc(e);
+
+            QF_INT_DISABLE();
+            QF_SIG_FILTER_IDLE_(a); // the state of 'a' is stable
+
+            if (a->m_eQueue.isEmpty()) { // empty queue?
+                QV_readySet_.remove(p);
+            }
+        }
+#ifdef QF_JOURNAL
+        else if (l_replayFile != (FILE *)0) { // all inputs replayed?
+            l_isRunning = false; // the replay is over
+        }
+#endif // QF_JOURNAL
+        else if (l_isVirtual) { // all queues empty in the virtual time
+            // jump to the next expiration of a time event, see NOTE01
+            if (advanceVirtualTime()) {
+                QF_INT_ENABLE();
+                QF_onClockTick(); // clock tick callback (must call QF_TICK_X())
+                QF_INT_DISABLE();
+
+                // QF_onClockTick() must tick all rates in use, see NOTE01
+                Q_ASSERT_ID(330, (l_armedRates & ~l_tickedRates)
+                                 == static_cast<uint_fast8_t>(0));
+            }
+            else { // no time events armed, nothing can ever happen
+                l_isRunning = false; // the simulation is over
+            }
+        }
+        else {
+            // the QV kernel in embedded systems calls here the QV_onIdle()
+            // callback. However, the POSIX-QV port does not do busy-waiting
+            // for events. Instead, the POSIX-QV port efficiently waits until
+            // QP events become available.
+            pthread_cond_wait(&QV_condVar_, &QF_pThreadMutex_);
+        }
+    }
+    QF_INT_ENABLE();
+
+    if (isTicker) {
+        pthread_join(ticker, NULL); // wait for the ticker thread to finish
+    }
+    onCleanup();  // cleanup callback
+#ifdef QF_JOURNAL
+    QF_journalClose();
+    if (l_replayFile != (FILE *)0) {
+        fclose(l_replayFile);
+        l_replayFile = (FILE *)0;
+    }
+#endif // QF_JOURNAL
+    QS_EXIT();    // cleanup the QSPY connection
+
+    pthread_cond_destroy(&QV_condVar_);
+    pthread_mutex_destroy(&QF_pThreadMutex_);
+    return static_cast<int_t>(0); // return success
+}
+//............................................................................
+// can be called in critical section (e.g., from Q_onAssert()), see NOTE04
+void QF::stop(void) {
+    // terminate the main event-loop
+    __atomic_store_n(&l_isRunning, false, __ATOMIC_RELEASE);
+
+    // unblock the event-loop
+    if (pthread_mutex_trylock(&QF_pThreadMutex_) == 0) {
+        pthread_cond_signal(&QV_condVar_);
+        pthread_mutex_unlock(&QF_pThreadMutex_);
+    }
+    else { // the mutex is held, possibly by the caller itself
+        pthread_cond_signal(&QV_condVar_);
+    }
+}
+//............................................................................
+void QF_setTickRate(uint32_t ticksPerSec) {
+    l_tick.tv_nsec = NANOSLEEP_NSEC_PER_SEC / ticksPerSec;
+}
+//............................................................................
+void QF_setVirtualTime(bool const isVirtual) {
+    /// @pre the time base can be selected only before calling QF::run()
+    Q_REQUIRE_ID(400, !l_isRunning);
+    l_isVirtual = isVirtual;
+}
+//............................................................................
+uint32_t QF_getVirtualTime(void) {
+    QF_INT_DISABLE();
+    uint32_t t = l_virtualTime;
+    QF_INT_ENABLE();
+    return t;
+}
+//............................................................................
+// must be called in critical section (at the beginning of every clock tick)
+void QF_tickHook_(uint_fast8_t const tickRate) {
+    l_tickedRates |= static_cast<uint_fast8_t>(1U << tickRate);
+
+#ifdef QF_JOURNAL
+    jrnlTick(tickRate); // the tick is an input
+#endif // QF_JOURNAL
+}
+
+#ifdef QF_JOURNAL
+//............................................................................
+// must be called in critical section
+static void jrnlTick(uint_fast8_t const tickRate) {
+    if ((l_jrnlFile != (FILE *)0)
+        && __atomic_load_n(&l_isRunning, __ATOMIC_ACQUIRE) && (!l_isVirtual)
+        && (QF_journalNest_ == static_cast<uint_fast8_t>(0)))
+    {
+        uint8_t hdr[5 + 1];
+        jrnlHeader(&hdr[0], static_cast<uint_fast8_t>(QF_JRNL_TICK));
+        hdr[5] = static_cast<uint8_t>(tickRate);
+        jrnlPut(&hdr[0], static_cast<uint_fast16_t>(sizeof(hdr)));
+    }
+}
+//............................................................................
+bool QF_journalOpen(char_t const * const fileName) {
+    QF_journalClose(); // close the previous journal, if any
+
+    FILE *f = fopen(fileName, "wb");
+    if (f == (FILE *)0) {
+        return false;
+    }
+    uint8_t const hdr[JRNL_HDR_SIZE] = {
+        static_cast<uint8_t>('Q'), static_cast<uint8_t>('F'),
+        static_cast<uint8_t>('J'), static_cast<uint8_t>(JRNL_VERSION),
+        static_cast<uint8_t>(Q_SIGNAL_SIZE),
+        static_cast<uint8_t>(QF_MAX_ACTIVE),
+        static_cast<uint8_t>(0), static_cast<uint8_t>(0)
+    };
+    if (fwrite(&hdr[0], 1, sizeof(hdr), f) != sizeof(hdr)) {
+        fclose(f);
+        return false;
+    }
+
+    pthread_mutex_lock(&l_jrnlWriter);
+    l_jrnlOut = f;
+    QF_INT_DISABLE();
+    l_jrnlFile = f; // start recording
+    QF_INT_ENABLE();
+    pthread_mutex_unlock(&l_jrnlWriter);
+    return true;
+}
+//............................................................................
+void QF_journalClose(void) {
+    pthread_mutex_lock(&l_jrnlWriter);
+    QF_INT_DISABLE();
+    l_jrnlFile = (FILE *)0; // stop recording
+    QF_INT_ENABLE();
+    jrnlWrite(); // the entries recorded so far
+    FILE * const f = l_jrnlOut;
+    l_jrnlOut = (FILE *)0;
+    pthread_mutex_unlock(&l_jrnlWriter);
+
+    if (f != (FILE *)0) {
+        fclose(f);
+    }
+}
+//............................................................................
+void QF_journalWrite_(void) {
+    pthread_mutex_lock(&l_jrnlWriter);
+    jrnlWrite();
+    pthread_mutex_unlock(&l_jrnlWriter);
+}
+//............................................................................
+// must be called with l_jrnlWriter locked, but outside critical section
+static void jrnlWrite(void) {
+    QF_INT_DISABLE();
+    while (QF_journalPend_ != static_cast<uint_fast16_t>(0)) {
+        uint_fast16_t const pend = QF_journalPend_;
+        uint_fast16_t tail = (l_jrnlHead >= pend)
+            ? static_cast<uint_fast16_t>(l_jrnlHead - pend)
+            : static_cast<uint_fast16_t>(l_jrnlHead
+                                         + QF_JOURNAL_BUF_SIZE - pend);
+        uint_fast16_t n = static_cast<uint_fast16_t>(
+                              QF_JOURNAL_BUF_SIZE - tail);
+        if (n > pend) {
+            n = pend;
+        }
+        QF_INT_ENABLE();
+
+        // the other threads put their entries only after these bytes
+        (void)fwrite(&l_jrnlBuf[tail], 1, n, l_jrnlOut);
+
+        QF_INT_DISABLE();
+        __atomic_store_n(&QF_journalPend_,
+            static_cast<uint_fast16_t>(QF_journalPend_ - n),
+            __ATOMIC_RELEASE);
+    }
+    QF_INT_ENABLE();
+}
+//............................................................................
+// must be called in critical section
+static void jrnlPut(uint8_t const * const data, uint_fast16_t const n) {
+    uint_fast16_t const pend = QF_journalPend_;
+
+    // the entries not written yet must fit into the buffer, see NOTE4
+    Q_ASSERT_ID(740, n <= static_cast<uint_fast16_t>(
+                              QF_JOURNAL_BUF_SIZE - pend));
+
+    for (uint_fast16_t i = static_cast<uint_fast16_t>(0); i < n; ++i) {
+        l_jrnlBuf[l_jrnlHead] = data[i];
+        ++l_jrnlHead;
+        if (l_jrnlHead == static_cast<uint_fast16_t>(QF_JOURNAL_BUF_SIZE)) {
+            l_jrnlHead = static_cast<uint_fast16_t>(0);
+        }
+    }
+    __atomic_store_n(&QF_journalPend_,
+                     static_cast<uint_fast16_t>(pend + n), __ATOMIC_RELEASE);
+}
+//............................................................................
+void QF_journalPool_(QMPool const * const pool,
+                     void const * const poolSto, uint_fast32_t const poolSize)
+{
+    JrnlPool * const jp = &l_jrnlPool[pool - &QF_pool_[0]];
+    free(jp->size); // the pool initialized again after QF::init()
+    jp->sto   = static_cast<uint8_t const *>(poolSto);
+    jp->block = static_cast<uint_fast16_t>(pool->getBlockSize());
+    jp->size  = static_cast<uint16_t *>(
+                    calloc(poolSize / jp->block, sizeof(uint16_t)));
+
+    // the sizes of all the events in the pool must be kept
+    Q_ASSERT_ID(750, jp->size != static_cast<uint16_t *>(0));
+}
+//............................................................................
+// called for every new dynamic event (the event is not shared yet)
+void QF_journalNew_(QEvt const * const e, uint_fast16_t const evtSize) {
+    JrnlPool const * const jp = &l_jrnlPool[e->poolId_ - 1U];
+    jp->size[static_cast<uint_fast32_t>(
+                 reinterpret_cast<uint8_t const *>(e) - jp->sto)
+             / jp->block] = static_cast<uint16_t>(evtSize);
+}
+//............................................................................
+bool QF_replayOpen(char_t const * const fileName) {
+    /// @pre the replay can be selected only before calling QF::run()
+    Q_REQUIRE_ID(700, !l_isRunning);
+
+    FILE *f = fopen(fileName, "rb");
+    if (f == (FILE *)0) {
+        return false;
+    }
+    uint8_t hdr[JRNL_HDR_SIZE];
+    if ((fread(&hdr[0], 1, sizeof(hdr), f) != sizeof(hdr))
+        || (hdr[0] != static_cast<uint8_t>('Q'))
+        || (hdr[1] != static_cast<uint8_t>('F'))
+        || (hdr[2] != static_cast<uint8_t>('J'))
+        || (hdr[3] != static_cast<uint8_t>(JRNL_VERSION))
+        || (hdr[4] != static_cast<uint8_t>(Q_SIGNAL_SIZE))
+        || (hdr[5] != static_cast<uint8_t>(QF_MAX_ACTIVE)))
+    {
+        fclose(f);
+        return false;
+    }
+
+    l_replayFile = f;
+    replayRead(); // read the first input
+    return true;
+}
+//............................................................................
+bool QF_isReplaying(void) {
+    return l_replayFile != (FILE *)0;
+}
+//............................................................................
+// must be called in critical section
+void QF_journalEvt_(uint_fast8_t const kind,
+                    uint_fast8_t const prio, QEvt const * const e)
+{
+    if ((l_jrnlFile != (FILE *)0)
+        && __atomic_load_n(&l_isRunning, __ATOMIC_ACQUIRE) && (!l_isVirtual)
+        && (QF_journalNest_ == static_cast<uint_fast8_t>(0)))
+    {
+        uint_fast16_t len = static_cast<uint_fast16_t>(0);
+        if (e->poolId_ != static_cast<uint8_t>(0)) { // dynamic event?
+            JrnlPool const * const jp = &l_jrnlPool[e->poolId_ - 1U];
+            uint_fast16_t const size = static_cast<uint_fast16_t>(
+                jp->size[static_cast<uint_fast32_t>(
+                             reinterpret_cast<uint8_t const *>(e) - jp->sto)
+                         / jp->block]);
+            if (size > static_cast<uint_fast16_t>(sizeof(QEvt))) {
+                len = static_cast<uint_fast16_t>(size - sizeof(QEvt));
+            }
+        }
+
+        uint8_t hdr[5 + 1 + Q_SIGNAL_SIZE + 2];
+        jrnlHeader(&hdr[0], kind);
+        hdr[5] = static_cast<uint8_t>(prio);
+        QSignal sig = e->sig;
+        uint_fast8_t n;
+        for (n = static_cast<uint_fast8_t>(6);
+             n < static_cast<uint_fast8_t>(6 + Q_SIGNAL_SIZE);
+             ++n)
+        {
+            hdr[n] = static_cast<uint8_t>(sig);
+            sig = static_cast<QSignal>(static_cast<uint32_t>(sig) >> 8);
+        }
+        hdr[n] = static_cast<uint8_t>(len);
+        hdr[n + 1U] = static_cast<uint8_t>(len >> 8);
+
+        jrnlPut(&hdr[0], static_cast<uint_fast16_t>(sizeof(hdr)));
+        jrnlPut(reinterpret_cast<uint8_t const *>(e) + sizeof(QEvt), len);
+    }
+}
+//............................................................................
+// the common beginning of the journal entries: [kind][step u32]
+static void jrnlHeader(uint8_t hdr[], uint_fast8_t const kind) {
+    hdr[0] = static_cast<uint8_t>(kind);
+    hdr[1] = static_cast<uint8_t>(l_rtcSteps);
+    hdr[2] = static_cast<uint8_t>(l_rtcSteps >> 8);
+    hdr[3] = static_cast<uint8_t>(l_rtcSteps >> 16);
+    hdr[4] = static_cast<uint8_t>(l_rtcSteps >> 24);
+}
+//............................................................................
+// read the next input into l_replay (the end of the journal at EOF)
+static void replayRead(void) {
+    uint8_t hdr[5 + 1 + Q_SIGNAL_SIZE + 2];
+    l_replayPending = false;
+    if (fread(&hdr[0], 1, 5 + 1, l_replayFile) != 5U + 1U) {
+        return; // end of the journal
+    }
+    l_replay.kind = hdr[0];
+    l_replay.step = static_cast<uint32_t>(hdr[1])
+                    | (static_cast<uint32_t>(hdr[2]) << 8)
+                    | (static_cast<uint32_t>(hdr[3]) << 16)
+                    | (static_cast<uint32_t>(hdr[4]) << 24);
+    l_replay.arg  = hdr[5];
+    l_replay.sig  = static_cast<QSignal>(0);
+    l_replay.len  = static_cast<uint16_t>(0);
+    if (l_replay.kind != static_cast<uint8_t>(QF_JRNL_TICK)) { // event?
+        if (fread(&hdr[6], 1, Q_SIGNAL_SIZE + 2, l_replayFile)
+            != static_cast<size_t>(Q_SIGNAL_SIZE + 2))
+        {
+            return; // truncated journal
+        }
+        uint32_t sig = static_cast<uint32_t>(0);
+        uint_fast8_t n;
+        for (n = static_cast<uint_fast8_t>(6 + Q_SIGNAL_SIZE);
+             n > static_cast<uint_fast8_t>(6);
+             --n)
+        {
+            sig = (sig << 8) | static_cast<uint32_t>(hdr[n - 1U]);
+        }
+        l_replay.sig = static_cast<QSignal>(sig);
+        n = static_cast<uint_fast8_t>(6 + Q_SIGNAL_SIZE);
+        l_replay.len = static_cast<uint16_t>(
+            static_cast<uint16_t>(hdr[n])
+            | static_cast<uint16_t>(static_cast<uint16_t>(hdr[n + 1U]) << 8));
+    }
+    l_replayPending = true;
+}
+//............................................................................
+// must be called in critical section (exits it for feeding the input)
+static void replayNext(void) {
+    ReplayEntry const r = l_replay;
+    QF_INT_ENABLE();
+
+    if (r.kind == static_cast<uint8_t>(QF_JRNL_TICK)) {
+        if (r.arg == static_cast<uint8_t>(0)) { // the base tick rate?
+            QF_INT_DISABLE();
+            ++l_virtualTime;
+            QF_INT_ENABLE();
+        }
+        QF::TICK_X(static_cast<uint_fast8_t>(r.arg), &l_replayer);
+    }
+    else {
+        QEvt *e = QF::newX_(
+            static_cast<uint_fast16_t>(sizeof(QEvt) + r.len),
+            QF_NO_MARGIN, static_cast<enum_t>(r.sig));
+        if (fread(reinterpret_cast<uint8_t *>(e) + sizeof(QEvt),
+                  1, r.len, l_replayFile) != static_cast<size_t>(r.len))
+        {
+            QF::gc(e); // recycle the incomplete event
+            QF_INT_DISABLE();
+            l_replayPending = false; // truncated journal, see NOTE4
+            return;
+        }
+
+        if (r.kind == static_cast<uint8_t>(QF_JRNL_PUBLISH)) {
+            QF::PUBLISH(e, &l_replayer);
+        }
+        else {
+            // the recorded target AO must be registered in QF
+            Q_ASSERT_ID(720, (r.arg <= static_cast<uint8_t>(QF_MAX_ACTIVE))
+                && (QF::active_[r.arg] != static_cast<QActive *>(0)));
+
+            if (r.kind == static_cast<uint8_t>(QF_JRNL_POST)) {
+                (void)QF::active_[r.arg]->POST(e, &l_replayer);
+            }
+            else {
+                // the only other kind of recorded inputs
+                Q_ASSERT_ID(730,
+                    r.kind == static_cast<uint8_t>(QF_JRNL_POST_LIFO));
+                QF::active_[r.arg]->postLIFO(e);
+            }
+        }
+    }
+
+    replayRead(); // the next input
+    QF_INT_DISABLE();
+}
+#endif // QF_JOURNAL
+
+//............................................................................
+void QActive::start(uint_fast8_t prio,
+                    QEvt const *qSto[], uint_fast16_t qLen,
+                    void *stkSto, uint_fast16_t /*stkSize*/,
+                    QEvt const *ie)
+{
+    Q_REQUIRE_ID(600, (static_cast<uint_fast8_t>(0) < prio) // priority...
+        && (prio <= static_cast<uint_fast8_t>(QF_MAX_ACTIVE)) //... in range
+        && (stkSto == static_cast<void *>(0))); // stack storage must NOT...
+                                                // ... be provided
+
+#ifdef QF_LATENCY
+    // the queue must fit the time stamps of the posted events
+    Q_REQUIRE_ID(610, qLen <= static_cast<uint_fast16_t>(QF_LATENCY_QLEN));
+#endif
+
+    m_prio = static_cast<uint8_t>(prio); // set the QF priority of this AO
+    QF::add_(this); // make QF aware of this AO
+
+    m_eQueue.init(qSto, qLen);
+
+    this->init(ie); // execute initial transition (virtual call)
+    QS_FLUSH();     // flush the QS trace buffer to the host
+}
+//............................................................................
+void QActive::stop(void) {
+    unsubscribeAll();
+    QF::remove_(this);
+}
+
+//............................................................................
+static void *ticker_thread(void * /*arg*/) { // the expected POSIX signature
+    while (__atomic_load_n(&l_isRunning, __ATOMIC_ACQUIRE)) {
+        nanosleep(&l_tick, NULL); // sleep for the tick interval, NOTE02
+        QF_onClockTick(); // clock tick callback (must call QF_TICK_X())
+    }
+
+    // unblock the event-loop in case QF::stop() could not, see NOTE04
+    QF_INT_DISABLE();
+    pthread_cond_signal(&QV_condVar_);
+    QF_INT_ENABLE();
+
+    return static_cast<void *>(0); // return success
+}
+//............................................................................
+// must be called in critical section
+static bool advanceVirtualTime(void) {
+    QTimeEvtCtr next = static_cast<QTimeEvtCtr>(0);
+    uint_fast8_t rate;
+
+    l_armedRates  = static_cast<uint_fast8_t>(0);
+    l_tickedRates = static_cast<uint_fast8_t>(0);
+
+    // find the earliest expiration of a time event over all tick rates
+    for (rate = static_cast<uint_fast8_t>(0);
+         rate < static_cast<uint_fast8_t>(QF_MAX_TICK_RATE);
+         ++rate)
+    {
+        QTimeEvtCtr n = QF::ticksToNextX(rate);
+        if (n != static_cast<QTimeEvtCtr>(0)) {
+            l_armedRates |= static_cast<uint_fast8_t>(1U << rate);
+            if ((next == static_cast<QTimeEvtCtr>(0)) || (n < next)) {
+                next = n;
+            }
+        }
+    }
+
+    if (next != static_cast<QTimeEvtCtr>(0)) { // any time events armed?
+        // skip all ticks but the last one, which QF_onClockTick() delivers
+        for (rate = static_cast<uint_fast8_t>(0);
+             rate < static_cast<uint_fast8_t>(QF_MAX_TICK_RATE);
+             ++rate)
+        {
+            QF::skipTicksX(rate, next - static_cast<QTimeEvtCtr>(1));
+        }
+        l_virtualTime += static_cast<uint32_t>(next);
+    }
+    return next != static_cast<QTimeEvtCtr>(0);
+}
+
+} // namespace QP
+
+//****************************************************************************
+// NOTE01:
+// In the virtual time, the whole skipped interval is accounted for in a
+// single critical section and QF_onClockTick() is then called only once.
+// Because the QV kernel runs all active objects in the single thread of
+// QF::run(), the time can advance only after all the consequences of the
+// previous tick have been processed (all event queues are empty), which
+// makes the simulation deterministic. The time events armed during the
+// RTC steps are taken into account, because QP::QF::ticksToNextX() also
+// scans the time events armed since the last tick.
+//
+// All tick rates skip the same number of ticks, so QF_onClockTick() must
+// deliver the last tick to every rate with armed time events. Otherwise,
+// the time events of the forgotten rate would expire late. QF::run()
+// therefore asserts that all the rates armed before the tick have been
+// ticked (QF_tickHook_() collects the rates ticked by QP::QF::tickX_()).
+//
+// NOTE02:
+// In some (older) Linux kernels, the POSIX nanosleep() system call might
+// deliver only 2*actual-system-tick granularity. To compensate for this,
+// you would need to reduce (by 2) the constant NANOSLEEP_NSEC_PER_SEC.
+//
+// NOTE03:
+// The journal records every input with the number of RTC steps started
+// before it arrived, because in the single thread of the QV kernel this
+// number determines, which events the active objects have already seen.
+// The replay feeds every input in just before the next RTC step with the
+// same number, and so reproduces the order of the inputs relative to the
+// RTC steps, regardless of the real timing of the recorded run. An input,
+// which is due while all event queues are empty, is fed in right away,
+// which also makes the replay run at the full speed of the CPU.
+//
+// NOTE04:
+// QF::stop() is called from Q_onAssert() and from the QS callbacks, which
+// often run in a critical section, that is, with QF_pThreadMutex_ already
+// locked by the calling thread. Locking the (non-recursive) mutex again
+// would deadlock, so QF::stop() sets the l_isRunning flag atomically and
+// only tries to lock the mutex for signaling the event-loop. When the
+// mutex is held by another thread, the signal can be lost, so the ticker
+// thread signals the event-loop once more after noticing the stop (within
+// one clock tick). The event-loop waits for the signal only in the real
+// time, that is, only when the ticker thread runs.
+//
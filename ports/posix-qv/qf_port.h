@@ -0,0 +1,294 @@
+/// @file
+/// @brief QF/C++ port to POSIX with cooperative QV scheduler (posix-qv)
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps, LLC. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+
+#ifndef qf_port_h
+#define qf_port_h
+
+// POSIX-QV event queue and thread types
+#define QF_EQUEUE_TYPE       QEQueue
+// QF_OS_OBJECT_TYPE  not used
+// QF_THREAD_TYPE     not used
+
+// The maximum number of active objects in the application
+#define QF_MAX_ACTIVE        64
+
+// The number of system clock tick rates
+#define QF_MAX_TICK_RATE     2
+
+// various QF object sizes configuration for this port
+#define QF_EVENT_SIZ_SIZE    4
+#define QF_EQUEUE_CTR_SIZE   4
+#define QF_MPOOL_SIZ_SIZE    4
+#define QF_MPOOL_CTR_SIZE    4
+#define QF_TIMEEVT_CTR_SIZE  4
+
+// time source of the latency histograms (QF_LATENCY) [ns], see NOTE3
+#define QF_LATENCY_TIME_()   (QP::QF_latencyTime_())
+
+// QF interrupt disable/enable, see NOTE1
+#define QF_INT_DISABLE()     pthread_mutex_lock(&QP::QF_pThreadMutex_)
+#define QF_INT_ENABLE()      pthread_mutex_unlock(&QP::QF_pThreadMutex_)
+
+// QF critical section entry/exit for POSIX-QV, see NOTE1
+// QF_CRIT_STAT_TYPE not defined
+#define QF_CRIT_ENTRY(dummy) QF_INT_DISABLE()
+#ifdef QF_JOURNAL
+    // the journal is written out after the critical section, see NOTE4
+    #define QF_CRIT_EXIT(dummy)  (QP::QF_journalCritExit_())
+#else
+    #define QF_CRIT_EXIT(dummy)  QF_INT_ENABLE()
+#endif // QF_JOURNAL
+
+#include <pthread.h>   // POSIX-thread API
+#include <time.h>      // for clock_gettime()
+#include "qep_port.h"  // QEP port
+#include "qequeue.h"   // POSIX-QV needs event-queue
+#include "qmpool.h"    // POSIX-QV needs memory-pool
+#include "qpset.h"     // POSIX-QV needs priority-set
+#include "qf.h"        // QF platform-independent public interface
+
+namespace QP {
+
+void QF_setTickRate(uint32_t ticksPerSec); // set clock tick rate
+void QF_onClockTick(void); // clock tick callback (provided in the app)
+
+// select the virtual (simulated) time instead of real time, see NOTE2
+void QF_setVirtualTime(bool const isVirtual);
+
+// the number of clock ticks elapsed in the virtual time, see NOTE2
+uint32_t QF_getVirtualTime(void);
+
+extern pthread_mutex_t QF_pThreadMutex_; // mutex for QF critical section
+
+#ifdef QF_JOURNAL
+// record the external inputs of the active objects in a file, see NOTE4
+bool QF_journalOpen(char_t const * const fileName);
+
+// stop recording and close the journal file
+void QF_journalClose(void);
+
+// replay the inputs recorded in the journal file instead of the real
+// clock tick and the "ISR-like" threads, see NOTE4
+bool QF_replayOpen(char_t const * const fileName);
+
+// is the journal being replayed?
+bool QF_isReplaying(void);
+
+// write out the journal entries collected in the critical sections
+void QF_journalWrite_(void);
+
+// the number of the journal bytes not written yet
+extern uint_fast16_t QF_journalPend_;
+
+// the end of the critical section, which writes out the journal entries
+// collected in it (outside of the critical section), see NOTE4
+inline void QF_journalCritExit_(void) {
+    pthread_mutex_unlock(&QF_pThreadMutex_);
+    if (__atomic_load_n(&QF_journalPend_, __ATOMIC_ACQUIRE)
+        != static_cast<uint_fast16_t>(0))
+    {
+        QF_journalWrite_();
+    }
+}
+#endif // QF_JOURNAL
+
+#ifdef QF_LATENCY
+//! CLOCK_MONOTONIC in nanoseconds (modulo 2^32), see NOTE3
+inline QFLatencyTime QF_latencyTime_(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<QFLatencyTime>(
+        (static_cast<uint32_t>(ts.tv_sec) * 1000000000U)
+        + static_cast<uint32_t>(ts.tv_nsec));
+}
+#endif // QF_LATENCY
+
+} // namespace QP
+
+//****************************************************************************
+// interface used only inside QF, but not in applications
+//
+#ifdef QP_IMPL
+
+    // POSIX-QV specific scheduler locking (not needed in QV)
+    #define QF_SCHED_STAT_
+    #define QF_SCHED_LOCK_(dummy) ((void)0)
+    #define QF_SCHED_UNLOCK_()    ((void)0)
+
+    // native QF event queue operations...
+    #define QACTIVE_EQUEUE_WAIT_(me_) \
+        Q_ASSERT_ID(410, \
+            (me_)->m_eQueue.m_frontEvt != static_cast<QEvt const *>(0))
+
+    #define QACTIVE_EQUEUE_SIGNAL_(me_) \
+        QV_readySet_.insert((me_)->m_prio); \
+        pthread_cond_signal(&QV_condVar_)
+
+    // native QF event pool operations...
+    #define QF_EPOOL_TYPE_            QMPool
+#ifdef QF_JOURNAL
+    // the journal records the requested sizes of the events, see NOTE4
+    #define QF_EPOOL_INIT_(p_, poolSto_, poolSize_, evtSize_) do { \
+        (p_).init(poolSto_, poolSize_, evtSize_); \
+        QP::QF_journalPool_(&(p_), (poolSto_), (poolSize_)); \
+    } while (false)
+#else
+    #define QF_EPOOL_INIT_(p_, poolSto_, poolSize_, evtSize_) \
+        (p_).init(poolSto_, poolSize_, evtSize_)
+#endif // QF_JOURNAL
+    #define QF_EPOOL_EVENT_SIZE_(p_)  ((p_).getBlockSize())
+    #define QF_EPOOL_GET_(p_, e_, m_) \
+        ((e_) = static_cast<QEvt *>((p_).get((m_))))
+    #define QF_EPOOL_PUT_(p_, e_)     ((p_).put(e_))
+
+    namespace QP {
+        extern QPSet QV_readySet_;         // QV-ready set of active objects
+        extern pthread_cond_t QV_condVar_; // cond. var. to signal events
+    } // namespace QP
+
+    // every clock tick (the virtual time check and the journal), NOTE2
+    #define QF_TICK_HOOK_(rate_) (QP::QF_tickHook_(rate_))
+
+    namespace QP {
+        void QF_tickHook_(uint_fast8_t const tickRate);
+    } // namespace QP
+
+#ifdef QF_JOURNAL
+    // recording of the external inputs, see NOTE4
+    #define QF_JOURNAL_EVT_(kind_, prio_, e_) \
+        (QP::QF_journalEvt_((kind_), (prio_), (e_)))
+    #define QF_JOURNAL_NEW_(e_, evtSize_) \
+        (QP::QF_journalNew_((e_), (evtSize_)))
+    #define QF_JOURNAL_ENTER_()     (++QP::QF_journalNest_)
+    #define QF_JOURNAL_EXIT_()      (--QP::QF_journalNest_)
+
+    namespace QP {
+        void QF_journalEvt_(uint_fast8_t const kind,
+                            uint_fast8_t const prio, QEvt const * const e);
+        void QF_journalNew_(QEvt const * const e,
+                            uint_fast16_t const evtSize);
+        void QF_journalPool_(QMPool const * const pool,
+                             void const * const poolSto,
+                             uint_fast32_t const poolSize);
+
+        // nesting of the code not producing inputs in the calling thread
+        extern __thread uint_fast8_t QF_journalNest_;
+    } // namespace QP
+#endif // QF_JOURNAL
+
+#endif // QP_IMPL
+
+// NOTES: ////////////////////////////////////////////////////////////////////
+//
+// NOTE1:
+// QF, like all real-time frameworks, needs to execute certain sections of
+// code indivisibly to avoid data corruption. The most straightforward way of
+// protecting such critical sections of code is disabling and enabling
+// interrupts, which POSIX does not allow.
+//
+// This QF port uses therefore a single package-scope p-thread mutex
+// QF_pThreadMutex_ to protect all critical sections. All active objects run
+// in the single thread of QF::run(), so the mutex protects only against the
+// ticker thread and any other "ISR-like" threads that post or publish
+// events to the active objects.
+//
+// NOTE2:
+// In the virtual time (see QF_setVirtualTime()), the ticker thread is not
+// created and the clock ticks do not happen in real time. Instead, whenever
+// all event queues are empty, QF::run() advances the time straight to the
+// earliest expiration of any armed time event (QP::QF::ticksToNextX()),
+// accounts for the skipped ticks at once (QP::QF::skipTicksX()) and calls
+// QF_onClockTick() only for the tick in which the time event expires. When
+// no time events are armed anymore, nothing can happen and QF::run()
+// returns. This makes the long-duration scenarios deterministic and allows
+// them to run as fast as the CPU can dispatch the events.
+//
+// The virtual time assumes that all the tick rates share one period, so
+// QF_onClockTick() must service all of them (call QF_TICK_X() for every
+// rate). QF::run() asserts that every rate with armed time events has been
+// ticked by QF_onClockTick() (assertion 330). The virtual time also
+// assumes that no other threads post events to the active objects.
+//
+// NOTE3:
+// The latency histograms of the active objects (QF_LATENCY) measure in
+// nanoseconds of CLOCK_MONOTONIC, also in the virtual time, so the queue
+// waits show how long the events really waited for the CPU.
+//
+// NOTE4:
+// With QF_JOURNAL defined, QF_journalOpen() records all events, which enter
+// the framework from outside of the active objects while QF::run() is
+// running: the clock ticks and the events posted or published by the ticker
+// thread and by any other "ISR-like" threads. The posts of the active
+// objects, the multicasting of published events and the posting of time
+// events are consequences of the recorded inputs and are not recorded.
+//
+// The journal is a compact binary file. It starts with the 8-byte header
+// 'Q','F','J',version,Q_SIGNAL_SIZE,QF_MAX_ACTIVE,0,0 followed by the
+// entries, each beginning with the kind (QP::QF_JournalKind) and the number
+// of RTC steps started so far (the logical time of the input, u32):
+//   tick:  [kind][step][tick rate]
+//   event: [kind][step][prio (0 for publish)][sig][len u16][len bytes]
+// The multi-byte values are little-endian. The payload of a dynamic event
+// has the size requested in Q_NEW() (QF_journalNew_() keeps the sizes of
+// the events in the blocks of the event pools). Static events are recorded
+// without any payload and are replayed as dynamic events.
+//
+// The entries are collected in a buffer inside the critical sections of
+// the inputs, and the thread leaving the critical section writes them to
+// the file (QF_journalCritExit_()), so the file I/O never runs with the
+// QF_pThreadMutex_ locked. A journal truncated in the middle of an entry
+// (e.g., by a crash of the recorded application) ends before that entry.
+//
+// QF_replayOpen() (called before QF::run()) makes QF::run() feed the
+// recorded inputs back, each one just before the RTC step, before which it
+// arrived, without any ticker thread and as fast as the CPU can dispatch the
+// events. QF::run() returns when the journal is exhausted and all queues
+// are empty. The application must not start its own input threads while
+// QF_isReplaying(). A rate-0 tick advances QF_getVirtualTime(), which the
+// application can use as the QS timestamp (QP::QS::onGetTime()).
+//
+// The replay is deterministic: every replay of the same journal produces
+// the same sequence of RTC steps and the same QS trace, which can be
+// compared against the recorded run (the application may also record the
+// replay into another journal, which must then equal the replayed one).
+// The only information the journal does not keep is the order of an input
+// relative to the events posted by the active object in the RTC step
+// running at the same time, so a race between them is replayed always in
+// the order, in which the input comes after the RTC step.
+//
+
+#endif // qf_port_h
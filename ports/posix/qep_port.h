@@ -39,6 +39,34 @@
 #define qep_port_h
 
 #include <stdint.h>  // exact-width integers, WG14/N843 C99, 7.18.1.1
+
+#ifdef QEP_PROFILE // QEP state-machine profiling enabled?
+
+    // QEP profiling timestamp (CPU cycles on x86, nanoseconds otherwise)
+    #define QEP_PROF_TIME_SIZE 8
+    #define QEP_PROF_TIME()    (QP::QEP_profTime_())
+
+    #if defined(__x86_64__) || defined(__i386__)
+        #include <x86intrin.h> // for __rdtsc()
+    #else
+        #include <time.h>      // for clock_gettime()
+    #endif
+
+namespace QP {
+    inline uint64_t QEP_profTime_(void) {
+    #if defined(__x86_64__) || defined(__i386__)
+        return static_cast<uint64_t>(__rdtsc());
+    #else
+        struct timespec ts;
+        (void)clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return (static_cast<uint64_t>(ts.tv_sec) * 1000000000U)
+               + static_cast<uint64_t>(ts.tv_nsec);
+    #endif
+    }
+} // namespace QP
+
+#endif // QEP_PROFILE
+
 #include "qep.h"     // QEP platform-independent public interface
 
 #endif // qep_port_h
@@ -47,6 +47,12 @@
 
 #include <limits.h>      // for PTHREAD_STACK_MIN
 #include <sys/mman.h>    // for mlockall()
+#include <time.h>        // for clock_gettime()
+#include <unistd.h>      // for read()
+#include <sys/timerfd.h> // for timerfd_create(), see NOTE07
+#include <sys/eventfd.h> // for eventfd(), see NOTE06
+#include <poll.h>        // for ppoll()
+#include <signal.h>      // for sigset_t
 
 namespace QP {
 
@@ -61,7 +67,25 @@ static bool l_isRunning;
 static struct timespec l_tick;
 enum { NANOSLEEP_NSEC_PER_SEC = 1000000000 }; // see NOTE05
 
+static bool l_isTickless;           // flag indicating the tickless mode
+static int l_tickFd;                // wakes up the tickless clock, NOTE06
+static uint64_t l_lastTick;         // time [ns] of the last accounted tick
+
+static int l_hrTimerFd;             // timerfd of the high-res. time events
+static QHrTimeEvt *l_hrHeap[QF_HR_TIMEEVT_MAX + 1]; // min-heap (1-based)
+static uint_fast16_t l_hrNum;       // number of armed high-res. time evts
+static bool l_hrStarted;            // the hrTimer thread created, NOTE07
+static bool l_hrStop;               // request to the hrTimer thread to end
+static pthread_t l_hrTimer;         // the thread of the high-res. time evts
+
 static void *ao_thread(void *arg); // thread routine for all AOs
+static void ticklessRun(void);
+static void ticklessWake(void);
+static bool ticklessWait(uint64_t const deadline);
+static uint64_t monotonicNsec(void);
+static QTimeEvtCtr ticksToNext(void);
+static void catchUpTicks(void);
+static void *hrTimer_thread(void *arg); // thread routine for QHrTimeEvt
 
 //............................................................................
 void QF::init(void) {
@@ -74,6 +98,17 @@ void QF::init(void) {
     // init the startup mutex with the default non-recursive initializer
     pthread_mutex_init(&l_startupMutex, NULL);
 
+    // create the eventfd waking up the tickless clock, see NOTE06
+    l_tickFd = eventfd(0U, EFD_CLOEXEC | EFD_NONBLOCK);
+    Q_ASSERT_ID(105, l_tickFd >= 0);
+
+    // create the timerfd of the high-resolution time events, see NOTE07
+    l_hrTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    Q_ASSERT_ID(110, l_hrTimerFd >= 0);
+    l_hrNum = static_cast<uint_fast16_t>(0);
+    l_hrStarted = false;
+    l_hrStop = false;
+
     // lock the startup mutex to block any active objects started before
     // calling QF::run()
     pthread_mutex_lock(&l_startupMutex);
@@ -109,12 +144,36 @@ int_t QF::run(void) {
     pthread_mutex_unlock(&l_startupMutex);
 
     l_isRunning = true;
-    while (l_isRunning) { // the clock tick loop...
-        QF_onClockTick(); // clock tick callback (must call QF_TICK_X())
+    if (l_isTickless) {
+        ticklessRun(); // the tickless clock loop, see NOTE06
+    }
+    else {
+        // the clock tick loop...
+        while (__atomic_load_n(&l_isRunning, __ATOMIC_ACQUIRE)) {
+            QF_onClockTick(); // clock tick callback (must call QF_TICK_X())
 
-        nanosleep(&l_tick, NULL); // sleep for the number of ticks, NOTE05
+            nanosleep(&l_tick, NULL); // sleep for the number of ticks, NOTE05
+        }
     }
+
+    // stop the thread of the high-resolution time events, if any
+    QF_INT_DISABLE();
+    bool const hrStarted = l_hrStarted;
+    l_hrStop = true;
+    struct itimerspec its;
+    its.it_interval.tv_sec  = 0;
+    its.it_interval.tv_nsec = 0;
+    its.it_value.tv_sec     = 0;
+    its.it_value.tv_nsec    = 1; // expire right away to unblock the thread
+    (void)timerfd_settime(l_hrTimerFd, 0, &its, NULL);
+    QF_INT_ENABLE();
+    if (hrStarted) {
+        pthread_join(l_hrTimer, NULL);
+    }
+    close(l_hrTimerFd);
+
     onCleanup(); // invoke cleanup callback
+    close(l_tickFd);
     pthread_mutex_destroy(&l_startupMutex);
     pthread_mutex_destroy(&QF_pThreadMutex_);
     return static_cast<int_t>(0); // return success
@@ -124,8 +183,24 @@ void QF_setTickRate(uint32_t ticksPerSec) {
     l_tick.tv_nsec = NANOSLEEP_NSEC_PER_SEC / ticksPerSec;
 }
 //............................................................................
+void QF_setTickless(bool const isTickless) {
+    /// @pre the clock mode can be selected only before calling QF::run()
+    Q_REQUIRE_ID(500, !l_isRunning);
+    l_isTickless = isTickless;
+}
+//............................................................................
+// can be called in critical section (e.g., from Q_onAssert()), see NOTE09
 void QF::stop(void) {
-    l_isRunning = false; // stop the loop in QF::run()
+    __atomic_store_n(&l_isRunning, false, __ATOMIC_RELEASE);
+    ticklessWake(); // unblock the tickless clock
+}
+//............................................................................
+// called from QTimeEvt::armX()/rearm() in critical section, see NOTE06
+void QF_ticklessArm_(void) {
+    if (l_isTickless && __atomic_load_n(&l_isRunning, __ATOMIC_ACQUIRE)) {
+        catchUpTicks(); // account for the ticks elapsed before arming
+        ticklessWake(); // re-evaluate the next deadline
+    }
 }
 //............................................................................
 void QF::thread_(QActive *act) {
@@ -137,6 +212,7 @@ void QF::thread_(QActive *act) {
     do {
         QEvt const *e = act->get_(); // wait for event
         act->dispatch(e); // dispatch to the active object's state machine
+        QF_LATENCY_DISPATCHED_(act); // end of the RTC step, see NOTE08
         gc(e); // check if the event is garbage, and collect it if so
     } while (act->m_thread != static_cast<uint8_t>(0));
 
@@ -152,6 +228,11 @@ void QActive::start(uint_fast8_t prio,
     // p-threads allocate stack internally
     Q_REQUIRE_ID(600, stkSto == static_cast<void *>(0));
 
+#ifdef QF_LATENCY
+    // the queue must fit the time stamps of the posted events
+    Q_REQUIRE_ID(610, qLen <= static_cast<uint_fast16_t>(QF_LATENCY_QLEN));
+#endif
+
     pthread_cond_init(&m_osObject, 0);
 
     m_eQueue.init(qSto, qLen);
@@ -205,6 +286,343 @@ static void *ao_thread(void *arg) { // the expected POSIX signature
     QF::thread_(static_cast<QActive *>(arg));
     return static_cast<void *>(0); // return success
 }
+//............................................................................
+static void ticklessRun(void) {
+    uint64_t period = static_cast<uint64_t>(l_tick.tv_sec)
+                      * static_cast<uint64_t>(NANOSLEEP_NSEC_PER_SEC)
+                      + static_cast<uint64_t>(l_tick.tv_nsec);
+
+    QF_INT_DISABLE();
+    l_lastTick = monotonicNsec();
+    while (__atomic_load_n(&l_isRunning, __ATOMIC_ACQUIRE)) {
+        QTimeEvtCtr next = ticksToNext();
+        if (next == static_cast<QTimeEvtCtr>(0)) { // no time events armed?
+            // sleep until a time event is armed or QF is stopped
+            (void)ticklessWait(static_cast<uint64_t>(0));
+
+            if (ticksToNext() == static_cast<QTimeEvtCtr>(0)) { // still?
+                l_lastTick = monotonicNsec(); // no ticks to account for
+            }
+        }
+        else {
+            uint64_t deadline = l_lastTick
+                                + static_cast<uint64_t>(next) * period;
+
+            // sleep until the deadline or until a sooner one is armed
+            if (ticklessWait(deadline)) {
+                catchUpTicks(); // account for all but the expiring tick
+                l_lastTick += period; // the tick delivered below
+
+                QF_INT_ENABLE();
+                QF_onClockTick(); // clock tick callback (must call QF_TICK_X())
+                QF_INT_DISABLE();
+            }
+        }
+    }
+    QF_INT_ENABLE();
+}
+//............................................................................
+// can be called in critical section, see NOTE09
+static void ticklessWake(void) {
+    uint64_t const one = static_cast<uint64_t>(1);
+    (void)write(l_tickFd, &one, sizeof(one)); // the counter never overflows
+}
+//............................................................................
+// must be called in critical section (exits it for waiting); sleeps until
+// the @p deadline [ns] (0 for none) or until ticklessWake() and returns
+// true when the deadline has passed without any wake up
+static bool ticklessWait(uint64_t const deadline) {
+    struct timespec ts;
+    struct timespec *timeout = static_cast<struct timespec *>(0);
+    if (deadline != static_cast<uint64_t>(0)) {
+        uint64_t const now = monotonicNsec();
+        uint64_t const rel = (deadline > now) ? (deadline - now) : 0U;
+        ts.tv_sec  = static_cast<time_t>(rel
+                         / static_cast<uint64_t>(NANOSLEEP_NSEC_PER_SEC));
+        ts.tv_nsec = static_cast<long>(rel
+                         % static_cast<uint64_t>(NANOSLEEP_NSEC_PER_SEC));
+        timeout = &ts;
+    }
+    struct pollfd pfd;
+    pfd.fd      = l_tickFd;
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+
+    QF_INT_ENABLE();
+    int const n = ppoll(&pfd, 1, timeout, static_cast<sigset_t *>(0));
+    QF_INT_DISABLE();
+
+    if (n > 0) { // woken up?
+        uint64_t cnt;
+        (void)read(l_tickFd, &cnt, sizeof(cnt)); // consume the wake ups
+        return false; // re-evaluate the next deadline
+    }
+    // a spurious return (e.g., EINTR) only re-evaluates the deadline
+    return (n == 0) && (deadline != static_cast<uint64_t>(0))
+           && (monotonicNsec() >= deadline);
+}
+//............................................................................
+static uint64_t monotonicNsec(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec)
+               * static_cast<uint64_t>(NANOSLEEP_NSEC_PER_SEC)
+           + static_cast<uint64_t>(now.tv_nsec);
+}
+//............................................................................
+// must be called in critical section
+static QTimeEvtCtr ticksToNext(void) {
+    QTimeEvtCtr next = static_cast<QTimeEvtCtr>(0);
+    uint_fast8_t rate;
+    for (rate = static_cast<uint_fast8_t>(0);
+         rate < static_cast<uint_fast8_t>(QF_MAX_TICK_RATE);
+         ++rate)
+    {
+        QTimeEvtCtr n = QF::ticksToNextX(rate);
+        if ((n != static_cast<QTimeEvtCtr>(0))
+            && ((next == static_cast<QTimeEvtCtr>(0)) || (n < next)))
+        {
+            next = n;
+        }
+    }
+    return next;
+}
+//............................................................................
+// must be called in critical section
+static void catchUpTicks(void) {
+    uint64_t period = static_cast<uint64_t>(l_tick.tv_sec)
+                      * static_cast<uint64_t>(NANOSLEEP_NSEC_PER_SEC)
+                      + static_cast<uint64_t>(l_tick.tv_nsec);
+    uint64_t now = monotonicNsec();
+    QTimeEvtCtr next = ticksToNext();
+    if (next == static_cast<QTimeEvtCtr>(0)) { // no time events armed?
+        l_lastTick = now; // no ticks to account for (NOTE06)
+        return;
+    }
+
+    uint64_t elapsed = (now > l_lastTick) ? ((now - l_lastTick) / period)
+                                          : static_cast<uint64_t>(0);
+    // no time event may expire in the skipped ticks, and the elapsed
+    // ticks must fit into QTimeEvtCtr before the cast
+    if (elapsed >= static_cast<uint64_t>(next)) {
+        elapsed = static_cast<uint64_t>(next) - 1U;
+    }
+    QTimeEvtCtr n = static_cast<QTimeEvtCtr>(elapsed);
+    if (n != static_cast<QTimeEvtCtr>(0)) {
+        uint_fast8_t rate;
+        for (rate = static_cast<uint_fast8_t>(0);
+             rate < static_cast<uint_fast8_t>(QF_MAX_TICK_RATE);
+             ++rate)
+        {
+            QF::skipTicksX(rate, n); // apply the elapsed ticks in one step
+        }
+        l_lastTick += static_cast<uint64_t>(n) * period;
+    }
+}
+
+
+//****************************************************************************
+static void *hrTimer_thread(void * /*arg*/) { // the expected POSIX signature
+    for (;;) {
+        uint64_t nExp;
+        // block until the earliest deadline passes
+        ssize_t n = read(l_hrTimerFd, &nExp, sizeof(nExp));
+
+        QF_CRIT_ENTRY(dummy);
+        bool const isStop = l_hrStop;
+        QF_CRIT_EXIT(dummy);
+        if (isStop) { // QF::run() is ending?
+            break;
+        }
+        if (n == static_cast<ssize_t>(sizeof(nExp))) {
+            QHrTimeEvt::service_();
+        }
+    }
+    return static_cast<void *>(0); // return success
+}
+
+//............................................................................
+QHrTimeEvt::QHrTimeEvt(QActive * const act, enum_t const sgnl)
+  :
+#ifdef Q_EVT_CTOR
+    QEvt(static_cast<QSignal>(sgnl)),
+#endif
+    m_act(act),
+    m_deadline(static_cast<uint64_t>(0)),
+    m_interval(static_cast<uint64_t>(0)),
+    m_idx(static_cast<uint_fast16_t>(0))
+{
+    /// @pre The signal must be valid
+    Q_REQUIRE_ID(700, sgnl >= Q_USER_SIG);
+
+#ifndef Q_EVT_CTOR
+    sig = static_cast<QSignal>(sgnl); // set QEvt::sig of this time event
+#endif
+    poolId_ = static_cast<uint8_t>(0); // not from any event pool
+    refCtr_ = static_cast<uint8_t>(0); // a static event
+}
+//............................................................................
+void QHrTimeEvt::armX(uint64_t const nsec, uint64_t const interval) {
+    armAt(now() + nsec, interval);
+}
+//............................................................................
+void QHrTimeEvt::armAt(uint64_t const deadline, uint64_t const interval) {
+    QF_CRIT_ENTRY(dummy);
+
+    /// @pre the host AO must be valid and the time event must be disarmed
+    Q_REQUIRE_ID(710, (m_act != static_cast<QActive *>(0))
+                      && (m_idx == static_cast<uint_fast16_t>(0)));
+
+    m_deadline = deadline;
+    m_interval = interval;
+    insert_();
+    if (m_idx == static_cast<uint_fast16_t>(1)) { // the earliest deadline?
+        reprogram_();
+    }
+    if (!l_hrStarted) { // start the thread servicing the time evts, NOTE07
+        Q_ALLEGE_ID(730, pthread_create(&l_hrTimer, NULL, &hrTimer_thread,
+                                        static_cast<void *>(0)) == 0);
+        l_hrStarted = true;
+    }
+    QF_CRIT_EXIT(dummy);
+}
+//............................................................................
+bool QHrTimeEvt::disarm(void) {
+    bool wasArmed;
+    QF_CRIT_ENTRY(dummy);
+    if (m_idx != static_cast<uint_fast16_t>(0)) { // armed?
+        remove_();
+        wasArmed = true;
+        // the timerfd is left alone, because an early wakeup is harmless
+    }
+    else {
+        wasArmed = false;
+    }
+    QF_CRIT_EXIT(dummy);
+    return wasArmed;
+}
+//............................................................................
+uint64_t QHrTimeEvt::currDeadline(void) const {
+    QF_CRIT_ENTRY(dummy);
+    uint64_t deadline = (m_idx != static_cast<uint_fast16_t>(0))
+                        ? m_deadline
+                        : static_cast<uint64_t>(0);
+    QF_CRIT_EXIT(dummy);
+    return deadline;
+}
+//............................................................................
+uint64_t QHrTimeEvt::now(void) {
+    return monotonicNsec();
+}
+//............................................................................
+void QHrTimeEvt::service_(void) {
+    QF_CRIT_ENTRY(dummy);
+    uint64_t t = monotonicNsec();
+    while ((l_hrNum != static_cast<uint_fast16_t>(0))
+           && (l_hrHeap[1]->m_deadline <= t))
+    {
+        QHrTimeEvt *te = l_hrHeap[1];
+        QActive *act = te->m_act;
+        te->remove_();
+
+        // periodic time event?
+        if (te->m_interval != static_cast<uint64_t>(0)) {
+            // advance the absolute deadline by whole intervals, so that
+            // the time event stays phase-aligned, see NOTE07
+            te->m_deadline += te->m_interval;
+            if (te->m_deadline <= t) { // missed some periods?
+                te->m_deadline += ((t - te->m_deadline) / te->m_interval
+                                   + static_cast<uint64_t>(1))
+                                  * te->m_interval;
+            }
+            te->insert_();
+        }
+        QF_CRIT_EXIT(dummy); // exit crit. section before posting
+
+        (void)act->POST(te, &l_hrTimerFd); // asserts if queue overflows
+
+        QF_CRIT_ENTRY(dummy); // re-enter crit. section to continue
+    }
+    reprogram_();
+    QF_CRIT_EXIT(dummy);
+}
+//............................................................................
+void QHrTimeEvt::insert_(void) {
+    /// @pre the heap of the high-resolution time events must not overflow
+    Q_REQUIRE_ID(720, l_hrNum < static_cast<uint_fast16_t>(QF_HR_TIMEEVT_MAX));
+
+    ++l_hrNum;
+    place_(this, l_hrNum);
+    sift_(l_hrNum);
+}
+//............................................................................
+void QHrTimeEvt::remove_(void) {
+    uint_fast16_t i = m_idx;
+    QHrTimeEvt *last = l_hrHeap[l_hrNum];
+
+    --l_hrNum;
+    m_idx = static_cast<uint_fast16_t>(0);
+    if (last != this) { // fill the hole with the last element
+        place_(last, i);
+        sift_(i);
+    }
+}
+//............................................................................
+void QHrTimeEvt::place_(QHrTimeEvt * const t, uint_fast16_t const i) {
+    l_hrHeap[i] = t;
+    t->m_idx = i;
+}
+//............................................................................
+void QHrTimeEvt::sift_(uint_fast16_t i) {
+    QHrTimeEvt *t = l_hrHeap[i];
+
+    // move up while earlier than the parent...
+    while ((i > static_cast<uint_fast16_t>(1))
+           && (t->m_deadline < l_hrHeap[i / 2U]->m_deadline))
+    {
+        place_(l_hrHeap[i / 2U], i);
+        i /= 2U;
+    }
+    // move down while later than the earliest child...
+    for (;;) {
+        uint_fast16_t c = i * 2U;
+        if (c > l_hrNum) {
+            break;
+        }
+        if ((c < l_hrNum)
+            && (l_hrHeap[c + 1U]->m_deadline < l_hrHeap[c]->m_deadline))
+        {
+            ++c;
+        }
+        if (l_hrHeap[c]->m_deadline >= t->m_deadline) {
+            break;
+        }
+        place_(l_hrHeap[c], i);
+        i = c;
+    }
+    place_(t, i);
+}
+//............................................................................
+void QHrTimeEvt::reprogram_(void) {
+    struct itimerspec its;
+    its.it_interval.tv_sec  = 0;
+    its.it_interval.tv_nsec = 0;
+    if (l_hrNum != static_cast<uint_fast16_t>(0)) {
+        uint64_t deadline = l_hrHeap[1]->m_deadline;
+        if (deadline == static_cast<uint64_t>(0)) {
+            deadline = static_cast<uint64_t>(1); // zero would disarm timerfd
+        }
+        its.it_value.tv_sec  = static_cast<time_t>(deadline
+                             / static_cast<uint64_t>(NANOSLEEP_NSEC_PER_SEC));
+        its.it_value.tv_nsec = static_cast<long>(deadline
+                             % static_cast<uint64_t>(NANOSLEEP_NSEC_PER_SEC));
+    }
+    else { // no time events armed, disarm the timerfd
+        its.it_value.tv_sec  = 0;
+        its.it_value.tv_nsec = 0;
+    }
+    (void)timerfd_settime(l_hrTimerFd, TFD_TIMER_ABSTIME, &its, NULL);
+}
 
 } // namespace QP
 
@@ -250,3 +668,59 @@ static void *ao_thread(void *arg) { // the expected POSIX signature
 // deliver only 2*actual-system-tick granularity. To compensate for this,
 // you would need to reduce (by 2) the constant NANOSLEEP_NSEC_PER_SEC.
 //
+// NOTE06:
+// In the tickless mode (see QF_setTickless()), QF::run() does not wake up
+// every clock tick. Instead, it sleeps until the earliest expiration of any
+// armed time event over all tick rates (QP::QF::ticksToNextX()), accounts
+// for the elapsed ticks in one step (QP::QF::skipTicksX()) and calls
+// QF_onClockTick() only for the tick in which the time event expires. When
+// no time events are armed, QF::run() sleeps until one is armed.
+//
+// QTimeEvt::armX() and QTimeEvt::rearm() call QF_ticklessArm_() (through
+// the QTIMEEVT_ARM_SIGNAL_() macro) before loading the time event counter.
+// This accounts for the ticks elapsed so far, so that the new time event
+// expires after the requested number of ticks, and wakes up QF::run() to
+// take a sooner deadline into account. While no time events are armed,
+// there are no ticks to account for, and the time of the last tick follows
+// the current time, so that a long idle period never needs more ticks than
+// QTimeEvtCtr can hold. Otherwise, the skipped ticks are limited to the
+// ticks before the next expiration.
+//
+// QF::run() sleeps in ppoll() on an eventfd (with the critical section
+// exited), which QF_ticklessArm_() and QF::stop() write to. Unlike a signal
+// of a condition variable, the write is never lost, even when it comes
+// before QF::run() starts to sleep.
+//
+// The tickless mode assumes that QF_onClockTick() services all the tick
+// rates (calls QF_TICK_X() for every rate) and does nothing else that needs
+// to run periodically, such as polling the console input.
+//
+// NOTE07:
+// The high-resolution time events (QP::QHrTimeEvt) are serviced by a
+// separate thread blocked on a timerfd, which is always programmed (with
+// an absolute CLOCK_MONOTONIC deadline) to the earliest deadline in the
+// heap of armed time events. When a periodic time event falls behind by
+// more than one interval (e.g., when the machine is very busy), the missed
+// expirations are skipped rather than posted in a burst, but the deadline
+// stays aligned to the original phase.
+//
+// The thread is created only when the first high-resolution time event is
+// armed, so the applications not using them do not pay for the thread.
+// At the end of QF::run(), the timerfd is programmed to expire right away
+// to unblock the thread, which then notices the stop request and ends, and
+// QF::run() joins it.
+//
+// NOTE08:
+// With QF_LATENCY, the duration of the RTC step recorded after dispatch()
+// includes the time when the active object thread was preempted by other
+// threads, so it measures the response time of the RTC step rather than
+// the CPU time spent in it.
+//
+// NOTE09:
+// QF::stop() is called from Q_onAssert() and from the QS callbacks, which
+// often run in a critical section, that is, with QF_pThreadMutex_ already
+// locked by the calling thread. Locking the (non-recursive) mutex again
+// would deadlock, so QF::stop() sets the l_isRunning flag atomically and
+// wakes up the tickless clock by writing to its eventfd, which does not
+// need the mutex (see NOTE06).
+//
@@ -54,7 +54,18 @@
 #define QF_EQUEUE_CTR_SIZE   4
 #define QF_MPOOL_SIZ_SIZE    4
 #define QF_MPOOL_CTR_SIZE    4
+#ifndef QF_TIMEEVT_CTR_SIZE // can be overridden (e.g., in the self-test)
 #define QF_TIMEEVT_CTR_SIZE  4
+#endif
+
+// signals covered by the per-AO masks of ignored signals (opt-in), NOTE2
+//#define QF_SIG_FILTER_SIZE 64
+
+// the maximum number of armed high-resolution time events, see NOTE4
+#define QF_HR_TIMEEVT_MAX    32
+
+// time source of the latency histograms (QF_LATENCY) [ns], see NOTE5
+#define QF_LATENCY_TIME_()   (QP::QF_latencyTime_())
 
 /* QF interrupt disable/enable, see NOTE1 */
 #define QF_INT_DISABLE()     pthread_mutex_lock(&QP::QF_pThreadMutex_)
@@ -66,6 +77,7 @@
 #define QF_CRIT_EXIT(dummy)  QF_INT_ENABLE()
 
 #include <pthread.h>   // POSIX-thread API
+#include <time.h>      // for clock_gettime()
 #include "qep_port.h"  // QEP port
 #include "qequeue.h"   // POSIX needs event-queue
 #include "qmpool.h"    // POSIX needs memory-pool
@@ -76,9 +88,95 @@ namespace QP {
 
 void QF_setTickRate(uint32_t ticksPerSec); // set clock tick rate
 void QF_onClockTick(void); // clock tick callback (provided in the app)
+void QF_setTickless(bool const isTickless); // tickless clock, see NOTE3
 
 extern pthread_mutex_t QF_pThreadMutex_; // mutex for QF critical section
 
+#ifdef QF_LATENCY
+//! CLOCK_MONOTONIC in nanoseconds (modulo 2^32), see NOTE5
+inline QFLatencyTime QF_latencyTime_(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<QFLatencyTime>(
+        (static_cast<uint32_t>(ts.tv_sec) * 1000000000U)
+        + static_cast<uint32_t>(ts.tv_nsec));
+}
+#endif // QF_LATENCY
+
+//****************************************************************************
+//! High-resolution time event with absolute deadlines (POSIX), see NOTE4
+/// @description
+/// QP::QHrTimeEvt is armed in nanoseconds of the CLOCK_MONOTONIC time base
+/// rather than in clock ticks. The armed time events are kept in a min-heap
+/// ordered by their absolute deadlines and are serviced by a dedicated
+/// thread blocked on a timerfd, which is always programmed to the earliest
+/// deadline. Upon expiration, the time event posts itself to the associated
+/// active object, exactly as QP::QTimeEvt does.
+///
+/// Periodic high-resolution time events advance their deadlines by the
+/// interval from the previous deadline (not from the actual expiration),
+/// so they stay phase-aligned and do not accumulate drift.
+class QHrTimeEvt : public QEvt {
+private:
+    //! the active object that receives the time events
+    QActive *m_act;
+
+    //! the absolute deadline [ns] in the CLOCK_MONOTONIC time base
+    uint64_t m_deadline;
+
+    //! the interval [ns] for periodic time events (0 for one-shot)
+    uint64_t m_interval;
+
+    //! the position in the heap of armed time events (0 when disarmed)
+    uint_fast16_t m_idx;
+
+public:
+    //! The constructor of the high-resolution time event
+    QHrTimeEvt(QActive * const act, enum_t const sgnl);
+
+    //! Arm the time event to expire in @p nsec nanoseconds from now
+    void armX(uint64_t const nsec,
+              uint64_t const interval = static_cast<uint64_t>(0));
+
+    //! Arm the time event to expire at the absolute @p deadline
+    void armAt(uint64_t const deadline,
+               uint64_t const interval = static_cast<uint64_t>(0));
+
+    //! Disarm the time event
+    bool disarm(void);
+
+    //! Get the absolute deadline of an armed time event (0 if disarmed)
+    uint64_t currDeadline(void) const;
+
+    //! The current time [ns] in the CLOCK_MONOTONIC time base
+    static uint64_t now(void);
+
+    //! Service the expired time events (used only inside the QF port)
+    static void service_(void);
+
+private:
+    //! insert this time event into the heap, must be called in crit. sect.
+    void insert_(void);
+
+    //! remove this time event from the heap, must be called in crit. sect.
+    void remove_(void);
+
+    //! program the timerfd to the earliest deadline in the heap
+    static void reprogram_(void);
+
+    //! restore the heap order by moving the element at @p i up or down
+    static void sift_(uint_fast16_t i);
+
+    //! place time event @p t at heap position @p i
+    static void place_(QHrTimeEvt * const t, uint_fast16_t const i);
+
+    //! hidden copy constructor
+    QHrTimeEvt(QHrTimeEvt const &);
+
+    //! hidden assignment operator
+    QHrTimeEvt & operator=(QHrTimeEvt const &);
+};
+
 } // namespace QP
 
 //****************************************************************************
@@ -101,6 +199,13 @@ extern pthread_mutex_t QF_pThreadMutex_; // mutex for QF critical section
                          != static_cast<QActive *>(0)); \
         pthread_cond_signal(&(me_)->m_osObject) \
 
+    // wake up the tickless clock when a time event is armed, see NOTE3
+    #define QTIMEEVT_ARM_SIGNAL_() QF_ticklessArm_()
+
+    namespace QP {
+        void QF_ticklessArm_(void);
+    } // namespace QP
+
     // native QF event pool operations...
     #define QF_EPOOL_TYPE_            QMPool
     #define QF_EPOOL_INIT_(p_, poolSto_, poolSize_, evtSize_) \
@@ -141,5 +246,34 @@ extern pthread_mutex_t QF_pThreadMutex_; // mutex for QF critical section
 // implementation, such as Linux p-threads, should support the priority-
 // inheritance protocol.
 //
+// NOTE2:
+// The masks of ignored signals (QP::QSigMask) allow active objects to
+// discard events that their current state ignores already at the time of
+// posting, see QP::QActive::setIgnoredSigs(). The feature is disabled by
+// default. To enable it, define QF_SIG_FILTER_SIZE (a multiple of 8) here
+// or for both the QP library and the application (e.g., "make
+// DEFINES=-DQF_SIG_FILTER_SIZE=64"), because it adds members to QActive.
+//
+// NOTE3:
+// By default, QF::run() calls QF_onClockTick() every clock tick, even when
+// no time events are armed. Calling QF_setTickless(true) before QF::run()
+// selects the tickless clock, which sleeps until the next expiration of
+// a time event and applies all the elapsed ticks in one step. This mode
+// requires that QF_onClockTick() does nothing but QF_TICK_X() for all
+// the tick rates (see also NOTE06 in qf_port.cpp).
+//
+// NOTE4:
+// The high-resolution time events (QP::QHrTimeEvt) do not use the clock
+// ticks at all, so they provide microsecond accuracy without a fast tick.
+// The heap of armed high-resolution time events has a fixed capacity of
+// QF_HR_TIMEEVT_MAX, which is asserted when arming a time event.
+//
+// NOTE5:
+// The latency histograms of the active objects (QF_LATENCY, e.g., "make
+// DEFINES=-DQF_LATENCY" for the QP library and the application) measure
+// in nanoseconds of CLOCK_MONOTONIC, which Linux reads from the vDSO
+// without a system call. The 32-bit time stamps wrap around every 4.3 s,
+// which limits the measured latencies, but not the run time.
+//
 
 #endif // qf_port_h
@@ -0,0 +1,75 @@
+/// \file
+/// \brief Layout of the QS flight-recorder file and shared memory (POSIX)
+/// \cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// \endcond
+
+#ifndef qs_file_h
+#define qs_file_h
+
+// This header is shared between the QS port and the qsdump and qsshm tools,
+// so it must remain valid in both C and C++.
+#include <stdint.h>
+
+#define QS_FILE_MAGIC     "QSFR"  // magic bytes at the start of the file
+#define QS_FILE_VERSION   2U      // version of the file layout
+// room for the saved Target info (the records produced by QS::initBuf()),
+// QS_initFileBuf() and QS_initShmBuf() assert that the records fit into it
+#define QS_FILE_INFO_SIZE 104U
+
+//! Header of the QS flight-recorder file, followed by the QS ring buffer
+/// @description
+/// The QS ring buffer lives in the file right after this header. QS keeps
+/// the @c head field up to date after every record (see QS_initFileBuf()),
+/// so the file contains everything needed to recover the records in order
+/// after the process dies. The header also keeps a copy of the Target info
+/// record produced at startup, which is typically overwritten in the ring
+/// long before a crash, but which QSPY needs to decode the other records.
+///
+/// The same layout is used for the QS buffer in POSIX shared memory (see
+/// QS_initShmBuf()). There, a consumer process (e.g., qsshm) reads the
+/// records in place between its @c tail and the @c head published by QS,
+/// and publishes its progress in @c tail. Both offsets are stored with the
+/// release and loaded with the acquire semantics.
+typedef struct {
+    char     magic[4];  //!< QS_FILE_MAGIC
+    uint32_t version;   //!< QS_FILE_VERSION
+    uint32_t size;      //!< size of the QS ring buffer [bytes]
+    uint32_t head;      //!< offset where the next QS byte will be written
+    uint32_t tail;      //!< offset of the next byte for the consumer
+    uint32_t infoLen;   //!< length of the saved Target info [bytes]
+    uint8_t  info[QS_FILE_INFO_SIZE]; //!< the saved Target info frames
+} QSFileHdr;
+
+#endif // qs_file_h
@@ -0,0 +1,544 @@
+/// @file
+/// @brief QS/C++ port to POSIX, flight-recorder QS buffer
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+
+#define QP_IMPL           // this is QP implementation
+#include "qs_port.h"      // QS port
+#include "qs_pkg.h"       // QS package-scope internal interface
+#include "qs_file.h"      // layout of the flight-recorder file
+#include "qassert.h"      // QP embedded assertions
+
+#include <fcntl.h>        // for open()
+#include <string.h>       // for memcpy()
+#include <sys/mman.h>     // for mmap(), shm_open()
+#include <unistd.h>       // for ftruncate(), close()
+#include <time.h>         // for clock_gettime(), nanosleep()
+#include <errno.h>        // for errno
+#include <sys/uio.h>      // for writev()
+
+#if defined(__x86_64__) || defined(__i386__)
+    #ifndef QS_TSC
+        #define QS_TSC    // the Time-Stamp Counter might be used, NOTE2
+    #endif
+    #include <cpuid.h>      // for __get_cpuid()
+    #include <x86intrin.h>  // for __rdtsc()
+#endif
+
+#ifndef QS_BLOCK_MS
+    //! the maximum wait for the QS flusher [ms], see QS_waitFlusher()
+    #define QS_BLOCK_MS 10U
+#endif
+
+namespace QP {
+
+Q_DEFINE_THIS_MODULE("qs_port")
+
+// high-resolution QS time source, see NOTE2
+static uint64_t l_ns0;     // CLOCK_MONOTONIC_RAW [ns] at QS_initTime()
+#ifdef QS_TSC
+static uint64_t l_tsc0;    // the TSC at QS_initTime()
+static uint64_t l_tscMult; // [ns per TSC tick] * 2^32 (0 if TSC not used)
+#endif
+
+#ifdef QS_THREAD_RINGS
+static pthread_key_t l_ringKey;  // releases the per-thread QS rings
+static pthread_once_t l_ringOnce = PTHREAD_ONCE_INIT;
+
+//! the destructor of l_ringKey, called at the exit of the thread
+static void ringKeyDestructor(void *ring) {
+    QS::ringExit_(ring);
+}
+//! create l_ringKey once
+static void ringKeyCreate(void) {
+    Q_ALLEGE_ID(500, pthread_key_create(&l_ringKey, &ringKeyDestructor)
+                     == 0);
+}
+#endif // QS_THREAD_RINGS
+
+//! read CLOCK_MONOTONIC_RAW in nanoseconds
+static uint64_t monoRawNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000000U)
+           + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+//! map the QS ring buffer with the QSFileHdr header from the file @p fd
+/// @description
+/// Used by QS_initFileBuf() and QS_initShmBuf(). The file descriptor is
+/// closed, because the mapping stays valid after closing the file.
+static bool mapBuf(int const fd, uint32_t const size) {
+    bool ok = false;
+    size_t len = sizeof(QSFileHdr) + static_cast<size_t>(size);
+
+    // the truncated file or shared memory object is extended with zeros,
+    // so qsdump can tell whether the ring of the flight-recorder file has
+    // wrapped around (qsshm uses the head and tail in the header instead)
+    if (ftruncate(fd, static_cast<off_t>(len)) == 0) {
+        void *map = mmap(static_cast<void *>(0), len,
+                         PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (map != MAP_FAILED) {
+            QSFileHdr *hdr = static_cast<QSFileHdr *>(map);
+            uint8_t *sto = static_cast<uint8_t *>(map) + sizeof(QSFileHdr);
+
+            QS::initBuf(sto, static_cast<uint_fast16_t>(size));
+
+            // save the records produced by QS::initBuf() (Target info),
+            // which must fit into the header, see QS_FILE_INFO_SIZE
+            uint32_t n = static_cast<uint32_t>(QS::priv_.head);
+            Q_ASSERT_ID(110, n <= static_cast<uint32_t>(QS_FILE_INFO_SIZE));
+            memcpy(hdr->info, sto, static_cast<size_t>(n));
+            hdr->infoLen = n;
+            hdr->size    = size;
+            hdr->tail    = static_cast<uint32_t>(0); // consume from start
+            hdr->version = static_cast<uint32_t>(QS_FILE_VERSION);
+            memcpy(hdr->magic, QS_FILE_MAGIC, sizeof(hdr->magic));
+
+            // from now on, QS keeps the head in the file, see NOTE3
+            QS_HEAD_PUBLISH_(&hdr->head, static_cast<QSCtr>(QS::priv_.head));
+            QS::priv_.headCopy = reinterpret_cast<QSCtr *>(&hdr->head);
+            ok = true;
+        }
+    }
+    close(fd);
+    return ok;
+}
+
+//****************************************************************************
+/// @description
+/// Places the QS ring buffer in the memory-mapped file @p fileName (see
+/// NOTE1), so that the last @p size bytes of QS records survive a crash
+/// of the process, including an assertion or a kill signal. This function
+/// should be called from QP::QS::onStartup() instead of QP::QS::initBuf().
+///
+/// @param[in] fileName the flight-recorder file (created or truncated)
+/// @param[in] size     size of the QS ring buffer in the file [bytes]
+///
+/// @returns 'true' if the file was mapped and 'false' otherwise, in which
+/// case the QS buffer was not initialized.
+///
+/// @note The records can be extracted from the file with the qsdump tool
+/// (ports/posix/qsdump), which produces a binary file for QSPY.
+///
+bool QS_initFileBuf(char_t const * const fileName, uint32_t const size) {
+    bool ok = false;
+    int fd = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        ok = mapBuf(fd, size);
+    }
+    return ok;
+}
+
+//****************************************************************************
+/// @description
+/// Places the QS ring buffer in the POSIX shared memory object @p name
+/// (see NOTE3), from which a local consumer process (e.g., the qsshm tool
+/// in ports/posix/qsshm) reads the QS records in place, without any system
+/// calls or copies in the traced application. This function should be
+/// called from QP::QS::onStartup() instead of QP::QS::initBuf().
+///
+/// @param[in] name the shared memory object (e.g., "/qspy"), which is
+///                 created or truncated
+/// @param[in] size size of the QS ring buffer [bytes]
+///
+/// @returns 'true' if the shared memory was mapped and 'false' otherwise,
+/// in which case the QS buffer was not initialized.
+///
+/// @note
+/// The application does not need to call QP::QS::getBlock() or to
+/// provide a QS output thread, because the consumer reads the records
+/// directly from the shared memory.
+///
+bool QS_initShmBuf(char_t const * const name, uint32_t const size) {
+    bool ok = false;
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd >= 0) {
+        ok = mapBuf(fd, size);
+    }
+    return ok;
+}
+
+// QS flusher thread, see NOTE4
+static pthread_t      l_flushThread;
+static pthread_cond_t l_flushCond;   // signaled at the watermark
+static pthread_cond_t l_roomCond;    // signaled when the data is written
+static int            l_flushFd;     // where the QS data is written
+static QSCtr          l_flushWmark;  // the watermark [bytes]
+static uint32_t       l_flushPeriod; // the maximum sleep time [ms]
+static bool           l_flushRun;    // the flusher is running
+
+//! write all the blocks with writev(), resuming after partial writes
+static bool writeAll(int const fd, struct iovec *iov, int cnt) {
+    bool ok = true;
+    while (ok && (cnt > 0)) {
+        ssize_t n = writev(fd, iov, cnt);
+        if (n >= 0) {
+            size_t rem = static_cast<size_t>(n);
+            while ((cnt > 0) && (rem >= iov->iov_len)) { // block written?
+                rem -= iov->iov_len;
+                ++iov;
+                --cnt;
+            }
+            if (cnt > 0) { // partial write of a block?
+                iov->iov_base = static_cast<uint8_t *>(iov->iov_base) + rem;
+                iov->iov_len -= rem;
+            }
+        }
+        else {
+            ok = (errno == EINTR); // retry only the interrupted writev()
+        }
+    }
+    return ok;
+}
+
+//! write the QS data to the flusher file (called with the mutex locked)
+static bool flushAll(void) {
+    bool ok   = true;
+    bool more = true;
+    while (ok && more) {
+        uint8_t const *blk[2];
+        QSCtr len[2];
+        uint_fast8_t const nBlk = QS::peekBlocks(blk, len);
+        more = (nBlk != static_cast<uint_fast8_t>(0));
+        if (more) {
+            struct iovec iov[2];
+            QSCtr n = static_cast<QSCtr>(0);
+            for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+                 i < nBlk; ++i)
+            {
+                iov[i].iov_base = const_cast<uint8_t *>(blk[i]);
+                iov[i].iov_len  = static_cast<size_t>(len[i]);
+                n += len[i];
+            }
+            uint32_t const lost = QS::priv_.lost;
+
+            pthread_mutex_unlock(&QF_pThreadMutex_); // write without lock
+            ok = writeAll(l_flushFd, &iov[0], static_cast<int>(nBlk));
+            pthread_mutex_lock(&QF_pThreadMutex_);
+
+            if (QS::priv_.lost == lost) { // no overrun during the write?
+                QS::freeBlocks(n);
+            }
+            // else the overrun already moved the tail past the written data
+            pthread_cond_broadcast(&l_roomCond); // release waiting producers
+
+            pthread_mutex_unlock(&QF_pThreadMutex_); // QS critical section
+            (void)QS::overrunReport();
+            pthread_mutex_lock(&QF_pThreadMutex_);
+
+            // keep writing while the buffer is above the watermark again,
+            // and write everything when the flusher is stopping
+            more = (QS::priv_.used >= l_flushWmark) || (!l_flushRun);
+        }
+    }
+    return ok;
+}
+
+//! the QS flusher thread routine
+static void *flushThread(void *arg) {
+    (void)arg;
+    bool ok = true;
+
+    pthread_mutex_lock(&QF_pThreadMutex_);
+    while (ok && l_flushRun) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        ts.tv_nsec += static_cast<long>(l_flushPeriod % 1000U) * 1000000L;
+        ts.tv_sec  += static_cast<time_t>(l_flushPeriod / 1000U);
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_nsec -= 1000000000L;
+            ++ts.tv_sec;
+        }
+        QS::setWatermark(l_flushWmark);
+        (void)pthread_cond_timedwait(&l_flushCond, &QF_pThreadMutex_, &ts);
+        QS::setWatermark(static_cast<QSCtr>(0)); // no wake-ups until armed
+        ok = flushAll();
+    }
+    if (ok) {
+        (void)flushAll(); // the rest of the QS data (l_flushRun is false)
+    }
+    pthread_mutex_unlock(&QF_pThreadMutex_);
+    return static_cast<void *>(0);
+}
+
+//****************************************************************************
+/// @description
+/// Starts the QS flusher thread (see NOTE4), which writes the QS data to
+/// the file descriptor @p fd. This function should be called from
+/// QP::QS::onStartup(), after the QS buffer has been initialized.
+///
+/// @param[in] fd       the open file or connected socket for the QS data
+/// @param[in] wmark    the number of bytes in the QS buffer that wakes up
+///                     the flusher (e.g., a half of the buffer)
+/// @param[in] periodMs the maximum time the data waits in the buffer [ms]
+///
+/// @returns 'true' if the flusher thread has been started.
+///
+/// @note The flusher stops writing (and exits) when the write fails,
+/// such as when QSPY closes the socket.
+///
+bool QS_startFlusher(int const fd, uint32_t const wmark,
+                     uint32_t const periodMs)
+{
+    /// @pre the watermark must be within the QS buffer and the period > 0
+    Q_REQUIRE_ID(100, (static_cast<QSCtr>(0) < static_cast<QSCtr>(wmark))
+                      && (static_cast<QSCtr>(wmark) <= QS::priv_.end)
+                      && (periodMs != static_cast<uint32_t>(0)));
+
+    pthread_condattr_t cattr;
+    pthread_condattr_init(&cattr);
+    pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+    pthread_cond_init(&l_flushCond, &cattr);
+    pthread_cond_init(&l_roomCond, &cattr);
+    pthread_condattr_destroy(&cattr);
+
+    l_flushFd     = fd;
+    l_flushWmark  = static_cast<QSCtr>(wmark);
+    l_flushPeriod = periodMs;
+    l_flushRun    = true;
+
+    bool ok = (pthread_create(&l_flushThread, static_cast<pthread_attr_t *>(0),
+                              &flushThread, static_cast<void *>(0)) == 0);
+    if (!ok) {
+        l_flushRun = false;
+        pthread_cond_destroy(&l_flushCond);
+        pthread_cond_destroy(&l_roomCond);
+    }
+    return ok;
+}
+
+//****************************************************************************
+/// @description
+/// Stops the QS flusher thread after it writes the remaining QS data.
+/// This function should be called from QP::QS::onCleanup().
+///
+void QS_stopFlusher(void) {
+    if (l_flushRun) {
+        pthread_mutex_lock(&QF_pThreadMutex_);
+        l_flushRun = false;
+        pthread_cond_signal(&l_flushCond);
+        pthread_cond_broadcast(&l_roomCond);
+        pthread_mutex_unlock(&QF_pThreadMutex_);
+
+        pthread_join(l_flushThread, static_cast<void **>(0));
+        pthread_cond_destroy(&l_flushCond);
+        pthread_cond_destroy(&l_roomCond);
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Wakes up the QS flusher thread to write the QS data now. QS calls this
+/// function (through #QS_WMARK_HOOK_) when the QS buffer reaches the
+/// watermark, and QP::QS::onFlush() can call it as well.
+///
+void QS_wakeFlusher(void) {
+    pthread_cond_signal(&l_flushCond);
+}
+
+//****************************************************************************
+/// @description
+/// Wakes up the QS flusher thread and waits (at most #QS_BLOCK_MS
+/// milliseconds) until it frees some room in the QS buffer. QS calls this
+/// function (through #QS_BLOCK_HOOK_) with the QF critical section locked,
+/// when a thread begins a record with the QS buffer nearly full and
+/// #QS_BLOCK_PRODUCER is defined. Without the running flusher, this
+/// function returns immediately and the record is dropped.
+///
+void QS_waitFlusher(void) {
+#ifdef QS_DROP_NEWEST
+    if (l_flushRun) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        ts.tv_nsec += static_cast<long>(QS_BLOCK_MS) * 1000000L;
+        while (ts.tv_nsec >= 1000000000L) {
+            ts.tv_nsec -= 1000000000L;
+            ++ts.tv_sec;
+        }
+        pthread_cond_signal(&l_flushCond);
+        int err = 0;
+        while ((err == 0) && l_flushRun
+               && (QS::priv_.used > QS::priv_.dropLevel))
+        {
+            err = pthread_cond_timedwait(&l_roomCond, &QF_pThreadMutex_,
+                                         &ts);
+        }
+    }
+#endif // QS_DROP_NEWEST
+}
+
+#ifdef QS_TSC
+//! read the TSC and CLOCK_MONOTONIC_RAW at (nearly) the same instant
+/// @description
+/// Brackets the clock reading between two TSC readings and keeps the
+/// tightest of several attempts, so that a preemption in between does not
+/// spoil the calibration.
+static void tscPair(uint64_t * const pTsc, uint64_t * const pNs) {
+    uint64_t best = ~static_cast<uint64_t>(0);
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(8); ++i)
+    {
+        uint64_t t0 = __rdtsc();
+        uint64_t ns = monoRawNs();
+        uint64_t t1 = __rdtsc();
+        if ((t1 - t0) < best) {
+            best  = t1 - t0;
+            *pTsc = t0 + ((t1 - t0) >> 1); // the midpoint
+            *pNs  = ns;
+        }
+    }
+}
+#endif // QS_TSC
+
+//****************************************************************************
+/// @description
+/// Starts the high-resolution QS time source (see NOTE2). On x86 with the
+/// invariant TSC, measures the TSC frequency against CLOCK_MONOTONIC_RAW
+/// over 10 ms. This function should be called at the beginning of
+/// QP::QS::onStartup(), before any threads produce QS records.
+///
+void QS_initTime(void) {
+    l_ns0 = monoRawNs();
+#ifdef QS_TSC
+    l_tscMult = static_cast<uint64_t>(0);
+
+    unsigned a, b, c, d;
+    if ((__get_cpuid(0x80000007U, &a, &b, &c, &d) != 0)
+        && ((d & (1U << 8)) != 0U)) // invariant TSC?
+    {
+        struct timespec const delay = { 0, 10000000L }; // 10 ms
+        uint64_t ns;
+        uint64_t tsc;
+        tscPair(&tsc, &ns);
+        nanosleep(&delay, static_cast<struct timespec *>(0));
+        uint64_t dtsc;
+        uint64_t dns;
+        tscPair(&dtsc, &dns);
+        dtsc -= tsc;
+        dns  -= ns;
+
+        if (dtsc != static_cast<uint64_t>(0)) {
+            l_tscMult = (dns << 32) / dtsc;
+            l_tsc0    = tsc;
+            l_ns0     = ns;
+        }
+    }
+#endif // QS_TSC
+}
+
+//****************************************************************************
+/// @description
+/// High-resolution QS time source for QP::QS::onGetTime().
+///
+/// @returns the nanoseconds since QP::QS_initTime() with the 64-bit time
+/// stamps (#QS_TIME_SIZE 8), otherwise the microseconds, truncated to the
+/// QP::QSTimeCtr type (see NOTE5 in qs_port.h).
+///
+QSTimeCtr QS_getTime(void) {
+    uint64_t ns;
+#ifdef QS_TSC
+    if (l_tscMult != static_cast<uint64_t>(0)) {
+        ns = static_cast<uint64_t>(
+                 (static_cast<unsigned __int128>(__rdtsc() - l_tsc0)
+                  * l_tscMult) >> 32);
+    }
+    else {
+        ns = monoRawNs() - l_ns0;
+    }
+#else
+    ns = monoRawNs() - l_ns0;
+#endif // QS_TSC
+
+#if (QS_TIME_SIZE < 8)
+    return static_cast<QSTimeCtr>(ns / 1000U); // microseconds, see NOTE5
+#else
+    return static_cast<QSTimeCtr>(ns);
+#endif
+}
+
+#ifdef QS_THREAD_RINGS
+//****************************************************************************
+/// @description
+/// Attaches the per-thread QS @p ring to the calling thread, so that the
+/// ring is released with QP::QS::ringExit_() when the thread exits.
+///
+void QS_ringAttach_(void * const ring) {
+    (void)pthread_once(&l_ringOnce, &ringKeyCreate);
+    (void)pthread_setspecific(l_ringKey, ring);
+}
+#endif // QS_THREAD_RINGS
+
+} // namespace QP
+
+//****************************************************************************
+// NOTE1:
+// The ring buffer is mapped with MAP_SHARED, so every QS record lands in
+// the kernel page cache of the file as soon as it is written, without any
+// system call. The kernel writes the dirty pages back to the file even
+// after the process crashes. In normal operation nothing needs to read
+// the QS buffer at all (QS::getBlock() can still be used to send the data
+// to QSPY live). When nobody reads the buffer, QS overwrites the oldest
+// records, so the file always holds the most recent records.
+//
+// NOTE2:
+// Reading the TSC (rdtsc) costs a few nanoseconds, and the invariant TSC
+// (CPUID 0x80000007, EDX bit 8) runs at a constant rate in all power states
+// and is synchronized across the cores, so the time stamps from different
+// threads are comparable. Without the invariant TSC (e.g., in some virtual
+// machines or on other CPUs), QS_getTime() reads CLOCK_MONOTONIC_RAW, which
+// is not slewed by NTP and is read from the vDSO without a system call.
+//
+// NOTE3:
+// QS publishes the head at the end of every record with a release store
+// (QS_HEAD_PUBLISH_() in qs_port.h), so a consumer in another process that
+// loads the head with the acquire semantics sees only complete records.
+// The consumer reads the bytes between its tail and the head in place,
+// in at most two spans (like QS::getBlock()), and then publishes the new
+// tail. QS does not wait for the consumer: when the consumer falls behind
+// by more than the size of the buffer, QS overwrites the oldest records,
+// and the consumer detects the loss by the gaps in the QS record sequence
+// numbers or by the bad checksums, just like QSPY does for lossy links.
+//
+// NOTE4:
+// The flusher holds the QF critical section (QF_pThreadMutex_) only to
+// peek at the QS buffer and to free the written bytes, but not during the
+// writev(), so the producers can keep adding records while the data is
+// being written. When QS overruns the buffer during the write (i.e.,
+// QS::priv_.lost changes), QS has already moved the tail past the old
+// data, so the written bytes are not freed again. The overwritten part of
+// the written data then fails the QSPY checksum, and the QS_OVERRUN
+// record reports the number of the lost bytes.
+//
@@ -38,7 +38,10 @@
 #ifndef qs_port_h
 #define qs_port_h
 
-#define QS_TIME_SIZE        4
+#ifndef QS_TIME_SIZE
+    // size of the QS time stamp (8 for 64-bit time stamps [ns]), NOTE5
+    #define QS_TIME_SIZE    4
+#endif
 
 #if defined(__LP64__) || defined(_LP64) // 64-bit architecture?
     #define QS_OBJ_PTR_SIZE 8
@@ -55,6 +58,264 @@
 // the QF framework, by simply including "qf_port.h" *before* "qs.h".
 //
 #include "qf_port.h" // use QS with QF
+
+// per-thread lock-free QS rings (define QS_THREAD_RINGS to enable), NOTE1
+#ifdef QS_THREAD_RINGS
+
+    #include <stdlib.h> // for malloc()
+    #include <time.h>   // for clock_gettime()
+
+    // thread-local storage class specifier
+    #define QS_THREAD_LOCAL      __thread
+
+    // size of the ring of every thread producing QS records
+    #define QS_RING_SIZE         8192U
+
+    // the maximum length of a single QS record (including the ring header)
+    #define QS_RING_REC_MAX      512U
+
+    // the records go into per-thread rings without a critical section
+    #define QS_CRIT_ENTRY(dummy) ((void)0)
+    #define QS_CRIT_EXIT(dummy)  ((void)0)
+
+    // allocation of the per-thread ring
+    #define QS_RING_ALLOC_(size_) \
+        static_cast<uint8_t *>(malloc(static_cast<size_t>(size_)))
+    #define QS_RING_FREE_(mem_)  (free(mem_))
+
+    // the ring is released at the exit of the calling thread (pthread key)
+    #define QS_RING_ATTACH_(r_)  (QP::QS_ringAttach_(r_))
+
+    // atomic access to the variables shared by the producer and consumer
+    #define QS_RING_LOAD_(var_) \
+        __atomic_load_n(&(var_), __ATOMIC_ACQUIRE)
+    #define QS_RING_STORE_(var_, val_) \
+        __atomic_store_n(&(var_), (val_), __ATOMIC_RELEASE)
+    #define QS_RING_CAS_(var_, expected_, desired_) \
+        __atomic_compare_exchange_n(&(var_), &(expected_), (desired_), \
+            false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+    #define QS_RING_FENCE_()     (__atomic_thread_fence(__ATOMIC_SEQ_CST))
+
+    // monotonic timestamp [ns] for merging the records from the rings
+    namespace QP {
+        inline uint64_t QS_ringTime_(void) {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return (static_cast<uint64_t>(ts.tv_sec) * 1000000000U)
+                   + static_cast<uint64_t>(ts.tv_nsec);
+        }
+    } // namespace QP
+    #define QS_RING_TIME_()      (QP::QS_ringTime_())
+
+    namespace QP {
+        void QS_ringAttach_(void * const ring);
+    } // namespace QP
+
+#endif // QS_THREAD_RINGS
+
 #include "qs.h"      // QS platform-independent public interface
 
+namespace QP {
+
+// place the QS buffer in a memory-mapped flight-recorder file, see NOTE2
+bool QS_initFileBuf(char_t const * const fileName, uint32_t const size);
+
+// place the QS buffer in POSIX shared memory for a local consumer, NOTE7
+bool QS_initShmBuf(char_t const * const name, uint32_t const size);
+
+// calibrate the high-resolution QS time source, see NOTE5
+void QS_initTime(void);
+
+// high-resolution QS time stamp [ns or us] since QS_initTime(), see NOTE5
+QSTimeCtr QS_getTime(void);
+
+// start the QS flusher thread writing to the file descriptor fd, NOTE8
+bool QS_startFlusher(int const fd, uint32_t const wmark,
+                     uint32_t const periodMs);
+
+// stop the QS flusher thread after writing the remaining QS data, NOTE8
+void QS_stopFlusher(void);
+
+// wake up the QS flusher thread (e.g., from QS::onFlush()), NOTE8
+void QS_wakeFlusher(void);
+
+// wait until the QS flusher frees some room in the QS buffer, NOTE9
+void QS_waitFlusher(void);
+
+} // namespace QP
+
+#ifdef QP_IMPL
+// publish the head to the consumer in another process, see NOTE7
+#define QS_HEAD_PUBLISH_(ptr_, head_) \
+    __atomic_store_n((ptr_), (head_), __ATOMIC_RELEASE)
+
+// wake up the QS flusher when the QS buffer reaches the watermark, NOTE8
+#define QS_WMARK_HOOK_() (QP::QS_wakeFlusher())
+
+// wait for the QS flusher when the QS buffer is full, see NOTE9
+#define QS_BLOCK_HOOK_() (QP::QS_waitFlusher())
+#endif // QP_IMPL
+
+// bulk HDLC escaping of the QS data with SSE2/AVX2, see NOTE3
+#if defined(QP_IMPL) && defined(__SSE2__) && !defined(QS_ESC_SCALAR)
+
+#ifdef __AVX2__
+    #include <immintrin.h> // AVX2 intrinsics
+
+    // number of bytes escaped at once
+    #define QS_ESC_CHUNK 32U
+
+    namespace QP {
+        inline bool QS_escChunk_(uint8_t * const dst,
+                                 uint8_t const * const src,
+                                 uint8_t * const pSum)
+        {
+            __m256i v = _mm256_loadu_si256(
+                            reinterpret_cast<__m256i const *>(src));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), v);
+            __m256i s = _mm256_sad_epu8(v, _mm256_setzero_si256());
+            *pSum = static_cast<uint8_t>(_mm256_extract_epi16(s, 0)
+                                         + _mm256_extract_epi16(s, 4)
+                                         + _mm256_extract_epi16(s, 8)
+                                         + _mm256_extract_epi16(s, 12));
+            __m256i m = _mm256_or_si256(
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7E)),  // QS_FRAME
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7D))); // QS_ESC
+            return _mm256_movemask_epi8(m) != 0;
+        }
+    } // namespace QP
+
+#else // SSE2
+    #include <emmintrin.h> // SSE2 intrinsics
+
+    // number of bytes escaped at once
+    #define QS_ESC_CHUNK 16U
+
+    namespace QP {
+        inline bool QS_escChunk_(uint8_t * const dst,
+                                 uint8_t const * const src,
+                                 uint8_t * const pSum)
+        {
+            __m128i v = _mm_loadu_si128(
+                            reinterpret_cast<__m128i const *>(src));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), v);
+            __m128i s = _mm_sad_epu8(v, _mm_setzero_si128());
+            *pSum = static_cast<uint8_t>(_mm_extract_epi16(s, 0)
+                                         + _mm_extract_epi16(s, 4));
+            __m128i m = _mm_or_si128(
+                _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7E)),  // QS_FRAME
+                _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7D))); // QS_ESC
+            return _mm_movemask_epi8(m) != 0;
+        }
+    } // namespace QP
+
+#endif // __AVX2__
+
+#endif // QP_IMPL && __SSE2__ && !QS_ESC_SCALAR
+
+//****************************************************************************
+// NOTE1:
+// By default, every QS record is written into the single QS buffer inside
+// the QF critical section, which in this port is the global mutex
+// QF_pThreadMutex_. Tracing thus serializes all active object threads.
+//
+// When QS_THREAD_RINGS is defined (e.g., "make CONF=spy
+// DEFINES=-DQS_THREAD_RINGS"), every thread writes its records into its
+// own lock-free ring without any critical section, and QS::getBlock()
+// merges the rings into the main QS buffer in the order of the monotonic
+// timestamps (taken at the beginning of the records). A record younger
+// than a record still being written by another thread is held back until
+// that record ends, so a thread preempted in the middle of a record delays
+// the output of the other threads. The output stream is the same as
+// without the rings, so QSPY parses it without any changes. A record that
+// does not fit into a full ring is dropped (see QS::getRingLost()). The
+// ring of a thread is freed after the thread exits (pthread key
+// destructor) and the remaining records are merged. The main QS buffer
+// must be larger than 2*QS_RING_REC_MAX, and QS::getBlock()/QS::getByte()
+// must not be called from more than one thread at a time.
+//
+// NOTE2:
+// QS_initFileBuf() replaces QS::initBuf() in QS::onStartup() to keep the
+// QS buffer in a memory-mapped file, so that the most recent QS records
+// survive a crash (e.g., an assertion in Q_onAssert()). The qsdump tool
+// (ports/posix/qsdump) extracts the records in order into a binary file
+// for QSPY. With QS_THREAD_RINGS, the records reach the file only when
+// the per-thread rings are merged by QS::getBlock().
+//
+// NOTE3:
+// QS::mem() escapes and checksums its data in chunks of QS_ESC_CHUNK bytes
+// with QS_escChunk_(), which copies the chunk into the QS buffer, computes
+// the sum of its bytes and reports whether any byte needs HDLC escaping.
+// With SSE2 (always available on x86-64) the chunk is 16 bytes, and with
+// AVX2 (e.g., "make DEFINES=-mavx2") it is 32 bytes. Defining QS_ESC_SCALAR
+// selects the portable default in qs_pkg.h. The QS output is the same
+// in all cases, which the self-test (examples/posix/self_test, suites
+// "default", "scalar" and "avx2") checks byte for byte.
+//
+// NOTE4:
+// The compact QS encoding (interned object/function IDs and delta time
+// stamps, see QS_COMPACT in qs.h) is enabled by "make CONF=spy
+// DEFINES=-DQS_COMPACT". It requires a host decoder that understands it,
+// and it cannot be combined with QS_THREAD_RINGS.
+//
+// NOTE5:
+// QS_getTime() is a QS time source for QS::onGetTime() that counts the
+// nanoseconds since QS_initTime(), which should be called at the beginning
+// of QS::onStartup(). On x86 with the invariant TSC, QS_getTime() reads the
+// TSC and scales it with the factor calibrated against CLOCK_MONOTONIC_RAW
+// in QS_initTime() (which takes about 10 ms). Otherwise it reads
+// CLOCK_MONOTONIC_RAW, which Linux also serves without a system call from
+// the vDSO. The nanoseconds in 32 bits would wrap around every 4.3 s, so
+// with the 32-bit time stamps (QS_TIME_SIZE 4, the default) QS_getTime()
+// counts the microseconds, which wrap around every 71 minutes. The 64-bit
+// time stamps ("make CONF=spy DEFINES=-DQS_TIME_SIZE=8") count the
+// nanoseconds (decode them with "qsexport -n 1").
+//
+// NOTE6:
+// The statistical sampling of QS records (see QS_SAMPLING in qs.h) is
+// enabled by "make CONF=spy DEFINES=-DQS_SAMPLING". QS::sample() then
+// selects the record types (and optionally signals) produced only 1 in N
+// times or once per time interval. The sampled records carry the number
+// of the skipped records, so the host can scale its counts. Sampling
+// cannot be combined with QS_THREAD_RINGS.
+//
+// NOTE7:
+// QS_initShmBuf() places the QS buffer (with the same header as the
+// flight-recorder file, see qs_file.h) in a POSIX shared memory object.
+// A local consumer, such as the qsshm tool (ports/posix/qsshm), maps the
+// object and reads the QS records in place, while the application writes
+// them without any system calls, copies, or a QS output thread. QS
+// publishes the head with a release store after every record, and the
+// consumer publishes its tail in the same way.
+//
+// NOTE8:
+// QS_startFlusher() starts a QS output thread (the "flusher"), which
+// writes the QS data to a file or a socket (e.g., the TCP connection to
+// QSPY), so the application does not need to poll QS::getBlock() from its
+// own thread. The flusher sleeps until a QS record fills the QS buffer to
+// the watermark 'wmark' (QS::setWatermark(), which is reserved for the
+// flusher), or until 'periodMs' elapses, and then sends the whole buffer
+// with a single writev() of the (at most) two blocks from
+// QS::peekBlocks(), without copying the data. After every write it calls
+// QS::overrunReport(), which produces the QS_OVERRUN record when QS
+// lost any data that the flusher did not write in time. With
+// QS_THREAD_RINGS the flusher merges the per-thread rings and wakes up
+// only periodically. When the flusher runs, QS::onFlush() should only call
+// QS_wakeFlusher() and must not read the QS buffer.
+//
+// NOTE9:
+// By default QS overwrites the oldest data when the flusher falls behind.
+// With QS_DROP_NEWEST, QS keeps the oldest data and drops the new records
+// that begin with less than QS_DROP_RESERVE bytes free in the buffer,
+// or whose strings, memory blocks or arrays do not leave QS_DROP_RESERVE
+// bytes free (the dropped records leave gaps in the QS sequence numbers).
+// With QS_BLOCK_PRODUCER, a thread that begins a record outside of a
+// critical section first waits for the flusher (QS_waitFlusher()) up to
+// QS_BLOCK_MS milliseconds, so no data is lost as long as the flusher
+// keeps up on average. Records produced inside the QF critical sections
+// are never blocked (they are dropped instead). The numbers of the
+// overwritten and dropped records and of the waits are reported in the
+// QS_OVERRUN record.
+//
+
 #endif // qs_port_h
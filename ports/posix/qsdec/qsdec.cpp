@@ -0,0 +1,1028 @@
+/// @file
+/// @brief QS decoder library -- unframing and decoding of the QS records
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+
+#include "qsdec.h"
+#include "../qs_file.h"
+
+#include <string.h>
+
+namespace QSpy {
+
+static uint8_t const QS_FRAME   = static_cast<uint8_t>(0x7E);
+static uint8_t const QS_ESC     = static_cast<uint8_t>(0x7D);
+static uint8_t const QS_ESC_XOR = static_cast<uint8_t>(0x20);
+static uint8_t const QS_GOOD_CHKSUM = static_cast<uint8_t>(0xFF);
+
+//****************************************************************************
+// The formats of the QS records produced by QP, one character per field:
+// t - time stamp, o - object, f - function, s - signal, e - event-queue
+// counter, c - time-event counter, m - memory-pool counter, z - event size,
+// b - uint8_t, p - two uint8_t, w - uint16_t, l - uint32_t, S - string.
+// The records with 0 format are decoded specially or not known at all.
+static char const * const l_fmt[QS_REC_MAX] = {
+    "",         // QS_EMPTY
+    "of",       // QS_QEP_STATE_ENTRY
+    "of",       // QS_QEP_STATE_EXIT
+    "off",      // QS_QEP_STATE_INIT
+    "tof",      // QS_QEP_INIT_TRAN
+    "tsof",     // QS_QEP_INTERN_TRAN
+    "tsoff",    // QS_QEP_TRAN
+    "tsof",     // QS_QEP_IGNORED
+    "tsof",     // QS_QEP_DISPATCH
+    "sof",      // QS_QEP_UNHANDLED
+    "tob",      // QS_QF_ACTIVE_ADD
+    "tob",      // QS_QF_ACTIVE_REMOVE
+    "tso",      // QS_QF_ACTIVE_SUBSCRIBE
+    "tso",      // QS_QF_ACTIVE_UNSUBSCRIBE
+    "tosopee",  // QS_QF_ACTIVE_POST_FIFO
+    "tsopee",   // QS_QF_ACTIVE_POST_LIFO
+    "tsope",    // QS_QF_ACTIVE_GET
+    "tsop",     // QS_QF_ACTIVE_GET_LAST
+    "oe",       // QS_QF_EQUEUE_INIT
+    "tsopee",   // QS_QF_EQUEUE_POST_FIFO
+    "tsopee",   // QS_QF_EQUEUE_POST_LIFO
+    "tsope",    // QS_QF_EQUEUE_GET
+    "tsop",     // QS_QF_EQUEUE_GET_LAST
+    "om",       // QS_QF_MPOOL_INIT
+    "tomm",     // QS_QF_MPOOL_GET
+    "tom",      // QS_QF_MPOOL_PUT
+    "tosp",     // QS_QF_PUBLISH
+    "tosopl",   // QS_QF_ACTIVE_POST_IGNORED
+    "tzs",      // QS_QF_NEW
+    "tsp",      // QS_QF_GC_ATTEMPT
+    "tsp",      // QS_QF_GC
+    "cb",       // QS_QF_TICK
+    "tooccb",   // QS_QF_TIMEEVT_ARM
+    "oob",      // QS_QF_TIMEEVT_AUTO_DISARM
+    "toob",     // QS_QF_TIMEEVT_DISARM_ATTEMPT
+    "tooccb",   // QS_QF_TIMEEVT_DISARM
+    "tooccbb",  // QS_QF_TIMEEVT_REARM
+    "tosob",    // QS_QF_TIMEEVT_POST
+    "tooccb",   // QS_QF_TIMEEVT_CTR
+    "tb",       // QS_QF_CRIT_ENTRY
+    "tb",       // QS_QF_CRIT_EXIT
+    "tbb",      // QS_QF_ISR_ENTRY
+    "tbb",      // QS_QF_ISR_EXIT
+    0,          // QS_QF_INT_DISABLE
+    0,          // QS_QF_INT_ENABLE
+    "tosopee",  // QS_QF_ACTIVE_POST_ATTEMPT
+    "tsopee",   // QS_QF_EQUEUE_POST_ATTEMPT
+    "tomm",     // QS_QF_MPOOL_GET_ATTEMPT
+    "tp",       // QS_MUTEX_LOCK
+    "tp",       // QS_MUTEX_UNLOCK
+    "tp",       // QS_SCHED_LOCK
+    "tp",       // QS_SCHED_UNLOCK
+    "tp",       // QS_SCHED_NEXT
+    "tb",       // QS_SCHED_IDLE
+    "tp",       // QS_SCHED_RESUME
+    "off",      // QS_QEP_TRAN_HIST
+    "off",      // QS_QEP_TRAN_EP
+    "off",      // QS_QEP_TRAN_XP
+    "",         // QS_TEST_PAUSED
+    "tfl",      // QS_TEST_PROBE_GET
+    "soS",      // QS_SIG_DICT
+    0,          // QS_OBJ_DICT
+    0,          // QS_FUN_DICT
+    "bS",       // QS_USR_DICT
+    0,          // QS_TARGET_INFO
+    "tb",       // QS_TARGET_DONE
+    "b",        // QS_RX_STATUS
+    "bswl",     // QS_SAMPLE_CFG
+    "twbb",     // QS_PEEK_DATA
+    "twS",      // QS_ASSERT_FAIL
+    "t", "t", "t", "t", "t", "t", "t", "t", "t", "t", // QS_USER...
+    "t", "t", "t", "t", "t", "t", "t", "t", "t", "t",
+    "t", "t", "t", "t", "t", "t", "t", "t", "t", "t",
+    "t", "t", "t", "t", "t", "t", "t", "t", "t", "t",
+    "t", "t", "t", "t", "t", "t", "t", "t", "t", "t",
+    "t", "t", "t", "t", "t",    // ...QS_USER + 54 (QS_OVERRUN)
+    0, 0, 0                     // reserved by QSPY
+};
+
+//! the names of the QS records (without the "QS_" prefix)
+static char const * const l_recName[QS_USER] = {
+    "EMPTY",
+    "QEP_STATE_ENTRY", "QEP_STATE_EXIT", "QEP_STATE_INIT",
+    "QEP_INIT_TRAN", "QEP_INTERN_TRAN", "QEP_TRAN", "QEP_IGNORED",
+    "QEP_DISPATCH", "QEP_UNHANDLED",
+    "QF_ACTIVE_ADD", "QF_ACTIVE_REMOVE", "QF_ACTIVE_SUBSCRIBE",
+    "QF_ACTIVE_UNSUBSCRIBE", "QF_ACTIVE_POST_FIFO", "QF_ACTIVE_POST_LIFO",
+    "QF_ACTIVE_GET", "QF_ACTIVE_GET_LAST",
+    "QF_EQUEUE_INIT", "QF_EQUEUE_POST_FIFO", "QF_EQUEUE_POST_LIFO",
+    "QF_EQUEUE_GET", "QF_EQUEUE_GET_LAST",
+    "QF_MPOOL_INIT", "QF_MPOOL_GET", "QF_MPOOL_PUT",
+    "QF_PUBLISH", "QF_ACTIVE_POST_IGNORED", "QF_NEW", "QF_GC_ATTEMPT",
+    "QF_GC", "QF_TICK",
+    "QF_TIMEEVT_ARM", "QF_TIMEEVT_AUTO_DISARM", "QF_TIMEEVT_DISARM_ATTEMPT",
+    "QF_TIMEEVT_DISARM", "QF_TIMEEVT_REARM", "QF_TIMEEVT_POST",
+    "QF_TIMEEVT_CTR",
+    "QF_CRIT_ENTRY", "QF_CRIT_EXIT", "QF_ISR_ENTRY", "QF_ISR_EXIT",
+    "QF_INT_DISABLE", "QF_INT_ENABLE",
+    "QF_ACTIVE_POST_ATTEMPT", "QF_EQUEUE_POST_ATTEMPT",
+    "QF_MPOOL_GET_ATTEMPT",
+    "MUTEX_LOCK", "MUTEX_UNLOCK",
+    "SCHED_LOCK", "SCHED_UNLOCK", "SCHED_NEXT", "SCHED_IDLE",
+    "SCHED_RESUME",
+    "QEP_TRAN_HIST", "QEP_TRAN_EP", "QEP_TRAN_XP",
+    "TEST_PAUSED", "TEST_PROBE_GET", "SIG_DICT", "OBJ_DICT", "FUN_DICT",
+    "USR_DICT", "TARGET_INFO", "TARGET_DONE", "RX_STATUS", "SAMPLE_CFG",
+    "PEEK_DATA", "ASSERT_FAIL"
+};
+
+//! the sizes of the array elements (see QSpy::ItemType)
+static uint8_t const l_arrElemSize[6] = { 0U, 1U, 2U, 4U, 4U, 8U };
+
+//****************************************************************************
+void appendUint(std::string *out, uint64_t v) {
+    char buf[20];
+    char *p = &buf[sizeof(buf)];
+    do {
+        *--p = static_cast<char>('0' + (v % 10U));
+        v /= 10U;
+    } while (v != 0U);
+    out->append(p, &buf[sizeof(buf)] - p);
+}
+
+//****************************************************************************
+void appendHex(std::string *out, uint64_t v) {
+    static char const hex[] = "0123456789ABCDEF";
+    char buf[18];
+    char *p = &buf[sizeof(buf)];
+    do {
+        *--p = hex[v & 0xFU];
+        v >>= 4;
+    } while (v != 0U);
+    *--p = 'x';
+    *--p = '0';
+    out->append(p, &buf[sizeof(buf)] - p);
+}
+
+//****************************************************************************
+Decoder::Decoder(Handler &handler)
+  : m_handler(handler),
+    m_esc(false),
+    m_seqValid(false),
+    m_seq(0U),
+    m_timeValid(false),
+    m_time(0U)
+{
+    // the defaults until the QS_TARGET_INFO record arrives
+    m_info.version  = 0U;
+    m_info.sigSize  = 2U;
+    m_info.evtSize  = 2U;
+    m_info.eqcSize  = 1U;
+    m_info.tecSize  = 4U;
+    m_info.mpsSize  = 2U;
+    m_info.mpcSize  = 2U;
+    m_info.objSize  = 4U;
+    m_info.funSize  = 4U;
+    m_info.timeSize = 4U;
+    m_info.compact  = false;
+    m_info.received = false;
+    memset(&m_stats, 0, sizeof(m_stats));
+    memset(m_smpl, 0, sizeof(m_smpl));
+    m_frame.reserve(1024U);
+}
+
+//****************************************************************************
+/// @description
+/// The frames are found with memchr() and the frames without any escape
+/// characters (the vast majority) are decoded directly in the input. Only
+/// the frames with escapes and the frames split between the calls are
+/// copied (in runs between the escape characters) into the frame buffer.
+///
+void Decoder::feed(uint8_t const *data, size_t len) {
+    uint8_t const * const end = data + len;
+    m_stats.bytes += len;
+
+    while (data < end) {
+        uint8_t const *f = static_cast<uint8_t const *>(
+                               memchr(data, QS_FRAME, end - data));
+        uint8_t const * const stop = (f != 0) ? f : end;
+
+        if ((f != 0) && m_frame.empty() && !m_esc
+            && (memchr(data, QS_ESC, f - data) == 0))
+        {
+            frame_(data, f - data); // the whole frame in the input
+        }
+        else {
+            if (m_esc && (data < stop)) { // escape at the end of last chunk?
+                m_frame.push_back(
+                    static_cast<uint8_t>(*data ^ QS_ESC_XOR));
+                m_esc = false;
+                ++data;
+            }
+            while (data < stop) { // copy the runs between the escapes
+                uint8_t const *e = static_cast<uint8_t const *>(
+                                       memchr(data, QS_ESC, stop - data));
+                if (e == 0) {
+                    m_frame.insert(m_frame.end(), data, stop);
+                    data = stop;
+                }
+                else {
+                    m_frame.insert(m_frame.end(), data, e);
+                    if (e + 1 < stop) {
+                        m_frame.push_back(
+                            static_cast<uint8_t>(e[1] ^ QS_ESC_XOR));
+                        data = e + 2;
+                    }
+                    else { // escape at the end of the chunk?
+                        m_esc = (f == 0);
+                        data = stop;
+                    }
+                }
+            }
+            if (f != 0) {
+                frame_(m_frame.data(), m_frame.size());
+                m_frame.clear();
+                m_esc = false;
+            }
+        }
+        data = (f != 0) ? (f + 1) : end; // skip the frame character
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Decodes the flight-recorder file (see qs_file.h in the POSIX QS port)
+/// the same way as the qsdump tool: if the QS ring in the file has wrapped
+/// around, the saved Target info is decoded first, and the partially
+/// overwritten oldest record is skipped.
+///
+/// @returns false if @p file is not a valid QS flight-recorder file
+///
+bool Decoder::feedFlightRecorder(uint8_t const *file, size_t len) {
+    QSFileHdr hdr;
+    if ((len < sizeof(hdr))
+        || (memcmp(file, QS_FILE_MAGIC, sizeof(hdr.magic)) != 0))
+    {
+        return false;
+    }
+    memcpy(&hdr, file, sizeof(hdr));
+    if ((hdr.version != QS_FILE_VERSION)
+        || (hdr.head >= hdr.size)
+        || (hdr.infoLen > QS_FILE_INFO_SIZE)
+        || (len - sizeof(hdr) < hdr.size))
+    {
+        return false;
+    }
+    uint8_t const * const ring = file + sizeof(hdr);
+
+    // the file is zero-filled when created, so the part of the ring past
+    // the head contains a frame character only if the ring has wrapped
+    uint8_t const * const f = static_cast<uint8_t const *>(
+        memchr(ring + hdr.head, QS_FRAME, hdr.size - hdr.head));
+    if (f == 0) { // all records from the beginning are still there
+        feed(ring, hdr.head);
+    }
+    else {
+        feed(hdr.info, hdr.infoLen);
+
+        // the oldest complete record starts after the frame character
+        feed(f + 1, ring + hdr.size - (f + 1));
+        feed(ring, hdr.head);
+    }
+    return true;
+}
+
+//****************************************************************************
+void Decoder::frame_(uint8_t const *f, size_t n) {
+    if (n == 0U) {
+        return; // empty frame (e.g., at the beginning of the stream)
+    }
+
+    uint8_t sum = 0U;
+    for (size_t i = 0U; i < n; ++i) {
+        sum = static_cast<uint8_t>(sum + f[i]);
+    }
+    if ((n < 3U) || (sum != QS_GOOD_CHKSUM)) {
+        ++m_stats.badSum;
+        return;
+    }
+
+    uint8_t const seq = f[0];
+    // the sequence starts over after the Target reset
+    bool const reset = (f[1] == static_cast<uint8_t>(QS_TARGET_INFO))
+                       && (f[2] == static_cast<uint8_t>(0xFF));
+    if (m_seqValid && !reset
+        && (seq != static_cast<uint8_t>(m_seq + 1U)))
+    {
+        uint32_t const lost = static_cast<uint8_t>(seq - m_seq - 1U);
+        m_stats.lost += lost;
+        m_timeValid = false; // the compact time deltas are broken
+        m_handler.onLost(*this, lost);
+    }
+    m_seq = seq;
+    m_seqValid = true;
+
+    m_rec.seq = seq;
+    record_(f + 1, f + n - 1U); // without the sequence and checksum
+}
+
+//****************************************************************************
+void Decoder::record_(uint8_t const *p, uint8_t const *end) {
+    Record &rec = m_rec;
+    uint8_t const type = static_cast<uint8_t>(*p++ & 0x7FU);
+    bool ok = true;
+
+    rec.type    = type;
+    rec.skip    = 0U;
+    rec.hasTime = false;
+    rec.hasSig  = false;
+    rec.nObj    = 0U;
+    rec.nFun    = 0U;
+    rec.nNum    = 0U;
+    rec.sig     = 0U;
+    rec.str     = 0;
+
+    if ((m_smpl[type >> 3] & (1U << (type & 7U))) != 0U) { // sampled?
+        uint64_t skip = 0U;
+        ok = uint_(&p, end, 2U, &skip);
+        rec.skip = static_cast<uint16_t>(skip);
+    }
+
+    if (!ok) {
+        // the record is too short
+    }
+    else if ((type == QS_OBJ_DICT) || (type == QS_FUN_DICT)) {
+        ok = dict_(p, end, &rec);
+    }
+    else if (type == QS_TARGET_INFO) {
+        ok = targetInfo_(p, end, &rec);
+    }
+    else {
+        ok = parse_(p, end, &rec);
+        if (ok) {
+            if (type == QS_SIG_DICT) {
+                m_sigDict[std::make_pair(rec.sig, rec.obj[0])] = rec.str;
+            }
+            else if (type == QS_USR_DICT) {
+                m_usrDict[rec.num[0] & 0x7FU] = rec.str;
+            }
+            else if (type == QS_SAMPLE_CFG) {
+                sampleCfg_(rec);
+            }
+            else if (type == QS_OVERRUN) {
+                overrun_(&rec);
+                m_stats.overBytes += rec.num[0];
+                m_stats.dropped   += rec.num[1] + rec.num[2];
+                m_stats.blocked   += rec.num[4];
+            }
+            else {
+                // no decoder state in the record
+            }
+        }
+    }
+
+    if (ok) {
+        ++m_stats.records;
+        m_handler.onRecord(*this, rec);
+    }
+    else {
+        ++m_stats.badLen;
+    }
+}
+
+//****************************************************************************
+bool Decoder::parse_(uint8_t const *p, uint8_t const *end, Record *rec) {
+    char const *fmt = l_fmt[rec->type];
+    if (fmt == 0) {
+        fmt = ""; // not known, all data in rec->data
+    }
+    for (; *fmt != '\0'; ++fmt) {
+        uint64_t v = 0U;
+        bool ok = true;
+        switch (*fmt) {
+            case 't':
+                ok = time_(&p, end, &v);
+                break;
+            case 'o':
+                ok = ptr_(&p, end, m_info.objSize, &rec->obj[rec->nObj]);
+                ++rec->nObj;
+                break;
+            case 'f':
+                ok = ptr_(&p, end, m_info.funSize, &rec->fun[rec->nFun]);
+                ++rec->nFun;
+                break;
+            case 's':
+                ok = uint_(&p, end, m_info.sigSize, &v);
+                rec->sig = static_cast<uint32_t>(v);
+                rec->hasSig = true;
+                break;
+            case 'e':
+                ok = uint_(&p, end, m_info.eqcSize, &v);
+                rec->num[rec->nNum++] = v;
+                break;
+            case 'c':
+                ok = uint_(&p, end, m_info.tecSize, &v);
+                rec->num[rec->nNum++] = v;
+                break;
+            case 'm':
+                ok = uint_(&p, end, m_info.mpcSize, &v);
+                rec->num[rec->nNum++] = v;
+                break;
+            case 'z':
+                ok = uint_(&p, end, m_info.evtSize, &v);
+                rec->num[rec->nNum++] = v;
+                break;
+            case 'b':
+                ok = uint_(&p, end, 1U, &v);
+                rec->num[rec->nNum++] = v;
+                break;
+            case 'p':
+                ok = uint_(&p, end, 1U, &v);
+                rec->num[rec->nNum++] = v;
+                ok = ok && uint_(&p, end, 1U, &v);
+                rec->num[rec->nNum++] = v;
+                break;
+            case 'w':
+                ok = uint_(&p, end, 2U, &v);
+                rec->num[rec->nNum++] = v;
+                break;
+            case 'l':
+                ok = uint_(&p, end, 4U, &v);
+                rec->num[rec->nNum++] = v;
+                break;
+            case 'S': {
+                uint8_t const *z = static_cast<uint8_t const *>(
+                                       memchr(p, '\0', end - p));
+                ok = (z != 0);
+                if (ok) {
+                    rec->str = reinterpret_cast<char const *>(p);
+                    p = z + 1;
+                }
+                break;
+            }
+            default:
+                ok = false;
+                break;
+        }
+        if (!ok) {
+            return false;
+        }
+        if (*fmt == 't') {
+            rec->hasTime = (v != UNKNOWN_ID);
+            rec->time = v;
+        }
+    }
+    rec->data = p;
+    rec->len  = end - p;
+    return true;
+}
+
+//****************************************************************************
+/// @description
+/// The object and function dictionaries hold the full pointer, preceded
+/// by the interned ID in the compact encoding. The decoder maps the IDs
+/// back to the full pointers in all the records that follow. The records
+/// with an empty name (QP::QS::internAll()) only re-send the ID and keep
+/// the name of the pointer.
+///
+bool Decoder::dict_(uint8_t const *p, uint8_t const *end, Record *rec) {
+    uint8_t const size = (rec->type == QS_OBJ_DICT)
+                         ? m_info.objSize : m_info.funSize;
+    uint64_t id = 0U;
+    uint64_t ptr;
+
+    if (m_info.compact) {
+        if (!varint_(&p, end, &id) || ((id & 1U) != 0U)) {
+            return false;
+        }
+        id >>= 1; // 0 when not interned (the Target table is full)
+    }
+    if (!uint_(&p, end, size, &ptr)) {
+        return false;
+    }
+    uint8_t const *z = static_cast<uint8_t const *>(memchr(p, '\0', end - p));
+    if (z == 0) {
+        return false;
+    }
+    rec->str = reinterpret_cast<char const *>(p);
+    if (rec->type == QS_OBJ_DICT) {
+        rec->obj[rec->nObj++] = ptr;
+    }
+    else {
+        rec->fun[rec->nFun++] = ptr;
+    }
+    if (id != 0U) {
+        rec->num[rec->nNum++] = id;
+        m_ids[id] = ptr;
+    }
+    if ((*rec->str != '\0') || (m_objDict.find(ptr) == m_objDict.end())) {
+        m_objDict[ptr] = rec->str;
+    }
+    rec->data = z + 1;
+    rec->len  = end - (z + 1);
+    return true;
+}
+
+//****************************************************************************
+/// @description
+/// The Target info record configures the sizes of all the other records.
+/// The Target info after the Target reset also clears the dictionaries and
+/// the sampling configuration.
+///
+bool Decoder::targetInfo_(uint8_t const *p, uint8_t const *end,
+                          Record *rec)
+{
+    if (end - p < 8) {
+        return false;
+    }
+    if (p[0] == static_cast<uint8_t>(0xFF)) { // Target reset?
+        m_sigDict.clear();
+        m_objDict.clear();
+        m_ids.clear();
+        m_smplCfg.clear();
+        memset(m_smpl, 0, sizeof(m_smpl));
+        for (size_t i = 0U; i < sizeof(m_usrDict)/sizeof(m_usrDict[0]); ++i)
+        {
+            m_usrDict[i].clear();
+        }
+        m_timeValid = false;
+    }
+    m_info.version  = static_cast<uint16_t>(p[1] | (p[2] << 8));
+    m_info.sigSize  = static_cast<uint8_t>(p[3] & 0x0FU);
+    m_info.evtSize  = static_cast<uint8_t>(p[3] >> 4);
+    m_info.eqcSize  = static_cast<uint8_t>(p[4] & 0x0FU);
+    m_info.tecSize  = static_cast<uint8_t>(p[4] >> 4);
+    m_info.mpsSize  = static_cast<uint8_t>(p[5] & 0x0FU);
+    m_info.mpcSize  = static_cast<uint8_t>(p[5] >> 4);
+    m_info.objSize  = static_cast<uint8_t>(p[6] & 0x0FU);
+    m_info.funSize  = static_cast<uint8_t>(p[6] >> 4);
+    m_info.timeSize = static_cast<uint8_t>(p[7] & 0x0FU);
+    m_info.compact  = ((p[7] & 0x80U) != 0U);
+    m_info.received = true;
+
+    rec->num[rec->nNum++] = p[0];           // isReset
+    rec->num[rec->nNum++] = m_info.version; // QP version
+    rec->data = p;
+    rec->len  = end - p;
+    return true;
+}
+
+//****************************************************************************
+/// @description
+/// Mirrors the sampling configuration of QS::sample(). Every record type
+/// with at least one sampling configuration carries the count of the
+/// skipped records after the record ID.
+///
+void Decoder::sampleCfg_(Record const &rec) {
+    uint64_t const key = (rec.num[0] << 32) | rec.sig;
+    if ((rec.num[1] > 1U) || (rec.num[2] != 0U)) {
+        m_smplCfg[key] = true;
+    }
+    else {
+        m_smplCfg.erase(key);
+    }
+    memset(m_smpl, 0, sizeof(m_smpl));
+    for (std::unordered_map<uint64_t, bool>::const_iterator it
+             = m_smplCfg.begin();
+         it != m_smplCfg.end(); ++it)
+    {
+        uint8_t const r = static_cast<uint8_t>((it->first >> 32) & 0x7FU);
+        m_smpl[r >> 3] |= static_cast<uint8_t>(1U << (r & 7U));
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Moves the formatted counters of the QS_OVERRUN record (a User record)
+/// to rec->num[0..4], so the exporters use them as the fixed fields of
+/// the other records.
+///
+void Decoder::overrun_(Record *rec) const {
+    uint8_t const *p = rec->data;
+    uint8_t const * const end = rec->data + rec->len;
+    Item item;
+    rec->nNum = 0U;
+    while ((rec->nNum < 5U) && nextItem(&p, end, &item)) {
+        rec->num[rec->nNum] = item.u;
+        ++rec->nNum;
+    }
+    for (uint8_t i = rec->nNum; i < 5U; ++i) {
+        rec->num[i] = 0U; // missing counters
+    }
+}
+
+//****************************************************************************
+bool Decoder::uint_(uint8_t const **pp, uint8_t const *end, uint8_t size,
+                    uint64_t *val) const
+{
+    uint8_t const *p = *pp;
+    if (end - p < size) {
+        return false;
+    }
+    uint64_t v = 0U;
+    for (uint_fast8_t i = size; i > 0U; --i) { // little endian
+        v = (v << 8) | p[i - 1U];
+    }
+    *val = v;
+    *pp = p + size;
+    return true;
+}
+
+//****************************************************************************
+bool Decoder::varint_(uint8_t const **pp, uint8_t const *end,
+                      uint64_t *val) const
+{
+    uint8_t const *p = *pp;
+    uint64_t v = 0U;
+    for (uint_fast8_t shift = 0U; (p < end) && (shift < 64U); shift += 7U) {
+        uint8_t const b = *p++;
+        v |= static_cast<uint64_t>(b & 0x7FU) << shift;
+        if ((b & 0x80U) == 0U) {
+            *val = v;
+            *pp = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+//****************************************************************************
+/// @description
+/// In the compact encoding, the pointer is the varint 0 for NULL, the even
+/// varint for the interned ID, or the varint 1 followed by the full pointer
+/// of @p size bytes.
+///
+bool Decoder::ptr_(uint8_t const **pp, uint8_t const *end, uint8_t size,
+                   uint64_t *val) const
+{
+    if (!m_info.compact) {
+        return uint_(pp, end, size, val);
+    }
+    uint64_t v;
+    if (!varint_(pp, end, &v)) {
+        return false;
+    }
+    if (v == 1U) {        // full pointer?
+        return uint_(pp, end, size, val);
+    }
+    else if ((v & 1U) != 0U) { // not used
+        return false;
+    }
+    else if (v == 0U) {   // NULL?
+        *val = 0U;
+    }
+    else {                // interned ID
+        std::unordered_map<uint64_t, uint64_t>::const_iterator const it
+            = m_ids.find(v >> 1);
+        *val = (it != m_ids.end()) ? it->second : (UNKNOWN_ID | (v >> 1));
+    }
+    return true;
+}
+
+//****************************************************************************
+/// @description
+/// In the compact encoding, the time stamps are mostly the deltas from the
+/// previous time stamp. The deltas after a lost record are reported as
+/// QSpy::UNKNOWN_ID (no time) until the next absolute time stamp.
+///
+bool Decoder::time_(uint8_t const **pp, uint8_t const *end, uint64_t *val) {
+    if (!m_info.compact) {
+        return uint_(pp, end, m_info.timeSize, val);
+    }
+    uint64_t v;
+    if (!varint_(pp, end, &v)) {
+        return false;
+    }
+    if ((v & 1U) != 0U) { // absolute time stamp?
+        m_time = v >> 1;
+        m_timeValid = true;
+    }
+    else if (m_timeValid) {
+        m_time += (v >> 1);
+        if (m_info.timeSize < 8U) { // the time counter wraps around
+            m_time &= (static_cast<uint64_t>(1) << (8U * m_info.timeSize))
+                      - 1U;
+        }
+    }
+    else {
+        *val = UNKNOWN_ID;
+        return true;
+    }
+    *val = m_time;
+    return true;
+}
+
+//****************************************************************************
+/// @description
+/// Parses one data item of the application-specific (user) record from
+/// the data of the record (QSpy::Record::data). The multi-byte numbers are
+/// little-endian in the QS records, so the memory blocks and arrays are
+/// returned as pointers into the record.
+///
+/// @returns false at the end of the data or if the item is truncated
+///
+bool Decoder::nextItem(uint8_t const **pp, uint8_t const *end,
+                       Item *item) const
+{
+    uint8_t const *p = *pp;
+    uint64_t v = 0U;
+    bool ok;
+
+    if (p >= end) {
+        return false;
+    }
+    item->type  = static_cast<uint8_t>(*p & 0x0FU);
+    item->width = static_cast<uint8_t>(*p >> 4);
+    item->u = 0U;
+    item->i = 0;
+    item->f = 0.0;
+    item->obj = 0U;
+    item->str = 0;
+    item->mem = 0;
+    item->n = 0U;
+    ++p;
+
+    switch (item->type) {
+        case I8_T:
+        case U8_T:
+            ok = uint_(&p, end, 1U, &v);
+            item->i = static_cast<int8_t>(v);
+            break;
+        case I16_T:
+        case U16_T:
+            ok = uint_(&p, end, 2U, &v);
+            item->i = static_cast<int16_t>(v);
+            break;
+        case I32_T:
+        case U32_T:
+        case U32_HEX_T:
+            ok = uint_(&p, end, 4U, &v);
+            item->i = static_cast<int32_t>(v);
+            break;
+        case I64_T:
+        case U64_T:
+            ok = uint_(&p, end, 8U, &v);
+            item->i = static_cast<int64_t>(v);
+            break;
+        case F32_T: {
+            ok = uint_(&p, end, 4U, &v);
+            uint32_t const u = static_cast<uint32_t>(v);
+            float f;
+            memcpy(&f, &u, sizeof(f));
+            item->f = f;
+            break;
+        }
+        case F64_T:
+            ok = uint_(&p, end, 8U, &v);
+            memcpy(&item->f, &v, sizeof(item->f));
+            break;
+        case STR_T: {
+            uint8_t const *z = static_cast<uint8_t const *>(
+                                   memchr(p, '\0', end - p));
+            ok = (z != 0);
+            if (ok) {
+                item->str = reinterpret_cast<char const *>(p);
+                p = z + 1;
+            }
+            break;
+        }
+        case MEM_T: {
+            uint8_t const es = (item->width < sizeof(l_arrElemSize))
+                               ? l_arrElemSize[item->width] : 0U;
+            if (item->width == 0U) { // memory block (u8 length)?
+                ok = uint_(&p, end, 1U, &v);
+                item->n = static_cast<uint32_t>(v);
+            }
+            else {                   // array (u16 count)
+                ok = (es != 0U) && uint_(&p, end, 2U, &v);
+                item->n = static_cast<uint32_t>(v);
+                v *= es;
+            }
+            ok = ok && (static_cast<uint64_t>(end - p) >= v);
+            if (ok) {
+                item->mem = p;
+                p += v;
+            }
+            break;
+        }
+        case SIG_T:
+            ok = uint_(&p, end, m_info.sigSize, &v)
+                 && uint_(&p, end, m_info.objSize, &item->obj);
+            break;
+        case OBJ_T:
+            ok = uint_(&p, end, m_info.objSize, &v);
+            break;
+        case FUN_T:
+            ok = uint_(&p, end, m_info.funSize, &v);
+            break;
+        default:
+            ok = false;
+            break;
+    }
+    if (ok) {
+        item->u = v;
+        *pp = p;
+    }
+    return ok;
+}
+
+//****************************************************************************
+/// @description
+/// Formats all the data items of the application-specific (user) record
+/// as text separated by spaces, similar to the QSPY human-readable output.
+///
+void Decoder::formatItems(Record const &rec, std::string *out) const {
+    uint8_t const *p = rec.data;
+    uint8_t const * const end = rec.data + rec.len;
+    Item item;
+    char buf[64];
+
+    while (nextItem(&p, end, &item)) {
+        char const *name = 0;
+        buf[0] = '\0';
+        if (!out->empty()) {
+            out->push_back(' ');
+        }
+        switch (item.type) {
+            case I8_T:
+            case I16_T:
+            case I32_T:
+            case I64_T:
+                if (item.width != 0U) {
+                    snprintf(buf, sizeof(buf), "%*lld", item.width,
+                             static_cast<long long>(item.i));
+                }
+                else if (item.i < 0) {
+                    out->push_back('-');
+                    appendUint(out,
+                        static_cast<uint64_t>(-(item.i + 1)) + 1U);
+                    continue;
+                }
+                else {
+                    appendUint(out, static_cast<uint64_t>(item.i));
+                    continue;
+                }
+                break;
+            case U8_T:
+            case U16_T:
+            case U32_T:
+            case U64_T:
+                if (item.width != 0U) {
+                    snprintf(buf, sizeof(buf), "%*llu", item.width,
+                             static_cast<unsigned long long>(item.u));
+                }
+                else {
+                    appendUint(out, item.u);
+                    continue;
+                }
+                break;
+            case U32_HEX_T:
+                snprintf(buf, sizeof(buf), "0x%0*llX", item.width,
+                         static_cast<unsigned long long>(item.u));
+                break;
+            case F32_T:
+            case F64_T:
+                snprintf(buf, sizeof(buf), "%*g", item.width, item.f);
+                break;
+            case STR_T:
+                name = item.str;
+                break;
+            case MEM_T:
+                formatMem_(item, out);
+                break;
+            case SIG_T:
+                name = sigName(static_cast<uint32_t>(item.u), item.obj);
+                if (name == 0) {
+                    snprintf(buf, sizeof(buf), "%llu",
+                             static_cast<unsigned long long>(item.u));
+                }
+                break;
+            case OBJ_T:
+                name = objName(item.u);
+                if (name == 0) {
+                    snprintf(buf, sizeof(buf), "0x%llX",
+                             static_cast<unsigned long long>(item.u));
+                }
+                break;
+            case FUN_T:
+                name = funName(item.u);
+                if (name == 0) {
+                    snprintf(buf, sizeof(buf), "0x%llX",
+                             static_cast<unsigned long long>(item.u));
+                }
+                break;
+            default:
+                break;
+        }
+        out->append((name != 0) ? name : buf);
+    }
+}
+
+//****************************************************************************
+void Decoder::formatMem_(Item const &item, std::string *out) const {
+    char buf[32];
+    if (item.width == 0U) { // memory block as hex bytes
+        for (uint32_t i = 0U; i < item.n; ++i) {
+            snprintf(buf, sizeof(buf), (i == 0U) ? "%02X" : " %02X",
+                     item.mem[i]);
+            out->append(buf);
+        }
+        return;
+    }
+    uint8_t const es = l_arrElemSize[item.width];
+    out->push_back('[');
+    for (uint32_t i = 0U; i < item.n; ++i) {
+        uint8_t const *e = item.mem + i*es;
+        uint64_t v;
+        (void)uint_(&e, e + es, es, &v);
+        if (i != 0U) {
+            out->push_back(' ');
+        }
+        if (item.width == ARR_F32_T) {
+            uint32_t const u = static_cast<uint32_t>(v);
+            float f;
+            memcpy(&f, &u, sizeof(f));
+            snprintf(buf, sizeof(buf), "%g", f);
+        }
+        else if (item.width == ARR_F64_T) {
+            double d;
+            memcpy(&d, &v, sizeof(d));
+            snprintf(buf, sizeof(buf), "%g", d);
+        }
+        else {
+            snprintf(buf, sizeof(buf), "%llu",
+                     static_cast<unsigned long long>(v));
+        }
+        out->append(buf);
+    }
+    out->push_back(']');
+}
+
+//****************************************************************************
+char const *Decoder::recName(uint8_t const type) const {
+    if (type < QS_USER) {
+        return l_recName[type];
+    }
+    else if (type == QS_OVERRUN) {
+        return "OVERRUN";
+    }
+    else if (type < QS_REC_MAX) {
+        return m_usrDict[type].empty() ? 0 : m_usrDict[type].c_str();
+    }
+    return 0;
+}
+
+//****************************************************************************
+/// @description
+/// Looks up the signal of the object @p obj first, and then the signal
+/// that has been produced without the object (global signal).
+///
+char const *Decoder::sigName(uint32_t const sig, uint64_t const obj) const {
+    std::map<std::pair<uint32_t, uint64_t>, std::string>::const_iterator it
+        = m_sigDict.find(std::make_pair(sig, obj));
+    if ((it == m_sigDict.end()) && (obj != 0U)) {
+        it = m_sigDict.find(std::make_pair(sig, static_cast<uint64_t>(0)));
+    }
+    return (it != m_sigDict.end()) ? it->second.c_str() : 0;
+}
+
+//****************************************************************************
+char const *Decoder::objName(uint64_t const obj) const {
+    std::unordered_map<uint64_t, std::string>::const_iterator const it
+        = m_objDict.find(obj);
+    return (it != m_objDict.end()) ? it->second.c_str() : 0;
+}
+
+//****************************************************************************
+char const *Decoder::funName(uint64_t const fun) const {
+    return objName(fun); // the functions share the dictionary with objects
+}
+
+} // namespace QSpy
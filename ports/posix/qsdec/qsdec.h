@@ -0,0 +1,348 @@
+/// @file
+/// @brief QS decoder library -- decodes the QS trace stream on the host
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+
+#ifndef qsdec_h
+#define qsdec_h
+
+// The QS decoder runs on the host, so unlike the QP code it uses the
+// standard C++ library. It does not depend on the QP headers, because it
+// decodes the QS streams from any Target, as described by the Target info
+// record (see QSpy::TargetInfo).
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+namespace QSpy {
+
+//! QS record types (the same values as QP::QSpyRecords in qs.h)
+enum RecordType {
+    QS_EMPTY,
+    QS_QEP_STATE_ENTRY, QS_QEP_STATE_EXIT, QS_QEP_STATE_INIT,
+    QS_QEP_INIT_TRAN, QS_QEP_INTERN_TRAN, QS_QEP_TRAN, QS_QEP_IGNORED,
+    QS_QEP_DISPATCH, QS_QEP_UNHANDLED,
+    QS_QF_ACTIVE_ADD, QS_QF_ACTIVE_REMOVE, QS_QF_ACTIVE_SUBSCRIBE,
+    QS_QF_ACTIVE_UNSUBSCRIBE, QS_QF_ACTIVE_POST_FIFO,
+    QS_QF_ACTIVE_POST_LIFO, QS_QF_ACTIVE_GET, QS_QF_ACTIVE_GET_LAST,
+    QS_QF_EQUEUE_INIT, QS_QF_EQUEUE_POST_FIFO, QS_QF_EQUEUE_POST_LIFO,
+    QS_QF_EQUEUE_GET, QS_QF_EQUEUE_GET_LAST, QS_QF_MPOOL_INIT,
+    QS_QF_MPOOL_GET, QS_QF_MPOOL_PUT, QS_QF_PUBLISH,
+    QS_QF_ACTIVE_POST_IGNORED, QS_QF_NEW, QS_QF_GC_ATTEMPT, QS_QF_GC,
+    QS_QF_TICK, QS_QF_TIMEEVT_ARM, QS_QF_TIMEEVT_AUTO_DISARM,
+    QS_QF_TIMEEVT_DISARM_ATTEMPT, QS_QF_TIMEEVT_DISARM,
+    QS_QF_TIMEEVT_REARM, QS_QF_TIMEEVT_POST, QS_QF_TIMEEVT_CTR,
+    QS_QF_CRIT_ENTRY, QS_QF_CRIT_EXIT, QS_QF_ISR_ENTRY, QS_QF_ISR_EXIT,
+    QS_QF_INT_DISABLE, QS_QF_INT_ENABLE, QS_QF_ACTIVE_POST_ATTEMPT,
+    QS_QF_EQUEUE_POST_ATTEMPT, QS_QF_MPOOL_GET_ATTEMPT,
+    QS_MUTEX_LOCK, QS_MUTEX_UNLOCK,
+    QS_SCHED_LOCK, QS_SCHED_UNLOCK, QS_SCHED_NEXT, QS_SCHED_IDLE,
+    QS_SCHED_RESUME,
+    QS_QEP_TRAN_HIST, QS_QEP_TRAN_EP, QS_QEP_TRAN_XP,
+    QS_TEST_PAUSED, QS_TEST_PROBE_GET, QS_SIG_DICT, QS_OBJ_DICT,
+    QS_FUN_DICT, QS_USR_DICT, QS_TARGET_INFO, QS_TARGET_DONE,
+    QS_RX_STATUS, QS_SAMPLE_CFG, QS_PEEK_DATA, QS_ASSERT_FAIL,
+    QS_USER,
+    QS_OVERRUN = QS_USER + 54, //!< the last User record (formatted)
+    QS_REC_MAX = 0x80 //!< the number of record types
+};
+
+//! The tag of the compact-encoding pointer IDs that could not be resolved
+uint64_t const UNKNOWN_ID = static_cast<uint64_t>(1) << 63;
+
+//! Data formats of the application-specific (user) record items
+//! (the same values as QP::QS::QSType and QP::QS::QSArrType in qs.h)
+enum ItemType {
+    I8_T, U8_T, I16_T, U16_T, I32_T, U32_T, F32_T, F64_T,
+    STR_T, MEM_T, SIG_T, OBJ_T, FUN_T, I64_T, U64_T, U32_HEX_T,
+
+    ARR_U8_T = 1, ARR_U16_T, ARR_U32_T, ARR_F32_T, ARR_F64_T
+};
+
+//! The Target configuration from the QS_TARGET_INFO record
+struct TargetInfo {
+    uint16_t version;  //!< the QP version
+    uint8_t sigSize;   //!< size of the signal
+    uint8_t evtSize;   //!< size of the event-size
+    uint8_t eqcSize;   //!< size of the event-queue counter
+    uint8_t tecSize;   //!< size of the time-event counter
+    uint8_t mpsSize;   //!< size of the memory-pool block-size
+    uint8_t mpcSize;   //!< size of the memory-pool counter
+    uint8_t objSize;   //!< size of the object pointer
+    uint8_t funSize;   //!< size of the function pointer
+    uint8_t timeSize;  //!< size of the time stamp
+    bool    compact;   //!< the compact QS encoding (see QS_COMPACT)
+    bool    received;  //!< the record has been received (not defaults)
+};
+
+//! One decoded QS record
+/// @description
+/// The fields of the QS records produced by QP are sorted by their kind
+/// into the arrays below in the order of their appearance in the record
+/// (e.g., the sender is obj[0] and the recipient obj[1] of the
+/// QS_QF_ACTIVE_POST_FIFO record). The pointers in the compact encoding
+/// are already translated to the full pointers (the IDs without the
+/// dictionary record are reported as QSpy::UNKNOWN_ID | ID), and the time
+/// stamps to the absolute time. The bytes pointed to by the record are
+/// valid only inside QSpy::Handler::onRecord().
+struct Record {
+    uint8_t  type;     //!< the record type (QSpy::RecordType)
+    uint8_t  seq;      //!< the record sequence number
+    uint16_t skip;     //!< # records skipped before (sampled records)
+    bool     hasTime;  //!< the record has a time stamp
+    bool     hasSig;   //!< the record has a signal
+    uint8_t  nObj;     //!< # objects in obj[]
+    uint8_t  nFun;     //!< # functions (states) in fun[]
+    uint8_t  nNum;     //!< # numbers (counters, priorities...) in num[]
+    uint64_t time;     //!< the time stamp
+    uint32_t sig;      //!< the signal
+    uint64_t obj[2];   //!< the objects (SM, AO, queue, pool, time event)
+    uint64_t fun[2];   //!< the functions (states)
+    uint64_t num[6];   //!< the other numbers in the record
+    char const *str;   //!< the string (dictionaries, assertions) or 0
+    uint8_t const *data; //!< the rest of the record (e.g., user data)
+    size_t   len;      //!< the number of bytes at data
+};
+
+//! One data item of an application-specific (user) QS record
+struct Item {
+    uint8_t type;      //!< the data format (QSpy::ItemType)
+    uint8_t width;     //!< the display width (or array element type)
+    uint64_t u;        //!< unsigned value (integers, pointers, signal)
+    int64_t  i;        //!< signed value (signed integers)
+    double   f;        //!< floating point value
+    uint64_t obj;      //!< the object of the SIG_T item
+    char const *str;   //!< the string of the STR_T item
+    uint8_t const *mem; //!< the bytes of MEM_T item (little-endian)
+    uint32_t n;        //!< # bytes (MEM_T) or elements (arrays)
+};
+
+//! Statistics of the decoded QS stream
+struct Stats {
+    uint64_t bytes;    //!< # bytes fed into the decoder
+    uint64_t records;  //!< # good records
+    uint64_t badSum;   //!< # frames with a bad checksum
+    uint64_t badLen;   //!< # records shorter than their format
+    uint64_t lost;     //!< # records lost (gaps in the sequence numbers)
+    uint64_t overBytes; //!< # bytes overwritten in the target (QS_OVERRUN)
+    uint64_t dropped;  //!< # records dropped in the target (QS_OVERRUN)
+    uint64_t blocked;  //!< # waits for the target QS output (QS_OVERRUN)
+};
+
+class Decoder;
+
+//! Append the decimal number @p v to @p out (faster than snprintf())
+void appendUint(std::string *out, uint64_t v);
+
+//! Append the hexadecimal number @p v with the "0x" prefix to @p out
+void appendHex(std::string *out, uint64_t v);
+
+//! Callback interface for the decoded QS records
+class Handler {
+public:
+    virtual ~Handler() {}
+
+    //! called for every good QS record
+    virtual void onRecord(Decoder const &dec, Record const &rec) = 0;
+
+    //! called for a gap of @p n lost records before the next record
+    virtual void onLost(Decoder const &dec, uint32_t n) {
+        (void)dec;
+        (void)n;
+    }
+};
+
+//! Streaming QS decoder
+/// @description
+/// The decoder accepts the QS stream (as produced by QP::QS::getBlock())
+/// in arbitrary chunks, removes the HDLC framing and escaping in bulk,
+/// validates the checksums and sequence numbers, and calls the handler
+/// for every good record. It keeps the dictionaries, the Target info and
+/// the sampling configuration from the stream, so the handler can look up
+/// the names of the signals, objects, functions and user records.
+class Decoder {
+public:
+    explicit Decoder(Handler &handler);
+
+    //! Decode the next @p len bytes of the QS stream
+    void feed(uint8_t const *data, size_t len);
+
+    //! Decode the flight-recorder file (see qs_file.h) in @p file
+    bool feedFlightRecorder(uint8_t const *file, size_t len);
+
+    //! Parse the next user data item at @p *pp before @p end
+    bool nextItem(uint8_t const **pp, uint8_t const *end, Item *item) const;
+
+    //! Format the user data items as text into @p out
+    void formatItems(Record const &rec, std::string *out) const;
+
+    //! the name of the record type (or 0 if not known)
+    char const *recName(uint8_t const type) const;
+
+    //! the name of the signal @p sig of the object @p obj (or 0)
+    char const *sigName(uint32_t const sig, uint64_t const obj) const;
+
+    //! the name of the object @p obj (or 0)
+    char const *objName(uint64_t const obj) const;
+
+    //! the name of the function @p fun (or 0)
+    char const *funName(uint64_t const fun) const;
+
+    TargetInfo const &targetInfo(void) const { return m_info; }
+    Stats const &stats(void) const { return m_stats; }
+
+private:
+    void frame_(uint8_t const *f, size_t n);
+    void record_(uint8_t const *p, uint8_t const *end);
+    bool parse_(uint8_t const *p, uint8_t const *end, Record *rec);
+    bool dict_(uint8_t const *p, uint8_t const *end, Record *rec);
+    bool targetInfo_(uint8_t const *p, uint8_t const *end, Record *rec);
+    void sampleCfg_(Record const &rec);
+    void overrun_(Record *rec) const;
+    void formatMem_(Item const &item, std::string *out) const;
+    bool uint_(uint8_t const **pp, uint8_t const *end, uint8_t size,
+               uint64_t *val) const;
+    bool varint_(uint8_t const **pp, uint8_t const *end,
+                 uint64_t *val) const;
+    bool ptr_(uint8_t const **pp, uint8_t const *end, uint8_t size,
+              uint64_t *val) const;
+    bool time_(uint8_t const **pp, uint8_t const *end, uint64_t *val);
+
+    Handler &m_handler;
+    TargetInfo m_info;
+    Stats m_stats;
+    Record m_rec;      //!< the record being decoded
+
+    std::vector<uint8_t> m_frame; //!< the (unescaped) incomplete frame
+    bool m_esc;        //!< the last byte of the input was QS_ESC
+    bool m_seqValid;   //!< m_seq holds the last sequence number
+    uint8_t m_seq;     //!< the last sequence number
+    bool m_timeValid;  //!< m_time is valid for the compact delta times
+    uint64_t m_time;   //!< the last time stamp (compact encoding)
+    uint8_t m_smpl[16]; //!< the sampled record types (QS_SAMPLE_CFG)
+
+    //! the sampling configurations (rec << 32 | sig), see QS_SAMPLE_CFG
+    std::unordered_map<uint64_t, bool> m_smplCfg;
+    //! the signal names by (signal, object)
+    std::map<std::pair<uint32_t, uint64_t>, std::string> m_sigDict;
+    std::unordered_map<uint64_t, std::string> m_objDict; //!< obj/fun names
+    std::unordered_map<uint64_t, uint64_t> m_ids; //!< compact IDs
+    std::string m_usrDict[QS_REC_MAX]; //!< user record names
+};
+
+//! Extension of the QS time stamps to 64 bits across the wrap-arounds of
+//! the Target time counter (for the exporters)
+class TimeExtender {
+public:
+    TimeExtender() : m_lastRaw(0U), m_epoch(0U) {}
+
+    //! the extended time of the record @p rec, which must have the time
+    uint64_t extend(Decoder const &dec, Record const &rec);
+
+private:
+    uint64_t m_lastRaw; //!< the last time stamp from the Target
+    uint64_t m_epoch;   //!< the wrap-arounds of the Target time counter
+};
+
+//! Handler that writes the records in the Chrome trace-event JSON format
+/// @description
+/// The output can be loaded into chrome://tracing or the Perfetto UI.
+/// Every state machine gets a "thread". The RTC steps (from the
+/// QS_QEP_DISPATCH record to the QS_QEP_TRAN, QS_QEP_INTERN_TRAN or
+/// QS_QEP_IGNORED record of the same state machine) are the complete
+/// events, the event queues are the counters, and the other records are
+/// the instant events.
+class ChromeExporter : public Handler {
+public:
+    //! @p nsPerTick converts the QS time stamps to nanoseconds
+    ChromeExporter(FILE *out, double const nsPerTick);
+    virtual ~ChromeExporter();
+
+    virtual void onRecord(Decoder const &dec, Record const &rec);
+    virtual void onLost(Decoder const &dec, uint32_t n);
+
+    //! Finish the JSON output (also called by the destructor)
+    void finish(void);
+
+private:
+    struct Rtc {
+        uint64_t start; //!< the time of the QS_QEP_DISPATCH
+        uint32_t sig;   //!< the dispatched signal
+        uint64_t state; //!< the state at the dispatch
+    };
+    void time_(Decoder const &dec, Record const &rec);
+    uint32_t tid_(Decoder const &dec, uint64_t const obj);
+    void event_(char const *ph, char const *name, uint32_t const tid,
+                uint64_t const time);
+    void name_(Decoder const &dec, uint64_t const ptr,
+               char *buf, size_t const size) const;
+
+    FILE *m_out;
+    double m_usPerTick;
+    TimeExtender m_ext;  //!< the time stamps extended to 64 bits
+    uint64_t m_lastTime; //!< the last (extended) time stamp
+    bool m_first;
+    bool m_done;
+    std::string m_text; //!< the formatted user data
+    std::string m_num;  //!< the formatted time
+    std::unordered_map<uint64_t, uint32_t> m_tids; //!< object -> "thread"
+    std::unordered_map<uint64_t, Rtc> m_rtc;       //!< open RTC steps
+};
+
+//! Handler that writes one line of comma-separated values per record
+class CsvExporter : public Handler {
+public:
+    explicit CsvExporter(FILE *out);
+
+    virtual void onRecord(Decoder const &dec, Record const &rec);
+    virtual void onLost(Decoder const &dec, uint32_t n);
+
+private:
+    void ptr_(Decoder const &dec, uint64_t const ptr);
+    void text_(char const *s);
+
+    FILE *m_out;
+    TimeExtender m_ext; //!< the time stamps extended to 64 bits
+    std::string m_line; //!< the line being formatted
+    std::string m_text; //!< the formatted user data
+};
+
+} // namespace QSpy
+
+#endif // qsdec_h
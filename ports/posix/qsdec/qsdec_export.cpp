@@ -0,0 +1,426 @@
+/// @file
+/// @brief QS decoder library -- exporters to Chrome trace-event JSON and CSV
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+
+#include "qsdec.h"
+
+#include <string.h>
+
+namespace QSpy {
+
+//****************************************************************************
+// write the string @p s as the JSON string (with the quotes)
+static void jsonStr(FILE *out, char const *s) {
+    fputc('"', out);
+    for (; *s != '\0'; ++s) {
+        unsigned char const c = static_cast<unsigned char>(*s);
+        if ((c == '"') || (c == '\\')) {
+            fputc('\\', out);
+            fputc(c, out);
+        }
+        else if (c < 0x20U) {
+            fprintf(out, "\\u%04x", c);
+        }
+        else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+//****************************************************************************
+// write the time @p ticks in microseconds with 3 decimals (nanoseconds)
+static void timeUs(FILE *out, std::string *buf, uint64_t const ticks,
+                   double const usPerTick)
+{
+    uint64_t const ns = static_cast<uint64_t>(
+                            static_cast<double>(ticks) * usPerTick * 1000.0
+                            + 0.5);
+    uint64_t const frac = ns % 1000U;
+    buf->clear();
+    appendUint(buf, ns / 1000U);
+    buf->push_back('.');
+    buf->push_back(static_cast<char>('0' + (frac / 100U)));
+    buf->push_back(static_cast<char>('0' + ((frac / 10U) % 10U)));
+    buf->push_back(static_cast<char>('0' + (frac % 10U)));
+    fwrite(buf->data(), 1U, buf->size(), out);
+}
+
+//****************************************************************************
+/// @description
+/// The time stamps shorter than 64 bits wrap around, so a time stamp
+/// smaller than the previous one starts the next epoch of the counter.
+///
+uint64_t TimeExtender::extend(Decoder const &dec, Record const &rec) {
+    uint8_t const size = dec.targetInfo().timeSize;
+    if ((size < 8U) && (rec.time < m_lastRaw)) { // wrap-around?
+        m_epoch += static_cast<uint64_t>(1) << (8U * size);
+    }
+    m_lastRaw = rec.time;
+    return m_epoch + rec.time;
+}
+
+//****************************************************************************
+ChromeExporter::ChromeExporter(FILE *out, double const nsPerTick)
+  : m_out(out),
+    m_usPerTick(nsPerTick / 1000.0),
+    m_lastTime(0U),
+    m_first(true),
+    m_done(false)
+{
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", m_out);
+}
+
+//****************************************************************************
+ChromeExporter::~ChromeExporter() {
+    finish();
+}
+
+//****************************************************************************
+void ChromeExporter::finish(void) {
+    if (!m_done) {
+        fputs("\n]}\n", m_out);
+        m_done = true;
+    }
+}
+
+//****************************************************************************
+/// @description
+/// The QS time stamps are extended to 64 bits across the wrap-arounds of
+/// the Target time counter, so the trace time keeps increasing.
+///
+void ChromeExporter::time_(Decoder const &dec, Record const &rec) {
+    if (!rec.hasTime) {
+        return; // keep the time of the last record with the time stamp
+    }
+    m_lastTime = m_ext.extend(dec, rec);
+}
+
+//****************************************************************************
+void ChromeExporter::name_(Decoder const &dec, uint64_t const ptr,
+                           char *buf, size_t const size) const
+{
+    char const * const name = dec.objName(ptr);
+    if (name != 0) {
+        snprintf(buf, size, "%s", name);
+    }
+    else {
+        snprintf(buf, size, "0x%llX", static_cast<unsigned long long>(ptr));
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Every object (state machine, active object) gets its own "thread" in
+/// the trace, named after the object from the object dictionary.
+///
+uint32_t ChromeExporter::tid_(Decoder const &dec, uint64_t const obj) {
+    std::unordered_map<uint64_t, uint32_t>::const_iterator const it
+        = m_tids.find(obj);
+    if (it != m_tids.end()) {
+        return it->second;
+    }
+    uint32_t const tid = static_cast<uint32_t>(m_tids.size() + 1U);
+    m_tids[obj] = tid;
+
+    char name[128];
+    name_(dec, obj, name, sizeof(name));
+    event_("M", "thread_name", tid, 0U);
+    fputs(",\"args\":{\"name\":", m_out);
+    jsonStr(m_out, name);
+    fputs("}}", m_out);
+    return tid;
+}
+
+//****************************************************************************
+// start the next trace event (without the closing brace)
+void ChromeExporter::event_(char const *ph, char const *name,
+                            uint32_t const tid, uint64_t const time)
+{
+    fputs(m_first ? "\n{\"name\":" : ",\n{\"name\":", m_out);
+    m_first = false;
+    jsonStr(m_out, name);
+    fprintf(m_out, ",\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":",
+            ph, tid);
+    timeUs(m_out, &m_num, time, m_usPerTick);
+}
+
+//****************************************************************************
+void ChromeExporter::onRecord(Decoder const &dec, Record const &rec) {
+    char name[128];
+    char const *s;
+
+    time_(dec, rec);
+    switch (rec.type) {
+        case QS_QEP_DISPATCH: {
+            Rtc &rtc = m_rtc[rec.obj[0]];
+            rtc.start = m_lastTime;
+            rtc.sig   = rec.sig;
+            rtc.state = rec.fun[0];
+            break;
+        }
+        case QS_QEP_TRAN:
+        case QS_QEP_INTERN_TRAN:
+        case QS_QEP_IGNORED: { // the end of the RTC step
+            std::unordered_map<uint64_t, Rtc>::iterator const it
+                = m_rtc.find(rec.obj[0]);
+            if (it == m_rtc.end()) {
+                break; // the QS_QEP_DISPATCH record has been lost
+            }
+            uint32_t const tid = tid_(dec, rec.obj[0]);
+            s = dec.sigName(it->second.sig, rec.obj[0]);
+            if (s == 0) {
+                snprintf(name, sizeof(name), "sig %u", it->second.sig);
+                s = name;
+            }
+            event_("X", s, tid, it->second.start);
+            fputs(",\"dur\":", m_out);
+            timeUs(m_out, &m_num, m_lastTime - it->second.start,
+                   m_usPerTick);
+            fputs(",\"cat\":\"rtc\",\"args\":{", m_out);
+            name_(dec, it->second.state, name, sizeof(name));
+            fputs("\"state\":", m_out);
+            jsonStr(m_out, name);
+            fprintf(m_out, ",\"result\":\"%s\"",
+                    (rec.type == QS_QEP_TRAN) ? "tran"
+                    : (rec.type == QS_QEP_IGNORED) ? "ignored"
+                    : "internal");
+            if (rec.type == QS_QEP_TRAN) {
+                name_(dec, rec.fun[1], name, sizeof(name));
+                fputs(",\"target\":", m_out);
+                jsonStr(m_out, name);
+            }
+            fputs("}}", m_out);
+            m_rtc.erase(it);
+            break;
+        }
+        case QS_QF_ACTIVE_POST_FIFO:
+        case QS_QF_ACTIVE_POST_LIFO:
+        case QS_QF_ACTIVE_GET:
+        case QS_QF_EQUEUE_POST_FIFO:
+        case QS_QF_EQUEUE_POST_LIFO:
+        case QS_QF_EQUEUE_GET: { // the free entries in the event queue
+            uint64_t const ao = (rec.type == QS_QF_ACTIVE_POST_FIFO)
+                                ? rec.obj[1] : rec.obj[0];
+            char ctr[160];
+            name_(dec, ao, name, sizeof(name));
+            snprintf(ctr, sizeof(ctr), "queue %s", name);
+            event_("C", ctr, 0U, m_lastTime);
+            fprintf(m_out, ",\"args\":{\"free\":%llu}}",
+                    static_cast<unsigned long long>(rec.num[2]));
+            break;
+        }
+        case QS_QF_PUBLISH: {
+            uint32_t const tid = tid_(dec, rec.obj[0]);
+            s = dec.sigName(rec.sig, 0U);
+            if (s == 0) {
+                snprintf(name, sizeof(name), "sig %u", rec.sig);
+                s = name;
+            }
+            event_("i", s, tid, m_lastTime);
+            fputs(",\"s\":\"t\",\"cat\":\"publish\"}", m_out);
+            break;
+        }
+        case QS_OBJ_DICT: { // object named after it appeared (lazy dict.)?
+            std::unordered_map<uint64_t, uint32_t>::const_iterator const it
+                = m_tids.find(rec.obj[0]);
+            if ((it != m_tids.end()) && (*rec.str != '\0')) {
+                event_("M", "thread_name", it->second, 0U);
+                fputs(",\"args\":{\"name\":", m_out);
+                jsonStr(m_out, rec.str);
+                fputs("}}", m_out);
+            }
+            break;
+        }
+        case QS_OVERRUN:
+            event_("i", "QS overrun", 0U, m_lastTime);
+            fprintf(m_out, ",\"s\":\"g\",\"args\":{\"bytes\":%llu,"
+                    "\"records\":%llu,\"dropped\":%llu,"
+                    "\"droppedBytes\":%llu,\"blocked\":%llu}}",
+                    static_cast<unsigned long long>(rec.num[0]),
+                    static_cast<unsigned long long>(rec.num[1]),
+                    static_cast<unsigned long long>(rec.num[2]),
+                    static_cast<unsigned long long>(rec.num[3]),
+                    static_cast<unsigned long long>(rec.num[4]));
+            break;
+        default:
+            if ((rec.type >= QS_USER) && (rec.type < QS_OVERRUN)) {
+                s = dec.recName(rec.type);
+                if (s == 0) {
+                    snprintf(name, sizeof(name), "USER+%u",
+                             static_cast<unsigned>(rec.type - QS_USER));
+                    s = name;
+                }
+                m_text.clear();
+                dec.formatItems(rec, &m_text);
+                event_("i", s, 0U, m_lastTime);
+                fputs(",\"s\":\"g\",\"cat\":\"user\",\"args\":{\"data\":",
+                      m_out);
+                jsonStr(m_out, m_text.c_str());
+                fputs("}}", m_out);
+            }
+            break;
+    }
+}
+
+//****************************************************************************
+void ChromeExporter::onLost(Decoder const &dec, uint32_t n) {
+    (void)dec;
+    event_("i", "QS records lost", 0U, m_lastTime);
+    fprintf(m_out, ",\"s\":\"g\",\"args\":{\"records\":%u}}", n);
+    m_rtc.clear(); // the ends of the open RTC steps might have been lost
+}
+
+//****************************************************************************
+CsvExporter::CsvExporter(FILE *out)
+  : m_out(out)
+{
+    fputs("seq,time,skip,record,obj,obj2,state,target,signal,"
+          "n0,n1,n2,n3,text\n", m_out);
+    m_line.reserve(256U);
+}
+
+//****************************************************************************
+// append the pointer by the name from the dictionary if known
+void CsvExporter::ptr_(Decoder const &dec, uint64_t const ptr) {
+    char const * const name = dec.objName(ptr);
+    m_line.push_back(',');
+    if (name != 0) {
+        text_(name);
+    }
+    else {
+        appendHex(&m_line, ptr);
+    }
+}
+
+//****************************************************************************
+// append the text field, quoted when necessary
+void CsvExporter::text_(char const *s) {
+    if (strpbrk(s, ",\"\n\r") == 0) {
+        m_line.append(s);
+        return;
+    }
+    m_line.push_back('"');
+    for (; *s != '\0'; ++s) {
+        if (*s == '"') {
+            m_line.push_back('"');
+        }
+        m_line.push_back(*s);
+    }
+    m_line.push_back('"');
+}
+
+//****************************************************************************
+/// @description
+/// The line is formatted in memory and written at once, because the
+/// formatted output (and not the decoding) limits the throughput.
+///
+void CsvExporter::onRecord(Decoder const &dec, Record const &rec) {
+    m_line.clear();
+    appendUint(&m_line, rec.seq);
+    m_line.push_back(',');
+    if (rec.hasTime) { // extended across the wrap-arounds
+        appendUint(&m_line, m_ext.extend(dec, rec));
+    }
+    m_line.push_back(',');
+    if (rec.skip != 0U) { // the records skipped by the QS sampling
+        appendUint(&m_line, rec.skip);
+    }
+    m_line.push_back(',');
+    char const *s = dec.recName(rec.type);
+    if (s != 0) {
+        text_(s);
+    }
+    else {
+        m_line.append("USER+");
+        appendUint(&m_line, rec.type - QS_USER);
+    }
+
+    for (uint_fast8_t i = 0U; i < 2U; ++i) { // obj, obj2
+        if (i < rec.nObj) {
+            ptr_(dec, rec.obj[i]);
+        }
+        else {
+            m_line.push_back(',');
+        }
+    }
+    for (uint_fast8_t i = 0U; i < 2U; ++i) { // state, target
+        if (i < rec.nFun) {
+            ptr_(dec, rec.fun[i]);
+        }
+        else {
+            m_line.push_back(',');
+        }
+    }
+    m_line.push_back(',');
+    if (rec.hasSig) {
+        s = dec.sigName(rec.sig, (rec.nObj != 0U) ? rec.obj[0] : 0U);
+        if ((s != 0) && (rec.type != QS_SIG_DICT)) {
+            text_(s);
+        }
+        else {
+            appendUint(&m_line, rec.sig);
+        }
+    }
+    for (uint_fast8_t i = 0U; i < 4U; ++i) {
+        m_line.push_back(',');
+        if (i < rec.nNum) {
+            appendUint(&m_line, rec.num[i]);
+        }
+    }
+    m_line.push_back(',');
+    if (rec.str != 0) {
+        text_(rec.str);
+    }
+    else if ((rec.type >= QS_USER) && (rec.type < QS_OVERRUN)) {
+        m_text.clear();
+        dec.formatItems(rec, &m_text);
+        text_(m_text.c_str());
+    }
+    else {
+        // no text
+    }
+    m_line.push_back('\n');
+    fwrite(m_line.data(), 1U, m_line.size(), m_out);
+}
+
+//****************************************************************************
+void CsvExporter::onLost(Decoder const &dec, uint32_t n) {
+    (void)dec;
+    fprintf(m_out, ",,,LOST,,,,,,%u,,,,\n", n);
+}
+
+} // namespace QSpy
@@ -0,0 +1,202 @@
+/// @file
+/// @brief qsexport -- exports QS traces to Chrome trace-event JSON or CSV
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+// Usage:
+//   qsexport [-f chrome|csv|stats] [-n <ns-per-tick>] <input|-> [output]
+//
+// The input is a binary QS stream (e.g., written by the QS flusher) or a
+// flight-recorder file (see QS_initFileBuf() in the POSIX QS port), which
+// is recognized by its header. The input "-" is the standard input. The
+// output (the standard output by default) is the Chrome trace-event JSON
+// (for chrome://tracing or the Perfetto UI) or one CSV line per record.
+// The "stats" format only counts the records. The statistics of the
+// decoding are always printed to the standard error.
+//
+#include "qsdec.h"
+#include "../qs_file.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//! Handler that only counts the records of every type
+class StatsCounter : public QSpy::Handler {
+public:
+    StatsCounter() {
+        memset(m_ctr, 0, sizeof(m_ctr));
+    }
+    virtual void onRecord(QSpy::Decoder const &dec,
+                          QSpy::Record const &rec)
+    {
+        (void)dec;
+        ++m_ctr[rec.type];
+    }
+    void print(QSpy::Decoder const &dec, FILE *out) const {
+        for (unsigned i = 0U; i < QSpy::QS_REC_MAX; ++i) {
+            if (m_ctr[i] != 0U) {
+                char const *name = dec.recName(static_cast<uint8_t>(i));
+                if (name != 0) {
+                    fprintf(out, "%-26s %llu\n", name, m_ctr[i]);
+                }
+                else {
+                    fprintf(out, "USER+%-21u %llu\n",
+                            i - QSpy::QS_USER, m_ctr[i]);
+                }
+            }
+        }
+    }
+private:
+    unsigned long long m_ctr[QSpy::QS_REC_MAX];
+};
+
+//****************************************************************************
+static int usage(char const *prog) {
+    fprintf(stderr, "usage: %s [-f chrome|csv|stats] [-n <ns-per-tick>] "
+            "<input|-> [output]\n", prog);
+    return 1;
+}
+
+//****************************************************************************
+int main(int argc, char *argv[]) {
+    char const *fmt = "csv";
+    double nsPerTick = 1000.0; // 1 microsecond per QS time-stamp tick
+    int i;
+
+    for (i = 1; (i + 1 < argc) && (argv[i][0] == '-')
+                && (argv[i][1] != '\0'); i += 2)
+    {
+        if (strcmp(argv[i], "-f") == 0) {
+            fmt = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "-n") == 0) {
+            nsPerTick = atof(argv[i + 1]);
+        }
+        else {
+            return usage(argv[0]);
+        }
+    }
+    if ((i >= argc) || (argc - i > 2)) {
+        return usage(argv[0]);
+    }
+
+    FILE *out = stdout;
+    if ((i + 1 < argc) && ((out = fopen(argv[i + 1], "w")) == NULL)) {
+        perror(argv[i + 1]);
+        return 1;
+    }
+    static char outBuf[1U << 20]; // large buffer for the formatted output
+    setvbuf(out, outBuf, _IOFBF, sizeof(outBuf));
+
+    QSpy::Handler *handler;
+    StatsCounter counter;
+    if (strcmp(fmt, "chrome") == 0) {
+        handler = new QSpy::ChromeExporter(out, nsPerTick);
+    }
+    else if (strcmp(fmt, "csv") == 0) {
+        handler = new QSpy::CsvExporter(out);
+    }
+    else if (strcmp(fmt, "stats") == 0) {
+        handler = &counter;
+    }
+    else {
+        return usage(argv[0]);
+    }
+    QSpy::Decoder dec(*handler);
+
+    int const fd = (strcmp(argv[i], "-") == 0)
+                   ? STDIN_FILENO
+                   : open(argv[i], O_RDONLY);
+    struct stat st;
+    if ((fd < 0) || (fstat(fd, &st) != 0)) {
+        perror(argv[i]);
+        return 1;
+    }
+
+    void *map = MAP_FAILED;
+    if (S_ISREG(st.st_mode) && (st.st_size > 0)) {
+        map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (map != MAP_FAILED) { // decode the whole file in place
+        uint8_t const *data = static_cast<uint8_t const *>(map);
+        size_t const len = static_cast<size_t>(st.st_size);
+        (void)madvise(map, len, MADV_SEQUENTIAL);
+        if ((len < 4U)
+            || (memcmp(data, QS_FILE_MAGIC, 4U) != 0)
+            || !dec.feedFlightRecorder(data, len))
+        {
+            dec.feed(data, len);
+        }
+        munmap(map, len);
+    }
+    else { // pipe or terminal
+        static uint8_t buf[1U << 16];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0) {
+            dec.feed(buf, static_cast<size_t>(n));
+        }
+    }
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+
+    if (handler != &counter) {
+        delete handler; // finishes the output
+    }
+    else {
+        counter.print(dec, out);
+    }
+    fclose(out);
+
+    QSpy::Stats const &stats = dec.stats();
+    fprintf(stderr, "%llu bytes, %llu records, %llu lost, "
+            "%llu bad checksum, %llu bad length\n",
+            static_cast<unsigned long long>(stats.bytes),
+            static_cast<unsigned long long>(stats.records),
+            static_cast<unsigned long long>(stats.lost),
+            static_cast<unsigned long long>(stats.badSum),
+            static_cast<unsigned long long>(stats.badLen));
+    if ((stats.overBytes | stats.dropped | stats.blocked) != 0U) {
+        fprintf(stderr, "target: %llu bytes overwritten, "
+                "%llu records dropped, %llu waits\n",
+                static_cast<unsigned long long>(stats.overBytes),
+                static_cast<unsigned long long>(stats.dropped),
+                static_cast<unsigned long long>(stats.blocked));
+    }
+    return 0;
+}
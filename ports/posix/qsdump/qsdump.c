@@ -0,0 +1,125 @@
+/// @file
+/// @brief qsdump -- extracts QS records from a flight-recorder file
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+
+// Usage:
+//   qsdump <flight-recorder-file> <output-file>
+//
+// The output file contains the QS records from the flight-recorder file
+// (see QS_initFileBuf() in the POSIX QS port) in the order in which they
+// were produced, as a binary QS stream that QSPY can read from a file.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../qs_file.h"
+
+#define QS_FRAME 0x7E
+
+int main(int argc, char *argv[]) {
+    FILE *in;
+    FILE *out;
+    QSFileHdr hdr;
+    uint8_t *ring;
+    uint32_t i;
+    uint32_t skip;
+    int wrapped;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <flight-recorder-file> <output-file>\n",
+                argv[0]);
+        return 1;
+    }
+    in = fopen(argv[1], "rb");
+    if (in == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    if ((fread(&hdr, sizeof(hdr), 1, in) != 1)
+        || (memcmp(hdr.magic, QS_FILE_MAGIC, sizeof(hdr.magic)) != 0)
+        || (hdr.version != QS_FILE_VERSION)
+        || (hdr.head >= hdr.size)
+        || (hdr.infoLen > QS_FILE_INFO_SIZE))
+    {
+        fprintf(stderr, "%s: not a QS flight-recorder file\n", argv[1]);
+        fclose(in);
+        return 1;
+    }
+    ring = (uint8_t *)malloc(hdr.size);
+    if ((ring == NULL) || (fread(ring, 1, hdr.size, in) != hdr.size)) {
+        fprintf(stderr, "%s: truncated QS flight-recorder file\n", argv[1]);
+        free(ring); // free(NULL) does nothing
+        fclose(in);
+        return 1;
+    }
+    fclose(in);
+
+    out = fopen(argv[2], "wb");
+    if (out == NULL) {
+        perror(argv[2]);
+        free(ring);
+        return 1;
+    }
+
+    // The file is zero-filled when created, so the part of the ring past
+    // the head contains a frame character only if the ring has wrapped.
+    wrapped = (memchr(&ring[hdr.head], QS_FRAME, hdr.size - hdr.head)
+               != NULL);
+
+    if (!wrapped) { // all records from the beginning are still there
+        fwrite(ring, 1, hdr.head, out);
+    }
+    else {
+        // the Target info produced at startup has been overwritten
+        fwrite(hdr.info, 1, hdr.infoLen, out);
+
+        // skip the partially overwritten oldest record up to its frame
+        for (skip = 0U; ring[(hdr.head + skip) % hdr.size] != QS_FRAME;
+             ++skip)
+        {
+        }
+        ++skip; // skip the frame character as well
+
+        // the oldest data starts at the head...
+        for (i = skip; i < hdr.size; ++i) {
+            fputc(ring[(hdr.head + i) % hdr.size], out);
+        }
+    }
+    fclose(out);
+    free(ring);
+    return 0;
+}
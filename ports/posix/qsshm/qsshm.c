@@ -0,0 +1,157 @@
+/// @file
+/// @brief qsshm -- reads QS records from POSIX shared memory
+/// @cond
+///***************************************************************************
+/// Last updated for version 6.0.3
+/// Last updated on  2018-01-20
+///
+///                    Q u a n t u m     L e a P s
+///                    ---------------------------
+///                    innovating embedded systems
+///
+/// Copyright (C) Quantum Leaps. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, this program may be distributed and modified under the
+/// terms of Quantum Leaps commercial licenses, which expressly supersede
+/// the GNU General Public License and are specifically designed for
+/// licensees interested in retaining the proprietary status of their code.
+///
+/// This program is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY; without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with this program. If not, see <http://www.gnu.org/licenses/>.
+///
+/// Contact information:
+/// https://state-machine.com
+/// mailto:info@state-machine.com
+///***************************************************************************
+/// @endcond
+
+
+// Usage:
+//   qsshm <shared-memory-name> [<output-file>]
+//
+// Follows the QS records that the application writes into the POSIX shared
+// memory (see QS_initShmBuf() in the POSIX QS port) and writes them to the
+// output file (the standard output by default) as a binary QS stream for
+// QSPY, until it is interrupted (e.g., Ctrl-C). The records are read in
+// place from the shared memory between the consumer's tail and the head
+// published by QS (see qs_file.h). A consumer that parses the records
+// itself (e.g., with QSPY_parse()) would replace the consume() function.
+//
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../qs_file.h"
+
+static volatile sig_atomic_t l_done;
+static FILE *l_out;
+
+static void onSignal(int sig) {
+    (void)sig;
+    l_done = 1;
+}
+
+// consume a span of QS data in place
+static void consume(uint8_t const *span, uint32_t n) {
+    fwrite(span, 1, n, l_out);
+}
+
+int main(int argc, char *argv[]) {
+    struct timespec const idle = { 0, 1000000L }; // 1 ms
+    struct stat st;
+    QSFileHdr *hdr;
+    uint8_t const *ring;
+    uint32_t head;
+    uint32_t tail;
+    void *map;
+    int fd;
+
+    if ((argc != 2) && (argc != 3)) {
+        fprintf(stderr, "usage: %s <shared-memory-name> [<output-file>]\n",
+                argv[0]);
+        return 1;
+    }
+    fd = shm_open(argv[1], O_RDWR, 0);
+    if (fd < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    if ((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(QSFileHdr))) {
+        fprintf(stderr, "%s: not a QS shared memory\n", argv[1]);
+        close(fd);
+        return 1;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+               fd, 0);
+    close(fd); // the mapping stays valid after closing the object
+    if (map == MAP_FAILED) {
+        perror(argv[1]);
+        return 1;
+    }
+    hdr  = (QSFileHdr *)map;
+    ring = (uint8_t const *)map + sizeof(QSFileHdr);
+    if ((memcmp(hdr->magic, QS_FILE_MAGIC, sizeof(hdr->magic)) != 0)
+        || (hdr->version != QS_FILE_VERSION)
+        || ((off_t)(sizeof(QSFileHdr) + hdr->size) > st.st_size)
+        || (hdr->infoLen > QS_FILE_INFO_SIZE))
+    {
+        fprintf(stderr, "%s: not a QS shared memory\n", argv[1]);
+        return 1;
+    }
+
+    l_out = stdout;
+    if (argc == 3) {
+        l_out = fopen(argv[2], "wb");
+        if (l_out == NULL) {
+            perror(argv[2]);
+            return 1;
+        }
+    }
+    signal(SIGINT,  &onSignal);
+    signal(SIGTERM, &onSignal);
+
+    tail = __atomic_load_n(&hdr->tail, __ATOMIC_ACQUIRE);
+    if (tail != 0U) { // not the first consumer?
+        // the Target info produced at startup has been consumed already
+        consume(hdr->info, hdr->infoLen);
+    }
+    while (!l_done) {
+        head = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+        if (head == tail) { // nothing new?
+            fflush(l_out);
+            nanosleep(&idle, NULL);
+        }
+        else {
+            if (head > tail) { // one contiguous span?
+                consume(&ring[tail], head - tail);
+            }
+            else { // the data wraps around the end of the ring
+                consume(&ring[tail], hdr->size - tail);
+                consume(&ring[0], head);
+            }
+            tail = head;
+            __atomic_store_n(&hdr->tail, tail, __ATOMIC_RELEASE);
+        }
+    }
+    fflush(l_out);
+    if (l_out != stdout) {
+        fclose(l_out);
+    }
+    munmap(map, (size_t)st.st_size);
+    return 0;
+}
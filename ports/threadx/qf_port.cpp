@@ -162,7 +162,7 @@ bool QActive::post_(QEvt const * const e, uint_fast16_t const margin,
     if (status) { // can post the event?
 
         QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_FIFO,
-                         QS::priv_.locFilter[QS::AO_OBJ], this)
+                         QS::AO_OBJ, this)
             QS_TIME_();       // timestamp
             QS_OBJ_(sender);  // the sender object
             QS_SIG_(e->sig);  // the signal of the event
@@ -187,7 +187,7 @@ bool QActive::post_(QEvt const * const e, uint_fast16_t const margin,
     else {
 
         QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_ATTEMPT,
-            QS::priv_.locFilter[QS::AO_OBJ], this)
+            QS::AO_OBJ, this)
             QS_TIME_();       // timestamp
             QS_OBJ_(sender);  // the sender object
             QS_SIG_(e->sig);  // the signal of the event
@@ -208,7 +208,7 @@ void QActive::postLIFO(QEvt const * const e) {
     QF_CRIT_ENTRY_();
 
     QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_LIFO,
-                     QS::priv_.locFilter[QS::AO_OBJ], this)
+                     QS::AO_OBJ, this)
         QS_TIME_();           // timestamp
         QS_SIG_(e->sig);      // the signal of this event
         QS_OBJ_(this);        // this active object
@@ -240,7 +240,7 @@ QEvt const *QActive::get_(void) {
         tx_queue_receive(&m_eQueue, (VOID *)&e, TX_WAIT_FOREVER)
         == TX_SUCCESS);
 
-    QS_BEGIN_(QS_QF_ACTIVE_GET, QS::priv_.locFilter[QS::AO_OBJ], this)
+    QS_BEGIN_(QS_QF_ACTIVE_GET, QS::AO_OBJ, this)
         QS_TIME_();           // timestamp
         QS_SIG_(e->sig);      // the signal of this event
         QS_OBJ_(this);        // this active object
@@ -265,7 +265,7 @@ void QFSchedLock::lock(uint_fast8_t prio) {
                      &m_prevThre) == TX_SUCCESS);
 
     m_lockPrio = prio;
-    QS_BEGIN_(QS_SCHED_LOCK, static_cast<void *>(0), static_cast<void *>(0))
+    QS_BEGIN_(QS_SCHED_LOCK, QS::NO_OBJ, static_cast<void *>(0))
         QS_TIME_(); // timestamp
         QS_2U8_(static_cast<uint8_t>(QF_TX_PRIO_OFFSET + QF_MAX_ACTIVE
                                      - m_prevThre),
@@ -281,7 +281,7 @@ void QFSchedLock::unlock(void) const {
     Q_REQUIRE_ID(900, m_lockHolder != static_cast<TX_THREAD *>(0));
 
     QS_BEGIN_(QS_SCHED_UNLOCK,
-              static_cast<void *>(0), static_cast<void *>(0))
+              QS::NO_OBJ, static_cast<void *>(0))
         QS_TIME_(); // timestamp
         QS_2U8_(static_cast<uint8_t>(m_lockPrio), /* prev lock prio */
                 static_cast<uint8_t>(QF_TX_PRIO_OFFSET + QF_MAX_ACTIVE
@@ -175,7 +175,7 @@ bool QActive::post_(QEvt const * const e, uint_fast16_t const margin,
     if (status) { // can post the event?
 
         QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_FIFO,
-                         QS::priv_.locFilter[QS::AO_OBJ], this)
+                         QS::AO_OBJ, this)
             QS_TIME_();             // timestamp
             QS_OBJ_(sender);        // the sender object
             QS_SIG_(e->sig);        // the signal of the event
@@ -198,7 +198,7 @@ bool QActive::post_(QEvt const * const e, uint_fast16_t const margin,
     else {
 
         QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_ATTEMPT,
-                         QS::priv_.locFilter[QS::AO_OBJ], this)
+                         QS::AO_OBJ, this)
             QS_TIME_();         // timestamp
             QS_OBJ_(sender);    // the sender object
             QS_SIG_(e->sig);    // the signal of the event
@@ -219,7 +219,7 @@ void QActive::postLIFO(QEvt const * const e) {
     QF_CRIT_ENTRY_();
 
     QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_LIFO,
-                     QS::priv_.locFilter[QS::AO_OBJ], this)
+                     QS::AO_OBJ, this)
         QS_TIME_();             // timestamp
         QS_SIG_(e->sig);        // the signal of this event
         QS_OBJ_(this);          // this active object
@@ -250,7 +250,7 @@ QEvt const *QActive::get_(void) {
         OSQPend(static_cast<OS_EVENT *>(m_eQueue), 0U, &err));
     Q_ASSERT_ID(910, err == OS_ERR_NONE);
 
-    QS_BEGIN_(QS_QF_ACTIVE_GET, QS::priv_.locFilter[QS::AO_OBJ], this)
+    QS_BEGIN_(QS_QF_ACTIVE_GET, QS::AO_OBJ, this)
         QS_TIME_();             // timestamp
         QS_SIG_(e->sig);        // the signal of this event
         QS_OBJ_(this);          // this active object
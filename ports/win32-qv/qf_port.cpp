@@ -124,6 +124,7 @@ int_t QF::run(void) {
             gc(e);
 
             QF_INT_DISABLE();
+            QF_SIG_FILTER_IDLE_(a); // the state of 'a' is stable
 
             if (a->m_eQueue.isEmpty()) { /* empty queue? */
                 QV_readySet_.remove(p);
@@ -50,10 +50,20 @@
 #define QEP_TRIG_(state_, sig_) \
     ((*(state_))(this, &QEP_reservedEvt_[sig_]))
 
+#ifdef QEP_PROFILE
+    //! helper macro to trigger internal event in an HSM with profiling
+    #define QEP_PROF_TRIG_(state_, sig_, kind_) \
+        (profTrig_((state_), &QEP_reservedEvt_[sig_], (kind_)))
+#else
+    #define QEP_PROF_TRIG_(state_, sig_, kind_) QEP_TRIG_(state_, sig_)
+#endif
+
 //! helper macro to trigger exit action in an HSM
 #define QEP_EXIT_(state_) do { \
-    if (QEP_TRIG_(state_, Q_EXIT_SIG) == Q_RET_HANDLED) { \
-        QS_BEGIN_(QS_QEP_STATE_EXIT, QS::priv_.locFilter[QS::SM_OBJ], this) \
+    if (QEP_PROF_TRIG_(state_, Q_EXIT_SIG, QEP_PROF_EXIT) \
+        == Q_RET_HANDLED) \
+    { \
+        QS_BEGIN_(QS_QEP_STATE_EXIT, QS::SM_OBJ, this) \
             QS_OBJ_(this); \
             QS_FUN_(state_); \
         QS_END_() \
@@ -62,8 +72,10 @@
 
 //! helper macro to trigger entry action in an HSM
 #define QEP_ENTER_(state_) do { \
-    if (QEP_TRIG_(state_, Q_ENTRY_SIG) == Q_RET_HANDLED) { \
-        QS_BEGIN_(QS_QEP_STATE_ENTRY, QS::priv_.locFilter[QS::SM_OBJ], this) \
+    if (QEP_PROF_TRIG_(state_, Q_ENTRY_SIG, QEP_PROF_ENTRY) \
+        == Q_RET_HANDLED) \
+    { \
+        QS_BEGIN_(QS_QEP_STATE_ENTRY, QS::SM_OBJ, this) \
             QS_OBJ_(this); \
             QS_FUN_(state_); \
         QS_END_() \
@@ -116,6 +128,9 @@ static QEvt const QEP_reservedEvt_[4] = {
 QHsm::QHsm(QStateHandler const initial) {
     m_state.fun = Q_STATE_CAST(&top);
     m_temp.fun = initial;
+#ifdef QEP_PROFILE
+    m_prof = static_cast<QSmProfile *>(0);
+#endif
 }
 
 //****************************************************************************
@@ -142,13 +157,17 @@ void QHsm::init(QEvt const * const e) {
                       && (t == Q_STATE_CAST(&QHsm::top)));
 
     // execute the top-most initial transition
+#ifdef QEP_PROFILE
+    QState r = profTrig_(m_temp.fun, e, QEP_PROF_INIT);
+#else
     QState r = (*m_temp.fun)(this, e);
+#endif
 
     // the top-most initial transition must be taken
     Q_ASSERT_ID(210, r == Q_RET_TRAN);
 
     QS_CRIT_STAT_
-    QS_BEGIN_(QS_QEP_STATE_INIT, QS::priv_.locFilter[QS::SM_OBJ], this)
+    QS_BEGIN_(QS_QEP_STATE_INIT, QS::SM_OBJ, this)
         QS_OBJ_(this);       // this state machine object
         QS_FUN_(t);          // the source state
         QS_FUN_(m_temp.fun); // the target of the initial transition
@@ -177,12 +196,12 @@ void QHsm::init(QEvt const * const e) {
 
         t = path[0]; // current state becomes the new source
 
-        r = QEP_TRIG_(t, Q_INIT_SIG); // execute initial transition
+        r = QEP_PROF_TRIG_(t, Q_INIT_SIG, QEP_PROF_INIT); // initial tran.
 
 #ifdef Q_SPY
         if (r == Q_RET_TRAN) {
             QS_BEGIN_(QS_QEP_STATE_INIT,
-                      QS::priv_.locFilter[QS::SM_OBJ], this)
+                      QS::SM_OBJ, this)
                 QS_OBJ_(this);       // this state machine object
                 QS_FUN_(t);          // the source state
                 QS_FUN_(m_temp.fun); // the target of the initial transition
@@ -192,7 +211,7 @@ void QHsm::init(QEvt const * const e) {
 
     } while (r == Q_RET_TRAN);
 
-    QS_BEGIN_(QS_QEP_INIT_TRAN, QS::priv_.locFilter[QS::SM_OBJ], this)
+    QS_BEGIN_(QS_QEP_INIT_TRAN, QS::SM_OBJ, this)
         QS_TIME_();    // time stamp
         QS_OBJ_(this); // this state machine object
         QS_FUN_(t);    // the new active state
@@ -243,7 +262,8 @@ void QHsm::dispatch(QEvt const * const e) {
     Q_REQUIRE_ID(400, (t != Q_STATE_CAST(0))
                        && (t == m_temp.fun));
 
-    QS_BEGIN_(QS_QEP_DISPATCH, QS::priv_.locFilter[QS::SM_OBJ], this)
+    QS_BEGIN_SIG_(QS_QEP_DISPATCH, e->sig,
+                  QS::SM_OBJ, this)
         QS_TIME_();         // time stamp
         QS_SIG_(e->sig);    // the signal of the event
         QS_OBJ_(this);      // this state machine object
@@ -253,11 +273,15 @@ void QHsm::dispatch(QEvt const * const e) {
     // process the event hierarchically...
     do {
         s = m_temp.fun;
+#ifdef QEP_PROFILE
+        r = profTrig_(s, e, QEP_PROF_EVT); // invoke state handler s
+#else
         r = (*s)(this, e); // invoke state handler s
+#endif
 
         if (r == Q_RET_UNHANDLED) { // unhandled due to a guard?
 
-            QS_BEGIN_(QS_QEP_UNHANDLED, QS::priv_.locFilter[QS::SM_OBJ], this)
+            QS_BEGIN_(QS_QEP_UNHANDLED, QS::SM_OBJ, this)
                 QS_SIG_(e->sig); // the signal of the event
                 QS_OBJ_(this);   // this state machine object
                 QS_FUN_(s);      // the current state
@@ -270,6 +294,11 @@ void QHsm::dispatch(QEvt const * const e) {
     // transition taken?
     if (r >= Q_RET_TRAN) {
         QStateHandler path[MAX_NEST_DEPTH_];
+#ifdef QEP_PROFILE
+        QEPProfTime const tranStart = (m_prof != static_cast<QSmProfile *>(0))
+                                      ? QEP_PROF_TIME()
+                                      : static_cast<QEPProfTime>(0);
+#endif
 
         path[0] = m_temp.fun; // save the target of the transition
         path[1] = t;
@@ -278,9 +307,11 @@ void QHsm::dispatch(QEvt const * const e) {
         // exit current state to transition source s...
         for (; t != s; t = m_temp.fun) {
             // exit handled?
-            if (QEP_TRIG_(t, Q_EXIT_SIG) == Q_RET_HANDLED) {
+            if (QEP_PROF_TRIG_(t, Q_EXIT_SIG, QEP_PROF_EXIT)
+                == Q_RET_HANDLED)
+            {
                 QS_BEGIN_(QS_QEP_STATE_EXIT,
-                          QS::priv_.locFilter[QS::SM_OBJ], this)
+                          QS::SM_OBJ, this)
                     QS_OBJ_(this); // this state machine object
                     QS_FUN_(t);    // the exited state
                 QS_END_()
@@ -294,7 +325,7 @@ void QHsm::dispatch(QEvt const * const e) {
 #ifdef Q_SPY
         if (r == Q_RET_TRAN_HIST) {
 
-            QS_BEGIN_(QS_QEP_TRAN_HIST, QS::priv_.locFilter[QS::SM_OBJ], this)
+            QS_BEGIN_(QS_QEP_TRAN_HIST, QS::SM_OBJ, this)
                 QS_OBJ_(this);     // this state machine object
                 QS_FUN_(t);        // the source of the transition
                 QS_FUN_(path[0]);  // the target of the tran. to history
@@ -311,10 +342,10 @@ void QHsm::dispatch(QEvt const * const e) {
         m_temp.fun = t; // update the next state
 
         // drill into the target hierarchy...
-        while (QEP_TRIG_(t, Q_INIT_SIG) == Q_RET_TRAN) {
+        while (QEP_PROF_TRIG_(t, Q_INIT_SIG, QEP_PROF_INIT) == Q_RET_TRAN) {
 
             QS_BEGIN_(QS_QEP_STATE_INIT,
-                      QS::priv_.locFilter[QS::SM_OBJ], this)
+                      QS::SM_OBJ, this)
                 QS_OBJ_(this);       // this state machine object
                 QS_FUN_(t);          // the source (pseudo)state
                 QS_FUN_(m_temp.fun); // the target of the transition
@@ -344,19 +375,23 @@ void QHsm::dispatch(QEvt const * const e) {
             t = path[0];
         }
 
-        QS_BEGIN_(QS_QEP_TRAN, QS::priv_.locFilter[QS::SM_OBJ], this)
+        QS_BEGIN_(QS_QEP_TRAN, QS::SM_OBJ, this)
             QS_TIME_();          // time stamp
             QS_SIG_(e->sig);     // the signal of the event
             QS_OBJ_(this);       // this state machine object
             QS_FUN_(s);          // the source of the transition
             QS_FUN_(t);          // the new active state
         QS_END_()
+
+#ifdef QEP_PROFILE
+        profTran_(s, tranStart);
+#endif
     }
 
 #ifdef Q_SPY
     else if (r == Q_RET_HANDLED) {
 
-        QS_BEGIN_(QS_QEP_INTERN_TRAN, QS::priv_.locFilter[QS::SM_OBJ], this)
+        QS_BEGIN_(QS_QEP_INTERN_TRAN, QS::SM_OBJ, this)
             QS_TIME_();          // time stamp
             QS_SIG_(e->sig);     // the signal of the event
             QS_OBJ_(this);       // this state machine object
@@ -366,7 +401,7 @@ void QHsm::dispatch(QEvt const * const e) {
     }
     else {
 
-        QS_BEGIN_(QS_QEP_IGNORED, QS::priv_.locFilter[QS::SM_OBJ], this)
+        QS_BEGIN_(QS_QEP_IGNORED, QS::SM_OBJ, this)
             QS_TIME_();          // time stamp
             QS_SIG_(e->sig);     // the signal of the event
             QS_OBJ_(this);       // this state machine object
@@ -495,10 +530,11 @@ int_fast8_t QHsm::hsm_tran(QStateHandler (&path)[MAX_NEST_DEPTH_]) {
                             r = Q_RET_IGNORED; // keep looping
                             do {
                                 // exit t unhandled?
-                                if (QEP_TRIG_(t, Q_EXIT_SIG) == Q_RET_HANDLED)
+                                if (QEP_PROF_TRIG_(t, Q_EXIT_SIG,
+                                        QEP_PROF_EXIT) == Q_RET_HANDLED)
                                 {
                                     QS_BEGIN_(QS_QEP_STATE_EXIT,
-                                              QS::priv_.locFilter[QS::SM_OBJ],
+                                              QS::SM_OBJ,
                                               this)
                                         QS_OBJ_(this);
                                         QS_FUN_(t);
@@ -614,4 +650,186 @@ QStateHandler QHsm::childState(QStateHandler const parent) {
     return child; // return the child
 }
 
+#ifdef QEP_PROFILE
+
+//****************************************************************************
+/// @description
+/// Calls the state handler @p s with the event @p e and, when a profile is
+/// attached to this state machine, records the execution time of the call.
+///
+QState QHsm::profTrig_(QStateHandler const s, QEvt const * const e,
+                       uint_fast8_t const kind)
+{
+    QState r;
+    if (m_prof == static_cast<QSmProfile *>(0)) {
+        r = (*s)(this, e);
+    }
+    else {
+        QEPProfTime const start = QEP_PROF_TIME();
+        r = (*s)(this, e);
+        m_prof->record(reinterpret_cast<QEPProfFun>(s), kind,
+                       QEP_PROF_TIME() - start);
+    }
+    return r;
+}
+
+//****************************************************************************
+/// @description
+/// Calls the action handler @p act and, when a profile is attached to this
+/// state machine, records the execution time of the call. The kind
+/// QP::QEP_PROF_ACT is refined based on the status returned from the
+/// action (entry, exit or initial transition).
+///
+QState QHsm::profAct_(QActionHandler const act, uint_fast8_t const kind) {
+    QState r;
+    if (m_prof == static_cast<QSmProfile *>(0)) {
+        r = (*act)(this);
+    }
+    else {
+        QEPProfTime const start = QEP_PROF_TIME();
+        r = (*act)(this);
+        QEPProfTime const dt = QEP_PROF_TIME() - start;
+        uint_fast8_t k = kind;
+        if (k == static_cast<uint_fast8_t>(QEP_PROF_ACT)) {
+            if (r == Q_RET_ENTRY) {
+                k = static_cast<uint_fast8_t>(QEP_PROF_ENTRY);
+            }
+            else if (r == Q_RET_EXIT) {
+                k = static_cast<uint_fast8_t>(QEP_PROF_EXIT);
+            }
+            else if (r == Q_RET_TRAN_INIT) {
+                k = static_cast<uint_fast8_t>(QEP_PROF_INIT);
+            }
+            else {
+                // transition action
+            }
+        }
+        m_prof->record(reinterpret_cast<QEPProfFun>(act), k, dt);
+    }
+    return r;
+}
+
+//****************************************************************************
+void QHsm::profTran_(QStateHandler const s, QEPProfTime const start) {
+    if (m_prof != static_cast<QSmProfile *>(0)) {
+        m_prof->record(reinterpret_cast<QEPProfFun>(s),
+                       static_cast<uint_fast8_t>(QEP_PROF_TRAN),
+                       QEP_PROF_TIME() - start);
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Initializes the profile with the application-supplied storage.
+///
+/// @param[in] sto pointer to the storage for the profile entries
+/// @param[in] len number of entries in the storage (must be a power of 2)
+///
+/// @note
+/// A profile must be used by only one state machine at a time, or the
+/// state machines sharing the profile must run in the same thread.
+///
+void QSmProfile::init(Entry * const sto, uint_fast16_t const len) {
+    /// @pre the storage must be provided and its length must be
+    /// a power of 2
+    Q_REQUIRE_ID(900, (sto != static_cast<Entry *>(0))
+                      && (len > static_cast<uint_fast16_t>(0))
+                      && ((len & (len - static_cast<uint_fast16_t>(1)))
+                          == static_cast<uint_fast16_t>(0)));
+    m_sto  = sto;
+    m_mask = len - static_cast<uint_fast16_t>(1);
+    reset();
+}
+
+//****************************************************************************
+void QSmProfile::reset(void) {
+    uint_fast16_t i;
+    for (i = static_cast<uint_fast16_t>(0); i <= m_mask; ++i) {
+        m_sto[i].fun   = static_cast<QEPProfFun>(0);
+        m_sto[i].total = static_cast<QEPProfTime>(0);
+        m_sto[i].max   = static_cast<QEPProfTime>(0);
+        m_sto[i].calls = static_cast<uint32_t>(0);
+        m_sto[i].kind  = static_cast<uint8_t>(0);
+    }
+    m_lost = static_cast<uint32_t>(0);
+}
+
+//****************************************************************************
+/// @description
+/// Accumulates the duration @p dt in the entry for the function @p fun and
+/// the given @p kind. The entry is located by linear probing from the hash
+/// of the function address, so the typical cost is a single comparison.
+///
+void QSmProfile::record(QEPProfFun const fun, uint_fast8_t const kind,
+                        QEPProfTime const dt)
+{
+    uintptr_t h = reinterpret_cast<uintptr_t>(fun);
+    h = (h >> 4) ^ (h >> 12) ^ static_cast<uintptr_t>(kind);
+    uint_fast16_t i = static_cast<uint_fast16_t>(h) & m_mask;
+    uint_fast16_t n = m_mask;
+    Entry *ent = &m_sto[i];
+
+    // probe for the entry with the same key or an empty entry...
+    while (((ent->fun != fun) || (ent->kind != static_cast<uint8_t>(kind)))
+           && (ent->fun != static_cast<QEPProfFun>(0))
+           && (n != static_cast<uint_fast16_t>(0)))
+    {
+        i = (i + static_cast<uint_fast16_t>(1)) & m_mask;
+        ent = &m_sto[i];
+        --n;
+    }
+
+    if (ent->fun == static_cast<QEPProfFun>(0)) { // empty entry found?
+        ent->fun  = fun;
+        ent->kind = static_cast<uint8_t>(kind);
+    }
+
+    if ((ent->fun == fun) && (ent->kind == static_cast<uint8_t>(kind))) {
+        ent->total += dt;
+        if (ent->max < dt) {
+            ent->max = dt;
+        }
+        ++ent->calls;
+    }
+    else { // the storage is full
+        ++m_lost;
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Produces one application-specific QS record @p rec for every non-empty
+/// entry of the profile. The record contains: the state machine object,
+/// the function, the kind, the number of calls, the accumulated time and
+/// the maximum time.
+///
+/// @param[in] sm  the state machine object (for the QS local filter)
+/// @param[in] rec the application-specific QS record number (>= QS_USER)
+///
+void QSmProfile::report(void const * const sm, enum_t const rec) const {
+    uint_fast16_t i;
+    for (i = static_cast<uint_fast16_t>(0); i <= m_mask; ++i) {
+        Entry const * const ent = &m_sto[i];
+        if (ent->fun != static_cast<QEPProfFun>(0)) {
+            QS_BEGIN(rec, sm)
+                QS_OBJ(sm);
+                QS_FUN(ent->fun);
+                QS_U8(0, ent->kind);
+                QS_U32(0, ent->calls);
+#if (QEP_PROF_TIME_SIZE == 8)
+                QS_U64(0, ent->total);
+                QS_U64(0, ent->max);
+#else
+                QS_U32(0, ent->total);
+                QS_U32(0, ent->max);
+#endif
+            QS_END()
+        }
+    }
+    (void)sm;  // avoid compiler warning in case 'sm' is not used
+    (void)rec; // avoid compiler warning in case 'rec' is not used
+}
+
+#endif // QEP_PROFILE
+
 } // namespace QP
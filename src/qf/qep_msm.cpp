@@ -51,6 +51,13 @@
 /// in a macro allows to selectively suppress this specific deviation.
 #define QEP_ACT_PTR_INC_(act_) (++(act_))
 
+#ifdef QEP_PROFILE
+    //! Internal macro to execute an action handler with profiling
+    #define QEP_ACT_(act_, kind_) (profAct_((act_), (kind_)))
+#else
+    #define QEP_ACT_(act_, kind_) ((*(act_))(this))
+#endif
+
 namespace QP {
 
 Q_DEFINE_THIS_MODULE("qep_msm")
@@ -108,12 +115,17 @@ void QMsm::init(QEvt const * const e) {
     Q_REQUIRE_ID(200, (m_temp.fun != Q_STATE_CAST(0))
                       && (m_state.obj == &msm_top_s));
 
-    QState r = (*m_temp.fun)(this, e); // execute the top-most initial tran.
+    // execute the top-most initial transition
+#ifdef QEP_PROFILE
+    QState r = profTrig_(m_temp.fun, e, QEP_PROF_INIT);
+#else
+    QState r = (*m_temp.fun)(this, e);
+#endif
 
     // initial tran. must be taken
     Q_ASSERT_ID(210, r == Q_RET_TRAN_INIT);
 
-    QS_BEGIN_(QS_QEP_STATE_INIT, QS::priv_.locFilter[QS::SM_OBJ], this)
+    QS_BEGIN_(QS_QEP_STATE_INIT, QS::SM_OBJ, this)
         QS_OBJ_(this);  // this state machine object
         QS_FUN_(m_state.obj->stateHandler);          // source state handler
         QS_FUN_(m_temp.tatbl->target->stateHandler); // target state handler
@@ -127,7 +139,7 @@ void QMsm::init(QEvt const * const e) {
         r = execTatbl_(m_temp.tatbl); // execute the transition-action table
     } while (r >= Q_RET_TRAN_INIT);
 
-    QS_BEGIN_(QS_QEP_INIT_TRAN, QS::priv_.locFilter[QS::SM_OBJ], this)
+    QS_BEGIN_(QS_QEP_INIT_TRAN, QS::SM_OBJ, this)
         QS_TIME_();                         // time stamp
         QS_OBJ_(this);                      // this state machine object
         QS_FUN_(m_state.obj->stateHandler); // the new current state
@@ -153,7 +165,8 @@ void QMsm::dispatch(QEvt const * const e) {
     /// @pre current state must be initialized
     Q_REQUIRE_ID(300, s != static_cast<QMState const *>(0));
 
-    QS_BEGIN_(QS_QEP_DISPATCH, QS::priv_.locFilter[QS::SM_OBJ], this)
+    QS_BEGIN_SIG_(QS_QEP_DISPATCH, e->sig,
+                  QS::SM_OBJ, this)
         QS_TIME_();               // time stamp
         QS_SIG_(e->sig);          // the signal of the event
         QS_OBJ_(this);            // this state machine object
@@ -162,7 +175,11 @@ void QMsm::dispatch(QEvt const * const e) {
 
     // scan the state hierarchy up to the top state...
     do {
+#ifdef QEP_PROFILE
+        r = profTrig_(t->stateHandler, e, QEP_PROF_EVT); // call state handler
+#else
         r = (*t->stateHandler)(this, e); // call state handler function
+#endif
 
         // event handled? (the most frequent case)
         if (r >= Q_RET_HANDLED) {
@@ -179,7 +196,7 @@ void QMsm::dispatch(QEvt const * const e) {
         // event unhandled due to a guard?
         else if (r == Q_RET_UNHANDLED) {
 
-            QS_BEGIN_(QS_QEP_UNHANDLED, QS::priv_.locFilter[QS::SM_OBJ], this)
+            QS_BEGIN_(QS_QEP_UNHANDLED, QS::SM_OBJ, this)
                 QS_SIG_(e->sig);    // the signal of the event
                 QS_OBJ_(this);      // this state machine object
                 QS_FUN_(t->stateHandler); // the current state
@@ -201,6 +218,12 @@ void QMsm::dispatch(QEvt const * const e) {
         // the transition source state must not be NULL
         Q_ASSERT_ID(320, ts != static_cast<QMState const *>(0));
 #endif // Q_SPY
+#ifdef QEP_PROFILE
+        QStateHandler const tsHandler = t->stateHandler; // tran. source
+        QEPProfTime const tranStart = (m_prof != static_cast<QSmProfile *>(0))
+                                      ? QEP_PROF_TIME()
+                                      : static_cast<QEPProfTime>(0);
+#endif // QEP_PROFILE
 
         do {
             // save the transition-action table before it gets clobbered
@@ -227,7 +250,7 @@ void QMsm::dispatch(QEvt const * const e) {
                 QActionHandler const act = m_state.act; // save XP action
                 m_state.obj = s; // restore the original state
 
-                r = (*act)(this); // execute the XP action
+                r = QEP_ACT_(act, QEP_PROF_ACT); // execute the XP action
                 if (r == Q_RET_TRAN) { // XP -> TRAN ?
                     exitToTranSource_(s, t);
                     // take the tran-to-XP segment inside submachine
@@ -257,13 +280,17 @@ void QMsm::dispatch(QEvt const * const e) {
 
         } while (r >= Q_RET_TRAN);
 
-        QS_BEGIN_(QS_QEP_TRAN, QS::priv_.locFilter[QS::SM_OBJ], this)
+        QS_BEGIN_(QS_QEP_TRAN, QS::SM_OBJ, this)
             QS_TIME_();                // time stamp
             QS_SIG_(e->sig);           // the signal of the event
             QS_OBJ_(this);             // this state machine object
             QS_FUN_(ts->stateHandler); // the transition source
             QS_FUN_(s->stateHandler);  // the new active state
         QS_END_()
+
+#ifdef QEP_PROFILE
+        profTran_(tsHandler, tranStart);
+#endif
     }
 
 #ifdef Q_SPY
@@ -272,7 +299,7 @@ void QMsm::dispatch(QEvt const * const e) {
         // internal tran. source can't be NULL
         Q_ASSERT_ID(340, t != static_cast<QMState const *>(0));
 
-        QS_BEGIN_(QS_QEP_INTERN_TRAN, QS::priv_.locFilter[QS::SM_OBJ], this)
+        QS_BEGIN_(QS_QEP_INTERN_TRAN, QS::SM_OBJ, this)
             QS_TIME_();               // time stamp
             QS_SIG_(e->sig);          // the signal of the event
             QS_OBJ_(this);            // this state machine object
@@ -283,7 +310,7 @@ void QMsm::dispatch(QEvt const * const e) {
     // event bubbled to the 'top' state?
     else if (t == static_cast<QMState const *>(0)) {
 
-        QS_BEGIN_(QS_QEP_IGNORED, QS::priv_.locFilter[QS::SM_OBJ], this)
+        QS_BEGIN_(QS_QEP_IGNORED, QS::SM_OBJ, this)
             QS_TIME_();               // time stamp
             QS_SIG_(e->sig);          // the signal of the event
             QS_OBJ_(this);            // this state machine object
@@ -320,12 +347,12 @@ QState QMsm::execTatbl_(QMTranActTable const * const tatbl) {
     Q_REQUIRE_ID(400, tatbl != static_cast<QMTranActTable const *>(0));
 
     for (a = &tatbl->act[0]; *a != Q_ACTION_CAST(0); QEP_ACT_PTR_INC_(a)) {
-        r = (*(*a))(this); // call the action through the 'a' pointer
+        r = QEP_ACT_(*a, QEP_PROF_ACT); // call the action through 'a'
 #ifdef Q_SPY
         if (r == Q_RET_ENTRY) {
 
             QS_BEGIN_(QS_QEP_STATE_ENTRY,
-                      QS::priv_.locFilter[QS::SM_OBJ], this)
+                      QS::SM_OBJ, this)
                 QS_OBJ_(this); // this state machine object
                 QS_FUN_(m_temp.obj->stateHandler); // entered state handler
             QS_END_()
@@ -333,7 +360,7 @@ QState QMsm::execTatbl_(QMTranActTable const * const tatbl) {
         else if (r == Q_RET_EXIT) {
 
             QS_BEGIN_(QS_QEP_STATE_EXIT,
-                      QS::priv_.locFilter[QS::SM_OBJ], this)
+                      QS::SM_OBJ, this)
                 QS_OBJ_(this); // this state machine object
                 QS_FUN_(m_temp.obj->stateHandler); // exited state handler
             QS_END_()
@@ -341,7 +368,7 @@ QState QMsm::execTatbl_(QMTranActTable const * const tatbl) {
         else if (r == Q_RET_TRAN_INIT) {
 
             QS_BEGIN_(QS_QEP_STATE_INIT,
-                      QS::priv_.locFilter[QS::SM_OBJ], this)
+                      QS::SM_OBJ, this)
                 QS_OBJ_(this); // this state machine object
                 QS_FUN_(tatbl->target->stateHandler);        // source
                 QS_FUN_(m_temp.tatbl->target->stateHandler); // target
@@ -349,7 +376,7 @@ QState QMsm::execTatbl_(QMTranActTable const * const tatbl) {
         }
         else if (r == Q_RET_TRAN_EP) {
 
-            QS_BEGIN_(QS_QEP_TRAN_EP, QS::priv_.locFilter[QS::SM_OBJ], this)
+            QS_BEGIN_(QS_QEP_TRAN_EP, QS::SM_OBJ, this)
                 QS_OBJ_(this); // this state machine object
                 QS_FUN_(tatbl->target->stateHandler);        // source
                 QS_FUN_(m_temp.tatbl->target->stateHandler); // target
@@ -357,7 +384,7 @@ QState QMsm::execTatbl_(QMTranActTable const * const tatbl) {
         }
         else if (r == Q_RET_TRAN_XP) {
 
-            QS_BEGIN_(QS_QEP_TRAN_XP, QS::priv_.locFilter[QS::SM_OBJ], this)
+            QS_BEGIN_(QS_QEP_TRAN_XP, QS::SM_OBJ, this)
                 QS_OBJ_(this); // this state machine object
                 QS_FUN_(tatbl->target->stateHandler);        // source
                 QS_FUN_(m_temp.tatbl->target->stateHandler); // target
@@ -391,11 +418,11 @@ void QMsm::exitToTranSource_(QMState const *s,
     while (s != ts) {
         // exit action provided in state 's'?
         if (s->exitAction != Q_ACTION_CAST(0)) {
-            (void)(*s->exitAction)(this); // execute the exit action
+            (void)QEP_ACT_(s->exitAction, QEP_PROF_EXIT); // exit action
 
             QS_CRIT_STAT_
             QS_BEGIN_(QS_QEP_STATE_EXIT,
-                      QS::priv_.locFilter[QS::SM_OBJ], this)
+                      QS::SM_OBJ, this)
                 QS_OBJ_(this);            // this state machine object
                 QS_FUN_(s->stateHandler); // the exited state handler
             QS_END_()
@@ -430,7 +457,7 @@ QState QMsm::enterHistory_(QMState const * const hist) {
     uint_fast8_t i = static_cast<uint_fast8_t>(0);  // entry path index
     QS_CRIT_STAT_
 
-    QS_BEGIN_(QS_QEP_TRAN_HIST, QS::priv_.locFilter[QS::SM_OBJ], this)
+    QS_BEGIN_(QS_QEP_TRAN_HIST, QS::SM_OBJ, this)
         QS_OBJ_(this);               // this state machine object
         QS_FUN_(ts->stateHandler);   // source state handler
         QS_FUN_(hist->stateHandler); // target state handler
@@ -451,9 +478,9 @@ QState QMsm::enterHistory_(QMState const * const hist) {
     // retrace the entry path in reverse (desired) order...
     while (i > static_cast<uint_fast8_t>(0)) {
         --i;
-        r = (*epath[i]->entryAction)(this); // run entry action in epath[i]
+        r = QEP_ACT_(epath[i]->entryAction, QEP_PROF_ENTRY); // entry action
 
-        QS_BEGIN_(QS_QEP_STATE_ENTRY, QS::priv_.locFilter[QS::SM_OBJ], this)
+        QS_BEGIN_(QS_QEP_STATE_ENTRY, QS::SM_OBJ, this)
             QS_OBJ_(this);
             QS_FUN_(epath[i]->stateHandler); // entered state handler
         QS_END_()
@@ -463,7 +490,7 @@ QState QMsm::enterHistory_(QMState const * const hist) {
 
     // initial tran. present?
     if (hist->initAction != static_cast<QActionHandler>(0)) {
-        r = (*hist->initAction)(this); // execute the transition action
+        r = QEP_ACT_(hist->initAction, QEP_PROF_INIT); // initial tran.
     }
     else {
         r = Q_RET_NULL;
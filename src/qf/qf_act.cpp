@@ -78,7 +78,7 @@ void QF::add_(QActive * const a) {
 
     active_[p] = a;  // registger the active object at this priority
 
-    QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_ADD, QS::priv_.locFilter[QS::AO_OBJ], a)
+    QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_ADD, QS::AO_OBJ, a)
         QS_TIME_();   // timestamp
         QS_OBJ_(a);   // the active object
         QS_U8_(static_cast<uint8_t>(p)); // prio of the active object
@@ -113,7 +113,7 @@ void QF::remove_(QActive * const a) {
     active_[p] = static_cast<QActive *>(0); // free-up the priority level
     a->m_state.fun = Q_STATE_CAST(0); // invalidate the state
 
-    QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_REMOVE, QS::priv_.locFilter[QS::AO_OBJ], a)
+    QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_REMOVE, QS::AO_OBJ, a)
         QS_TIME_();   // timestamp
         QS_OBJ_(a);   // the active object
         QS_U8_(static_cast<uint8_t>(p)); // prio of the active object
@@ -116,10 +116,43 @@ bool QActive::post_(QEvt const * const e, uint_fast16_t const margin,
         status = false; // cannot post
     }
 
+#ifdef QF_SIG_FILTER_SIZE
+    // is the event ignored in the current (stable) state of this AO?
+    // NOTE: the state is stable only when the AO waits for events with
+    // an empty queue, because any pending event can change the state.
+    if (m_isIdle
+        && (m_eQueue.m_frontEvt == static_cast<QEvt const *>(0))
+        && (m_ignoredSigs != static_cast<QSigMask const *>(0))
+        && m_ignoredSigs->hasSig(e->sig))
+    {
+        ++m_ignoredCtr;
+
+        QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_IGNORED,
+                         QS::AO_OBJ, this)
+            QS_TIME_();               // timestamp
+            QS_OBJ_(sender);          // the sender object
+            QS_SIG_(e->sig);          // the signal of the event
+            QS_OBJ_(this);            // this active object
+            QS_2U8_(e->poolId_, e->refCtr_); // pool Id & refCtr of the evt
+            QS_U32_(m_ignoredCtr);    // number of ignored events so far
+        QS_END_NOCRIT_()
+
+        QF_CRIT_EXIT_();
+
+        // recycle the event only if nobody else holds a reference to it
+        // (e.g., QF::publish_() holds a reference during multicasting)
+        if (e->refCtr_ == static_cast<uint8_t>(0)) {
+            QF::gc(e);
+        }
+        status = true; // event "delivered" (and discarded)
+    }
+    else
+#endif // QF_SIG_FILTER_SIZE
+
     if (status) { // can post the event?
 
-        QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_FIFO,
-                         QS::priv_.locFilter[QS::AO_OBJ], this)
+        QS_BEGIN_SIG_NOCRIT_(QS_QF_ACTIVE_POST_FIFO, e->sig,
+                             QS::AO_OBJ, this)
             QS_TIME_();               // timestamp
             QS_OBJ_(sender);          // the sender object
             QS_SIG_(e->sig);          // the signal of the event
@@ -129,6 +162,8 @@ bool QActive::post_(QEvt const * const e, uint_fast16_t const margin,
             QS_EQC_(m_eQueue.m_nMin); // min number of free entries
         QS_END_NOCRIT_()
 
+        QF_JOURNAL_EVT_(QF_JRNL_POST, m_prio, e); // record the input
+
         // is it a dynamic event?
         if (e->poolId_ != static_cast<uint8_t>(0)) {
             QF_EVT_REF_CTR_INC_(e); // increment the reference counter
@@ -138,11 +173,15 @@ bool QActive::post_(QEvt const * const e, uint_fast16_t const margin,
         m_eQueue.m_nFree = nFree;     // update the volatile
         if (m_eQueue.m_nMin > nFree) {
             m_eQueue.m_nMin = nFree;  // update minimum so far
+            QS_TRG_VALUE_(QS::TRG_QMIN, this, nFree); // trace trigger
         }
 
         // is the queue empty?
         if (m_eQueue.m_frontEvt == static_cast<QEvt const *>(0)) {
             m_eQueue.m_frontEvt = e;      // deliver event directly
+#ifdef QF_LATENCY
+            m_latFront = QF_LATENCY_TIME_(); // the time of posting
+#endif
             QACTIVE_EQUEUE_SIGNAL_(this); // signal the event queue
         }
         // queue is not empty, insert event into the ring-buffer
@@ -150,6 +189,11 @@ bool QActive::post_(QEvt const * const e, uint_fast16_t const margin,
             // insert event pointer e into the buffer (FIFO)
             QF_PTR_AT_(m_eQueue.m_ring, m_eQueue.m_head) = e;
 
+#ifdef QF_LATENCY
+            // the queue fits m_latRing[], see QP::QActive::start()
+            m_latRing[m_eQueue.m_head] = QF_LATENCY_TIME_();
+#endif
+
             // need to wrap head?
             if (m_eQueue.m_head == static_cast<QEQueueCtr>(0)) {
                 m_eQueue.m_head = m_eQueue.m_end; // wrap around
@@ -166,7 +210,7 @@ bool QActive::post_(QEvt const * const e, uint_fast16_t const margin,
         Q_ASSERT_ID(110, margin != QF_NO_MARGIN);
 
         QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_ATTEMPT,
-                         QS::priv_.locFilter[QS::AO_OBJ], this)
+                         QS::AO_OBJ, this)
             QS_TIME_();               // timestamp
             QS_OBJ_(sender);          // the sender object
             QS_SIG_(e->sig);          // the signal of the event
@@ -208,8 +252,8 @@ void QActive::postLIFO(QEvt const * const e) {
     // the queue must be able to accept the event (cannot overflow)
     Q_ASSERT_ID(210, nFree != static_cast<QEQueueCtr>(0));
 
-    QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_LIFO,
-                     QS::priv_.locFilter[QS::AO_OBJ], this)
+    QS_BEGIN_SIG_NOCRIT_(QS_QF_ACTIVE_POST_LIFO, e->sig,
+                         QS::AO_OBJ, this)
         QS_TIME_();                      // timestamp
         QS_SIG_(e->sig);                 // the signal of this event
         QS_OBJ_(this);                   // this active object
@@ -218,6 +262,8 @@ void QActive::postLIFO(QEvt const * const e) {
         QS_EQC_(m_eQueue.m_nMin);        // min number of free entries
     QS_END_NOCRIT_()
 
+    QF_JOURNAL_EVT_(QF_JRNL_POST_LIFO, m_prio, e); // record the input
+
     // is it a dynamic event?
     if (e->poolId_ != static_cast<uint8_t>(0)) {
         QF_EVT_REF_CTR_INC_(e); // increment the reference counter
@@ -227,11 +273,17 @@ void QActive::postLIFO(QEvt const * const e) {
     m_eQueue.m_nFree = nFree; // update the volatile
     if (m_eQueue.m_nMin > nFree) {
         m_eQueue.m_nMin = nFree; // update minimum so far
+        QS_TRG_VALUE_(QS::TRG_QMIN, this, nFree); // trace trigger
     }
 
     QEvt const *frontEvt = m_eQueue.m_frontEvt;// read volatile into temporary
     m_eQueue.m_frontEvt = e; // deliver the event directly to the front
 
+#ifdef QF_LATENCY
+    QFLatencyTime const frontTime = m_latFront; // time of the old front
+    m_latFront = QF_LATENCY_TIME_(); // the time of posting
+#endif
+
     // was the queue empty?
     if (frontEvt == static_cast<QEvt const *>(0)) {
         QACTIVE_EQUEUE_SIGNAL_(this); // signal the event queue
@@ -244,6 +296,10 @@ void QActive::postLIFO(QEvt const * const e) {
         }
 
         QF_PTR_AT_(m_eQueue.m_ring, m_eQueue.m_tail) = frontEvt;
+
+#ifdef QF_LATENCY
+        m_latRing[m_eQueue.m_tail] = frontTime; // see QP::QActive::start()
+#endif
     }
     QF_CRIT_EXIT_();
 }
@@ -271,10 +327,23 @@ QEvt const *QActive::get_(void) {
     QF_CRIT_STAT_
     QF_CRIT_ENTRY_();
 
+#ifdef QF_SIG_FILTER_SIZE
+    m_isIdle = true;  // the previous RTC step is complete
+#endif
+
     QACTIVE_EQUEUE_WAIT_(this); // wait for event to arrive directly
 
+#ifdef QF_SIG_FILTER_SIZE
+    m_isIdle = false; // the next RTC step is about to begin
+#endif
+
     QEvt const *e = m_eQueue.m_frontEvt; // always remove evt from the front
     QEQueueCtr nFree = m_eQueue.m_nFree + static_cast<QEQueueCtr>(1);
+
+#ifdef QF_LATENCY
+    m_latStart = QF_LATENCY_TIME_(); // the RTC step starts now
+    m_waitHist.record(static_cast<QFLatencyTime>(m_latStart - m_latFront));
+#endif
     m_eQueue.m_nFree = nFree; // upate the number of free
 
     // any events in the ring buffer?
@@ -282,13 +351,16 @@ QEvt const *QActive::get_(void) {
 
         // remove event from the tail
         m_eQueue.m_frontEvt = QF_PTR_AT_(m_eQueue.m_ring, m_eQueue.m_tail);
+#ifdef QF_LATENCY
+        m_latFront = m_latRing[m_eQueue.m_tail];
+#endif
         if (m_eQueue.m_tail == static_cast<QEQueueCtr>(0)) { // need to wrap?
             m_eQueue.m_tail = m_eQueue.m_end; // wrap around
         }
         --m_eQueue.m_tail;
 
-        QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_GET,
-                         QS::priv_.locFilter[QS::AO_OBJ], this)
+        QS_BEGIN_SIG_NOCRIT_(QS_QF_ACTIVE_GET, e->sig,
+                             QS::AO_OBJ, this)
             QS_TIME_();                      // timestamp
             QS_SIG_(e->sig);                 // the signal of this event
             QS_OBJ_(this);                   // this active object
@@ -304,8 +376,8 @@ QEvt const *QActive::get_(void) {
         Q_ASSERT_ID(310, nFree ==
                          (m_eQueue.m_end + static_cast<QEQueueCtr>(1)));
 
-        QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_GET_LAST,
-                         QS::priv_.locFilter[QS::AO_OBJ], this)
+        QS_BEGIN_SIG_NOCRIT_(QS_QF_ACTIVE_GET_LAST, e->sig,
+                             QS::AO_OBJ, this)
             QS_TIME_();                      // timestamp
             QS_SIG_(e->sig);                 // the signal of this event
             QS_OBJ_(this);                   // this active object
@@ -316,6 +388,54 @@ QEvt const *QActive::get_(void) {
     return e;
 }
 
+#ifdef QF_SIG_FILTER_SIZE
+//****************************************************************************
+/// @description
+/// Installs the mask of signals that the active object ignores in its
+/// current state. While the active object waits for events with an empty
+/// queue, QActive::post_() (and therefore also QF::publish_()) discards
+/// the events with the ignored signals instead of queuing them. Each such
+/// event is counted and reported by the #QS_QF_ACTIVE_POST_IGNORED record.
+///
+/// The active object waits for events after the end of an RTC step. In the
+/// ports with a thread per active object this is when it blocks in
+/// QActive::get_(). The QV, QK and QXK kernels (and the QV-based ports, such
+/// as POSIX-QV) mark it with #QF_SIG_FILTER_IDLE_ after dispatching an
+/// event. No events are discarded before the first RTC step completes.
+///
+/// @param[in] mask pointer to the constant mask of ignored signals or NULL
+///                 to accept all signals.
+///
+/// @note
+/// This function should be called only from the active object's own
+/// thread of execution, typically in the entry action of a state (with the
+/// mask of that state) and in the exit action (with NULL or with the mask
+/// of the superstate). The mask must stay valid while it is installed.
+///
+/// @usage
+/// @code
+/// static QSigMask const l_idleIgnored = { { 0x00U, 0x0CU } }; // sig 10,11
+/// ...
+/// case Q_ENTRY_SIG: {
+///     setIgnoredSigs(&l_idleIgnored);
+///     status_ = Q_HANDLED();
+///     break;
+/// }
+/// case Q_EXIT_SIG: {
+///     setIgnoredSigs(static_cast<QSigMask const *>(0));
+///     status_ = Q_HANDLED();
+///     break;
+/// }
+/// @endcode
+///
+void QActive::setIgnoredSigs(QSigMask const * const mask) {
+    QF_CRIT_STAT_
+    QF_CRIT_ENTRY_();
+    m_ignoredSigs = mask;
+    QF_CRIT_EXIT_();
+}
+#endif // QF_SIG_FILTER_SIZE
+
 //****************************************************************************
 /// @description
 /// Queries the minimum of free ever present in the given event queue of
@@ -348,6 +468,239 @@ uint_fast16_t QF::getQueueMin(uint_fast8_t const prio) {
     return min;
 }
 
+#ifdef QF_LATENCY
+
+//****************************************************************************
+/// @description
+/// Clears the histograms of the queue waits and of the RTC step durations
+/// of the active object, for example to start a new measurement period.
+///
+void QActive::resetLatency(void) {
+    QF_CRIT_STAT_
+    QF_CRIT_ENTRY_();
+    m_waitHist.reset();
+    m_dispHist.reset();
+    QF_CRIT_EXIT_();
+}
+
+//****************************************************************************
+/// @description
+/// Records the duration of the RTC step that started when QActive::get_()
+/// returned the event. Called by the QF ports and kernels right after
+/// dispatching the event (see #QF_LATENCY_DISPATCHED_). With #QS_TRIGGER,
+/// the duration is also checked against the QP::QS::TRG_RTC triggers.
+///
+/// @note
+/// The histograms are updated, reset and read only inside the critical
+/// section, see also QActive::get_(), QActive::resetLatency() and
+/// QF::latencyReport().
+///
+void QActive::dispatched_(void) {
+    QFLatencyTime const dt = static_cast<QFLatencyTime>(
+        QF_LATENCY_TIME_() - m_latStart);
+
+    QF_CRIT_STAT_
+    QF_CRIT_ENTRY_();
+    m_dispHist.record(dt);
+
+#if (defined Q_SPY) && (defined QS_TRIGGER)
+    // any RTC-step trigger armed?
+    if ((QS::priv_.trgArmed & static_cast<uint8_t>(1U << QS::TRG_RTC))
+        != static_cast<uint8_t>(0))
+    {
+        QS_TRG_VALUE_(QS::TRG_RTC, this, dt);
+    }
+#endif // Q_SPY && QS_TRIGGER
+    QF_CRIT_EXIT_();
+}
+
+//****************************************************************************
+/// @description
+/// For every started active object, produces two QS records @p rec (an
+/// application-specific record, see QP::QS_USER), one for the times that
+/// the events waited in the queue (kind 0) and one for the durations of
+/// the RTC steps (kind 1), in the units of QF_LATENCY_TIME_():
+///
+/// [OBJ active object][U8 kind][U32 count][U32 p50][U32 p90][U32 p99]
+/// [U32 p99.9][U32 max]
+///
+/// The records are self-describing (formatted), so QSPY displays them
+/// without any customization. The application typically calls this
+/// function periodically, for example every second.
+///
+/// @note
+/// Every histogram is copied inside the critical section and the
+/// percentiles are computed from the copy outside of it. The copy is
+/// static (a histogram takes about 1KB), so this function must be called
+/// from one thread only.
+///
+/// @param[in] rec  the application-specific QS record to produce
+///
+/// @usage
+/// @code
+/// QS_USR_DICTIONARY(LATENCY); // in QS_onStartup()
+/// . . .
+/// QP::QF::latencyReport(LATENCY); // e.g., every second
+/// @endcode
+///
+void QF::latencyReport(enum_t const rec) {
+#ifdef Q_SPY
+    static QLatencyHist h; // snapshot of a histogram (see the note above)
+    QF_CRIT_STAT_
+
+    for (uint_fast8_t p = static_cast<uint_fast8_t>(QF_MAX_ACTIVE);
+         p != static_cast<uint_fast8_t>(0); --p)
+    {
+        QActive const * const a = active_[p];
+        if (a != static_cast<QActive *>(0)) {
+            for (uint_fast8_t kind = static_cast<uint_fast8_t>(0);
+                 kind < static_cast<uint_fast8_t>(2); ++kind)
+            {
+                QF_CRIT_ENTRY_();
+                h = (kind == static_cast<uint_fast8_t>(0))
+                    ? a->m_waitHist
+                    : a->m_dispHist;
+                QF_CRIT_EXIT_();
+
+                // compute the percentiles outside of the critical section
+                uint32_t const cnt = h.getCount();
+                QFLatencyTime const p50  = h.getPerMille(500U);
+                QFLatencyTime const p90  = h.getPerMille(900U);
+                QFLatencyTime const p99  = h.getPerMille(990U);
+                QFLatencyTime const p999 = h.getPerMille(999U);
+                QFLatencyTime const max  = h.getMax();
+
+                QS_BEGIN(rec, a)
+                    QS_OBJ(a);
+                    QS_U8(0, kind);
+                    QS_U32(0, cnt);
+                    QS_U32(0, p50);
+                    QS_U32(0, p90);
+                    QS_U32(0, p99);
+                    QS_U32(0, p999);
+                    QS_U32(0, max);
+                QS_END()
+            }
+        }
+    }
+#else
+    (void)rec;
+#endif // Q_SPY
+}
+
+//****************************************************************************
+void QLatencyHist::reset(void) {
+    for (uint_fast16_t i = static_cast<uint_fast16_t>(0);
+         i < static_cast<uint_fast16_t>(QF_LATENCY_BINS); ++i)
+    {
+        m_bins[i] = static_cast<uint32_t>(0);
+    }
+    m_count = static_cast<uint32_t>(0);
+    m_max   = static_cast<QFLatencyTime>(0);
+}
+
+//****************************************************************************
+void QLatencyHist::record(QFLatencyTime const t) {
+    ++m_bins[binOf(t)];
+    ++m_count;
+    if (m_max < t) {
+        m_max = t;
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Returns the highest value counted in the bucket, in which the
+/// cumulative count reaches @p pm per mille of all recorded values (but
+/// not more than the maximum), for example 990U for the 99th percentile.
+/// Returns 0 for an empty histogram.
+///
+QFLatencyTime QLatencyHist::getPerMille(uint_fast16_t const pm) const {
+    QFLatencyTime t = static_cast<QFLatencyTime>(0);
+    uint32_t const cnt = m_count;
+    if (cnt != static_cast<uint32_t>(0)) {
+        // the rank of the value, rounded up and at least 1
+        uint64_t rank = ((static_cast<uint64_t>(cnt) * pm) + 999U) / 1000U;
+        if (rank == static_cast<uint64_t>(0)) {
+            rank = static_cast<uint64_t>(1);
+        }
+        uint64_t sum = static_cast<uint64_t>(0);
+        uint_fast16_t i = static_cast<uint_fast16_t>(0);
+        for (; i < static_cast<uint_fast16_t>(QF_LATENCY_BINS - 1U); ++i) {
+            sum += m_bins[i];
+            if (sum >= rank) {
+                break;
+            }
+        }
+        t = binMax(i);
+        if (t > m_max) {
+            t = m_max;
+        }
+    }
+    return t;
+}
+
+//****************************************************************************
+QFLatencyTime QLatencyHist::binMax(uint_fast16_t const i) {
+    uint_fast16_t const nSub = static_cast<uint_fast16_t>(
+        1U << QF_LATENCY_SUB_BITS);
+    QFLatencyTime t;
+    if (i < nSub) { // exact bucket?
+        t = static_cast<QFLatencyTime>(i);
+    }
+    else {
+        uint_fast8_t const shift = static_cast<uint_fast8_t>(
+            (i >> QF_LATENCY_SUB_BITS) - 1U);
+        t = static_cast<QFLatencyTime>(
+            (static_cast<QFLatencyTime>(nSub + (i & (nSub - 1U))) << shift)
+            + ((static_cast<QFLatencyTime>(1) << shift) - 1U));
+    }
+    return t;
+}
+
+//****************************************************************************
+uint_fast16_t QLatencyHist::binOf(QFLatencyTime const t) {
+    uint_fast16_t bin;
+    if (t < static_cast<QFLatencyTime>(1U << QF_LATENCY_SUB_BITS)) {
+        bin = static_cast<uint_fast16_t>(t); // exact bucket
+    }
+    else {
+        // find the most significant bit of t
+        uint_fast8_t msb = static_cast<uint_fast8_t>(0);
+        QFLatencyTime x = t;
+        if (x >= static_cast<QFLatencyTime>(0x10000U)) {
+            x >>= 16;
+            msb += static_cast<uint_fast8_t>(16);
+        }
+        if (x >= static_cast<QFLatencyTime>(0x100U)) {
+            x >>= 8;
+            msb += static_cast<uint_fast8_t>(8);
+        }
+        if (x >= static_cast<QFLatencyTime>(0x10U)) {
+            x >>= 4;
+            msb += static_cast<uint_fast8_t>(4);
+        }
+        if (x >= static_cast<QFLatencyTime>(4U)) {
+            x >>= 2;
+            msb += static_cast<uint_fast8_t>(2);
+        }
+        if (x >= static_cast<QFLatencyTime>(2U)) {
+            ++msb;
+        }
+        // the power of two selects the group of buckets and the bits
+        // below the most significant bit select the bucket in the group
+        uint_fast8_t const shift = static_cast<uint_fast8_t>(
+            msb - QF_LATENCY_SUB_BITS);
+        bin = static_cast<uint_fast16_t>(
+            (static_cast<uint_fast16_t>(shift + 1U) << QF_LATENCY_SUB_BITS)
+            | static_cast<uint_fast16_t>((t >> shift)
+                  & ((1U << QF_LATENCY_SUB_BITS) - 1U)));
+    }
+    return bin;
+}
+
+#endif // QF_LATENCY
+
 //****************************************************************************
 QTicker::QTicker(uint_fast8_t const tickRate)
   : QActive(Q_STATE_CAST(0))
@@ -394,6 +747,9 @@ bool QTicker::post_(QEvt const * const /*e*/, uint_fast16_t const /*margin*/,
 
         m_eQueue.m_frontEvt = &tickEvt; // deliver event directly
         --m_eQueue.m_nFree; // one less free event
+#ifdef QF_LATENCY
+        m_latFront = QF_LATENCY_TIME_(); // the time of the first tick
+#endif
 
         QACTIVE_EQUEUE_SIGNAL_(this); // signal the event queue
     }
@@ -401,7 +757,7 @@ bool QTicker::post_(QEvt const * const /*e*/, uint_fast16_t const /*margin*/,
     ++m_eQueue.m_tail; // account for one more tick event
 
     QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_FIFO,
-                     QS::priv_.locFilter[QS::AO_OBJ], this)
+                     QS::AO_OBJ, this)
         QS_TIME_();               // timestamp
         QS_OBJ_(sender);          // the sender object
         QS_SIG_(static_cast<QSignal>(0)); // the signal of the event
@@ -141,7 +141,7 @@ QEvt *QF::newX_(uint_fast16_t const evtSize,
     Q_ASSERT_ID(310, idx < QF_maxPool_);
 
     QS_CRIT_STAT_
-    QS_BEGIN_(QS_QF_NEW, static_cast<void *>(0), static_cast<void *>(0))
+    QS_BEGIN_(QS_QF_NEW, QS::NO_OBJ, static_cast<void *>(0))
         QS_TIME_();                              // timestamp
         QS_EVS_(static_cast<QEvtSize>(evtSize)); // the size of the event
         QS_SIG_(static_cast<QSignal>(sig));      // the signal of the event
@@ -162,6 +162,8 @@ QEvt *QF::newX_(uint_fast16_t const evtSize,
                        idx + static_cast<uint_fast8_t>(1));
         // initialize the reference counter to 0
         e->refCtr_ = static_cast<uint8_t>(0);
+
+        QF_JOURNAL_NEW_(e, evtSize); // the real size of the event
     }
     else {
         // event was not allocated, assert that the caller provided non-zero
@@ -205,7 +207,7 @@ void QF::gc(QEvt const * const e) {
             QF_EVT_REF_CTR_DEC_(e); // decrement the ref counter
 
             QS_BEGIN_NOCRIT_(QS_QF_GC_ATTEMPT,
-                static_cast<void *>(0), static_cast<void *>(0))
+                QS::NO_OBJ, static_cast<void *>(0))
                 QS_TIME_();        // timestamp
                 QS_SIG_(e->sig);   // the signal of the event
                 QS_2U8_(e->poolId_, e->refCtr_);// pool Id & refCtr of the evt
@@ -219,7 +221,7 @@ void QF::gc(QEvt const * const e) {
                                - static_cast<uint_fast8_t>(1);
 
             QS_BEGIN_NOCRIT_(QS_QF_GC,
-                static_cast<void *>(0), static_cast<void *>(0))
+                QS::NO_OBJ, static_cast<void *>(0))
                 QS_TIME_();        // timestamp
                 QS_SIG_(e->sig);   // the signal of the event
                 QS_2U8_(e->poolId_, e->refCtr_);// pool Id & refCtr of the evt
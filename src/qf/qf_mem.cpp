@@ -151,7 +151,7 @@ void QMPool::init(void * const poolSto, uint_fast32_t poolSize,
     m_end      = fb;      // the last block in this pool
 
     QS_CRIT_STAT_
-    QS_BEGIN_(QS_QF_MPOOL_INIT, QS::priv_.locFilter[QS::MP_OBJ], m_start)
+    QS_BEGIN_(QS_QF_MPOOL_INIT, QS::MP_OBJ, m_start)
         QS_OBJ_(m_start);  // the memory managed by this pool
         QS_MPC_(m_nTot);   // the total number of blocks
     QS_END_()
@@ -187,7 +187,7 @@ void QMPool::put(void * const b) {
     ++m_nFree;       // one more free block in this pool
 
     QS_BEGIN_NOCRIT_(QS_QF_MPOOL_PUT,
-                     QS::priv_.locFilter[QS::MP_OBJ], m_start)
+                     QS::MP_OBJ, m_start)
         QS_TIME_();       // timestamp
         QS_OBJ_(m_start); // the memory managed by this pool
         QS_MPC_(m_nFree); // the number of free blocks in the pool
@@ -256,7 +256,7 @@ void *QMPool::get(uint_fast16_t const margin) {
         m_free_head = fb_next; // adjust list head to the next free block
 
         QS_BEGIN_NOCRIT_(QS_QF_MPOOL_GET,
-                         QS::priv_.locFilter[QS::MP_OBJ], m_start)
+                         QS::MP_OBJ, m_start)
             QS_TIME_();        // timestamp
             QS_OBJ_(m_start);  // the memory managed by this pool
             QS_MPC_(m_nFree);  // the number of free blocks in the pool
@@ -267,7 +267,7 @@ void *QMPool::get(uint_fast16_t const margin) {
         fb = static_cast<QFreeBlock *>(0);
 
         QS_BEGIN_NOCRIT_(QS_QF_MPOOL_GET_ATTEMPT,
-                         QS::priv_.locFilter[QS::MP_OBJ], m_start)
+                         QS::MP_OBJ, m_start)
             QS_TIME_();        // timestamp
             QS_OBJ_(m_start);  // the memory managed by this pool
             QS_MPC_(m_nFree);  // the # free blocks in the pool
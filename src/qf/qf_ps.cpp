@@ -123,14 +123,17 @@ void QF::publish_(QEvt const * const e, void const * const sender) {
     QF_CRIT_STAT_
     QF_CRIT_ENTRY_();
 
-    QS_BEGIN_NOCRIT_(QS_QF_PUBLISH,
-        static_cast<void *>(0), static_cast<void *>(0))
+    QS_BEGIN_SIG_NOCRIT_(QS_QF_PUBLISH, e->sig,
+        QS::NO_OBJ, static_cast<void *>(0))
         QS_TIME_();                      // the timestamp
         QS_OBJ_(sender);                 // the sender object
         QS_SIG_(e->sig);                 // the signal of the event
         QS_2U8_(e->poolId_, e->refCtr_); // pool Id & refCtr of the evt
     QS_END_NOCRIT_()
 
+    // record the input (the multicasting below is its consequence)
+    QF_JOURNAL_EVT_(QF_JRNL_PUBLISH, static_cast<uint_fast8_t>(0), e);
+
     // is it a dynamic event?
     if (e->poolId_ != static_cast<uint8_t>(0)) {
         // NOTE: The reference counter of a dynamic event is incremented to
@@ -152,6 +155,7 @@ void QF::publish_(QEvt const * const e, void const * const sender) {
         QF_SCHED_STAT_
 
         QF_SCHED_LOCK_(p); // lock the scheduler up to prio 'p'
+        QF_JOURNAL_ENTER_(); // the posts to subscribers are not inputs
         do { // loop over all subscribers */
             // the prio of the AO must be registered with the framework
             Q_ASSERT_ID(210, active_[p] != static_cast<QActive *>(0));
@@ -167,6 +171,7 @@ void QF::publish_(QEvt const * const e, void const * const sender) {
                 p = static_cast<uint_fast8_t>(0); // no more subscribers
             }
         } while (p != static_cast<uint_fast8_t>(0));
+        QF_JOURNAL_EXIT_();
         QF_SCHED_UNLOCK_(); // unlock the scheduler
     }
 
@@ -206,7 +211,7 @@ void QActive::subscribe(enum_t const sig) const {
     QF_CRIT_ENTRY_();
 
     QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_SUBSCRIBE,
-                     QS::priv_.locFilter[QS::AO_OBJ], this)
+                     QS::AO_OBJ, this)
         QS_TIME_();    // timestamp
         QS_SIG_(sig);  // the signal of this event
         QS_OBJ_(this); // this active object
@@ -248,7 +253,7 @@ void QActive::unsubscribe(enum_t const sig) const {
     QF_CRIT_ENTRY_();
 
     QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_UNSUBSCRIBE,
-                     QS::priv_.locFilter[QS::AO_OBJ], this)
+                     QS::AO_OBJ, this)
         QS_TIME_();         // timestamp
         QS_SIG_(sig);       // the signal of this event
         QS_OBJ_(this);      // this active object
@@ -292,7 +297,7 @@ void QActive::unsubscribeAll(void) const {
             QF_PTR_AT_(QF_subscrList_, sig).remove(p);
 
             QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_UNSUBSCRIBE,
-                             QS::priv_.locFilter[QS::AO_OBJ], this)
+                             QS::AO_OBJ, this)
                 QS_TIME_();     // timestamp
                 QS_SIG_(sig);   // the signal of this event
                 QS_OBJ_(this);  // this active object
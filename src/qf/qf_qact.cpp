@@ -54,6 +54,19 @@ QActive::QActive(QStateHandler const initial)
 #ifdef QF_THREAD_TYPE
     QF::bzero(&m_thread, static_cast<uint_fast16_t>(sizeof(m_thread)));
 #endif
+
+#ifdef QF_SIG_FILTER_SIZE
+    m_ignoredSigs = static_cast<QSigMask const *>(0);
+    m_ignoredCtr  = static_cast<uint32_t>(0);
+    m_isIdle      = false;
+#endif
+
+#ifdef QF_LATENCY
+    m_waitHist.reset();
+    m_dispHist.reset();
+    m_latFront = static_cast<QFLatencyTime>(0);
+    m_latStart = static_cast<QFLatencyTime>(0);
+#endif
 }
 
 } // namespace QP
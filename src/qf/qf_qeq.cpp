@@ -93,7 +93,7 @@ void QEQueue::init(QEvt const *qSto[], uint_fast16_t const qLen) {
     m_nMin     = m_nFree;
 
     QS_CRIT_STAT_
-    QS_BEGIN_(QS_QF_EQUEUE_INIT, QS::priv_.locFilter[QS::EQ_OBJ], this)
+    QS_BEGIN_(QS_QF_EQUEUE_INIT, QS::EQ_OBJ, this)
         QS_OBJ_(this);   // this QEQueue object
         QS_EQC_(m_end);  // the length of the queue
     QS_END_()
@@ -136,7 +136,7 @@ bool QEQueue::post(QEvt const * const e, uint_fast16_t const margin) {
         || (nFree > static_cast<QEQueueCtr>(margin)))
     {
         QS_BEGIN_NOCRIT_(QS_QF_EQUEUE_POST_FIFO,
-                         QS::priv_.locFilter[QS::EQ_OBJ], this)
+                         QS::EQ_OBJ, this)
             QS_TIME_();                      // timestamp
             QS_SIG_(e->sig);                 // the signal of this event
             QS_OBJ_(this);                   // this queue object
@@ -154,6 +154,7 @@ bool QEQueue::post(QEvt const * const e, uint_fast16_t const margin) {
         m_nFree = nFree; // update the volatile
         if (m_nMin > nFree) {
             m_nMin = nFree; // update minimum so far
+            QS_TRG_VALUE_(QS::TRG_QMIN, this, nFree); // trace trigger
         }
 
         // is the queue empty?
@@ -179,7 +180,7 @@ bool QEQueue::post(QEvt const * const e, uint_fast16_t const margin) {
         Q_ASSERT_ID(210, margin != QF_NO_MARGIN);
 
         QS_BEGIN_NOCRIT_(QS_QF_EQUEUE_POST_ATTEMPT,
-                         QS::priv_.locFilter[QS::EQ_OBJ], this)
+                         QS::EQ_OBJ, this)
             QS_TIME_();                      // timestamp
             QS_SIG_(e->sig);                 // the signal of this event
             QS_OBJ_(this);                   // this queue object
@@ -222,7 +223,7 @@ void QEQueue::postLIFO(QEvt const * const e) {
     Q_REQUIRE_ID(300, nFree != static_cast<QEQueueCtr>(0));
 
     QS_BEGIN_NOCRIT_(QS_QF_EQUEUE_POST_LIFO,
-                     QS::priv_.locFilter[QS::EQ_OBJ], this)
+                     QS::EQ_OBJ, this)
         QS_TIME_();                      // timestamp
         QS_SIG_(e->sig);                 // the signal of this event
         QS_OBJ_(this);                   // this queue object
@@ -240,6 +241,7 @@ void QEQueue::postLIFO(QEvt const * const e) {
     m_nFree = nFree; // update the volatile
     if (m_nMin > nFree) {
         m_nMin = nFree; // update minimum so far
+        QS_TRG_VALUE_(QS::TRG_QMIN, this, nFree); // trace trigger
     }
 
     QEvt const *frontEvt = m_frontEvt; // read volatile into temporary
@@ -291,7 +293,7 @@ QEvt const *QEQueue::get(void) {
             --m_tail;
 
             QS_BEGIN_NOCRIT_(QS_QF_EQUEUE_GET,
-                             QS::priv_.locFilter[QS::EQ_OBJ], this)
+                             QS::EQ_OBJ, this)
                 QS_TIME_();              // timestamp
                 QS_SIG_(e->sig);         // the signal of this event
                 QS_OBJ_(this);           // this queue object
@@ -306,7 +308,7 @@ QEvt const *QEQueue::get(void) {
             Q_ASSERT_ID(410, nFree == (m_end + static_cast<QEQueueCtr>(1)));
 
             QS_BEGIN_NOCRIT_(QS_QF_EQUEUE_GET_LAST,
-                             QS::priv_.locFilter[QS::EQ_OBJ],
+                             QS::EQ_OBJ,
                              this)
                 QS_TIME_();              // timestamp
                 QS_SIG_(e->sig);         // the signal of this event
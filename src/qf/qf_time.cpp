@@ -81,11 +81,14 @@ void QF::tickX_(uint_fast8_t const tickRate, void const * const sender)
 
     QF_CRIT_ENTRY_();
 
-    QS_BEGIN_NOCRIT_(QS_QF_TICK, static_cast<void*>(0), static_cast<void*>(0))
+    QS_BEGIN_NOCRIT_(QS_QF_TICK, QS::NO_OBJ, static_cast<void*>(0))
         QS_TEC_(static_cast<QTimeEvtCtr>(++prev->m_ctr)); // tick ctr
         QS_U8_(static_cast<uint8_t>(tickRate));           // tick rate
     QS_END_NOCRIT_()
 
+    QF_TICK_HOOK_(tickRate); // e.g., record the input...
+    QF_JOURNAL_ENTER_(); // ...but not the time events posted below
+
     // scan the linked-list of time events at this rate...
     for (;;) {
         QTimeEvt *t = prev->m_next; // advance down the time evt. list
@@ -138,7 +141,7 @@ void QF::tickX_(uint_fast8_t const tickRate, void const * const sender)
                     // do NOT advance the prev pointer
 
                     QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_AUTO_DISARM,
-                                     QS::priv_.locFilter[QS::TE_OBJ], t)
+                                     QS::TE_OBJ, t)
                         QS_OBJ_(t);        // this time event object
                         QS_OBJ_(act);      // the target AO
                         QS_U8_(static_cast<uint8_t>(tickRate)); // tick rate
@@ -146,7 +149,7 @@ void QF::tickX_(uint_fast8_t const tickRate, void const * const sender)
                 }
 
                 QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_POST,
-                                 QS::priv_.locFilter[QS::TE_OBJ], t)
+                                 QS::TE_OBJ, t)
                     QS_TIME_();            // timestamp
                     QS_OBJ_(t);            // the time event object
                     QS_SIG_(t->sig);       // signal of this time event
@@ -168,6 +171,7 @@ void QF::tickX_(uint_fast8_t const tickRate, void const * const sender)
         }
         QF_CRIT_ENTRY_(); // re-enter crit. section to continue
     }
+    QF_JOURNAL_EXIT_();
     QF_CRIT_EXIT_();
 }
 
@@ -199,10 +203,10 @@ bool QF::noTimeEvtsActiveX(uint_fast8_t const tickRate) {
     Q_REQUIRE_ID(200, tickRate < static_cast<uint_fast8_t>(QF_MAX_TICK_RATE));
 
     bool inactive;
-    if (timeEvtHead_[tickRate].m_next == static_cast<QTimeEvt *>(0)) {
+    if (timeEvtHead_[tickRate].m_next != static_cast<QTimeEvt *>(0)) {
         inactive = false;
     }
-    else if (timeEvtHead_[tickRate].m_act == static_cast<void *>(0)) {
+    else if (timeEvtHead_[tickRate].m_act != static_cast<void *>(0)) {
         inactive = false;
     }
     else {
@@ -211,6 +215,91 @@ bool QF::noTimeEvtsActiveX(uint_fast8_t const tickRate) {
     return inactive;
 }
 
+//****************************************************************************
+/// @description
+/// Finds the number of clock ticks of the given rate until the earliest
+/// expiration of any armed time event, including the time events armed
+/// since the last call to QP::QF::tickX_().
+///
+/// @param[in]  tickRate  system clock tick rate to find out about.
+///
+/// @returns the number of ticks (at least 1) until the next time event
+/// expires, or 0 if no time events are armed at the given tick rate.
+///
+/// @note This function should be called in critical section.
+///
+/// @sa QP::QF::skipTicksX()
+///
+QTimeEvtCtr QF::ticksToNextX(uint_fast8_t const tickRate) {
+    /// @pre the tick rate must be in range
+    Q_REQUIRE_ID(250, tickRate < static_cast<uint_fast8_t>(QF_MAX_TICK_RATE));
+
+    QTimeEvtCtr next = static_cast<QTimeEvtCtr>(0);
+    QTimeEvt *t = timeEvtHead_[tickRate].m_next; // the main list
+    uint_fast8_t pass;
+
+    // scan the main list and then the list of the newly armed time evts...
+    for (pass = static_cast<uint_fast8_t>(0);
+         pass < static_cast<uint_fast8_t>(2);
+         ++pass)
+    {
+        while (t != static_cast<QTimeEvt *>(0)) {
+            QTimeEvtCtr ctr = t->m_ctr; // temporary to hold volatile
+            // armed (not scheduled for removal) and sooner than next?
+            if ((ctr != static_cast<QTimeEvtCtr>(0))
+                && ((next == static_cast<QTimeEvtCtr>(0)) || (ctr < next)))
+            {
+                next = ctr;
+            }
+            t = t->m_next;
+        }
+        t = timeEvtHead_[tickRate].toTimeEvt(); // newly armed time events
+    }
+    return next;
+}
+
+//****************************************************************************
+/// @description
+/// Accounts for @p nTicks clock ticks of the given rate at once by
+/// decrementing the counters of all armed time events. This allows a QF
+/// port to skip the clock ticks in which nothing happens (e.g., tickless
+/// idle or simulated time) and to call QP::QF::tickX_() only for the
+/// tick in which the earliest time event expires.
+///
+/// @param[in]  tickRate  system clock tick rate to advance.
+/// @param[in]  nTicks    number of ticks to skip, which must be less than
+///                       the value returned from QP::QF::ticksToNextX().
+///
+/// @note This function should be called in critical section.
+///
+void QF::skipTicksX(uint_fast8_t const tickRate,
+                    QTimeEvtCtr const nTicks)
+{
+    /// @pre the tick rate must be in range
+    Q_REQUIRE_ID(260, tickRate < static_cast<uint_fast8_t>(QF_MAX_TICK_RATE));
+
+    QTimeEvt *t = timeEvtHead_[tickRate].m_next; // the main list
+    uint_fast8_t pass;
+
+    timeEvtHead_[tickRate].m_ctr += nTicks; // the tick counter of this rate
+
+    // adjust the main list and then the list of newly armed time events...
+    for (pass = static_cast<uint_fast8_t>(0);
+         pass < static_cast<uint_fast8_t>(2);
+         ++pass)
+    {
+        while (t != static_cast<QTimeEvt *>(0)) {
+            if (t->m_ctr != static_cast<QTimeEvtCtr>(0)) { // armed?
+                // no time event may expire in the skipped ticks
+                Q_ASSERT_ID(270, t->m_ctr > nTicks);
+                t->m_ctr -= nTicks;
+            }
+            t = t->m_next;
+        }
+        t = timeEvtHead_[tickRate].toTimeEvt(); // newly armed time events
+    }
+}
+
 //****************************************************************************
 /// @description
 /// When creating a time event, you must commit it to a specific active object
@@ -328,6 +417,7 @@ void QTimeEvt::armX(QTimeEvtCtr const nTicks, QTimeEvtCtr const interval) {
                  && (static_cast<enum_t>(sig) >= Q_USER_SIG));
 
     QF_CRIT_ENTRY_();
+    QTIMEEVT_ARM_SIGNAL_(); // let the tickless clock catch up, if used
     m_ctr = nTicks;
     m_interval = interval;
 
@@ -351,7 +441,7 @@ void QTimeEvt::armX(QTimeEvtCtr const nTicks, QTimeEvtCtr const interval) {
         QF::timeEvtHead_[tickRate].m_act = this;
     }
 
-    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_ARM, QS::priv_.locFilter[QS::TE_OBJ], this)
+    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_ARM, QS::TE_OBJ, this)
         QS_TIME_();        // timestamp
         QS_OBJ_(this);     // this time event object
         QS_OBJ_(m_act);    // the active object
@@ -387,7 +477,7 @@ bool QTimeEvt::disarm(void) {
         wasArmed = true;
 
         QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_DISARM,
-                         QS::priv_.locFilter[QS::TE_OBJ], this)
+                         QS::TE_OBJ, this)
             QS_TIME_();            // timestamp
             QS_OBJ_(this);         // this time event object
             QS_OBJ_(m_act);        // the target AO
@@ -404,7 +494,7 @@ bool QTimeEvt::disarm(void) {
         wasArmed = false;
 
         QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_DISARM_ATTEMPT,
-                         QS::priv_.locFilter[QS::TE_OBJ], this)
+                         QS::TE_OBJ, this)
             QS_TIME_();            // timestamp
             QS_OBJ_(this);         // this time event object
             QS_OBJ_(m_act);        // the target AO
@@ -450,6 +540,7 @@ bool QTimeEvt::rearm(QTimeEvtCtr const nTicks) {
                  && (static_cast<enum_t>(sig) >= Q_USER_SIG));
 
     QF_CRIT_ENTRY_();
+    QTIMEEVT_ARM_SIGNAL_(); // let the tickless clock catch up, if used
     bool isArmed;
 
     // is the time evt not running? */
@@ -486,7 +577,7 @@ bool QTimeEvt::rearm(QTimeEvtCtr const nTicks) {
     m_ctr = nTicks; // re-load the tick counter (shift the phasing)
 
     QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_REARM,
-                     QS::priv_.locFilter[QS::TE_OBJ], this)
+                     QS::TE_OBJ, this)
         QS_TIME_();          // timestamp
         QS_OBJ_(this);       // this time event object
         QS_OBJ_(m_act);      // the target AO
@@ -521,7 +612,7 @@ QTimeEvtCtr QTimeEvt::ctr(void) const {
     QF_CRIT_ENTRY_();
     QTimeEvtCtr ret = m_ctr;
 
-    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_CTR, QS::priv_.locFilter[QS::TE_OBJ], this)
+    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_CTR, QS::TE_OBJ, this)
         QS_TIME_();            // timestamp
         QS_OBJ_(this);         // this time event object
         QS_OBJ_(m_act);        // the target AO
@@ -82,6 +82,65 @@
     #define QF_CRIT_EXIT_()     QF_CRIT_EXIT(critStat_)
 #endif  // QF_CRIT_STAT_TYPE
 
+#ifndef QTIMEEVT_ARM_SIGNAL_
+    //! This is an internal macro invoked inside the critical section of
+    //! QP::QTimeEvt::armX() and QP::QTimeEvt::rearm() before the time event
+    //! counter is loaded.
+    /// @description
+    /// A tickless QF port can define this macro in its qf_port.h to account
+    /// for the clock ticks elapsed so far and to wake up its clock thread,
+    /// so that a sooner deadline takes effect. By default it does nothing.
+    #define QTIMEEVT_ARM_SIGNAL_() ((void)0)
+#endif // QTIMEEVT_ARM_SIGNAL_
+
+#ifndef QF_JOURNAL_EVT_
+    //! This is an internal macro invoked inside the critical section of
+    //! QP::QActive::post_(), QP::QActive::postLIFO() and QP::QF::publish_()
+    //! for every event successfully delivered (see QP::QF_JournalKind).
+    /// @description
+    /// A QF port can define this macro in its qf_port.h to record the
+    /// events, which enter the framework from outside of the active objects
+    /// (e.g., from the "ISR-like" threads), for a deterministic replay. By
+    /// default it does nothing.
+    #define QF_JOURNAL_EVT_(kind_, prio_, e_) ((void)0)
+#endif // QF_JOURNAL_EVT_
+
+#ifndef QF_JOURNAL_NEW_
+    //! This is an internal macro invoked in QP::QF::newX_() for every
+    //! allocated dynamic event @p e_ with the requested size @p evtSize_.
+    /// @description
+    /// A QF port can define this macro in its qf_port.h to record only
+    /// the real sizes of the events, whose blocks in the event pools can be
+    /// larger. By default it does nothing.
+    /// @sa #QF_JOURNAL_EVT_
+    #define QF_JOURNAL_NEW_(e_, evtSize_) ((void)0)
+#endif // QF_JOURNAL_NEW_
+
+#ifndef QF_TICK_HOOK_
+    //! This is an internal macro invoked inside the critical section of
+    //! QP::QF::tickX_() at the beginning of every clock tick.
+    /// @description
+    /// A QF port can define this macro in its qf_port.h to keep track of
+    /// the ticked rates (e.g., for a virtual time) or to record the tick as
+    /// an input (see #QF_JOURNAL_EVT_). By default it does nothing.
+    #define QF_TICK_HOOK_(rate_) ((void)0)
+#endif // QF_TICK_HOOK_
+
+#ifndef QF_JOURNAL_ENTER_
+    //! This is an internal macro, which marks the beginning of the code,
+    //! in which the calling thread posts the events only as a consequence
+    //! of an already recorded input (e.g., multicasting of a published
+    //! event or posting of the time events in QP::QF::tickX_()).
+    /// @description
+    /// The QF port must not record such events with #QF_JOURNAL_EVT_ until
+    /// the matching #QF_JOURNAL_EXIT_. The sections can nest.
+    #define QF_JOURNAL_ENTER_() ((void)0)
+
+    //! This is an internal macro, which marks the end of the code started
+    //! with #QF_JOURNAL_ENTER_
+    #define QF_JOURNAL_EXIT_()  ((void)0)
+#endif // QF_JOURNAL_ENTER_
+
 
 namespace QP {
 
@@ -91,6 +150,14 @@ extern uint_fast8_t QF_maxPool_;     //!< # of initialized event pools
 extern QSubscrList *QF_subscrList_;  //!< the subscriber list array
 extern enum_t QF_maxPubSignal_;      //!< the maximum published signal
 
+//! The kinds of the events recorded by #QF_JOURNAL_EVT_
+enum QF_JournalKind {
+    QF_JRNL_TICK = 1,  //!< clock tick (QP::QF::tickX_())
+    QF_JRNL_POST,      //!< event posted FIFO (QP::QActive::post_())
+    QF_JRNL_POST_LIFO, //!< event posted LIFO (QP::QActive::postLIFO())
+    QF_JRNL_PUBLISH    //!< event published (QP::QF::publish_())
+};
+
 //............................................................................
 //! Structure representing a free block in the Native QF Memory Pool
 /// @sa QP::QMPool
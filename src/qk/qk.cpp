@@ -174,6 +174,11 @@ void QActive::start(uint_fast8_t const prio,
                       && (prio <= static_cast<uint_fast8_t>(QF_MAX_ACTIVE))
                       && (stkSto == static_cast<void *>(0)));
 
+#ifdef QF_LATENCY
+    /// @pre the queue must fit the time stamps of the posted events
+    Q_REQUIRE_ID(310, qLen <= static_cast<uint_fast16_t>(QF_LATENCY_QLEN));
+#endif
+
     m_eQueue.init(qSto, qLen); // initialize the built-in queue
 
     m_prio = static_cast<uint8_t>(prio);  // set the QF priority of this AO
@@ -256,7 +261,7 @@ QSchedStatus QK::schedLock(uint_fast8_t const ceiling) {
         QK_attr_.lockPrio = static_cast<uint8_t>(ceiling);
 
         QS_BEGIN_NOCRIT_(QS_SCHED_LOCK,
-                         static_cast<void *>(0), static_cast<void *>(0))
+                         QS::NO_OBJ, static_cast<void *>(0))
             QS_TIME_(); // timestamp
             QS_2U8_(static_cast<uint8_t>(stat), /* the previous lock prio */
                     QK_attr_.lockPrio); // new lock prio
@@ -307,7 +312,7 @@ void QK::schedUnlock(QSchedStatus const stat) {
                           && (lockPrio > prevPrio));
 
         QS_BEGIN_NOCRIT_(QS_SCHED_UNLOCK,
-                         static_cast<void *>(0), static_cast<void *>(0))
+                         QS::NO_OBJ, static_cast<void *>(0))
             QS_TIME_(); // timestamp
             QS_2U8_(static_cast<uint8_t>(lockPrio),/* prio before unlocking */
                     static_cast<uint8_t>(prevPrio));// prio after unlocking
@@ -393,7 +398,7 @@ void QK_activate_(void) {
         QK_attr_.actPrio = static_cast<uint8_t>(p); // the new active prio
 
         QS_BEGIN_NOCRIT_(QP::QS_SCHED_NEXT,
-                         QP::QS::priv_.locFilter[QP::QS::AO_OBJ], a)
+                         QP::QS::AO_OBJ, a)
             QS_TIME_();   // timestamp
             QS_2U8_(static_cast<uint8_t>(p), // prio of the scheduled AO
                     static_cast<uint8_t>(pprev)); // previous priority
@@ -415,10 +420,12 @@ void QK_activate_(void) {
         //
         QP::QEvt const *e = a->get_();
         a->dispatch(e);
+        QF_LATENCY_DISPATCHED_(a);
         QP::QF::gc(e);
 
         // determine the next highest-priority AO ready to run...
         QF_INT_DISABLE();
+        QF_SIG_FILTER_IDLE_(a); // the state of 'a' is stable
 
         if (a->m_eQueue.isEmpty()) { // empty queue?
             QK_attr_.readySet.remove(p);
@@ -446,7 +453,7 @@ void QK_activate_(void) {
         a = QP::QF::active_[pin]; // the pointer to the preempted AO
 
         QS_BEGIN_NOCRIT_(QP::QS_SCHED_RESUME,
-                         QP::QS::priv_.locFilter[QP::QS::AO_OBJ], a)
+                         QP::QS::AO_OBJ, a)
             QS_TIME_();  // timestamp
             QS_2U8_(static_cast<uint8_t>(pin), /* prio of the resumed AO */
                     static_cast<uint8_t>(pprev)); // previous priority
@@ -454,7 +461,7 @@ void QK_activate_(void) {
     }
     else {  // resuming priority==0 --> idle
         QS_BEGIN_NOCRIT_(QP::QS_SCHED_IDLE,
-                         static_cast<void *>(0), static_cast<void *>(0))
+                         QP::QS::NO_OBJ, static_cast<void *>(0))
             QS_TIME_();  // timestamp
             QS_U8_(static_cast<uint8_t>(pprev)); // previous priority
         QS_END_NOCRIT_()
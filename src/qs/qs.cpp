@@ -51,6 +51,144 @@ extern char_t const BUILD_TIME[9];
 
 QS QS::priv_; // QS private data
 
+#ifdef QS_THREAD_RINGS
+QS_THREAD_LOCAL QS::QSRing *QS::ring_; // ring of the calling thread
+QS::QSRing *QS::rings_; // list of all per-thread rings
+
+//! size of the header (timestamp and length) of records in the rings
+static QSCtr const l_ringHdr = static_cast<QSCtr>(10);
+
+//! room kept in the longest record for the fixed-size data that might
+//! follow the variable-length data (strings, memory blocks and arrays)
+static QSCtr const l_ringTail = static_cast<QSCtr>(64);
+
+//! the lost records of the rings already released
+static uint32_t l_ringLostFreed;
+
+//! QSRing::busy of the ring with no record being written
+static uint64_t const l_ringIdle = ~static_cast<uint64_t>(0);
+
+//! byte at the offset @p i (possibly past the end) in the ring @p r
+static inline uint8_t ringAt(QS::QSRing const * const r, QSCtr i) {
+    if (i >= r->size) {
+        i -= r->size;
+    }
+    return r->sto[i];
+}
+
+//! room for the variable-length data in the current record of the ring
+//! (up to #QS_RING_REC_MAX with l_ringTail kept for the fixed-size data)
+static QSCtr ringRoom(uint8_t const * const buf_, QSCtr const head_,
+                      QSCtr const end_)
+{
+    QS::QSRing const * const r = QS::ring_;
+    QSCtr const rec_ = (buf_ == r->sto)
+                       ? r->rec
+                       : static_cast<QSCtr>(0); // record in the scratch area
+    QSCtr const len_ = (head_ >= rec_)
+                       ? static_cast<QSCtr>(head_ - rec_)
+                       : static_cast<QSCtr>(end_ - rec_ + head_);
+    QSCtr const max_ = static_cast<QSCtr>(QS_RING_REC_MAX - l_ringTail);
+    return (len_ < max_)
+           ? static_cast<QSCtr>(max_ - len_)
+           : static_cast<QSCtr>(0);
+}
+
+//! the longest string (with the zero) for the current record of the ring
+#define QS_STR_MAX_(buf_, head_, end_) \
+    ((ringRoom((buf_), (head_), (end_)) != static_cast<QSCtr>(0)) \
+     ? ringRoom((buf_), (head_), (end_)) : static_cast<QSCtr>(1))
+#else
+//! the strings are not limited outside the per-thread rings
+#define QS_STR_MAX_(buf_, head_, end_) (static_cast<QSCtr>(~0U))
+#endif // QS_THREAD_RINGS
+
+#ifdef QS_LAZY_DICT
+//! states of the registered dictionaries, see #QS_LAZY_DICT
+enum {
+    DICT_NEW,  //!< the dictionary record not produced yet
+    DICT_PEND, //!< the dictionary record to be produced after the record
+    DICT_DONE  //!< the dictionary record produced
+};
+
+static void dictFlush_(void);
+#endif // QS_LAZY_DICT
+
+#ifdef QS_DROP_NEWEST
+//! the sink of the dropped records (the data is discarded, so it can
+//! wrap around any number of times)
+static uint8_t l_dropSto[QS_DROP_RESERVE];
+
+static void dropBegin_(uint_fast8_t const rec);
+static void dropDivert_(void);
+static void dropRoom_(QSCtr const n);
+static QSCtr strRoom_(char_t const *s);
+static void dropEnd_(void);
+#endif // QS_DROP_NEWEST
+
+#ifdef QS_TRIGGER
+static void trgPost_(QSCtr const head_);
+
+//! the number of bytes available for the output (none while the trace
+//! capture holds the output, see QP::QS::trgArm())
+#define QS_OUT_USED_() \
+    ((QS::priv_.trgState != static_cast<uint8_t>(QS::TRG_ARMED)) \
+     ? QS::priv_.used : static_cast<QSCtr>(0))
+#else
+#define QS_OUT_USED_() (QS::priv_.used)
+#endif // QS_TRIGGER
+
+//! sizes of the elements of the typed arrays, see QP::QS::QSArrType
+static uint8_t const l_arrElemSize[] = {
+    static_cast<uint8_t>(1),  // ARR_U8_T
+    static_cast<uint8_t>(2),  // ARR_U16_T
+    static_cast<uint8_t>(4),  // ARR_U32_T
+    static_cast<uint8_t>(4),  // ARR_F32_T
+    static_cast<uint8_t>(8)   // ARR_F64_T
+};
+
+//! insert the zero-terminated string @p s into the buffer @p buf_
+/// @description
+/// Copies the string (including the terminating zero) in contiguous
+/// segments up to the end of the buffer, so that the wrap-around is checked
+/// once per segment rather than once per byte. ASCII characters don't need
+/// escaping. Updates the checksum @p pChksum and the counter @p pUsed.
+/// The string longer than @p n bytes (including the zero) is truncated.
+///
+/// @returns the new head of the buffer
+static QSCtr insertStr(uint8_t * const buf_, QSCtr head_, QSCtr const end_,
+                       char_t const *s, QSCtr n,
+                       uint8_t * const pChksum, QSCtr * const pUsed)
+{
+    uint8_t chksum_ = *pChksum;
+    uint8_t b;
+
+    do {
+        uint8_t *dst = &QS_PTR_AT_(buf_, head_);
+        QSCtr room = static_cast<QSCtr>(end_ - head_);
+        QSCtr i    = static_cast<QSCtr>(0);
+        do {
+            --n;
+            b = (n != static_cast<QSCtr>(0))
+                ? static_cast<uint8_t>(*s)
+                : static_cast<uint8_t>(0); // the string is truncated
+            QS_PTR_AT_(dst, i) = b;
+            chksum_ = static_cast<uint8_t>(chksum_ + b);
+            QS_PTR_INC_(s);
+            ++i;
+        } while ((b != static_cast<uint8_t>(0)) && (i < room));
+
+        *pUsed += i;
+        head_  += i;
+        if (head_ == end_) {
+            head_ = static_cast<QSCtr>(0);
+        }
+    } while (b != static_cast<uint8_t>(0));
+
+    *pChksum = chksum_;
+    return head_;
+}
+
 //****************************************************************************
 /// @description
 /// This function should be called from QP::QS::onStartup() to provide QS with
@@ -80,12 +218,18 @@ void QS::initBuf(uint8_t sto[], uint_fast16_t const stoSize) {
     //
     QS_FILTER_OFF(QS_ALL_RECORDS); // disable all maskable filters
 
-    priv_.locFilter[SM_OBJ] = static_cast<void *>(0);
-    priv_.locFilter[AO_OBJ] = static_cast<void *>(0);
-    priv_.locFilter[MP_OBJ] = static_cast<void *>(0);
-    priv_.locFilter[EQ_OBJ] = static_cast<void *>(0);
-    priv_.locFilter[TE_OBJ] = static_cast<void *>(0);
-    priv_.locFilter[TE_OBJ] = static_cast<void *>(0);
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i <= static_cast<uint_fast8_t>(NO_OBJ); ++i)
+    {
+        priv_.locFilterN[i] = static_cast<uint16_t>(0); // pass all objects
+    }
+    for (uint_fast16_t i = static_cast<uint_fast16_t>(0);
+         i < static_cast<uint_fast16_t>(QS_LOC_FILTER_SIZE); ++i)
+    {
+        priv_.locObj[i]   = static_cast<void const *>(0);
+        priv_.locKinds[i] = static_cast<uint8_t>(0);
+    }
+    priv_.locNum = static_cast<uint16_t>(0);
 
     priv_.buf      = &sto[0];
     priv_.end      = static_cast<QSCtr>(stoSize);
@@ -95,6 +239,77 @@ void QS::initBuf(uint8_t sto[], uint_fast16_t const stoSize) {
     priv_.seq      = static_cast<uint8_t>(0);
     priv_.chksum   = static_cast<uint8_t>(0);
     priv_.critNest = static_cast<uint_fast8_t>(0);
+    priv_.headCopy = static_cast<QSCtr *>(0);
+    priv_.wmark    = static_cast<QSCtr>(~static_cast<QSCtr>(0)); // disarmed
+    priv_.lost     = static_cast<uint32_t>(0);
+    priv_.lostRep  = static_cast<uint32_t>(0);
+    priv_.ringRep  = static_cast<uint32_t>(0);
+    priv_.full     = static_cast<uint8_t>(0);
+
+#ifdef QS_DROP_NEWEST
+    priv_.dropLevel = (priv_.end > static_cast<QSCtr>(QS_DROP_RESERVE))
+                      ? static_cast<QSCtr>(priv_.end - QS_DROP_RESERVE)
+                      : static_cast<QSCtr>(0);
+    priv_.dropRecs  = static_cast<uint32_t>(0);
+    priv_.dropBytes = static_cast<uint32_t>(0);
+    priv_.dropRep   = static_cast<uint32_t>(0);
+    priv_.dropBRep  = static_cast<uint32_t>(0);
+    priv_.blocks    = static_cast<uint32_t>(0);
+    priv_.blockRep  = static_cast<uint32_t>(0);
+    priv_.dropOk    = static_cast<uint8_t>(0);
+#endif // QS_DROP_NEWEST
+
+#ifdef QS_COMPACT
+    for (uint_fast16_t i = static_cast<uint_fast16_t>(0);
+         i < static_cast<uint_fast16_t>(QS_INTERN_SIZE); ++i)
+    {
+        priv_.ptrs[i] = static_cast<QSPtr>(0);
+    }
+    priv_.nIds     = static_cast<uint16_t>(0);
+    priv_.lastTime = static_cast<QSTimeCtr>(0);
+    priv_.timeSync = static_cast<uint8_t>(0); // start with absolute time
+#endif // QS_COMPACT
+
+#ifdef QS_LAZY_DICT
+    for (uint_fast16_t i = static_cast<uint_fast16_t>(0);
+         i < static_cast<uint_fast16_t>(QS_DICT_SIZE); ++i)
+    {
+        priv_.dict[i].kind     = static_cast<uint8_t>(0); // unused
+        priv_.dict[i].homeLeft = static_cast<uint16_t>(0);
+    }
+    priv_.dictNum   = static_cast<uint16_t>(0);
+    priv_.dictLeft  = static_cast<uint16_t>(0);
+    priv_.dictNPend = static_cast<uint8_t>(0);
+#endif // QS_LAZY_DICT
+
+#ifdef QS_SAMPLING
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(sizeof(priv_.smplFilter)); ++i)
+    {
+        priv_.smplFilter[i] = static_cast<uint8_t>(0);
+    }
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(QS_SAMPLE_MAX); ++i)
+    {
+        priv_.smpl[i].rec = static_cast<uint8_t>(0); // unused
+    }
+    priv_.smplSkip = static_cast<uint16_t>(0);
+#endif // QS_SAMPLING
+
+#ifdef QS_TRIGGER
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(QS_TRG_MAX); ++i)
+    {
+        priv_.trg[i].kind = static_cast<uint8_t>(TRG_NONE); // unused
+    }
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(sizeof(priv_.trgRecs)); ++i)
+    {
+        priv_.trgRecs[i] = static_cast<uint8_t>(0);
+    }
+    priv_.trgArmed = static_cast<uint8_t>(0);
+    priv_.trgState = static_cast<uint8_t>(TRG_OFF);
+#endif // QS_TRIGGER
 
     // produce an empty record to "flush" the QS trace buffer
     beginRec(QS_REC_NUM_(QS_EMPTY));
@@ -292,6 +507,197 @@ void QS::filterOff(uint_fast8_t const rec) {
     }
 }
 
+//****************************************************************************
+//! index of the first slot to probe for the object @p obj in the table
+//! of the objects in the local filters
+static inline uint_fast16_t locHash_(void const * const obj) {
+    QSPtr const p = reinterpret_cast<QSPtr>(obj);
+    return static_cast<uint_fast16_t>(
+               (static_cast<uint32_t>(static_cast<uint32_t>(p >> 3)
+                                      ^ static_cast<uint32_t>(p >> 17))
+                * static_cast<uint32_t>(0x9E3779B1U)) >> 16)
+           & static_cast<uint_fast16_t>(QS_LOC_FILTER_SIZE - 1U);
+}
+
+//****************************************************************************
+//! slot of the object @p obj or the empty slot where it belongs
+static uint_fast16_t locSlot_(void const * const obj) {
+    uint_fast16_t const mask =
+        static_cast<uint_fast16_t>(QS_LOC_FILTER_SIZE - 1U);
+    uint_fast16_t i = locHash_(obj);
+
+    // linear probing ends at the object or at an empty slot, as
+    // the table always keeps at least one slot empty
+    while ((QS::priv_.locObj[i] != obj)
+           && (QS::priv_.locObj[i] != static_cast<void const *>(0)))
+    {
+        i = (i + static_cast<uint_fast16_t>(1)) & mask;
+    }
+    return i;
+}
+
+//****************************************************************************
+/// @description
+/// Sets the local filter of the given @p kind of objects to pass only the
+/// QS records of the object @p obj, or of all objects when @p obj is NULL.
+/// This function is called through the macros #QS_FILTER_SM_OBJ,
+/// #QS_FILTER_AO_OBJ, #QS_FILTER_MP_OBJ, #QS_FILTER_EQ_OBJ,
+/// #QS_FILTER_TE_OBJ and #QS_FILTER_AP_OBJ.
+///
+/// @param[in] kind  the kind of objects (QP::QS::QSpyObjKind)
+/// @param[in] obj   the object to trace or NULL to trace all objects
+///
+void QS::locFilter(uint_fast8_t const kind, void const * const obj) {
+    uint8_t const bit = static_cast<uint8_t>(1U << kind);
+    uint_fast16_t i = static_cast<uint_fast16_t>(0);
+
+    Q_REQUIRE_ID(700, kind < static_cast<uint_fast8_t>(MAX_OBJ));
+
+    // remove all objects of this kind; removing an object might move
+    // another object into the same slot, so the slot is checked again
+    while ((priv_.locFilterN[kind] != static_cast<uint16_t>(0))
+           && (i < static_cast<uint_fast16_t>(QS_LOC_FILTER_SIZE)))
+    {
+        if ((priv_.locKinds[i] & bit) != static_cast<uint8_t>(0)) {
+            locFilterRemove(kind, priv_.locObj[i]);
+        }
+        else {
+            ++i;
+        }
+    }
+    locFilterAdd(kind, obj);
+}
+
+//****************************************************************************
+/// @description
+/// Adds the object @p obj to the set of objects of the given @p kind,
+/// whose QS records pass the local filter. As long as the set is empty,
+/// the local filter passes the records of all objects of the kind. The
+/// objects of all kinds share one open-addressing table of
+/// #QS_LOC_FILTER_SIZE slots, so the local filter is checked in constant
+/// time regardless of the number of the objects.
+///
+/// @note
+/// The table is changed and probed only inside the QS critical section.
+/// With #QS_THREAD_RINGS this critical section is empty, so the local
+/// filters should be changed only while no other thread produces QS
+/// records (e.g., before QF::run()).
+///
+/// @param[in] kind  the kind of objects (QP::QS::QSpyObjKind)
+/// @param[in] obj   the object to trace (NULL is ignored)
+///
+/// @sa #QS_FILTER_OBJ_ADD, QP::QS::locFilterRemove()
+///
+void QS::locFilterAdd(uint_fast8_t const kind, void const * const obj) {
+    uint8_t const bit = static_cast<uint8_t>(1U << kind);
+    QS_CRIT_STAT_
+
+    Q_REQUIRE_ID(710, kind < static_cast<uint_fast8_t>(MAX_OBJ));
+
+    if (obj != static_cast<void const *>(0)) {
+        QS_CRIT_ENTRY_();
+        uint_fast16_t const i = locSlot_(obj);
+        if (priv_.locObj[i] == static_cast<void const *>(0)) { // new?
+            // the table must keep at least one slot empty
+            Q_ASSERT_ID(720, priv_.locNum
+                < static_cast<uint16_t>(QS_LOC_FILTER_SIZE - 1U));
+            ++priv_.locNum;
+            priv_.locObj[i]   = obj;
+            priv_.locKinds[i] = static_cast<uint8_t>(0);
+        }
+        if ((priv_.locKinds[i] & bit) == static_cast<uint8_t>(0)) {
+            priv_.locKinds[i] |= bit;
+            ++priv_.locFilterN[kind];
+        }
+        QS_CRIT_EXIT_();
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Removes the object @p obj from the set of objects of the given @p kind,
+/// whose QS records pass the local filter. When the last object is
+/// removed, the local filter passes the records of all objects again.
+///
+/// @param[in] kind  the kind of objects (QP::QS::QSpyObjKind)
+/// @param[in] obj   the object not to trace anymore
+///
+/// @sa #QS_FILTER_OBJ_REMOVE, QP::QS::locFilterAdd()
+///
+void QS::locFilterRemove(uint_fast8_t const kind, void const * const obj) {
+    uint_fast16_t const mask =
+        static_cast<uint_fast16_t>(QS_LOC_FILTER_SIZE - 1U);
+    uint8_t const bit = static_cast<uint8_t>(1U << kind);
+    QS_CRIT_STAT_
+
+    Q_REQUIRE_ID(730, kind < static_cast<uint_fast8_t>(MAX_OBJ));
+
+    QS_CRIT_ENTRY_();
+    uint_fast16_t i = locSlot_(obj);
+    if ((obj != static_cast<void const *>(0))
+        && ((priv_.locKinds[i] & bit) != static_cast<uint8_t>(0)))
+    {
+        priv_.locKinds[i] &= static_cast<uint8_t>(~bit);
+        --priv_.locFilterN[kind];
+
+        if (priv_.locKinds[i] == static_cast<uint8_t>(0)) { // unused?
+            // move the following objects of the probe sequence back,
+            // so that the linear probing never needs tombstones
+            uint_fast16_t j = i;
+            for (;;) {
+                j = (j + static_cast<uint_fast16_t>(1)) & mask;
+                if (priv_.locObj[j] == static_cast<void const *>(0)) {
+                    break;
+                }
+                uint_fast16_t const k = locHash_(priv_.locObj[j]);
+                bool const stay = (i <= j)
+                                  ? ((i < k) && (k <= j))
+                                  : ((i < k) || (k <= j));
+                if (!stay) { // can the object move back to the slot i?
+                    priv_.locObj[i]   = priv_.locObj[j];
+                    priv_.locKinds[i] = priv_.locKinds[j];
+                    i = j;
+                }
+            }
+            priv_.locObj[i]   = static_cast<void const *>(0);
+            priv_.locKinds[i] = static_cast<uint8_t>(0);
+            --priv_.locNum;
+        }
+    }
+    QS_CRIT_EXIT_();
+}
+
+//****************************************************************************
+/// @description
+/// Probes the table of the local filters in a critical section, because
+/// QP::QS::locFilterRemove() moves the objects in the table.
+///
+/// @note This function is only to be used through the macro
+/// #QS_LOC_FILTER_ (outside of a critical section), which calls it only
+/// when the local filter of the @p kind of objects is not empty.
+///
+bool QS::locFilterHas_(uint_fast8_t const kind, void const * const obj) {
+    QS_CRIT_STAT_
+    QS_CRIT_ENTRY_();
+    bool const has = locFilterHasNoCrit_(kind, obj);
+    QS_CRIT_EXIT_();
+    return has;
+}
+
+//****************************************************************************
+/// @note This function is only to be used through the macro
+/// #QS_LOC_FILTER_NOCRIT_ (inside a critical section), which calls it only
+/// when the local filter of the @p kind of objects is not empty.
+///
+bool QS::locFilterHasNoCrit_(uint_fast8_t const kind,
+                             void const * const obj)
+{
+    uint_fast16_t const i = locSlot_(obj);
+    return (priv_.locObj[i] != static_cast<void const *>(0))
+           && ((priv_.locKinds[i] & static_cast<uint8_t>(1U << kind))
+               != static_cast<uint8_t>(0));
+}
+
 //****************************************************************************
 /// @description
 /// This function must be called at the beginning of each QS record.
@@ -299,7 +705,12 @@ void QS::filterOff(uint_fast8_t const rec) {
 /// or #QS_BEGIN_NOCRIT, depending if it's called in a normal code or from
 /// a critical section.
 ///
+#ifndef QS_THREAD_RINGS
+
 void QS::beginRec(uint_fast8_t const rec) {
+#ifdef QS_DROP_NEWEST
+    dropBegin_(rec); // drop the record if the QS buffer has no room for it
+#endif // QS_DROP_NEWEST
     uint8_t b = static_cast<uint8_t>(priv_.seq + static_cast<uint8_t>(1));
     uint8_t chksum_ = static_cast<uint8_t>(0); // reset the checksum
     uint8_t *buf_   = priv_.buf;   // put in a temporary (register)
@@ -314,6 +725,17 @@ void QS::beginRec(uint_fast8_t const rec) {
     chksum_ = static_cast<uint8_t>(chksum_ + static_cast<uint8_t>(rec));
     QS_INSERT_BYTE(static_cast<uint8_t>(rec)) // rec does not need escaping
 
+#ifdef QS_SAMPLING
+    if (QS_SMPL_FILTER_(rec)) { // sampled record type?
+        // the number of records skipped before this one
+        priv_.used += static_cast<QSCtr>(2); // 2 bytes about to be added
+        b = static_cast<uint8_t>(priv_.smplSkip);
+        QS_INSERT_ESC_BYTE(b)
+        b = static_cast<uint8_t>(priv_.smplSkip >> 8);
+        QS_INSERT_ESC_BYTE(b)
+    }
+#endif // QS_SAMPLING
+
     priv_.head   = head_;   // save the head
     priv_.chksum = chksum_; // save the checksum
 }
@@ -347,12 +769,468 @@ void QS::endRec(void) {
     QS_INSERT_BYTE(QS_FRAME) // do not escape this QS_FRAME
 
     priv_.head = head_; // save the head
+#ifdef QS_DROP_NEWEST
+    if (priv_.full != static_cast<uint8_t>(0)) { // record dropped?
+        dropEnd_(); // restore the QS buffer
+        head_ = priv_.head;
+        end_  = priv_.end;
+    }
+#endif // QS_DROP_NEWEST
+    if (priv_.headCopy != static_cast<QSCtr *>(0)) { // head published?
+        QS_HEAD_PUBLISH_(priv_.headCopy, head_); // keep it with the data
+    }
+#ifdef QS_TRIGGER
+    if (priv_.trgState == static_cast<uint8_t>(TRG_POST)) { // post-trigger?
+        trgPost_(head_);
+    }
+    // the output is held while capturing the trace, see QS::trgArm()
+    bool const held = (priv_.trgState == static_cast<uint8_t>(TRG_ARMED));
+#else
+    bool const held = false;
+#endif // QS_TRIGGER
     if (priv_.used > end_) { // overrun over the old data?
+        if (!held) { // old data not overwritten on purpose?
+            priv_.lost += static_cast<uint32_t>(priv_.used - end_);
+        }
         priv_.used = end_;   // the whole buffer is used
         priv_.tail = head_;  // shift the tail to the old data
     }
+    if ((priv_.used >= priv_.wmark) && (!held)) { // watermark reached?
+        priv_.wmark = static_cast<QSCtr>(~static_cast<QSCtr>(0)); // disarm
+        QS_WMARK_HOOK_(); // wake up the QS output, see QS::setWatermark()
+    }
+#ifdef QS_LAZY_DICT
+    if (priv_.dictNPend != static_cast<uint8_t>(0)) { // dictionaries used?
+        dictFlush_(); // produce them right after this record
+    }
+#endif // QS_LAZY_DICT
+}
+
+#ifdef QS_DROP_NEWEST
+//****************************************************************************
+//! redirect the maskable record @p rec to the sink of the dropped records
+//! when less than #QS_DROP_RESERVE bytes are free in the QS buffer
+//! (the dictionaries, QS_TRG_FIRED, QS_OVERRUN, and other non-maskable
+//! records are never dropped, so they use the reserve)
+static void dropBegin_(uint_fast8_t const rec) {
+    bool canDrop = (rec < static_cast<uint_fast8_t>(QS_SIG_DICT))
+        || ((rec >= static_cast<uint_fast8_t>(QS_USER))
+            && (rec < static_cast<uint_fast8_t>(QS_TRG_FIRED)));
+#ifdef QS_TRIGGER
+    // the old data is overwritten on purpose while capturing the trace
+    canDrop = canDrop
+           && (QS::priv_.trgState != static_cast<uint8_t>(QS::TRG_ARMED));
+#endif // QS_TRIGGER
+    QS::priv_.full   = static_cast<uint8_t>(0);
+    QS::priv_.dropOk = canDrop ? static_cast<uint8_t>(1)
+                               : static_cast<uint8_t>(0);
+    if (canDrop) { // remember the QS buffer before the record, dropEnd_()
+        QS::priv_.dropBuf  = QS::priv_.buf;
+        QS::priv_.dropEnd  = QS::priv_.end;
+        QS::priv_.dropHead = QS::priv_.head;
+        QS::priv_.dropUsed = QS::priv_.used;
+#ifdef QS_COMPACT
+        QS::priv_.dropTime = QS::priv_.lastTime;
+        QS::priv_.dropSync = QS::priv_.timeSync;
+#endif // QS_COMPACT
+        if (QS::priv_.used > QS::priv_.dropLevel) {
+            dropDivert_();
+        }
+    }
+}
+
+//****************************************************************************
+//! write the rest of the current record into the sink of the dropped
+//! records (the bytes already written to the QS buffer are taken back in
+//! dropEnd_(), before they overwrite any old data)
+static void dropDivert_(void) {
+    QS::priv_.full = static_cast<uint8_t>(1);
+    QS::priv_.buf  = &l_dropSto[0];
+    QS::priv_.end  = static_cast<QSCtr>(sizeof(l_dropSto));
+    QS::priv_.head = static_cast<QSCtr>(0);
+}
+
+//****************************************************************************
+//! drop the current record when the @p n bytes of its variable-length data
+//! would leave less than #QS_DROP_RESERVE bytes free in the QS buffer for
+//! the rest of the record
+static void dropRoom_(QSCtr const n) {
+    if ((QS::priv_.dropOk != static_cast<uint8_t>(0))
+        && (QS::priv_.full == static_cast<uint8_t>(0))
+        && ((QS::priv_.used > QS::priv_.dropLevel)
+            || (n > static_cast<QSCtr>(QS::priv_.dropLevel
+                                       - QS::priv_.used))))
+    {
+        dropDivert_();
+    }
+}
+
+//****************************************************************************
+//! the room for the string @p s with the zero and the format byte (the
+//! strings are not escaped, see insertStr()), see dropRoom_()
+static QSCtr strRoom_(char_t const *s) {
+    QSCtr n = static_cast<QSCtr>(2);
+    while (*s != static_cast<char_t>(0)) {
+        ++n;
+        QS_PTR_INC_(s);
+    }
+    return n;
+}
+
+//****************************************************************************
+//! count the dropped record and restore the QS buffer
+static void dropEnd_(void) {
+    ++QS::priv_.dropRecs;
+    QS::priv_.dropBytes += static_cast<uint32_t>(QS::priv_.used
+                                                 - QS::priv_.dropUsed);
+    QS::priv_.buf  = QS::priv_.dropBuf;
+    QS::priv_.end  = QS::priv_.dropEnd;
+    QS::priv_.head = QS::priv_.dropHead;
+    QS::priv_.used = QS::priv_.dropUsed;
+#ifdef QS_COMPACT
+    // the host keeps the time stamps of the records actually sent
+    QS::priv_.lastTime = QS::priv_.dropTime;
+    QS::priv_.timeSync = QS::priv_.dropSync;
+#endif // QS_COMPACT
+#ifdef QS_LAZY_DICT
+    // the dictionaries used in the dropped record are not pending anymore
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(QS::priv_.dictNPend); ++i)
+    {
+        QS::QSDict * const d = &QS::priv_.dict[QS::priv_.dictPend[i]];
+        if (d->state == static_cast<uint8_t>(DICT_PEND)) {
+            d->state = static_cast<uint8_t>(DICT_NEW);
+        }
+    }
+    QS::priv_.dictNPend = static_cast<uint8_t>(0);
+#endif // QS_LAZY_DICT
+}
+#endif // QS_DROP_NEWEST
+
+#else // QS_THREAD_RINGS
+
+void QS::beginRec(uint_fast8_t const rec) {
+    QSRing *r = ring_;
+    if (r == static_cast<QSRing *>(0)) { // first record of this thread?
+        r = ringAlloc_();
+    }
+
+    uint8_t chksum_ = static_cast<uint8_t>(0);
+    uint8_t *buf_   = r->sto;
+    QSCtr   head_   = r->head;
+    QSCtr   end_    = r->size;
+    QSCtr   tail_   = QS_RING_LOAD_(r->tail);
+    QSCtr   used_   = (head_ >= tail_)
+                      ? static_cast<QSCtr>(head_ - tail_)
+                      : static_cast<QSCtr>(end_ - tail_ + head_);
+
+    r->rec = head_; // remember where this record starts
+
+    // not enough room for the longest record?
+    if (static_cast<QSCtr>(end_ - used_)
+        <= static_cast<QSCtr>(QS_RING_REC_MAX))
+    {
+        // write the record into the scratch area past the end of the ring
+        // and discard it in QP::QS::endRec()
+        buf_  = &QS_PTR_AT_(r->sto, end_);
+        end_  = static_cast<QSCtr>(QS_RING_REC_MAX);
+        head_ = static_cast<QSCtr>(0);
+    }
+
+    // hold back the merge of all the records (see QP::QS::QSRing) until
+    // the timestamp of this record is known
+    QS_RING_STORE_(r->busy, static_cast<uint64_t>(0));
+    QS_RING_FENCE_();
+    uint64_t t = QS_RING_TIME_(); // monotonic timestamp of the record
+    QS_RING_STORE_(r->busy, t); // hold back only the younger records
+    for (int_fast8_t i = static_cast<int_fast8_t>(8);
+         i != static_cast<int_fast8_t>(0);
+         --i)
+    {
+        QS_INSERT_BYTE(static_cast<uint8_t>(t))
+        t >>= 8;
+    }
+    QS_INSERT_BYTE(static_cast<uint8_t>(0)) // the length, see endRec()
+    QS_INSERT_BYTE(static_cast<uint8_t>(0))
+
+    QS_INSERT_BYTE(static_cast<uint8_t>(rec)) // the record ID
+
+    r->buf    = buf_;
+    r->end    = end_;
+    r->head   = head_;
+    r->chksum = chksum_;
+}
+
+//****************************************************************************
+/// @description
+/// This function must be called at the end of each QS record.
+/// This function should be called indirectly through the macro #QS_END,
+/// or #QS_END_NOCRIT, depending if it's called in a normal code or from
+/// a critical section.
+///
+void QS::endRec(void) {
+    QSRing *r = ring_;
+
+    if (r->buf != r->sto) { // the record was discarded?
+        ++r->lost;
+        r->head = r->rec; // restore the head
+    }
+    else {
+        QSCtr head_ = r->head;
+        QSCtr len = static_cast<QSCtr>(
+                        ((head_ >= r->rec)
+                         ? static_cast<QSCtr>(head_ - r->rec)
+                         : static_cast<QSCtr>(r->size - r->rec + head_))
+                        - l_ringHdr);
+
+        // the record longer than the room checked in QP::QS::beginRec()
+        // (possible only with too much fixed-size data), see QP::QS::QSRing
+        if (static_cast<QSCtr>(len + l_ringHdr)
+            >= static_cast<QSCtr>(QS_RING_REC_MAX))
+        {
+            ++r->lost;
+            r->head = r->rec; // drop the record
+            r->buf = r->sto;
+            r->end = r->size;
+            QS_RING_STORE_(r->busy, l_ringIdle);
+            return;
+        }
+
+        QSCtr i = static_cast<QSCtr>(r->rec + static_cast<QSCtr>(8));
+        if (i >= r->size) {
+            i -= r->size;
+        }
+        QS_PTR_AT_(r->sto, i) = static_cast<uint8_t>(len);
+        ++i;
+        if (i == r->size) {
+            i = static_cast<QSCtr>(0);
+        }
+        QS_PTR_AT_(r->sto, i) = static_cast<uint8_t>(len >> 8);
+
+        QS_RING_STORE_(r->pub, head_); // publish the record to the consumer
+    }
+    r->buf = r->sto;
+    r->end = r->size;
+    QS_RING_STORE_(r->busy, l_ringIdle); // no record being written
+}
+
+//****************************************************************************
+/// @description
+/// Allocates the ring of the calling thread with #QS_RING_ALLOC_ and
+/// pushes it (lock-free) onto the list of all rings.
+///
+QS::QSRing *QS::ringAlloc_(void) {
+    uint8_t *mem = QS_RING_ALLOC_(sizeof(QSRing)
+                                  + static_cast<uint32_t>(QS_RING_SIZE)
+                                  + static_cast<uint32_t>(QS_RING_REC_MAX));
+    Q_ASSERT_ID(230, mem != static_cast<uint8_t *>(0));
+
+    QSRing *r = reinterpret_cast<QSRing *>(mem);
+    r->sto    = &mem[sizeof(QSRing)];
+    r->size   = static_cast<QSCtr>(QS_RING_SIZE);
+    r->buf    = r->sto;
+    r->end    = r->size;
+    r->head   = static_cast<QSCtr>(0);
+    r->used   = static_cast<QSCtr>(0);
+    r->chksum = static_cast<uint8_t>(0);
+    r->rec    = static_cast<QSCtr>(0);
+    r->pub    = static_cast<QSCtr>(0);
+    r->tail   = static_cast<QSCtr>(0);
+    r->busy   = l_ringIdle;
+    r->lost   = static_cast<uint32_t>(0);
+    r->dead   = static_cast<uint8_t>(0);
+
+    QSRing *next = QS_RING_LOAD_(rings_);
+    do {
+        r->next = next;
+    } while (!QS_RING_CAS_(rings_, next, r));
+
+    ring_ = r;
+    QS_RING_ATTACH_(r); // release the ring when the thread exits
+    return r;
+}
+
+//****************************************************************************
+/// @description
+/// Marks the @p ring of an exiting thread, so that QP::QS::ringMerge_()
+/// frees it after merging its remaining records. Called by the QS port
+/// at the exit of the thread, to which the ring was attached with
+/// #QS_RING_ATTACH_.
+///
+void QS::ringExit_(void * const ring) {
+    QSRing * const r = static_cast<QSRing *>(ring);
+    QS_RING_STORE_(r->dead, static_cast<uint8_t>(1));
+}
+
+//****************************************************************************
+/// @description
+/// Unlinks and frees the rings of the exited threads, which have no
+/// records left to merge. Only the consumer of the rings removes them from
+/// the list, while the producers only push new rings at the head, so just
+/// the removal of the head needs the atomic compare-and-swap.
+///
+/// @note Called from QP::QS::ringMerge_(), which must not be called
+/// concurrently.
+///
+void QS::ringFree_(void) {
+    QSRing *prev = static_cast<QSRing *>(0);
+    QSRing *r = QS_RING_LOAD_(rings_);
+    while (r != static_cast<QSRing *>(0)) {
+        QSRing * const next = r->next;
+        if ((QS_RING_LOAD_(r->dead) != static_cast<uint8_t>(0))
+            && (r->tail == QS_RING_LOAD_(r->pub))) // all merged?
+        {
+            bool isUnlinked = true;
+            if (prev != static_cast<QSRing *>(0)) {
+                prev->next = next;
+            }
+            else {
+                QSRing *head = r;
+                isUnlinked = QS_RING_CAS_(rings_, head, next);
+            }
+            if (!isUnlinked) { // a new ring pushed meanwhile?
+                break; // try again next time
+            }
+            l_ringLostFreed += r->lost;
+            QS_RING_FREE_(reinterpret_cast<uint8_t *>(r));
+        }
+        else {
+            prev = r;
+        }
+        r = next;
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Moves the records from the per-thread rings into the main QS buffer
+/// in the order of their timestamps, for as long as the main buffer has
+/// room for the longest (fully escaped) record and no thread is writing
+/// an older record (see QP::QS::QSRing). Each merged record obtains
+/// the sequence number, checksum and HDLC framing, so the main buffer holds
+/// exactly the same stream as without the per-thread rings.
+///
+/// @note Called from QP::QS::getBlock() and QP::QS::getByte(), which must
+/// not be called concurrently.
+///
+void QS::ringMerge_(void) {
+    ringFree_(); // free the rings of the exited threads
+
+    while (static_cast<QSCtr>(priv_.end - priv_.used)
+           > static_cast<QSCtr>(2U * QS_RING_REC_MAX))
+    {
+        QSRing *best = static_cast<QSRing *>(0);
+        uint64_t bestTime = static_cast<uint64_t>(0);
+        QSRing *r;
+
+        // find the ring with the oldest unmerged record
+        for (r = QS_RING_LOAD_(rings_);
+             r != static_cast<QSRing *>(0);
+             r = r->next)
+        {
+            QSCtr tail_ = r->tail; // only the consumer changes the tail
+            if (tail_ != QS_RING_LOAD_(r->pub)) { // any records?
+                uint64_t t = static_cast<uint64_t>(0);
+                for (QSCtr i = static_cast<QSCtr>(8);
+                     i != static_cast<QSCtr>(0);
+                     --i)
+                {
+                    t = (t << 8)
+                        | static_cast<uint64_t>(ringAt(r,
+                              static_cast<QSCtr>(tail_ + i - 1U)));
+                }
+                if ((best == static_cast<QSRing *>(0)) || (t < bestTime)) {
+                    best = r;
+                    bestTime = t;
+                }
+            }
+        }
+        if (best == static_cast<QSRing *>(0)) { // all rings empty?
+            break;
+        }
+
+        // any older record still being written? (pairs with the fence in
+        // QP::QS::beginRec(), so a record begun after this check is younger)
+        QS_RING_FENCE_();
+        for (r = QS_RING_LOAD_(rings_);
+             r != static_cast<QSRing *>(0);
+             r = r->next)
+        {
+            if ((r != best) && (QS_RING_LOAD_(r->busy) < bestTime)) {
+                break;
+            }
+        }
+        if (r != static_cast<QSRing *>(0)) {
+            break; // merge the records only after the older one is written
+        }
+
+        QSCtr tail_ = best->tail;
+        QSCtr len = static_cast<QSCtr>(
+            static_cast<QSCtr>(ringAt(best, static_cast<QSCtr>(tail_ + 8U)))
+            | static_cast<QSCtr>(static_cast<QSCtr>(
+                  ringAt(best, static_cast<QSCtr>(tail_ + 9U))) << 8));
+        tail_ += l_ringHdr;
+        if (tail_ >= best->size) {
+            tail_ -= best->size;
+        }
+
+        // frame the record into the main QS buffer (see beginRec/endRec)
+        uint8_t b = static_cast<uint8_t>(priv_.seq + static_cast<uint8_t>(1));
+        uint8_t chksum_ = static_cast<uint8_t>(0);
+        uint8_t *buf_   = priv_.buf;
+        QSCtr   head_   = priv_.head;
+        QSCtr   end_    = priv_.end;
+
+        priv_.seq = b;
+        priv_.used += static_cast<QSCtr>(len + 3U); // seq, chksum and frame
+        QS_MERGE_ESC_BYTE(b)
+
+        b = ringAt(best, tail_); // the record ID does not need escaping
+        chksum_ = static_cast<uint8_t>(chksum_ + b);
+        QS_INSERT_BYTE(b)
+        for (QSCtr i = static_cast<QSCtr>(1); i < len; ++i) {
+            b = ringAt(best, static_cast<QSCtr>(tail_ + i));
+            QS_MERGE_ESC_BYTE(b)
+        }
+        tail_ += len;
+        if (tail_ >= best->size) {
+            tail_ -= best->size;
+        }
+        QS_RING_STORE_(best->tail, tail_); // free the space for the producer
+
+        b = static_cast<uint8_t>(chksum_ ^ static_cast<uint8_t>(0xFF));
+        if ((b != QS_FRAME) && (b != QS_ESC)) {
+            QS_INSERT_BYTE(b)
+        }
+        else {
+            QS_INSERT_BYTE(QS_ESC)
+            QS_INSERT_BYTE(b ^ QS_ESC_XOR)
+            ++priv_.used; // account for the ESC byte
+        }
+        QS_INSERT_BYTE(QS_FRAME) // do not escape this QS_FRAME
+
+        priv_.head = head_;
+        if (priv_.headCopy != static_cast<QSCtr *>(0)) { // published?
+            QS_HEAD_PUBLISH_(priv_.headCopy, head_); // keep it with data
+        }
+    }
+}
+
+//****************************************************************************
+uint32_t QS::getRingLost(void) {
+    uint32_t lost = l_ringLostFreed;
+    QSRing *r;
+    for (r = QS_RING_LOAD_(rings_);
+         r != static_cast<QSRing *>(0);
+         r = r->next)
+    {
+        lost += r->lost;
+    }
+    return lost;
 }
 
+#endif // QS_THREAD_RINGS
+
 //****************************************************************************
 void QS_target_info_(uint8_t const isReset) {
 
@@ -386,7 +1264,11 @@ void QS_target_info_(uint8_t const isReset) {
         QS_U8_(static_cast<uint8_t>(QS_OBJ_PTR_SIZE)
                | static_cast<uint8_t>(
                      static_cast<uint8_t>(QS_FUN_PTR_SIZE) << 4));
+#ifdef QS_COMPACT
+        QS_U8_(static_cast<uint8_t>(QS_TIME_SIZE) | 0x80U); // compact
+#else
         QS_U8_(static_cast<uint8_t>(QS_TIME_SIZE));
+#endif // QS_COMPACT
 
         // send the limits...
         QS_U8_(static_cast<uint8_t>(QF_MAX_ACTIVE));
@@ -523,18 +1405,18 @@ void QS_target_info_(uint8_t const isReset) {
 /// client code directly.
 ///
 void QS::u8(uint8_t const format, uint8_t const d) {
-    uint8_t chksum_ = priv_.chksum; // put in a temporary (register)
-    uint8_t *buf_   = priv_.buf;    // put in a temporary (register)
-    QSCtr   head_   = priv_.head;   // put in a temporary (register)
-    QSCtr   end_    = priv_.end;    // put in a temporary (register)
+    uint8_t chksum_ = QS_RING_.chksum; // put in a temporary (register)
+    uint8_t *buf_   = QS_RING_.buf;    // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;   // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;    // put in a temporary (register)
 
-    priv_.used += static_cast<QSCtr>(2); // 2 bytes about to be added
+    QS_RING_.used += static_cast<QSCtr>(2); // 2 bytes about to be added
 
     QS_INSERT_ESC_BYTE(format)
     QS_INSERT_ESC_BYTE(d)
 
-    priv_.head   = head_;   // save the head
-    priv_.chksum = chksum_; // save the checksum
+    QS_RING_.head   = head_;   // save the head
+    QS_RING_.chksum = chksum_; // save the checksum
 }
 
 //****************************************************************************
@@ -543,12 +1425,12 @@ void QS::u8(uint8_t const format, uint8_t const d) {
 /// client code directly.
 ///
 void QS::u16(uint8_t format, uint16_t d) {
-    uint8_t chksum_ = priv_.chksum; // put in a temporary (register)
-    uint8_t *buf_   = priv_.buf;    // put in a temporary (register)
-    QSCtr   head_   = priv_.head;   // put in a temporary (register)
-    QSCtr   end_    = priv_.end;    // put in a temporary (register)
+    uint8_t chksum_ = QS_RING_.chksum; // put in a temporary (register)
+    uint8_t *buf_   = QS_RING_.buf;    // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;   // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;    // put in a temporary (register)
 
-    priv_.used += static_cast<QSCtr>(3); // 3 bytes about to be added
+    QS_RING_.used += static_cast<QSCtr>(3); // 3 bytes about to be added
 
     QS_INSERT_ESC_BYTE(format)
 
@@ -559,8 +1441,8 @@ void QS::u16(uint8_t format, uint16_t d) {
     format = static_cast<uint8_t>(d);
     QS_INSERT_ESC_BYTE(format)
 
-    priv_.head   = head_;    // save the head
-    priv_.chksum = chksum_;  // save the checksum
+    QS_RING_.head   = head_;    // save the head
+    QS_RING_.chksum = chksum_;  // save the checksum
 }
 
 //****************************************************************************
@@ -568,12 +1450,12 @@ void QS::u16(uint8_t format, uint16_t d) {
 /// client code directly.
 ///
 void QS::u32(uint8_t format, uint32_t d) {
-    uint8_t chksum_ = priv_.chksum;  // put in a temporary (register)
-    uint8_t *buf_   = priv_.buf;     // put in a temporary (register)
-    QSCtr   head_   = priv_.head;    // put in a temporary (register)
-    QSCtr   end_    = priv_.end;     // put in a temporary (register)
+    uint8_t chksum_ = QS_RING_.chksum;  // put in a temporary (register)
+    uint8_t *buf_   = QS_RING_.buf;     // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;    // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;     // put in a temporary (register)
 
-    priv_.used += static_cast<QSCtr>(5); // 5 bytes about to be added
+    QS_RING_.used += static_cast<QSCtr>(5); // 5 bytes about to be added
     QS_INSERT_ESC_BYTE(format) // insert the format byte
 
     for (int_t i = static_cast<int_t>(4); i != static_cast<int_t>(0); --i) {
@@ -582,8 +1464,8 @@ void QS::u32(uint8_t format, uint32_t d) {
         d >>= 8;
     }
 
-    priv_.head   = head_;   // save the head
-    priv_.chksum = chksum_; // save the checksum
+    QS_RING_.head   = head_;   // save the head
+    QS_RING_.chksum = chksum_; // save the checksum
 }
 
 //****************************************************************************
@@ -591,16 +1473,16 @@ void QS::u32(uint8_t format, uint32_t d) {
 /// client code directly.
 ///
 void QS::u8_(uint8_t const d) {
-    uint8_t chksum_ = priv_.chksum; // put in a temporary (register)
-    uint8_t *buf_   = priv_.buf;    // put in a temporary (register)
-    QSCtr   head_   = priv_.head;   // put in a temporary (register)
-    QSCtr   end_    = priv_.end;    // put in a temporary (register)
+    uint8_t chksum_ = QS_RING_.chksum; // put in a temporary (register)
+    uint8_t *buf_   = QS_RING_.buf;    // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;   // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;    // put in a temporary (register)
 
-    ++priv_.used;  // 1 byte about to be added
+    ++QS_RING_.used;  // 1 byte about to be added
     QS_INSERT_ESC_BYTE(d)
 
-    priv_.head   = head_;   // save the head
-    priv_.chksum = chksum_; // save the checksum
+    QS_RING_.head   = head_;   // save the head
+    QS_RING_.chksum = chksum_; // save the checksum
 }
 
 //****************************************************************************
@@ -608,17 +1490,17 @@ void QS::u8_(uint8_t const d) {
 /// client code directly.
 ///
 void QS::u8u8_(uint8_t const d1, uint8_t const d2) {
-    uint8_t chksum_ = priv_.chksum; // put in a temporary (register)
-    uint8_t *buf_   = priv_.buf;    // put in a temporary (register)
-    QSCtr   head_   = priv_.head;   // put in a temporary (register)
-    QSCtr   end_    = priv_.end;    // put in a temporary (register)
+    uint8_t chksum_ = QS_RING_.chksum; // put in a temporary (register)
+    uint8_t *buf_   = QS_RING_.buf;    // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;   // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;    // put in a temporary (register)
 
-    priv_.used += static_cast<QSCtr>(2); // 2 bytes about to be added
+    QS_RING_.used += static_cast<QSCtr>(2); // 2 bytes about to be added
     QS_INSERT_ESC_BYTE(d1)
     QS_INSERT_ESC_BYTE(d2)
 
-    priv_.head   = head_;    // save the head
-    priv_.chksum = chksum_;  // save the checksum
+    QS_RING_.head   = head_;    // save the head
+    QS_RING_.chksum = chksum_;  // save the checksum
 }
 
 //****************************************************************************
@@ -627,12 +1509,12 @@ void QS::u8u8_(uint8_t const d1, uint8_t const d2) {
 ///
 void QS::u16_(uint16_t d) {
     uint8_t b = static_cast<uint8_t>(d);
-    uint8_t chksum_ = priv_.chksum; // put in a temporary (register)
-    uint8_t *buf_   = priv_.buf;    // put in a temporary (register)
-    QSCtr   head_   = priv_.head;   // put in a temporary (register)
-    QSCtr   end_    = priv_.end;    // put in a temporary (register)
+    uint8_t chksum_ = QS_RING_.chksum; // put in a temporary (register)
+    uint8_t *buf_   = QS_RING_.buf;    // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;   // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;    // put in a temporary (register)
 
-    priv_.used += static_cast<QSCtr>(2); // 2 bytes about to be added
+    QS_RING_.used += static_cast<QSCtr>(2); // 2 bytes about to be added
 
     QS_INSERT_ESC_BYTE(b)
 
@@ -640,8 +1522,8 @@ void QS::u16_(uint16_t d) {
     b = static_cast<uint8_t>(d);
     QS_INSERT_ESC_BYTE(b)
 
-    priv_.head   = head_;    // save the head
-    priv_.chksum = chksum_;  // save the checksum
+    QS_RING_.head   = head_;    // save the head
+    QS_RING_.chksum = chksum_;  // save the checksum
 }
 
 //****************************************************************************
@@ -649,20 +1531,20 @@ void QS::u16_(uint16_t d) {
 /// client code directly.
 ///
 void QS::u32_(uint32_t d) {
-    uint8_t chksum_ = priv_.chksum; // put in a temporary (register)
-    uint8_t *buf_   = priv_.buf;    // put in a temporary (register)
-    QSCtr   head_   = priv_.head;   // put in a temporary (register)
-    QSCtr   end_    = priv_.end;    // put in a temporary (register)
+    uint8_t chksum_ = QS_RING_.chksum; // put in a temporary (register)
+    uint8_t *buf_   = QS_RING_.buf;    // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;   // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;    // put in a temporary (register)
 
-    priv_.used += static_cast<QSCtr>(4); // 4 bytes about to be added
+    QS_RING_.used += static_cast<QSCtr>(4); // 4 bytes about to be added
     for (int_t i = static_cast<int_t>(4); i != static_cast<int_t>(0); --i) {
         uint8_t b = static_cast<uint8_t>(d);
         QS_INSERT_ESC_BYTE(b)
         d >>= 8;
     }
 
-    priv_.head   = head_;    // save the head
-    priv_.chksum = chksum_;  // save the checksum
+    QS_RING_.head   = head_;    // save the head
+    QS_RING_.chksum = chksum_;  // save the checksum
 }
 
 //****************************************************************************
@@ -670,63 +1552,231 @@ void QS::u32_(uint32_t d) {
 /// client code directly.
 ///
 void QS::str_(char_t const *s) {
-    uint8_t b = static_cast<uint8_t>(*s);
-    uint8_t chksum_ = priv_.chksum; // put in a temporary (register)
-    uint8_t *buf_   = priv_.buf;    // put in a temporary (register)
-    QSCtr   head_   = priv_.head;   // put in a temporary (register)
-    QSCtr   end_    = priv_.end;    // put in a temporary (register)
-    QSCtr   used_   = priv_.used;   // put in a temporary (register)
-
-    while (b != static_cast<uint8_t>(0)) {
-        chksum_ += b;      // update checksum
-        QS_INSERT_BYTE(b)  // ASCII characters don't need escaping
-        QS_PTR_INC_(s);
-        b = static_cast<uint8_t>(*s);
-        ++used_;
-    }
-    QS_INSERT_BYTE(static_cast<uint8_t>(0)) // zero-terminate the string
-    ++used_;
-
-    priv_.head   = head_;    // save the head
-    priv_.chksum = chksum_;  // save the checksum
-    priv_.used   = used_;    // save # of used buffer space
+#ifdef QS_DROP_NEWEST
+    dropRoom_(strRoom_(s)); // no room for the string?
+#endif // QS_DROP_NEWEST
+    uint8_t chksum_ = QS_RING_.chksum; // put in a temporary (register)
+    QSCtr   used_   = QS_RING_.used;   // put in a temporary (register)
+
+    QS_RING_.head   = insertStr(QS_RING_.buf, QS_RING_.head, QS_RING_.end,
+                                s, QS_STR_MAX_(QS_RING_.buf, QS_RING_.head,
+                                               QS_RING_.end),
+                                &chksum_, &used_);
+    QS_RING_.chksum = chksum_;  // save the checksum
+    QS_RING_.used   = used_;    // save # of used buffer space
 }
 
 //****************************************************************************
 /// @description
-/// This function delivers one byte at a time from the QS data buffer.
-///
-/// @returns the byte in the least-significant 8-bits of the 16-bit return
-/// value if the byte is available. If no more data is available at the time,
-/// the function returns QP::QS_EOD (End-Of-Data).
+/// Inserts @p n bytes from @p blk into the QS buffer with the HDLC escaping.
+/// As long as a whole chunk of #QS_ESC_CHUNK bytes fits before the end of
+/// the buffer, the chunk is copied and checksummed at once by
+/// QP::QS_escChunk_(). Only the chunks that contain bytes to escape and the
+/// bytes at the end of the buffer take the byte-by-byte path, so the output
+/// is the same as with #QS_INSERT_ESC_BYTE.
 ///
-/// @note QP::QS::getByte() is __not__ protected with a critical section.
+/// @note This function is only to be used through macros, never in the
+/// client code directly.
 ///
-uint16_t QS::getByte(void) {
-    uint16_t ret;
-    if (priv_.used == static_cast<QSCtr>(0)) {
-        ret = QS_EOD; // set End-Of-Data
+void QS::memBlk_(uint8_t const *blk, QSCtr n) {
+    uint8_t chksum_ = QS_RING_.chksum; // put in a temporary (register)
+    uint8_t *buf_   = QS_RING_.buf;    // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;   // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;    // put in a temporary (register)
+    QSCtr const chunk = static_cast<QSCtr>(QS_ESC_CHUNK);
+    uint8_t b;
+
+    QS_RING_.used += n; // n bytes about to be added (escapes counted later)
+
+    while (n != static_cast<QSCtr>(0)) {
+        // a whole chunk left and it fits before the end of the buffer?
+        if ((n >= chunk) && (static_cast<QSCtr>(end_ - head_) >= chunk)) {
+            if (!QS_escChunk_(&QS_PTR_AT_(buf_, head_), blk, &b)) {
+                chksum_ = static_cast<uint8_t>(chksum_ + b);
+                head_ += chunk;
+                if (head_ == end_) {
+                    head_ = static_cast<QSCtr>(0);
+                }
+                blk = &QS_PTR_AT_(blk, chunk);
+            }
+            else { // some bytes in the chunk need escaping
+                for (QSCtr i = static_cast<QSCtr>(0); i < chunk; ++i) {
+                    b = *blk;
+                    QS_INSERT_ESC_BYTE(b)
+                    QS_PTR_INC_(blk);
+                }
+            }
+            n -= chunk;
+        }
+        else {
+            b = *blk;
+            QS_INSERT_ESC_BYTE(b)
+            QS_PTR_INC_(blk);
+            --n;
+        }
     }
-    else {
-        uint8_t *buf_ = priv_.buf;  // put in a temporary (register)
-        QSCtr tail_   = priv_.tail; // put in a temporary (register)
 
-        // the byte to return
-        ret = static_cast<uint16_t>(QS_PTR_AT_(buf_, tail_));
+    QS_RING_.head   = head_;    // save the head
+    QS_RING_.chksum = chksum_;  // save the checksum
+}
 
-        ++tail_;  // advance the tail
-        if (tail_ == priv_.end) {  // tail wrap around?
-            tail_ = static_cast<QSCtr>(0);
-        }
-        priv_.tail = tail_;  // update the tail
-        --priv_.used;        // one less byte used
+#ifdef QS_COMPACT
+
+//****************************************************************************
+/// @note This function is only to be used through macros, never in the
+/// client code directly.
+///
+void QS::varint_(uint64_t v) {
+    uint8_t chksum_ = QS_RING_.chksum; // put in a temporary (register)
+    uint8_t *buf_   = QS_RING_.buf;    // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;   // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;    // put in a temporary (register)
+    QSCtr   n       = static_cast<QSCtr>(1); // # bytes added (w/o escapes)
+    uint8_t b;
+
+    while (v > static_cast<uint64_t>(0x7F)) {
+        b = static_cast<uint8_t>(static_cast<uint8_t>(v) | 0x80U);
+        QS_INSERT_ESC_BYTE(b)
+        v >>= 7;
+        ++n;
     }
-    return ret;  // return the byte or EOD
+    b = static_cast<uint8_t>(v); // the last byte (bit 7 clear)
+    QS_INSERT_ESC_BYTE(b)
+
+    QS_RING_.head   = head_;    // save the head
+    QS_RING_.chksum = chksum_;  // save the checksum
+    QS_RING_.used  += n;        // n bytes added
 }
 
 //****************************************************************************
 /// @description
-/// This function delivers a contiguous block of data from the QS data buffer.
+/// Looks up the pointer @p p in the open-addressing table of the interned
+/// pointers. When @p kind is the dictionary record (QP::QS_OBJ_DICT or
+/// QP::QS_FUN_DICT) and the pointer is not there yet, the pointer obtains
+/// the next free ID, unless the table is full. The bit 15 of the stored ID
+/// remembers the function pointers for QP::QS::internAll().
+///
+/// @returns the ID of the pointer or 0 if the pointer is not interned
+///
+uint_fast16_t QS::intern_(QSPtr const p, uint_fast8_t const kind) {
+    uint_fast16_t const mask = static_cast<uint_fast16_t>(QS_INTERN_SIZE - 1U);
+    uint_fast16_t i = static_cast<uint_fast16_t>(
+        (static_cast<uint32_t>(static_cast<uint32_t>(p >> 3)
+                               ^ static_cast<uint32_t>(p >> 17))
+         * static_cast<uint32_t>(0x9E3779B1U)) >> 16) & mask;
+    uint_fast16_t id = static_cast<uint_fast16_t>(0);
+
+    if (p != static_cast<QSPtr>(0)) {
+        // linear probing ends at the pointer or at an empty slot, as
+        // the table always keeps at least one slot empty
+        while ((priv_.ptrs[i] != p)
+               && (priv_.ptrs[i] != static_cast<QSPtr>(0)))
+        {
+            i = (i + static_cast<uint_fast16_t>(1)) & mask;
+        }
+        if (priv_.ptrs[i] == p) {
+            id = static_cast<uint_fast16_t>(priv_.ids[i] & 0x7FFFU);
+        }
+        else if ((kind != static_cast<uint_fast8_t>(0))
+                 && (priv_.nIds < mask))
+        {
+            ++priv_.nIds;
+            priv_.ptrs[i] = p;
+            priv_.ids[i]  = (kind == static_cast<uint_fast8_t>(QS_FUN_DICT))
+                            ? static_cast<uint16_t>(priv_.nIds | 0x8000U)
+                            : priv_.nIds;
+            id = static_cast<uint_fast16_t>(priv_.nIds);
+        }
+        else {
+            // not interned
+        }
+    }
+    return id;
+}
+
+//****************************************************************************
+/// @description
+/// Outputs the interned ID of the pointer @p p (or 0 for NULL). The
+/// pointer that has not been interned is tagged with the varint 1, after
+/// which the caller outputs the full pointer (#QS_OBJ_RAW_, #QS_FUN_RAW_),
+/// so it costs only one byte more than in the encoding without
+/// #QS_COMPACT.
+///
+/// @returns 'true' if the full pointer must follow.
+///
+/// @note This function is only to be used through macros, never in the
+/// client code directly.
+///
+bool QS::ptr_(QSPtr const p) {
+    uint_fast16_t const id = intern_(p, static_cast<uint_fast8_t>(0));
+    bool const full = (id == static_cast<uint_fast16_t>(0))
+                      && (p != static_cast<QSPtr>(0));
+    if (full) {
+        varint_(static_cast<uint64_t>(1)); // the full pointer follows
+    }
+    else {
+        varint_(static_cast<uint64_t>(id) << 1); // interned ID or NULL
+    }
+    return full;
+}
+
+//****************************************************************************
+/// @note This function is only to be used through macros, never in the
+/// client code directly.
+///
+void QS::time_(QSTimeCtr const t) {
+    if (priv_.timeSync == static_cast<uint8_t>(0)) { // time for absolute?
+        priv_.timeSync = static_cast<uint8_t>(QS_TIME_SYNC - 1U);
+        varint_((static_cast<uint64_t>(t) << 1) | static_cast<uint64_t>(1));
+    }
+    else {
+        --priv_.timeSync;
+        varint_(static_cast<uint64_t>(
+                    static_cast<QSTimeCtr>(t - priv_.lastTime)) << 1);
+    }
+    priv_.lastTime = t;
+}
+
+#endif // QS_COMPACT
+
+//****************************************************************************
+/// @description
+/// This function delivers one byte at a time from the QS data buffer.
+///
+/// @returns the byte in the least-significant 8-bits of the 16-bit return
+/// value if the byte is available. If no more data is available at the time,
+/// the function returns QP::QS_EOD (End-Of-Data).
+///
+/// @note QP::QS::getByte() is __not__ protected with a critical section.
+///
+uint16_t QS::getByte(void) {
+    uint16_t ret;
+#ifdef QS_THREAD_RINGS
+    ringMerge_(); // merge the records from the per-thread rings
+#endif
+    if (QS_OUT_USED_() == static_cast<QSCtr>(0)) {
+        ret = QS_EOD; // set End-Of-Data
+    }
+    else {
+        uint8_t *buf_ = priv_.buf;  // put in a temporary (register)
+        QSCtr tail_   = priv_.tail; // put in a temporary (register)
+
+        // the byte to return
+        ret = static_cast<uint16_t>(QS_PTR_AT_(buf_, tail_));
+
+        ++tail_;  // advance the tail
+        if (tail_ == priv_.end) {  // tail wrap around?
+            tail_ = static_cast<QSCtr>(0);
+        }
+        priv_.tail = tail_;  // update the tail
+        --priv_.used;        // one less byte used
+    }
+    return ret;  // return the byte or EOD
+}
+
+//****************************************************************************
+/// @description
+/// This function delivers a contiguous block of data from the QS data buffer.
 /// The function returns the pointer to the beginning of the block, and writes
 /// the number of bytes in the block to the location pointed to by @a pNbytes.
 /// The argument @a pNbytes is also used as input to provide the maximum size
@@ -748,7 +1798,10 @@ uint16_t QS::getByte(void) {
 /// @note QP::QS::getBlock() is __not__ protected with a critical section.
 ///
 uint8_t const *QS::getBlock(uint16_t * const pNbytes) {
-    QSCtr used_ = priv_.used;  // put in a temporary (register)
+#ifdef QS_THREAD_RINGS
+    ringMerge_(); // merge the records from the per-thread rings
+#endif
+    QSCtr used_ = QS_OUT_USED_();  // put in a temporary (register)
     uint8_t *buf_;
 
     // any bytes used in the ring buffer?
@@ -780,9 +1833,455 @@ uint8_t const *QS::getBlock(uint16_t * const pNbytes) {
     return buf_;
 }
 
+//****************************************************************************
+/// @description
+/// This function provides the data in the QS data buffer as (at most) two
+/// contiguous blocks, without removing the data from the buffer, so that
+/// a QS output thread can send the whole buffer with a single gather
+/// write (e.g., writev()) and then free the bytes actually sent with
+/// QP::QS::freeBlocks().
+///
+/// @param[out] blk the pointers to the blocks (the tail first)
+/// @param[out] len the number of bytes in the blocks
+///
+/// @returns the number of the blocks (0 when the QS buffer is empty, or
+/// 2 when the data wraps around the end of the buffer).
+///
+/// @note QP::QS::peekBlocks() and QP::QS::freeBlocks() must be called
+/// inside the critical section, unless the QS records are produced only
+/// in the per-thread rings (#QS_THREAD_RINGS). When the QS buffer has
+/// been overrun in between (see QP::QS::priv_.lost), the tail has already
+/// moved and the peeked bytes must not be freed.
+///
+uint_fast8_t QS::peekBlocks(uint8_t const *blk[2], QSCtr len[2]) {
+#ifdef QS_THREAD_RINGS
+    ringMerge_(); // merge the records from the per-thread rings
+#endif
+    QSCtr used_ = QS_OUT_USED_();  // put in a temporary (register)
+    uint_fast8_t nBlk = static_cast<uint_fast8_t>(0);
+
+    if (used_ != static_cast<QSCtr>(0)) { // any bytes used?
+        QSCtr tail_ = priv_.tail; // put in a temporary (register)
+        QSCtr n = static_cast<QSCtr>(priv_.end - tail_);
+        if (n > used_) {
+            n = used_;
+        }
+        blk[0] = &QS_PTR_AT_(priv_.buf, tail_);
+        len[0] = n;
+        ++nBlk;
+        if (n < used_) { // wrap around?
+            blk[1] = &QS_PTR_AT_(priv_.buf, 0);
+            len[1] = static_cast<QSCtr>(used_ - n);
+            ++nBlk;
+        }
+    }
+    return nBlk;
+}
+
+//****************************************************************************
+/// @description
+/// This function removes @p n bytes (obtained from QP::QS::peekBlocks())
+/// from the tail of the QS data buffer.
+///
+void QS::freeBlocks(QSCtr const n) {
+    /// @pre cannot free more bytes than used
+    Q_REQUIRE_ID(510, n <= priv_.used);
+
+    QSCtr tail_ = static_cast<QSCtr>(priv_.tail + n);
+    if (tail_ >= priv_.end) { // tail wrap around?
+        tail_ -= priv_.end;
+    }
+    priv_.tail  = tail_;
+    priv_.used -= n;
+}
+
+//****************************************************************************
+/// @description
+/// Arms the watermark of the QS data buffer. As soon as a QS record fills
+/// the buffer to @p wmark bytes (or more), QS invokes #QS_WMARK_HOOK_ and
+/// disarms the watermark, so the hook is not invoked again until the QS
+/// output thread drains the buffer and arms the watermark again.
+///
+/// @param[in] wmark the number of used bytes, or 0 to disarm
+///
+/// @note The watermark applies to the main QS buffer written by the
+/// records, so it is not used with #QS_THREAD_RINGS.
+///
+void QS::setWatermark(QSCtr const wmark) {
+    /// @pre the watermark must be reachable in the QS buffer
+    Q_REQUIRE_ID(520, wmark <= priv_.end);
+
+    priv_.wmark = (wmark != static_cast<QSCtr>(0))
+                  ? wmark
+                  : static_cast<QSCtr>(~static_cast<QSCtr>(0));
+}
+
+//****************************************************************************
+/// @description
+/// Produces the QP::QS_OVERRUN record when any QS data has been lost since
+/// the previous report. The record is the last application-specific
+/// record (QP::QS_USER + 54, because QSPY reserves the IDs above it), so
+/// it is formatted like the records of QS_BEGIN() and it follows its own
+/// QS_USR_DICT record, which QSPY needs to display it by name. The record
+/// contains the time stamp and the numbers since the previous report of:
+/// - the bytes of the old records overwritten in the QS buffer (u32);
+/// - the records dropped in the full per-thread rings (u32, see
+///   #QS_THREAD_RINGS);
+/// - the records dropped in the full QS buffer (u32, see #QS_DROP_NEWEST);
+/// - the bytes of these dropped records (u32);
+/// - the waits for the QS output (u32, see #QS_BLOCK_PRODUCER).
+///
+/// This function should be called periodically by the QS output, such as
+/// the QS flusher in the POSIX port, so the time stamps of the reports
+/// show when the data has been lost.
+///
+/// @returns 'true' if the QP::QS_OVERRUN record has been produced.
+///
+bool QS::overrunReport(void) {
+    QS_CRIT_STAT_
+
+    QS_CRIT_ENTRY_();
+    uint32_t const nBytes = priv_.lost - priv_.lostRep;
+#ifdef QS_THREAD_RINGS
+    uint32_t const nRecs = getRingLost() - priv_.ringRep;
+#else
+    uint32_t const nRecs = static_cast<uint32_t>(0);
+#endif
+#ifdef QS_DROP_NEWEST
+    uint32_t const nDrop   = priv_.dropRecs  - priv_.dropRep;
+    uint32_t const nDropB  = priv_.dropBytes - priv_.dropBRep;
+    uint32_t const nBlocks = priv_.blocks    - priv_.blockRep;
+#else
+    uint32_t const nDrop   = static_cast<uint32_t>(0);
+    uint32_t const nDropB  = static_cast<uint32_t>(0);
+    uint32_t const nBlocks = static_cast<uint32_t>(0);
+#endif
+    bool report = (nBytes != static_cast<uint32_t>(0))
+                  || (nRecs != static_cast<uint32_t>(0))
+                  || (nDrop != static_cast<uint32_t>(0))
+                  || (nBlocks != static_cast<uint32_t>(0));
+    if (report) {
+        priv_.lostRep += nBytes;
+        priv_.ringRep += nRecs;
+#ifdef QS_DROP_NEWEST
+        priv_.dropRep  += nDrop;
+        priv_.dropBRep += nDropB;
+        priv_.blockRep += nBlocks;
+#endif
+        beginRec(static_cast<uint_fast8_t>(QS_USR_DICT));
+        QS_U8_(static_cast<uint8_t>(QS_OVERRUN));
+        QS_STR_("QS_OVERRUN");
+        endRec();
+
+        beginRec(static_cast<uint_fast8_t>(QS_OVERRUN));
+        QS_TIME_();
+        u32(static_cast<uint8_t>(U32_T), nBytes);
+        u32(static_cast<uint8_t>(U32_T), nRecs);
+        u32(static_cast<uint8_t>(U32_T), nDrop);
+        u32(static_cast<uint8_t>(U32_T), nDropB);
+        u32(static_cast<uint8_t>(U32_T), nBlocks);
+        endRec();
+    }
+    QS_CRIT_EXIT_();
+    return report;
+}
+
+#ifdef QS_BLOCK_PRODUCER
+//****************************************************************************
+/// @description
+/// Called at the QS_BEGIN gates outside of critical sections when less
+/// than #QS_DROP_RESERVE bytes are free in the QS buffer. Waits for the QS
+/// output to free some room through #QS_BLOCK_HOOK_, so the record that
+/// follows does not need to be dropped.
+///
+/// @note This function is only to be used through macros, never in the
+/// client code directly.
+///
+void QS::block_(void) {
+    QS_CRIT_STAT_
+
+    QS_CRIT_ENTRY_();
+    if (priv_.used > priv_.dropLevel) { // still no room for a record?
+        ++priv_.blocks;
+        QS_BLOCK_HOOK_(); // wait for the QS output
+    }
+    QS_CRIT_EXIT_();
+}
+#endif // QS_BLOCK_PRODUCER
+
+//****************************************************************************
+//! produce the signal dictionary record (in a critical section)
+static void sigDictRec_(QSignal const sig, void const * const obj,
+                        char_t const * const name)
+{
+    QS::beginRec(static_cast<uint_fast8_t>(QS_SIG_DICT));
+    QS_SIG_RAW_(sig);
+    QS_OBJ_PTR_(obj);
+    QS_STR_(name);
+    QS::endRec();
+}
+
+//****************************************************************************
+//! produce the object dictionary record (in a critical section)
+static void objDictRec_(void const * const obj, char_t const * const name) {
+    QS::beginRec(static_cast<uint_fast8_t>(QS_OBJ_DICT));
+#ifdef QS_COMPACT
+    QS::varint_(static_cast<uint64_t>(  // the interned ID (0 if full)...
+        QS::intern_(reinterpret_cast<QSPtr>(obj),
+                    static_cast<uint_fast8_t>(QS_OBJ_DICT))) << 1);
+#endif // QS_COMPACT
+    QS_OBJ_RAW_(obj); // ...and the full pointer
+    QS_STR_(name);
+    QS::endRec();
+}
+
+//****************************************************************************
+//! produce the function dictionary record (in a critical section)
+static void funDictRec_(void (* const fun)(void),
+                        char_t const * const name)
+{
+    QS::beginRec(static_cast<uint_fast8_t>(QS_FUN_DICT));
+#ifdef QS_COMPACT
+    QS::varint_(static_cast<uint64_t>(  // the interned ID (0 if full)...
+        QS::intern_(reinterpret_cast<QSPtr>(fun),
+                    static_cast<uint_fast8_t>(QS_FUN_DICT))) << 1);
+#endif // QS_COMPACT
+    QS_FUN_RAW_(fun); // ...and the full pointer
+    QS_STR_(name);
+    QS::endRec();
+}
+
+#ifdef QS_COMPACT
+
+//****************************************************************************
+/// @description
+/// Produces the object and function dictionary records with an empty name
+/// for all the interned pointers, so that the host attached to a running
+/// Target (or the host that lost the dictionary records) can map the IDs
+/// back to the pointers. This function is called after the Target info
+/// requested by the host through QS-RX, but can be called also directly
+/// (e.g., periodically from the idle callback).
+///
+/// @note
+/// This function calls QP::QS::onFlush() after every dictionary record,
+/// just as the dictionary functions.
+///
+void QS::internAll(void) {
+    QS_CRIT_STAT_
+
+    for (uint_fast16_t i = static_cast<uint_fast16_t>(0);
+         i < static_cast<uint_fast16_t>(QS_INTERN_SIZE); ++i)
+    {
+        QS_CRIT_ENTRY_();
+        QSPtr const p = priv_.ptrs[i];
+        if (p == static_cast<QSPtr>(0)) {
+            // empty slot
+        }
+        else if ((priv_.ids[i] & 0x8000U) != 0U) { // function?
+            funDictRec_(reinterpret_cast<void (*)(void)>(p), "");
+        }
+        else {
+            objDictRec_(reinterpret_cast<void const *>(p), "");
+        }
+        QS_CRIT_EXIT_();
+        if (p != static_cast<QSPtr>(0)) {
+            onFlush();
+        }
+    }
+}
+
+#endif // QS_COMPACT
+
+#ifdef QS_LAZY_DICT
+
+//****************************************************************************
+//! index of the first slot to probe for the dictionary @p key
+static inline uint_fast16_t dictHash_(uint_fast8_t const kind,
+                                      QSPtr const key)
+{
+    uint32_t const k = (kind == static_cast<uint_fast8_t>(QS::DICT_SIG))
+        ? static_cast<uint32_t>(key) // signals are small consecutive values
+        : static_cast<uint32_t>(static_cast<uint32_t>(key >> 3)
+                                ^ static_cast<uint32_t>(key >> 17));
+    return static_cast<uint_fast16_t>(
+               (k * static_cast<uint32_t>(0x9E3779B1U)) >> 16)
+           & static_cast<uint_fast16_t>(QS_DICT_SIZE - 1U);
+}
+
+//****************************************************************************
+//! register the dictionary in a critical section (see #QS_LAZY_DICT)
+//! @returns false if the table of the dictionaries is full
+static bool dictAdd_(uint_fast8_t const kind, QSPtr const key,
+                     void const * const obj, void (* const fun)(void),
+                     char_t const * const name)
+{
+    uint_fast16_t const mask = static_cast<uint_fast16_t>(QS_DICT_SIZE - 1U);
+    uint_fast16_t const home = dictHash_(kind, key);
+    uint_fast16_t i = home;
+    QS::QSDict *d = &QS::priv_.dict[i];
+
+    // linear probing ends at the same dictionary or at an empty slot, as
+    // the table always keeps at least one slot empty
+    while ((d->kind != static_cast<uint8_t>(0))
+           && ((d->kind != static_cast<uint8_t>(kind))
+               || (d->key != key)
+               || ((kind == static_cast<uint_fast8_t>(QS::DICT_SIG))
+                   && (d->ptr.obj != obj))))
+    {
+        i = (i + static_cast<uint_fast16_t>(1)) & mask;
+        d = &QS::priv_.dict[i];
+    }
+
+    bool added = true;
+    if (d->kind == static_cast<uint8_t>(0)) { // new dictionary?
+        if (QS::priv_.dictNum < static_cast<uint16_t>(mask)) {
+            ++QS::priv_.dictNum;
+            ++QS::priv_.dictLeft;
+            ++QS::priv_.dict[home].homeLeft;
+            d->key   = key;
+            d->kind  = static_cast<uint8_t>(kind);
+            d->state = static_cast<uint8_t>(DICT_NEW);
+        }
+        else {
+            added = false; // the table is full
+        }
+    }
+    else if (d->state == static_cast<uint8_t>(DICT_DONE)) { // re-defined?
+        ++QS::priv_.dictLeft;
+        ++QS::priv_.dict[home].homeLeft;
+        d->state = static_cast<uint8_t>(DICT_NEW); // produce it again
+    }
+    else {
+        // not produced yet
+    }
+    if (added) {
+        if (kind == static_cast<uint_fast8_t>(QS::DICT_FUN)) {
+            d->ptr.fun = fun;
+        }
+        else {
+            d->ptr.obj = obj;
+        }
+        d->name = name;
+    }
+    return added;
+}
+
+//****************************************************************************
+//! produce the dictionary record of the registered dictionary @p d
+static void dictRec_(QS::QSDict * const d) {
+    if (d->state != static_cast<uint8_t>(DICT_DONE)) {
+        d->state = static_cast<uint8_t>(DICT_DONE);
+        --QS::priv_.dictLeft;
+        --QS::priv_.dict[dictHash_(d->kind, d->key)].homeLeft;
+    }
+    switch (d->kind) {
+        case QS::DICT_OBJ: {
+            objDictRec_(d->ptr.obj, d->name);
+            break;
+        }
+        case QS::DICT_FUN: {
+            funDictRec_(d->ptr.fun, d->name);
+            break;
+        }
+        default: { // QS::DICT_SIG
+            sigDictRec_(static_cast<QSignal>(d->key), d->ptr.obj, d->name);
+            break;
+        }
+    }
+}
+
+//****************************************************************************
+//! produce the dictionaries used in the just completed record
+static void dictFlush_(void) {
+    uint_fast8_t const n = static_cast<uint_fast8_t>(QS::priv_.dictNPend);
+    QS::priv_.dictNPend = static_cast<uint8_t>(0); // the records below
+                                                   // add no pending dicts
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0); i < n; ++i) {
+        QS::QSDict * const d = &QS::priv_.dict[QS::priv_.dictPend[i]];
+        if (d->state == static_cast<uint8_t>(DICT_PEND)) { // still pending?
+            dictRec_(d);
+        }
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Marks the registered dictionaries of the object, function or signal
+/// @p key (all the signal dictionaries of the signal) as pending, so that
+/// their records are produced right after the current QS record.
+///
+/// The cost is a hash and one check of the slot, to which the @p key
+/// hashes, for every key without a dictionary to be produced (such as the
+/// keys with the dictionaries already produced or without any
+/// dictionary). Only when a dictionary hashed to this slot (of this or of
+/// a colliding key) is still to be produced, the table is probed up to
+/// the next empty slot (the cluster), which stays short as long as
+/// #QS_DICT_SIZE leaves enough empty slots in the table.
+///
+/// @note This function is only to be used through macros #QS_OBJ_,
+/// #QS_FUN_ and #QS_SIG_ inside a QS record (in a critical section).
+///
+void QS::dictUse_(uint_fast8_t const kind, QSPtr const key) {
+    uint_fast16_t const mask = static_cast<uint_fast16_t>(QS_DICT_SIZE - 1U);
+    uint_fast16_t i = dictHash_(kind, key);
+
+    // any dictionary hashed to this slot still to be produced?
+    if (priv_.dict[i].homeLeft != static_cast<uint16_t>(0)) {
+        QSDict *d = &priv_.dict[i];
+        while (d->kind != static_cast<uint8_t>(0)) {
+            if ((d->kind == static_cast<uint8_t>(kind))
+                && (d->key == key)
+                && (d->state == static_cast<uint8_t>(DICT_NEW))
+                && (priv_.dictNPend
+                    < static_cast<uint8_t>(Q_DIM(priv_.dictPend))))
+            {
+                d->state = static_cast<uint8_t>(DICT_PEND);
+                priv_.dictPend[priv_.dictNPend] = static_cast<uint16_t>(i);
+                ++priv_.dictNPend;
+            }
+            i = (i + static_cast<uint_fast16_t>(1)) & mask;
+            d = &priv_.dict[i];
+        }
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Produces the dictionary records of all the registered dictionaries,
+/// regardless whether they were already produced or not. This function is
+/// called upon the QP::QS_RX_DICT request from the host (e.g., after the
+/// host attached to a running target), but can be called also directly.
+///
+/// @note
+/// This function calls QP::QS::onFlush() after every dictionary record,
+/// just as the dictionary functions without #QS_LAZY_DICT.
+///
+void QS::dictAll(void) {
+    QS_CRIT_STAT_
+
+    for (uint_fast16_t i = static_cast<uint_fast16_t>(0);
+         i < static_cast<uint_fast16_t>(QS_DICT_SIZE); ++i)
+    {
+        QS_CRIT_ENTRY_();
+        bool const used = (priv_.dict[i].kind != static_cast<uint8_t>(0));
+        if (used) {
+            dictRec_(&priv_.dict[i]);
+        }
+        QS_CRIT_EXIT_();
+        if (used) {
+            onFlush();
+        }
+    }
+}
+
+#endif // QS_LAZY_DICT
+
 //****************************************************************************
 /// @note This function is only to be used through macro QS_SIG_DICTIONARY()
 ///
+/// @note With #QS_LAZY_DICT, the function only registers the dictionary
+/// (the @p name must be a static string), see QP::QS::dictUse_().
+///
 void QS::sig_dict(enum_t const sig, void const * const obj,
                   char_t const *name)
 {
@@ -792,18 +2291,30 @@ void QS::sig_dict(enum_t const sig, void const * const obj,
         QS_PTR_INC_(name);
     }
     QS_CRIT_ENTRY_();
-    beginRec(static_cast<uint_fast8_t>(QS_SIG_DICT));
-    QS_SIG_(static_cast<QSignal>(sig));
-    QS_OBJ_(obj);
-    QS_STR_(name);
-    endRec();
+#ifdef QS_LAZY_DICT
+    bool const eager = !dictAdd_(static_cast<uint_fast8_t>(DICT_SIG),
+                                 static_cast<QSPtr>(sig), obj,
+                                 static_cast<void (*)(void)>(0), name);
+    if (eager) { // the table of the dictionaries full?
+        sigDictRec_(static_cast<QSignal>(sig), obj, name);
+    }
+    QS_CRIT_EXIT_();
+    if (eager) {
+        onFlush();
+    }
+#else
+    sigDictRec_(static_cast<QSignal>(sig), obj, name);
     QS_CRIT_EXIT_();
     onFlush();
+#endif // QS_LAZY_DICT
 }
 
 //****************************************************************************
 /// @note This function is only to be used through macro QS_OBJ_DICTIONARY()
 ///
+/// @note With #QS_LAZY_DICT, the function only registers the dictionary
+/// (the @p name must be a static string), see QP::QS::dictUse_().
+///
 void QS::obj_dict(void const * const obj,
                   char_t const *name)
 {
@@ -813,17 +2324,30 @@ void QS::obj_dict(void const * const obj,
         QS_PTR_INC_(name);
     }
     QS_CRIT_ENTRY_();
-    beginRec(static_cast<uint_fast8_t>(QS_OBJ_DICT));
-    QS_OBJ_(obj);
-    QS_STR_(name);
-    endRec();
+#ifdef QS_LAZY_DICT
+    bool const eager = !dictAdd_(static_cast<uint_fast8_t>(DICT_OBJ),
+                                 reinterpret_cast<QSPtr>(obj), obj,
+                                 static_cast<void (*)(void)>(0), name);
+    if (eager) { // the table of the dictionaries full?
+        objDictRec_(obj, name);
+    }
+    QS_CRIT_EXIT_();
+    if (eager) {
+        onFlush();
+    }
+#else
+    objDictRec_(obj, name);
     QS_CRIT_EXIT_();
     onFlush();
+#endif // QS_LAZY_DICT
 }
 
 //****************************************************************************
 /// @note This function is only to be used through macro QS_FUN_DICTIONARY()
 ///
+/// @note With #QS_LAZY_DICT, the function only registers the dictionary
+/// (the @p name must be a static string), see QP::QS::dictUse_().
+///
 void QS::fun_dict(void (* const fun)(void), char_t const *name) {
     QS_CRIT_STAT_
 
@@ -831,12 +2355,22 @@ void QS::fun_dict(void (* const fun)(void), char_t const *name) {
         QS_PTR_INC_(name);
     }
     QS_CRIT_ENTRY_();
-    beginRec(static_cast<uint_fast8_t>(QS_FUN_DICT));
-    QS_FUN_(fun);
-    QS_STR_(name);
-    endRec();
+#ifdef QS_LAZY_DICT
+    bool const eager = !dictAdd_(static_cast<uint_fast8_t>(DICT_FUN),
+                                 reinterpret_cast<QSPtr>(fun),
+                                 static_cast<void const *>(0), fun, name);
+    if (eager) { // the table of the dictionaries full?
+        funDictRec_(fun, name);
+    }
+    QS_CRIT_EXIT_();
+    if (eager) {
+        onFlush();
+    }
+#else
+    funDictRec_(fun, name);
     QS_CRIT_EXIT_();
     onFlush();
+#endif // QS_LAZY_DICT
 }
 
 //****************************************************************************
@@ -855,33 +2389,607 @@ void QS::usr_dict(enum_t const rec,
     onFlush();
 }
 
+#ifdef QS_SAMPLING
+
+//****************************************************************************
+/// @description
+/// Configures the QS records of the type @p rec (optionally only those
+/// about the signal @p sig) to be produced only once per @p n records
+/// (when @p n > 1), or at most once per @p interval of the QS time stamp
+/// (when @p n is 0 or 1). Calling the function with @p n <= 1 and
+/// @p interval == 0 stops the sampling of the given records.
+///
+/// @param[in] rec      the maskable QS record type to sample
+/// @param[in] sig      the signal to sample or 0 for all signals
+/// @param[in] n        produce 1 in @p n records (0 for time-based)
+/// @param[in] interval minimum time between produced records
+///
+/// @note
+/// The signal applies only to the records produced with the signal known
+/// at the QS_BEGIN gate (the event posting, publishing, retrieving and
+/// dispatching records). The sampling of a signal takes precedence over
+/// the sampling of all signals of the same record type.
+///
+/// @note
+/// Every sampled record carries the number of records skipped before it
+/// (uint16_t, saturated) right after the record ID. The configuration is
+/// reported in the QP::QS_SAMPLE_CFG record.
+///
+/// @usage
+/// @code
+/// QS_FILTER_ON(QS_ALL_RECORDS);
+/// QP::QS::sample(QP::QS_QEP_DISPATCH, 0, 100U, 0U); // 1 in 100
+/// QP::QS::sample(QP::QS_QF_PUBLISH, TIMEOUT_SIG, 0U, 1000U); // 1 per 1000
+/// @endcode
+///
+void QS::sample(uint_fast8_t const rec, enum_t const sig,
+                uint16_t const n, QSTimeCtr const interval)
+{
+    // only the maskable records can be sampled
+    Q_REQUIRE_ID(410, (rec > static_cast<uint_fast8_t>(QS_EMPTY))
+        && ((rec < static_cast<uint_fast8_t>(QS_SIG_DICT))
+            || (rec >= static_cast<uint_fast8_t>(QS_USER))));
+
+    QSignal const s = static_cast<QSignal>(sig);
+    bool const on = (n > static_cast<uint16_t>(1))
+                    || (interval != static_cast<QSTimeCtr>(0));
+    uint_fast8_t free = static_cast<uint_fast8_t>(QS_SAMPLE_MAX);
+    uint_fast8_t i;
+    QS_CRIT_STAT_
+
+    QS_CRIT_ENTRY_();
+    for (i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(QS_SAMPLE_MAX); ++i)
+    {
+        if (priv_.smpl[i].rec == static_cast<uint8_t>(0)) {
+            if (free == static_cast<uint_fast8_t>(QS_SAMPLE_MAX)) {
+                free = i;
+            }
+        }
+        else if ((priv_.smpl[i].rec == static_cast<uint8_t>(rec))
+                 && (priv_.smpl[i].sig == s))
+        {
+            break; // reconfigure the existing entry
+        }
+        else {
+            // keep looking
+        }
+    }
+    if (i == static_cast<uint_fast8_t>(QS_SAMPLE_MAX)) { // new entry?
+        i = free;
+    }
+
+    if (on) {
+        // the sampling table must not overflow
+        Q_ASSERT_ID(420, i < static_cast<uint_fast8_t>(QS_SAMPLE_MAX));
+
+        QSSample * const smpl = &priv_.smpl[i];
+        smpl->rec      = static_cast<uint8_t>(rec);
+        smpl->sig      = s;
+        smpl->n        = n;
+        smpl->ctr      = static_cast<uint16_t>(0); // produce the next record
+        smpl->skip     = static_cast<uint16_t>(0);
+        smpl->interval = interval;
+        smpl->last     = static_cast<QSTimeCtr>(onGetTime() - interval);
+    }
+    else if (i < static_cast<uint_fast8_t>(QS_SAMPLE_MAX)) {
+        priv_.smpl[i].rec = static_cast<uint8_t>(0); // free the entry
+    }
+    else {
+        // nothing to remove
+    }
+
+    // re-compute the set of the sampled record types
+    for (i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(sizeof(priv_.smplFilter)); ++i)
+    {
+        priv_.smplFilter[i] = static_cast<uint8_t>(0);
+    }
+    for (i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(QS_SAMPLE_MAX); ++i)
+    {
+        uint8_t const r = priv_.smpl[i].rec;
+        if (r != static_cast<uint8_t>(0)) {
+            priv_.smplFilter[r >> 3] |= static_cast<uint8_t>(
+                1U << (r & static_cast<uint8_t>(7)));
+        }
+    }
+
+    beginRec(static_cast<uint_fast8_t>(QS_SAMPLE_CFG));
+    QS_U8_(static_cast<uint8_t>(rec));
+    QS_SIG_(s);
+    QS_U16_(n);
+    QS_U32_(static_cast<uint32_t>(interval));
+    endRec();
+    QS_CRIT_EXIT_();
+    onFlush();
+}
+
+//****************************************************************************
+/// @description
+/// Called at the QS_BEGIN gate (inside the critical section) for the
+/// sampled record types only. Returns true if the record @p rec about the
+/// signal @p sig should be produced and remembers the number of the
+/// records skipped before it for QP::QS::beginRec().
+///
+/// @note This function is only to be used through macros, never in the
+/// client code directly.
+///
+bool QS::sample_(uint_fast8_t const rec, QSignal const sig) {
+    QSSample *smpl = static_cast<QSSample *>(0);
+    bool produce = true;
+
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(QS_SAMPLE_MAX); ++i)
+    {
+        QSSample * const e = &priv_.smpl[i];
+        if (e->rec == static_cast<uint8_t>(rec)) {
+            if (e->sig == sig) {
+                smpl = e; // the exact match wins
+                break;
+            }
+            else if (e->sig == static_cast<QSignal>(0)) {
+                smpl = e; // all signals, but keep looking for exact match
+            }
+            else {
+                // different signal
+            }
+        }
+    }
+
+    if (smpl == static_cast<QSSample *>(0)) { // not sampled?
+        priv_.smplSkip = static_cast<uint16_t>(0);
+    }
+    else {
+        if (smpl->n > static_cast<uint16_t>(1)) { // 1 in n?
+            if (smpl->ctr == static_cast<uint16_t>(0)) {
+                smpl->ctr = static_cast<uint16_t>(smpl->n - 1U);
+            }
+            else {
+                --smpl->ctr;
+                produce = false;
+            }
+        }
+        else { // time-based
+            QSTimeCtr const t = onGetTime();
+            if (static_cast<QSTimeCtr>(t - smpl->last) >= smpl->interval) {
+                smpl->last = t;
+            }
+            else {
+                produce = false;
+            }
+        }
+
+        if (produce) {
+            priv_.smplSkip = smpl->skip;
+            smpl->skip = static_cast<uint16_t>(0);
+        }
+        else if (smpl->skip != static_cast<uint16_t>(0xFFFFU)) {
+            ++smpl->skip; // saturate the skipped count
+        }
+        else {
+            // saturated
+        }
+    }
+    return produce;
+}
+
+#endif // QS_SAMPLING
+
+#ifdef QS_TRIGGER
+
+//****************************************************************************
+//! re-compute the armed triggers (in a critical section)
+static void trgUpdate_(void) {
+    uint_fast8_t i;
+
+    for (i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(sizeof(QS::priv_.trgRecs)); ++i)
+    {
+        QS::priv_.trgRecs[i] = static_cast<uint8_t>(0);
+    }
+    QS::priv_.trgArmed = static_cast<uint8_t>(0);
+
+    if (QS::priv_.trgState == static_cast<uint8_t>(QS::TRG_ARMED)) {
+        for (i = static_cast<uint_fast8_t>(0);
+             i < static_cast<uint_fast8_t>(QS_TRG_MAX); ++i)
+        {
+            QS::QSTrg const * const t = &QS::priv_.trg[i];
+            if (t->kind != static_cast<uint8_t>(QS::TRG_NONE)) {
+                QS::priv_.trgArmed |= static_cast<uint8_t>(1U << t->kind);
+                if (t->kind == static_cast<uint8_t>(QS::TRG_REC)) {
+                    QS::priv_.trgRecs[t->rec >> 3] |= static_cast<uint8_t>(
+                        1U << (t->rec & static_cast<uint8_t>(7)));
+                }
+            }
+        }
+    }
+}
+
+//****************************************************************************
+//! restore the global filters saved when the capture completed
+//! (in a critical section)
+static void trgThaw_(void) {
+    if (QS::priv_.trgState == static_cast<uint8_t>(QS::TRG_DONE)) {
+        for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+             i < static_cast<uint_fast8_t>(sizeof(QS::priv_.glbFilter)); ++i)
+        {
+            QS::priv_.glbFilter[i] = QS::priv_.trgFilter[i];
+        }
+    }
+}
+
+//****************************************************************************
+//! fire the trigger number @p idx (0xFF from the application) measured
+//! at @p value: release the pre-trigger window for the output and mark
+//! the trigger with the QS_TRG_FIRED record (in a critical section)
+static void trgFire_(uint_fast8_t const idx, uint32_t const value) {
+    if (QS::priv_.trgState == static_cast<uint8_t>(QS::TRG_ARMED)) {
+        QSCtr const end_ = QS::priv_.end;
+        QSCtr const pre  = QS::priv_.trgPre;
+
+        if (QS::priv_.used > pre) { // more data than the pre-trigger window?
+            QSCtr tail_ = static_cast<QSCtr>(QS::priv_.tail
+                                             + (QS::priv_.used - pre));
+            QSCtr n = pre;
+            if (tail_ >= end_) { // tail wrap around?
+                tail_ -= end_;
+            }
+            // skip to the beginning of the first whole record
+            while ((n != static_cast<QSCtr>(0))
+                   && (QS_PTR_AT_(QS::priv_.buf,
+                          ((tail_ != static_cast<QSCtr>(0)) ? tail_ : end_)
+                          - static_cast<QSCtr>(1)) != QS_FRAME))
+            {
+                ++tail_;
+                if (tail_ == end_) {
+                    tail_ = static_cast<QSCtr>(0);
+                }
+                --n;
+            }
+            QS::priv_.tail = tail_;
+            QS::priv_.used = n;
+        }
+        QS::priv_.trgHead  = QS::priv_.head;
+        QS::priv_.trgDist  = static_cast<QSCtr>(0);
+        QS::priv_.trgState = static_cast<uint8_t>(QS::TRG_POST);
+        trgUpdate_(); // disarm all the triggers
+
+        // the marker is the first record after the pre-trigger window
+        QS::beginRec(static_cast<uint_fast8_t>(QS_USR_DICT));
+        QS_U8_(static_cast<uint8_t>(QS_TRG_FIRED));
+        QS_STR_("QS_TRG_FIRED");
+        QS::endRec();
+
+        QS::beginRec(static_cast<uint_fast8_t>(QS_TRG_FIRED));
+        QS_TIME_();
+        QS::u8(static_cast<uint8_t>(QS::U8_T), static_cast<uint8_t>(idx));
+        QS::u32(static_cast<uint8_t>(QS::U32_T), value);
+        QS::endRec();
+
+        if (QS::priv_.used >= QS::priv_.wmark) { // watermark reached?
+            QS::priv_.wmark = static_cast<QSCtr>(~static_cast<QSCtr>(0));
+            QS_WMARK_HOOK_(); // wake up the QS output
+        }
+    }
+}
+
+//****************************************************************************
+//! end the capture after the post-trigger window (called from
+//! QP::QS::endRec() in the QS::TRG_POST state)
+static void trgPost_(QSCtr const head_) {
+    QSCtr dist = static_cast<QSCtr>(head_ - QS::priv_.trgHead);
+    if (head_ < QS::priv_.trgHead) { // head wrap around?
+        dist += QS::priv_.end;
+    }
+
+    // post-trigger window complete or the head went over the trigger?
+    if ((dist >= QS::priv_.trgPost) || (dist < QS::priv_.trgDist)) {
+        for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+             i < static_cast<uint_fast8_t>(sizeof(QS::priv_.glbFilter)); ++i)
+        {
+            QS::priv_.trgFilter[i] = QS::priv_.glbFilter[i];
+        }
+        QS::filterOff(static_cast<uint_fast8_t>(QS_ALL_RECORDS)); // freeze
+        QS::priv_.trgState = static_cast<uint8_t>(QS::TRG_DONE);
+    }
+    else {
+        QS::priv_.trgDist = dist;
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Configures the trace trigger number @p idx, which fires (when the
+/// capture is armed, see QP::QS::trgArm()) as follows:
+/// - QP::QS::TRG_REC on the QS record @p rec that passed the filters,
+///   optionally only with the signal @p sig and the object @p obj;
+/// - QP::QS::TRG_QMIN when the minimum number of free entries of the event
+///   queue of the active object (or the raw queue) @p obj drops below
+///   @p thresh;
+/// - QP::QS::TRG_RTC when the RTC step of the active object @p obj takes
+///   longer than @p thresh in the units of QF_LATENCY_TIME_() (requires
+///   QF_LATENCY in the QF port).
+///
+/// The object @p obj of 0 matches any object. The kind QP::QS::TRG_NONE
+/// removes the trigger.
+///
+/// @usage
+/// @code
+/// QP::QS::trgSet(0U, QP::QS::TRG_REC, QP::QS_QF_ACTIVE_POST_FIFO,
+///                OVERHEAT_SIG, AO_Ctrl, 0U); // OVERHEAT posted to Ctrl
+/// QP::QS::trgSet(1U, QP::QS::TRG_QMIN, 0U, 0, AO_Ctrl, 2U);
+/// QP::QS::trgSet(2U, QP::QS::TRG_REC, QP::QS_ASSERT_FAIL, 0, 0, 0U);
+/// QP::QS::trgArm(1024U, 256U); // 1KB before and 256B after the trigger
+/// @endcode
+///
+void QS::trgSet(uint_fast8_t const idx, uint_fast8_t const kind,
+                uint_fast8_t const rec, enum_t const sig,
+                void const * const obj, uint32_t const thresh)
+{
+    /// @pre the trigger must exist and be of a known kind
+    Q_REQUIRE_ID(800, (idx < static_cast<uint_fast8_t>(QS_TRG_MAX))
+        && (kind <= static_cast<uint_fast8_t>(TRG_RTC))
+        && (rec < static_cast<uint_fast8_t>(8U*sizeof(priv_.trgRecs))));
+
+    QS_CRIT_STAT_
+
+    QS_CRIT_ENTRY_();
+    QSTrg * const t = &priv_.trg[idx];
+    t->obj    = obj;
+    t->thresh = thresh;
+    t->sig    = static_cast<QSignal>(sig);
+    t->kind   = static_cast<uint8_t>(kind);
+    t->rec    = static_cast<uint8_t>(rec);
+    trgUpdate_();
+    QS_CRIT_EXIT_();
+}
+
+//****************************************************************************
+/// @description
+/// Starts capturing the trace: the QS data buffer is no longer output, but
+/// overwritten with the newest records (without counting the lost bytes),
+/// until a trigger fires (see QP::QS::trgSet() and QP::QS::trgFire()).
+/// The trigger releases the last @p pre bytes of the buffer for the
+/// output, starting at the first whole record, and the capture completes
+/// after @p post more bytes. The complete capture freezes QS (all maskable
+/// global filters are off), so the capture is not overwritten by the newer
+/// records. Calling this function again (or QP::QS::trgDisarm()) restores
+/// the global filters.
+///
+/// @param[in] pre  the pre-trigger window (bytes)
+/// @param[in] post the post-trigger window (bytes)
+///
+/// @note
+/// Both windows together must fit into the QS buffer, with room for the
+/// record that completes the post-trigger window.
+///
+void QS::trgArm(QSCtr const pre, QSCtr const post) {
+    /// @pre both windows must fit into the QS buffer
+    Q_REQUIRE_ID(810, (pre < priv_.end) && (post < priv_.end - pre));
+
+    QS_CRIT_STAT_
+
+    QS_CRIT_ENTRY_();
+    trgThaw_();
+    priv_.trgPre   = pre;
+    priv_.trgPost  = post;
+    priv_.trgState = static_cast<uint8_t>(TRG_ARMED);
+    trgUpdate_();
+    QS_CRIT_EXIT_();
+}
+
+//****************************************************************************
+/// @description
+/// Stops capturing the trace, releases the whole QS data buffer for the
+/// output and restores the global filters (if the capture completed).
+///
+void QS::trgDisarm(void) {
+    QS_CRIT_STAT_
+
+    QS_CRIT_ENTRY_();
+    trgThaw_();
+    priv_.trgState = static_cast<uint8_t>(TRG_OFF);
+    trgUpdate_();
+    if (priv_.used >= priv_.wmark) { // watermark reached?
+        priv_.wmark = static_cast<QSCtr>(~static_cast<QSCtr>(0)); // disarm
+        QS_WMARK_HOOK_(); // wake up the QS output
+    }
+    QS_CRIT_EXIT_();
+}
+
+//****************************************************************************
+/// @description
+/// Fires the trigger from the application, for example, when it detects
+/// a fault condition that no QS record reveals. The function has no
+/// effect unless the capture is armed (see QP::QS::trgArm()).
+///
+/// @note
+/// The QP::QS_TRG_FIRED record, which marks the fired trigger in the
+/// capture, contains the time stamp, the trigger number (u8, 0xFF for this
+/// function, see QP::QS::trgSet()) and the value that fired the trigger
+/// (u32: the record type, the free entries of the queue, the RTC time, or
+/// 0 for this function).
+///
+void QS::trgFire(void) {
+    QS_CRIT_STAT_
+
+    QS_CRIT_ENTRY_();
+    trgFire_(static_cast<uint_fast8_t>(0xFF), static_cast<uint32_t>(0));
+    QS_CRIT_EXIT_();
+}
+
+//****************************************************************************
+/// @description
+/// Called at the QS_BEGIN gate (inside the critical section) only for the
+/// record types with armed QP::QS::TRG_REC triggers. Fires the trigger
+/// before the record @p rec is produced, so the record is the first one
+/// after the pre-trigger window.
+///
+/// @note This function is only to be used through macros, never in the
+/// client code directly.
+///
+void QS::trgRec_(uint_fast8_t const rec, QSignal const sig,
+                 void const * const obj)
+{
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(QS_TRG_MAX); ++i)
+    {
+        QSTrg const * const t = &priv_.trg[i];
+        if ((t->kind == static_cast<uint8_t>(TRG_REC))
+            && (t->rec == static_cast<uint8_t>(rec))
+            && ((t->sig == static_cast<QSignal>(0)) || (t->sig == sig))
+            && ((t->obj == static_cast<void const *>(0)) || (t->obj == obj)))
+        {
+            trgFire_(i, static_cast<uint32_t>(rec));
+            break;
+        }
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Called (inside the critical section) through #QS_TRG_VALUE_ where the
+/// minimum number of free entries of the event queues changes
+/// (QP::QS::TRG_QMIN) and where the RTC steps end (QP::QS::TRG_RTC).
+///
+/// @note This function is only to be used through macros, never in the
+/// client code directly.
+///
+void QS::trgValue_(uint_fast8_t const kind, void const * const obj,
+                   uint32_t const value)
+{
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(QS_TRG_MAX); ++i)
+    {
+        QSTrg const * const t = &priv_.trg[i];
+        if ((t->kind == static_cast<uint8_t>(kind))
+            && ((t->obj == static_cast<void const *>(0)) || (t->obj == obj))
+            && ((kind == static_cast<uint_fast8_t>(TRG_QMIN))
+                ? (value < t->thresh)
+                : (value > t->thresh)))
+        {
+            trgFire_(i, value);
+            break;
+        }
+    }
+}
+
+#endif // QS_TRIGGER
+
 //****************************************************************************
 /// @note This function is only to be used through macros, never in the
 /// client code directly.
 ///
 void QS::mem(uint8_t const *blk, uint8_t size) {
+#ifdef QS_DROP_NEWEST
+    // no room for the (escaped) block? see dropRoom_()
+    dropRoom_(static_cast<QSCtr>(2U * (static_cast<QSCtr>(size) + 1U)));
+#endif // QS_DROP_NEWEST
     uint8_t b = static_cast<uint8_t>(MEM_T);
-    uint8_t chksum_ = static_cast<uint8_t>(priv_.chksum + b);
-    uint8_t *buf_   = priv_.buf;   // put in a temporary (register)
-    QSCtr   head_   = priv_.head;  // put in a temporary (register)
-    QSCtr   end_    = priv_.end;   // put in a temporary (register)
+    uint8_t chksum_ = static_cast<uint8_t>(QS_RING_.chksum + b);
+    uint8_t *buf_   = QS_RING_.buf;   // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;  // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;   // put in a temporary (register)
+
+#ifdef QS_THREAD_RINGS
+    // room for the block (after the 2 bytes below), see QP::QS::QSRing
+    QSCtr room_ = ringRoom(buf_, head_, end_);
+    room_ = (room_ > static_cast<QSCtr>(2))
+            ? static_cast<QSCtr>(room_ - 2U)
+            : static_cast<QSCtr>(0);
+    if (static_cast<QSCtr>(size) > room_) {
+        size = static_cast<uint8_t>(room_); // truncate the block
+    }
+#endif // QS_THREAD_RINGS
 
-    priv_.used += (static_cast<QSCtr>(size) // size+2 bytes to be added
-                   + static_cast<QSCtr>(2));
+    QS_RING_.used += static_cast<QSCtr>(2); // 2 bytes to be added
 
     QS_INSERT_BYTE(b)
     QS_INSERT_ESC_BYTE(size)
 
-    // output the 'size' number of bytes
-    while (size != static_cast<uint8_t>(0)) {
-        b = *blk;
-        QS_INSERT_ESC_BYTE(b)
-        QS_PTR_INC_(blk);
-        --size;
+    QS_RING_.head   = head_;    // save the head
+    QS_RING_.chksum = chksum_;  // save the checksum
+
+    memBlk_(blk, static_cast<QSCtr>(size)); // output the 'size' bytes
+}
+
+//****************************************************************************
+/// @description
+/// Outputs the QP::QS::MEM_T format byte with the element type @p elemType
+/// (see QP::QS::QSArrType) in the upper nibble, the number of elements
+/// @p n (uint16_t), and the @p n elements at @p data. On a little-endian
+/// Target the elements are escaped and copied into the QS buffer in bulk
+/// (see QP::QS::memBlk_()); otherwise each element is byte-swapped.
+///
+/// @note With #QS_THREAD_RINGS, the array is truncated to the elements
+/// that still fit into the longest record (#QS_RING_REC_MAX).
+///
+/// @note This function is only to be used through macros, never in the
+/// client code directly.
+///
+void QS::arr(uint8_t const elemType, void const * const data, uint16_t n) {
+    /// @pre the element type must be one of QP::QS::QSArrType
+    Q_REQUIRE_ID(610, (static_cast<uint8_t>(ARR_U8_T) <= elemType)
+                      && (elemType <= static_cast<uint8_t>(ARR_F64_T)));
+
+    QSCtr const size = static_cast<QSCtr>(
+        l_arrElemSize[elemType - static_cast<uint8_t>(ARR_U8_T)]);
+#ifdef QS_DROP_NEWEST
+    // no room for the (escaped) elements? see dropRoom_()
+    dropRoom_(static_cast<QSCtr>(
+        2U * (static_cast<QSCtr>(static_cast<QSCtr>(n) * size) + 2U) + 1U));
+#endif // QS_DROP_NEWEST
+    uint8_t b = static_cast<uint8_t>(
+                    static_cast<uint8_t>(elemType << 4)
+                    | static_cast<uint8_t>(MEM_T));
+    uint8_t chksum_ = static_cast<uint8_t>(QS_RING_.chksum + b);
+    uint8_t *buf_   = QS_RING_.buf;   // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;  // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;   // put in a temporary (register)
+
+#ifdef QS_THREAD_RINGS
+    // room for the elements (after the 3 bytes below), see QP::QS::QSRing
+    QSCtr room_ = ringRoom(buf_, head_, end_);
+    room_ = (room_ > static_cast<QSCtr>(3))
+            ? static_cast<QSCtr>(room_ - 3U)
+            : static_cast<QSCtr>(0);
+    if (static_cast<QSCtr>(n) > (room_ / size)) {
+        n = static_cast<uint16_t>(room_ / size); // truncate the array
     }
+#endif // QS_THREAD_RINGS
+
+    QS_RING_.used += static_cast<QSCtr>(3); // 3 bytes to be added
 
-    priv_.head   = head_;    // save the head
-    priv_.chksum = chksum_;  // save the checksum
+    QS_INSERT_BYTE(b)
+    b = static_cast<uint8_t>(n);
+    QS_INSERT_ESC_BYTE(b)
+    b = static_cast<uint8_t>(n >> 8);
+    QS_INSERT_ESC_BYTE(b)
+
+    uint8_t const *blk = static_cast<uint8_t const *>(data);
+    uint16_t const one = static_cast<uint16_t>(1);
+    if ((size == static_cast<QSCtr>(1))
+        || (*reinterpret_cast<uint8_t const *>(&one)
+            == static_cast<uint8_t>(1))) // little-endian Target?
+    {
+        QS_RING_.head   = head_;    // save the head
+        QS_RING_.chksum = chksum_;  // save the checksum
+
+        memBlk_(blk, static_cast<QSCtr>(static_cast<QSCtr>(n) * size));
+    }
+    else { // big-endian Target, output each element byte-swapped
+        QS_RING_.used += static_cast<QSCtr>(static_cast<QSCtr>(n) * size);
+        for (; n != static_cast<uint16_t>(0); --n) {
+            for (QSCtr i = size; i != static_cast<QSCtr>(0); --i) {
+                b = blk[i - static_cast<QSCtr>(1)];
+                QS_INSERT_ESC_BYTE(b)
+            }
+            blk = &blk[size];
+        }
+        QS_RING_.head   = head_;    // save the head
+        QS_RING_.chksum = chksum_;  // save the checksum
+    }
 }
 
 //****************************************************************************
@@ -889,30 +2997,25 @@ void QS::mem(uint8_t const *blk, uint8_t size) {
 /// client code directly.
 ///
 void QS::str(char_t const *s) {
-    uint8_t b       = static_cast<uint8_t>(*s);
+#ifdef QS_DROP_NEWEST
+    dropRoom_(strRoom_(s)); // no room for the string?
+#endif // QS_DROP_NEWEST
     uint8_t chksum_ = static_cast<uint8_t>(
-                          priv_.chksum + static_cast<uint8_t>(STR_T));
-    uint8_t *buf_   = priv_.buf;  // put in a temporary (register)
-    QSCtr   head_   = priv_.head; // put in a temporary (register)
-    QSCtr   end_    = priv_.end;  // put in a temporary (register)
-    QSCtr   used_   = priv_.used; // put in a temporary (register)
+                          QS_RING_.chksum + static_cast<uint8_t>(STR_T));
+    uint8_t *buf_   = QS_RING_.buf;  // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head; // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;  // put in a temporary (register)
+    QSCtr   used_   = QS_RING_.used; // put in a temporary (register)
 
-    used_ += static_cast<QSCtr>(2); // the format byte and the terminating-0
+    ++used_; // the format byte
 
     QS_INSERT_BYTE(static_cast<uint8_t>(STR_T))
-    while (b != static_cast<uint8_t>(0)) {
-        // ASCII characters don't need escaping
-        chksum_ += b;  // update checksum
-        QS_INSERT_BYTE(b)
-        QS_PTR_INC_(s);
-        b = static_cast<uint8_t>(*s);
-        ++used_;
-    }
-    QS_INSERT_BYTE(static_cast<uint8_t>(0)) // zero-terminate the string
 
-    priv_.head   = head_;   // save the head
-    priv_.chksum = chksum_; // save the checksum
-    priv_.used   = used_;   // save # of used buffer space
+    QS_RING_.head   = insertStr(buf_, head_, end_, s,
+                                QS_STR_MAX_(buf_, head_, end_),
+                                &chksum_, &used_);
+    QS_RING_.chksum = chksum_; // save the checksum
+    QS_RING_.used   = used_;   // save # of used buffer space
 }
 
 } // namespace QP
@@ -39,7 +39,7 @@
 #define QP_IMPL           // this is QF/QK implementation
 #include "qs_port.h"      // QS port
 
-#if (QS_OBJ_PTR_SIZE == 8) || (QS_FUN_PTR_SIZE == 8)
+#if (QS_OBJ_PTR_SIZE == 8) || (QS_FUN_PTR_SIZE == 8) || (QS_TIME_SIZE == 8)
 
 #include "qs_pkg.h"       // QS package-scope internal interface
 
@@ -50,12 +50,12 @@ namespace QP {
 /// client code directly.
 ///
 void QS::u64_(uint64_t d) {
-    uint8_t chksum_ = priv_.chksum;
-    uint8_t *buf_   = priv_.buf;
-    QSCtr   head_   = priv_.head;
-    QSCtr   end_    = priv_.end;
+    uint8_t chksum_ = QS_RING_.chksum;
+    uint8_t *buf_   = QS_RING_.buf;
+    QSCtr   head_   = QS_RING_.head;
+    QSCtr   end_    = QS_RING_.end;
 
-    priv_.used += static_cast<QSCtr>(8); // 8 bytes are about to be added
+    QS_RING_.used += static_cast<QSCtr>(8); // 8 bytes are about to be added
     for (int_fast8_t i = static_cast<int_fast8_t>(8);
          i != static_cast<int_fast8_t>(0);
          --i)
@@ -65,8 +65,8 @@ void QS::u64_(uint64_t d) {
         d >>= 8;
     }
 
-    priv_.head   = head_;    // save the head
-    priv_.chksum = chksum_;  // save the checksum
+    QS_RING_.head   = head_;    // save the head
+    QS_RING_.chksum = chksum_;  // save the checksum
 }
 
 //****************************************************************************
@@ -74,12 +74,12 @@ void QS::u64_(uint64_t d) {
 /// client code directly.
 ///
 void QS::u64(uint8_t format, uint64_t d) {
-    uint8_t chksum_ = priv_.chksum;
-    uint8_t *buf_   = priv_.buf;
-    QSCtr   head_   = priv_.head;
-    QSCtr   end_    = priv_.end;
+    uint8_t chksum_ = QS_RING_.chksum;
+    uint8_t *buf_   = QS_RING_.buf;
+    QSCtr   head_   = QS_RING_.head;
+    QSCtr   end_    = QS_RING_.end;
 
-    priv_.used += static_cast<QSCtr>(9); // 9 bytes are about to be added
+    QS_RING_.used += static_cast<QSCtr>(9); // 9 bytes are about to be added
     QS_INSERT_ESC_BYTE(format)  // insert the format byte
 
     for (int_fast8_t i = static_cast<int_fast8_t>(8);
@@ -91,10 +91,10 @@ void QS::u64(uint8_t format, uint64_t d) {
         d >>= 8;
     }
 
-    priv_.head   = head_;    // save the head
-    priv_.chksum = chksum_;  // save the checksum
+    QS_RING_.head   = head_;    // save the head
+    QS_RING_.chksum = chksum_;  // save the checksum
 }
 
 } // namespace QP
 
-#endif // (QS_OBJ_PTR_SIZE == 8) || (QS_FUN_PTR_SIZE == 8)
+#endif // (QS_OBJ_PTR_SIZE == 8) || ... || (QS_TIME_SIZE == 8)
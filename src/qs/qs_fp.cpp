@@ -52,14 +52,14 @@ void QS::f32(uint8_t format, float32_t const d) {
         float32_t f;
         uint32_t  u;
     } fu32; // the internal binary representation
-    uint8_t chksum_ = priv_.chksum;  // put in a temporary (register)
-    uint8_t *buf_   = priv_.buf;     // put in a temporary (register)
-    QSCtr   head_   = priv_.head;    // put in a temporary (register)
-    QSCtr   end_    = priv_.end;     // put in a temporary (register)
+    uint8_t chksum_ = QS_RING_.chksum;  // put in a temporary (register)
+    uint8_t *buf_   = QS_RING_.buf;     // put in a temporary (register)
+    QSCtr   head_   = QS_RING_.head;    // put in a temporary (register)
+    QSCtr   end_    = QS_RING_.end;     // put in a temporary (register)
 
     fu32.f = d; // assign the binary representation
 
-    priv_.used += static_cast<QSCtr>(5); // 5 bytes about to be added
+    QS_RING_.used += static_cast<QSCtr>(5); // 5 bytes about to be added
     QS_INSERT_ESC_BYTE(format)  // insert the format byte
 
     for (int_t i = static_cast<int_t>(4); i != static_cast<int_t>(0); --i) {
@@ -68,8 +68,8 @@ void QS::f32(uint8_t format, float32_t const d) {
         fu32.u >>= 8;
     }
 
-    priv_.head   = head_;    // save the head
-    priv_.chksum = chksum_;  // save the checksum
+    QS_RING_.head   = head_;    // save the head
+    QS_RING_.chksum = chksum_;  // save the checksum
 }
 
 //****************************************************************************
@@ -84,10 +84,10 @@ void QS::f64(uint8_t format, float64_t const d) {
             uint32_t u2;
         } i;
     } fu64;  // the internal binary representation
-    uint8_t chksum_ = priv_.chksum;
-    uint8_t *buf_   = priv_.buf;
-    QSCtr   head_   = priv_.head;
-    QSCtr   end_    = priv_.end;
+    uint8_t chksum_ = QS_RING_.chksum;
+    uint8_t *buf_   = QS_RING_.buf;
+    QSCtr   head_   = QS_RING_.head;
+    QSCtr   end_    = QS_RING_.end;
     uint32_t i;
     // static constant untion to detect endianness of the machine
     static union U32Rep {
@@ -97,7 +97,7 @@ void QS::f64(uint8_t format, float64_t const d) {
 
     fu64.d = d;  // assign the binary representation
 
-    priv_.used += static_cast<QSCtr>(9); // 9 bytes about to be added
+    QS_RING_.used += static_cast<QSCtr>(9); // 9 bytes about to be added
     QS_INSERT_ESC_BYTE(format)  // insert the format byte
 
     // is this a big-endian machine?
@@ -122,8 +122,8 @@ void QS::f64(uint8_t format, float64_t const d) {
         fu64.i.u2 >>= 8;
     }
 
-    priv_.head   = head_;   // update the head
-    priv_.chksum = chksum_; // update the checksum
+    QS_RING_.head   = head_;   // update the head
+    QS_RING_.chksum = chksum_; // update the checksum
 }
 
 } // namespace QP
@@ -131,6 +131,27 @@ struct EvtVar {
     uint8_t  idx;
 };
 
+struct EvtsVar {
+    uint16_t len; // the number of the collected bytes of the batch
+};
+
+#ifdef QS_TRIGGER
+// QS_RX_TRIGGER operations and the sizes of their data
+enum TrgOp {
+    TRG_OP_DISARM, // []
+    TRG_OP_ARM,    // [pre u32][post u32]
+    TRG_OP_SET,    // [idx u8][kind u8][rec u8][sig][obj][thresh u32]
+    TRG_OP_FIRE    // []
+};
+
+struct TrgVar {
+    uint8_t data[3 + Q_SIGNAL_SIZE + QS_OBJ_PTR_SIZE + 4];
+    uint8_t op;
+    uint8_t len;
+    uint8_t idx;
+};
+#endif // QS_TRIGGER
+
 // extended-state variables for the current QS-RX state
 static struct ExtState {
     union Variant {
@@ -142,7 +163,11 @@ static struct ExtState {
         AFltVar  aFlt;
         ObjVar   obj;
         EvtVar   evt;
+        EvtsVar  evts;
         TPVar    tp;
+#ifdef QS_TRIGGER
+        TrgVar   trg;
+#endif // QS_TRIGGER
     } var;
     uint8_t state;
     uint8_t esc;
@@ -150,10 +175,18 @@ static struct ExtState {
     uint8_t chksum;
 } l_rx;
 
+// the unescaped frame collected by QP::QS::rxParseBlock()
+static struct RxFrame {
+    uint8_t  buf[QS_RX_FRAME_SIZE]; // [seq][rec][payload...][chksum]
+    uint16_t len;   // the number of the collected bytes
+    uint8_t  sum;   // the sum of the collected bytes
+} l_rxFrm;
+
 enum RxStateEnum {
     WAIT4_SEQ,
     WAIT4_REC,
     WAIT4_INFO_FRAME,
+    WAIT4_DICT_FRAME,
     WAIT4_CMD_ID,
     WAIT4_CMD_PARAM1,
     WAIT4_CMD_PARAM2,
@@ -186,6 +219,10 @@ enum RxStateEnum {
     WAIT4_EVT_LEN,
     WAIT4_EVT_PAR,
     WAIT4_EVT_FRAME,
+    WAIT4_EVTS_DATA,
+    WAIT4_TRG_OP,
+    WAIT4_TRG_DATA,
+    WAIT4_TRG_FRAME,
     WAIT4_TEST_SETUP_FRAME,
     WAIT4_TEST_TEARDOWN_FRAME,
     WAIT4_TEST_PROBE_DATA,
@@ -204,13 +241,23 @@ enum RxStateEnum {
 #endif // Q_UTEST
 
 // internal helper functions...
+static void rxParseByte_(uint8_t b);
 static void rxParseData_(uint8_t b);
+static void rxBlockByte_(uint8_t b);
+static void rxFrameByte_(uint8_t const b);
+static void rxReplay_(void);
+static bool rxFrame_(uint8_t const * const f, uint16_t const n);
+static void rxSeq_(uint8_t const b);
 static void rxHandleGoodFrame_(uint8_t state);
 static void rxHandleBadFrame_(uint8_t state);
 static void rxReportAck_(enum QSpyRxRecords recId);
 static void rxReportError_(uint8_t code);
 static void rxReportDone_(enum QSpyRxRecords recId);
 static void rxPoke_(void);
+static void rxEvents_(uint8_t const *p, uint16_t len);
+#ifdef QS_TRIGGER
+static void rxTrigger_(void);
+#endif // QS_TRIGGER
 
 static uint8_t const l_QS_RX = static_cast<uint8_t>(0); // QS source ID
 
@@ -258,6 +305,8 @@ void QS::rxInitBuf(uint8_t sto[], uint16_t const stoSize) {
     l_rx.esc    = static_cast<uint8_t>(0);
     l_rx.seq    = static_cast<uint8_t>(0);
     l_rx.chksum = static_cast<uint8_t>(0);
+    l_rxFrm.len = static_cast<uint16_t>(0);
+    l_rxFrm.sum = static_cast<uint8_t>(0);
 
     beginRec(static_cast<uint_fast8_t>(QS_OBJ_DICT));
         QS_OBJ_(&l_QS_RX);
@@ -306,48 +355,321 @@ void QS::rxParse(void) {
              rxPriv_.tail = rxPriv_.end;
         }
 
-        if (l_rx.esc != static_cast<uint8_t>(0)) {  // escaped byte arrived?
-            l_rx.esc = static_cast<uint8_t>(0);
-            b ^= QS_ESC_XOR;
+        rxParseByte_(b);
+    }
+}
+
+//****************************************************************************
+/// @description
+/// Parses the @p nBytes received bytes at @p block directly, without the
+/// QS-RX ring buffer (e.g., the whole block received from a socket). The
+/// bytes of each frame are unescaped, copied and checksummed in chunks of
+/// #QS_ESC_CHUNK bytes by QP::QS_escChunk_() (the same, possibly SIMD,
+/// function that escapes the QS output) into the frame buffer. The whole
+/// frames of the most frequent records (QP::QS_RX_EVENT, QP::QS_RX_POKE,
+/// QP::QS_RX_FILL, QP::QS_RX_COMMAND, and QP::QS_RX_TICK) are then decoded
+/// at once. All other frames, the frames with a bad checksum or length,
+/// and the frames longer than #QS_RX_FRAME_SIZE take the byte-by-byte
+/// path of QP::QS::rxParse(), so the QS-RX responses are the same.
+///
+/// The only difference is the timing: a whole frame is decoded only after
+/// its checksum has been received and verified, while the byte-by-byte path
+/// acts on the data as it arrives. For example, QP::QS_RX_EVENT is
+/// acknowledged (and its event allocated) as soon as its length arrives,
+/// while here only after the whole frame, even if it spans the blocks.
+/// A frame with a bad checksum is replayed byte by byte, so it takes the
+/// same actions (e.g., the acknowledgment) before the error is reported.
+///
+/// @param[in] block  the received bytes (a frame can span the blocks)
+/// @param[in] nBytes the number of the received bytes
+///
+/// @note The bytes put into the QS-RX buffer with QP::QS::rxPut() are
+/// parsed first, but the two paths are not meant to be mixed.
+///
+void QS::rxParseBlock(uint8_t const * const block, uint16_t const nBytes) {
+    uint8_t const *p = block;
+    uint16_t n = nBytes;
+    uint16_t const chunk = static_cast<uint16_t>(QS_ESC_CHUNK);
+
+    rxParse(); // the bytes already in the QS-RX buffer
 
-            l_rx.chksum += b;
-            rxParseData_(b);
+    while (n != static_cast<uint16_t>(0)) {
+        uint8_t sum;
+        // a whole chunk of a frame being collected that fits the buffer?
+        if ((n >= chunk)
+            && (l_rx.state == static_cast<uint8_t>(WAIT4_SEQ))
+            && (l_rx.esc == static_cast<uint8_t>(0))
+            && ((static_cast<uint16_t>(QS_RX_FRAME_SIZE) - l_rxFrm.len)
+                >= chunk)
+            && (!QS_escChunk_(&l_rxFrm.buf[l_rxFrm.len], p, &sum)))
+        {
+            l_rxFrm.sum = static_cast<uint8_t>(l_rxFrm.sum + sum);
+            l_rxFrm.len += chunk;
+            p = &p[chunk];
+            n -= chunk;
         }
-        else if (b == QS_ESC) {
-            l_rx.esc = static_cast<uint8_t>(1);
+        else {
+            uint16_t m = (n < chunk) ? n : chunk;
+            n -= m;
+            for (; m != static_cast<uint16_t>(0); --m) {
+                rxBlockByte_(*p);
+                ++p;
+            }
         }
-        else if (b == QS_FRAME) {
-            // get ready for the next frame
-            b = l_rx.state; // save the current state in b
-            l_rx.esc = static_cast<uint8_t>(0);
-            tran_(WAIT4_SEQ);
+    }
+}
+
+//****************************************************************************
+//! parse one (escaped) byte received from QSPY byte by byte
+static void rxParseByte_(uint8_t b) {
+    if (l_rx.esc != static_cast<uint8_t>(0)) {  // escaped byte arrived?
+        l_rx.esc = static_cast<uint8_t>(0);
+        b ^= QS_ESC_XOR;
+
+        l_rx.chksum += b;
+        rxParseData_(b);
+    }
+    else if (b == QS_ESC) {
+        l_rx.esc = static_cast<uint8_t>(1);
+    }
+    else if (b == QS_FRAME) {
+        // get ready for the next frame
+        b = l_rx.state; // save the current state in b
+        l_rx.esc = static_cast<uint8_t>(0);
+        tran_(WAIT4_SEQ);
+
+        if (l_rx.chksum == QS_GOOD_CHKSUM) {
+            l_rx.chksum = static_cast<uint8_t>(0);
+            rxHandleGoodFrame_(b);
+        }
+        else { // bad checksum
+            l_rx.chksum = static_cast<uint8_t>(0);
+            rxReportError_(static_cast<uint8_t>(0x00));
+            rxHandleBadFrame_(b);
+        }
+    }
+    else {
+        l_rx.chksum += b;
+        rxParseData_(b);
+    }
+}
+
+//****************************************************************************
+//! parse one (escaped) byte received by QP::QS::rxParseBlock()
+/// @description
+/// Collects the unescaped bytes of the frame in the frame buffer, unless
+/// the frame is already being parsed byte by byte.
+static void rxBlockByte_(uint8_t b) {
+    if (l_rx.state != static_cast<uint8_t>(WAIT4_SEQ)) { // byte by byte?
+        rxParseByte_(b);
+    }
+    else if (l_rx.esc != static_cast<uint8_t>(0)) { // escaped byte arrived?
+        l_rx.esc = static_cast<uint8_t>(0);
+        rxFrameByte_(static_cast<uint8_t>(b ^ QS_ESC_XOR));
+    }
+    else if (b == QS_ESC) {
+        l_rx.esc = static_cast<uint8_t>(1);
+    }
+    else if (b == QS_FRAME) {
+        if ((l_rxFrm.sum != QS_GOOD_CHKSUM)
+            || (!rxFrame_(&l_rxFrm.buf[0], l_rxFrm.len)))
+        {
+            rxReplay_();
+            rxParseByte_(b); // the end of the frame
+        }
+        l_rxFrm.len = static_cast<uint16_t>(0);
+        l_rxFrm.sum = static_cast<uint8_t>(0);
+    }
+    else {
+        rxFrameByte_(b);
+    }
+}
+
+//****************************************************************************
+//! add the unescaped byte @p b to the frame being collected
+/// @description
+/// When the frame does not fit the frame buffer, the collected bytes are
+/// replayed and the rest of the frame is parsed byte by byte.
+static void rxFrameByte_(uint8_t const b) {
+    if (l_rxFrm.len < static_cast<uint16_t>(QS_RX_FRAME_SIZE)) {
+        l_rxFrm.buf[l_rxFrm.len] = b;
+        ++l_rxFrm.len;
+        l_rxFrm.sum = static_cast<uint8_t>(l_rxFrm.sum + b);
+    }
+    else {
+        rxReplay_();
+        l_rx.chksum += b;
+        rxParseData_(b);
+    }
+}
 
-            if (l_rx.chksum == QS_GOOD_CHKSUM) {
-                l_rx.chksum = static_cast<uint8_t>(0);
-                rxHandleGoodFrame_(b);
+//****************************************************************************
+//! parse the unescaped bytes collected in the frame buffer byte by byte
+static void rxReplay_(void) {
+    for (uint16_t i = static_cast<uint16_t>(0); i < l_rxFrm.len; ++i) {
+        l_rx.chksum += l_rxFrm.buf[i];
+        rxParseData_(l_rxFrm.buf[i]);
+    }
+    l_rxFrm.len = static_cast<uint16_t>(0);
+    l_rxFrm.sum = static_cast<uint8_t>(0);
+}
+
+//****************************************************************************
+//! little-endian unsigned integer of @p n bytes at @p p
+static inline uint32_t rxLoad_(uint8_t const * const p, uint_fast8_t n) {
+    uint32_t v = static_cast<uint32_t>(0);
+    for (; n > static_cast<uint_fast8_t>(0); --n) {
+        v = (v << 8) | static_cast<uint32_t>(p[n - 1U]);
+    }
+    return v;
+}
+
+//****************************************************************************
+/// @description
+/// Decodes the whole unescaped frame @p f of @p n bytes (including the
+/// sequence number, the record ID and the good checksum) with the same
+/// actions and QS-RX responses as the byte-by-byte path.
+///
+/// @returns 'false' if the frame must be parsed byte by byte instead
+/// (the record is not decoded at once or the frame is not well-formed).
+/// No actions are taken in that case.
+///
+static bool rxFrame_(uint8_t const * const f, uint16_t const n) {
+    if (n < static_cast<uint16_t>(3)) {
+        return false; // not even [seq][rec][chksum]
+    }
+    uint8_t const *p = &f[2]; // the payload
+    uint16_t const len = static_cast<uint16_t>(n - 3U);
+    bool ok = false;
+
+    switch (f[1]) {
+        case QS_RX_COMMAND: {
+            ok = (len == static_cast<uint16_t>(1U + 3U*4U));
+            if (ok) {
+                rxSeq_(f[0]);
+                l_rx.var.cmd.cmdId  = p[0];
+                l_rx.var.cmd.param1 = rxLoad_(&p[1], 4U);
+                l_rx.var.cmd.param2 = rxLoad_(&p[5], 4U);
+                l_rx.var.cmd.param3 = rxLoad_(&p[9], 4U);
+                rxHandleGoodFrame_(static_cast<uint8_t>(WAIT4_CMD_FRAME));
             }
-            else { // bad checksum
-                l_rx.chksum = static_cast<uint8_t>(0);
-                rxReportError_(static_cast<uint8_t>(0x00));
-                rxHandleBadFrame_(b);
+            break;
+        }
+        case QS_RX_TICK: {
+            ok = (len == static_cast<uint16_t>(1));
+            if (ok) {
+                rxSeq_(f[0]);
+                l_rx.var.tick.rate = static_cast<uint_fast8_t>(p[0]);
+                rxHandleGoodFrame_(static_cast<uint8_t>(WAIT4_TICK_FRAME));
             }
+            break;
         }
-        else {
-            l_rx.chksum += b;
-            rxParseData_(b);
+        case QS_RX_POKE:   // intentionally fall-through
+        case QS_RX_FILL: {
+            bool const fill = (f[1] == static_cast<uint8_t>(QS_RX_FILL));
+            ok = (QS::rxPriv_.currObj[QS::AP_OBJ] != static_cast<void *>(0))
+                 && (len >= static_cast<uint16_t>(4));
+            if (ok) {
+                uint8_t const size = p[2];
+                uint8_t const num  = p[3];
+                ok = ((size == static_cast<uint8_t>(1))
+                      || (size == static_cast<uint8_t>(2))
+                      || (size == static_cast<uint8_t>(4)))
+                     && (num != static_cast<uint8_t>(0))
+                     && (len == static_cast<uint16_t>(4U
+                                + (fill ? size : (size * num))));
+            }
+            if (ok) {
+                rxSeq_(f[0]);
+                l_rx.var.poke.offs = static_cast<uint16_t>(rxLoad_(p, 2U));
+                l_rx.var.poke.size = p[2];
+                l_rx.var.poke.num  = p[3];
+                l_rx.var.poke.fill = fill
+                                     ? static_cast<uint8_t>(1)
+                                     : static_cast<uint8_t>(0);
+                p = &p[4];
+                if (fill) {
+                    l_rx.var.poke.data = rxLoad_(p, l_rx.var.poke.size);
+                    rxHandleGoodFrame_(
+                        static_cast<uint8_t>(WAIT4_FILL_FRAME));
+                }
+                else {
+                    for (uint8_t i = static_cast<uint8_t>(0);
+                         i < l_rx.var.poke.num; ++i)
+                    {
+                        l_rx.var.poke.data = rxLoad_(p, l_rx.var.poke.size);
+                        rxPoke_();
+                        p = &p[l_rx.var.poke.size];
+                    }
+                    rxHandleGoodFrame_(
+                        static_cast<uint8_t>(WAIT4_POKE_FRAME));
+                }
+            }
+            break;
+        }
+        case QS_RX_EVENT: {
+            uint16_t const hdr = static_cast<uint16_t>(1U + Q_SIGNAL_SIZE
+                                                       + 2U);
+            ok = (len >= hdr)
+                 && (len == static_cast<uint16_t>(hdr
+                        + rxLoad_(&p[1U + Q_SIGNAL_SIZE], 2U)));
+            if (ok) {
+                rxSeq_(f[0]);
+                l_rx.var.evt.prio = p[0];
+                l_rx.var.evt.sig  = static_cast<QSignal>(
+                                        rxLoad_(&p[1], Q_SIGNAL_SIZE));
+                l_rx.var.evt.len  = static_cast<uint16_t>(len - hdr);
+                p = &p[hdr];
+                if ((l_rx.var.evt.len + static_cast<uint16_t>(sizeof(QEvt)))
+                    <= static_cast<uint16_t>(QF::poolGetMaxBlockSize()))
+                {
+                    // report Ack before generating any other QS records
+                    rxReportAck_(QS_RX_EVENT);
+
+                    l_rx.var.evt.e = QF::newX_(
+                        (static_cast<uint_fast16_t>(l_rx.var.evt.len)
+                         + static_cast<uint_fast16_t>(sizeof(QEvt))),
+                        static_cast<uint_fast16_t>(1), // margin
+                        static_cast<enum_t>(l_rx.var.evt.sig));
+                }
+                else {
+                    l_rx.var.evt.e = static_cast<QEvt *>(0);
+                }
+
+                if (l_rx.var.evt.e != static_cast<QEvt *>(0)) {
+                    uint8_t *par = reinterpret_cast<uint8_t *>(
+                                       l_rx.var.evt.e) + sizeof(QEvt);
+                    for (uint16_t i = static_cast<uint16_t>(0);
+                         i < l_rx.var.evt.len; ++i)
+                    {
+                        par[i] = p[i];
+                    }
+                    rxHandleGoodFrame_(static_cast<uint8_t>(WAIT4_EVT_FRAME));
+                }
+                else {
+                    rxReportError_(static_cast<uint8_t>(QS_RX_EVENT));
+                }
+            }
+            break;
+        }
+        case QS_RX_EVENTS: {
+            ok = true; // the batch is checked by rxEvents_()
+            rxSeq_(f[0]);
+            rxEvents_(p, len);
+            break;
+        }
+        default: {
+            break; // parse the other records byte by byte
         }
     }
+    return ok;
 }
 
 //****************************************************************************
 static void rxParseData_(uint8_t const b) {
     switch (l_rx.state) {
         case WAIT4_SEQ: {
-            ++l_rx.seq;
-            if (l_rx.seq != b) { // not the expected sequence?
-                rxReportError_(static_cast<uint8_t>(0x42));
-                l_rx.seq = b; // update the sequence
-            }
+            rxSeq_(b);
             tran_(WAIT4_REC);
             break;
         }
@@ -356,6 +678,11 @@ static void rxParseData_(uint8_t const b) {
                 case QS_RX_INFO:
                     tran_(WAIT4_INFO_FRAME);
                     break;
+#ifdef QS_LAZY_DICT
+                case QS_RX_DICT:
+                    tran_(WAIT4_DICT_FRAME);
+                    break;
+#endif // QS_LAZY_DICT
                 case QS_RX_COMMAND:
                     tran_(WAIT4_CMD_ID);
                     break;
@@ -417,6 +744,15 @@ static void rxParseData_(uint8_t const b) {
                 case QS_RX_EVENT:
                     tran_(WAIT4_EVT_PRIO);
                     break;
+                case QS_RX_EVENTS:
+                    l_rx.var.evts.len = static_cast<uint16_t>(0);
+                    tran_(WAIT4_EVTS_DATA);
+                    break;
+#ifdef QS_TRIGGER
+                case QS_RX_TRIGGER:
+                    tran_(WAIT4_TRG_OP);
+                    break;
+#endif // QS_TRIGGER
 
 #ifdef Q_UTEST
                 case QS_RX_TEST_SETUP:
@@ -453,7 +789,8 @@ static void rxParseData_(uint8_t const b) {
             }
             break;
         }
-        case WAIT4_INFO_FRAME: {
+        case WAIT4_INFO_FRAME: // intentionally fall-through
+        case WAIT4_DICT_FRAME: {
             // keep ignoring the data until a frame is collected
             break;
         }
@@ -663,7 +1000,7 @@ static void rxParseData_(uint8_t const b) {
         }
         case WAIT4_OBJ_ADDR: {
             l_rx.var.obj.addr |=
-                static_cast<uint32_t>(b) << l_rx.var.obj.idx;
+                static_cast<QSObj>(b) << l_rx.var.obj.idx;
             l_rx.var.obj.idx += static_cast<uint8_t>(8);
             if (l_rx.var.obj.idx
                 == static_cast<uint8_t>((8*QS_OBJ_PTR_SIZE)))
@@ -756,6 +1093,56 @@ static void rxParseData_(uint8_t const b) {
             // keep ignoring the data until a frame is collected
             break;
         }
+        case WAIT4_EVTS_DATA: {
+            // collect the batch in the frame buffer, which is free here
+            // (or already replayed up to this byte, see rxReplay_())
+            if (l_rx.var.evts.len < static_cast<uint16_t>(QS_RX_FRAME_SIZE)) {
+                l_rxFrm.buf[l_rx.var.evts.len] = b;
+                ++l_rx.var.evts.len;
+            }
+            else {
+                rxReportError_(static_cast<uint8_t>(QS_RX_EVENTS));
+                tran_(ERROR_STATE);
+            }
+            break;
+        }
+#ifdef QS_TRIGGER
+        case WAIT4_TRG_OP: {
+            l_rx.var.trg.op  = b;
+            l_rx.var.trg.idx = static_cast<uint8_t>(0);
+            if (b == static_cast<uint8_t>(TRG_OP_ARM)) {
+                l_rx.var.trg.len = static_cast<uint8_t>(8);
+                tran_(WAIT4_TRG_DATA);
+            }
+            else if (b == static_cast<uint8_t>(TRG_OP_SET)) {
+                l_rx.var.trg.len =
+                    static_cast<uint8_t>(sizeof(l_rx.var.trg.data));
+                tran_(WAIT4_TRG_DATA);
+            }
+            else if ((b == static_cast<uint8_t>(TRG_OP_DISARM))
+                     || (b == static_cast<uint8_t>(TRG_OP_FIRE)))
+            {
+                tran_(WAIT4_TRG_FRAME);
+            }
+            else {
+                rxReportError_(static_cast<uint8_t>(QS_RX_TRIGGER));
+                tran_(ERROR_STATE);
+            }
+            break;
+        }
+        case WAIT4_TRG_DATA: {
+            l_rx.var.trg.data[l_rx.var.trg.idx] = b;
+            ++l_rx.var.trg.idx;
+            if (l_rx.var.trg.idx == l_rx.var.trg.len) {
+                tran_(WAIT4_TRG_FRAME);
+            }
+            break;
+        }
+        case WAIT4_TRG_FRAME: {
+            // keep ignoring the data until a frame is collected
+            break;
+        }
+#endif // QS_TRIGGER
 
 #ifdef Q_UTEST
         case WAIT4_TEST_SETUP_FRAME: {
@@ -783,7 +1170,7 @@ static void rxParseData_(uint8_t const b) {
             break;
         }
         case WAIT4_TEST_PROBE_ADDR: {
-            l_rx.var.tp.addr |= static_cast<uint32_t>(b) << l_rx.var.tp.idx;
+            l_rx.var.tp.addr |= static_cast<QSFun>(b) << l_rx.var.tp.idx;
             l_rx.var.tp.idx += static_cast<uint8_t>(8);
             if (l_rx.var.tp.idx == static_cast<uint8_t>(8*QS_FUN_PTR_SIZE)) {
                 tran_(WAIT4_TEST_PROBE_FRAME);
@@ -808,6 +1195,16 @@ static void rxParseData_(uint8_t const b) {
     }
 }
 
+//****************************************************************************
+//! check the sequence number @p b of the received frame
+static void rxSeq_(uint8_t const b) {
+    ++l_rx.seq;
+    if (l_rx.seq != b) { // not the expected sequence?
+        rxReportError_(static_cast<uint8_t>(0x42));
+        l_rx.seq = b; // update the sequence
+    }
+}
+
 //****************************************************************************
 static void rxHandleGoodFrame_(uint8_t state) {
     uint8_t i;
@@ -817,8 +1214,18 @@ static void rxHandleGoodFrame_(uint8_t state) {
         case WAIT4_INFO_FRAME: {
             // no need to report Ack or Done
             QS_target_info_(static_cast<uint8_t>(0)); // send only Target info
+#ifdef QS_COMPACT
+            QS::internAll(); // the host might not know the interned IDs
+#endif // QS_COMPACT
             break;
         }
+#ifdef QS_LAZY_DICT
+        case WAIT4_DICT_FRAME: {
+            // no need to report Ack or Done
+            QS::dictAll(); // send all the registered dictionaries
+            break;
+        }
+#endif // QS_LAZY_DICT
         case WAIT4_RESET_FRAME: {
             // no need to report Ack or Done, because Target resets
             QS::onReset(); // reset the Target
@@ -925,8 +1332,9 @@ static void rxHandleGoodFrame_(uint8_t state) {
                 if (l_rx.var.obj.recId
                     == static_cast<uint8_t>(QS_RX_LOC_FILTER))
                 {
-                    QS::priv_.locFilter[l_rx.var.obj.kind]
-                         = reinterpret_cast<void *>(l_rx.var.obj.addr);
+                    QS::locFilter(
+                        static_cast<uint_fast8_t>(l_rx.var.obj.kind),
+                        reinterpret_cast<void *>(l_rx.var.obj.addr));
                 }
                 else {
                     QS::rxPriv_.currObj[l_rx.var.obj.kind] =
@@ -940,10 +1348,12 @@ static void rxHandleGoodFrame_(uint8_t state) {
                 if (l_rx.var.obj.recId
                     == static_cast<uint8_t>(QS_RX_LOC_FILTER))
                 {
-                    QS::priv_.locFilter[QS::SM_OBJ] =
-                        reinterpret_cast<void *>(l_rx.var.obj.addr);
-                    QS::priv_.locFilter[QS::AO_OBJ] =
-                        reinterpret_cast<void *>(l_rx.var.obj.addr);
+                    QS::locFilter(
+                        static_cast<uint_fast8_t>(QS::SM_OBJ),
+                        reinterpret_cast<void *>(l_rx.var.obj.addr));
+                    QS::locFilter(
+                        static_cast<uint_fast8_t>(QS::AO_OBJ),
+                        reinterpret_cast<void *>(l_rx.var.obj.addr));
                 }
                 else {
                     QS::rxPriv_.currObj[QS::SM_OBJ] =
@@ -963,10 +1373,10 @@ static void rxHandleGoodFrame_(uint8_t state) {
             rxReportAck_(QS_RX_AO_FILTER);
             if (l_rx.var.aFlt.prio <= static_cast<uint8_t>(QF_MAX_ACTIVE)) {
                 rxReportAck_(QS_RX_AO_FILTER);
-                QS::priv_.locFilter[QS::AO_OBJ] =
-                    QF::active_[l_rx.var.aFlt.prio];
-                QS::priv_.locFilter[QS::SM_OBJ] =
-                    QF::active_[l_rx.var.aFlt.prio];
+                QS::locFilter(static_cast<uint_fast8_t>(QS::AO_OBJ),
+                              QF::active_[l_rx.var.aFlt.prio]);
+                QS::locFilter(static_cast<uint_fast8_t>(QS::SM_OBJ),
+                              QF::active_[l_rx.var.aFlt.prio]);
             }
             else {
                 rxReportError_(static_cast<uint8_t>(QS_RX_AO_FILTER));
@@ -986,7 +1396,7 @@ static void rxHandleGoodFrame_(uint8_t state) {
                 QF::PUBLISH(l_rx.var.evt.e, &l_QS_RX);
                 rxReportDone_(QS_RX_EVENT);
             }
-            else if (l_rx.var.evt.prio < static_cast<uint8_t>(QF_MAX_ACTIVE))
+            else if (l_rx.var.evt.prio <= static_cast<uint8_t>(QF_MAX_ACTIVE))
             {
                 if (!QF::active_[l_rx.var.evt.prio]->POST_X(
                                 l_rx.var.evt.e,
@@ -1058,6 +1468,21 @@ static void rxHandleGoodFrame_(uint8_t state) {
             break;
         }
 
+        case WAIT4_EVTS_DATA: {
+            // the last byte collected is the checksum
+            rxEvents_(&l_rxFrm.buf[0],
+                      static_cast<uint16_t>(l_rx.var.evts.len - 1U));
+            break;
+        }
+
+#ifdef QS_TRIGGER
+        case WAIT4_TRG_FRAME: {
+            rxTrigger_(); // reports Ack or Error
+            // no need to report Done
+            break;
+        }
+#endif // QS_TRIGGER
+
 #ifdef Q_UTEST
         case WAIT4_TEST_SETUP_FRAME: {
             rxReportAck_(QS_RX_TEST_SETUP);
@@ -1167,6 +1592,190 @@ static void rxPoke_(void) {
     l_rx.var.poke.offs += static_cast<uint16_t>(l_rx.var.poke.size);
 }
 
+//****************************************************************************
+/// @description
+/// Injects the batch of events from the QP::QS_RX_EVENTS payload @p p of
+/// @p len bytes. Each event in the batch is:
+/// [prio u8][ticks u8][sig][len u16][parameters], where 'prio' is 0 to
+/// publish the event, the priority of the active object to post it to,
+/// or 253 to post it to the current AO object. 'ticks' is the relative
+/// time stamp of the event: the number of the ticks of the clock rate 0
+/// (QP::QF::tickX_()) to process before the event.
+///
+/// The whole batch is checked first, so a malformed batch is rejected
+/// (Error) before any event is injected. Otherwise, a single Ack is
+/// reported, all the events are allocated and posted (or published) in
+/// one pass, and a single Done is reported when all of them have been
+/// delivered (or Error when an allocation or a post failed).
+///
+static void rxEvents_(uint8_t const *p, uint16_t len) {
+    uint16_t const hdr = static_cast<uint16_t>(2U + Q_SIGNAL_SIZE + 2U);
+    uint16_t const maxPar = static_cast<uint16_t>(
+        static_cast<uint16_t>(QF::poolGetMaxBlockSize())
+        - static_cast<uint16_t>(sizeof(QEvt)));
+    uint8_t const *q = p;
+    uint16_t n = len;
+    bool ok = (QF::poolGetMaxBlockSize()
+               >= static_cast<uint_fast16_t>(sizeof(QEvt)));
+
+    while (ok && (n != static_cast<uint16_t>(0))) { // check the batch
+        ok = (n >= hdr);
+        if (ok) {
+            uint16_t const parLen = static_cast<uint16_t>(
+                rxLoad_(&q[2U + Q_SIGNAL_SIZE], 2U));
+            ok = (parLen <= maxPar)
+                 && (parLen <= static_cast<uint16_t>(n - hdr))
+                 && ((q[0] == static_cast<uint8_t>(0))
+                     || (q[0] <= static_cast<uint8_t>(QF_MAX_ACTIVE))
+                     || ((q[0] == static_cast<uint8_t>(253))
+                         && (QS::rxPriv_.currObj[QS::AO_OBJ]
+                             != static_cast<void *>(0))));
+            if (ok) {
+                q = &q[hdr + parLen];
+                n -= static_cast<uint16_t>(hdr + parLen);
+            }
+        }
+    }
+    if (!ok) {
+        rxReportError_(static_cast<uint8_t>(QS_RX_EVENTS));
+        return;
+    }
+
+    // report Ack before generating any other QS records
+    rxReportAck_(QS_RX_EVENTS);
+
+    uint8_t status = static_cast<uint8_t>(0); // 0 == all events delivered
+    while (len != static_cast<uint16_t>(0)) { // inject the batch
+        uint8_t const prio = p[0];
+        for (uint8_t t = p[1]; t != static_cast<uint8_t>(0); --t) {
+            QF::tickX_(static_cast<uint_fast8_t>(0), &l_QS_RX);
+        }
+        uint16_t const parLen = static_cast<uint16_t>(
+            rxLoad_(&p[2U + Q_SIGNAL_SIZE], 2U));
+        QEvt *e = QF::newX_(
+            (static_cast<uint_fast16_t>(parLen)
+             + static_cast<uint_fast16_t>(sizeof(QEvt))),
+            static_cast<uint_fast16_t>(1), // margin
+            static_cast<enum_t>(rxLoad_(&p[2], Q_SIGNAL_SIZE)));
+        p = &p[hdr];
+        if (e != static_cast<QEvt *>(0)) {
+            uint8_t *par = reinterpret_cast<uint8_t *>(e) + sizeof(QEvt);
+            for (uint16_t i = static_cast<uint16_t>(0); i < parLen; ++i) {
+                par[i] = p[i];
+            }
+#ifdef Q_UTEST
+            QS::onTestEvt(e); // "massage" the event, if needed
+#endif // Q_UTEST
+            if (prio == static_cast<uint8_t>(0)) { // publish
+                QF::PUBLISH(e, &l_QS_RX);
+            }
+            else {
+                QActive *a = (prio == static_cast<uint8_t>(253))
+                    ? static_cast<QActive *>(QS::rxPriv_.currObj[QS::AO_OBJ])
+                    : QF::active_[prio];
+                if (a == static_cast<QActive *>(0)) { // no AO at prio?
+                    QF::gc(e);
+                    status = static_cast<uint8_t>(1);
+                }
+                else if (!a->POST_X(e, static_cast<uint_fast16_t>(1),
+                                    &l_QS_RX))
+                {
+                    // failed QACTIVE_POST() recycles the event
+                    status = static_cast<uint8_t>(1);
+                }
+                else {
+                    // the event has been posted
+                }
+            }
+        }
+        else {
+            status = static_cast<uint8_t>(1); // event not allocated
+        }
+        p = &p[parLen];
+        len -= static_cast<uint16_t>(hdr + parLen);
+    }
+
+    if (status == static_cast<uint8_t>(0)) {
+        rxReportDone_(QS_RX_EVENTS);
+    }
+    else {
+        rxReportError_(static_cast<uint8_t>(QS_RX_EVENTS));
+    }
+}
+
+#ifdef QS_TRIGGER
+//****************************************************************************
+//! little-endian unsigned integer of @p n bytes in the trigger data
+static uint64_t rxTrgData_(uint8_t const idx, uint8_t const n) {
+    uint64_t v = static_cast<uint64_t>(0);
+    for (uint8_t i = n; i > static_cast<uint8_t>(0); --i) {
+        v = (v << 8) | static_cast<uint64_t>(
+                           l_rx.var.trg.data[idx + i - 1U]);
+    }
+    return v;
+}
+
+//****************************************************************************
+/// @description
+/// Executes the QP::QS_RX_TRIGGER operation. The operations are: disarm
+/// (0), arm (1) with the pre- and post-trigger windows (u32 each), set (2)
+/// a trigger [idx u8][kind u8][rec u8][sig][obj][thresh u32], and fire
+/// (3), see QP::QS::trgSet() and QP::QS::trgArm().
+///
+static void rxTrigger_(void) {
+    uint8_t const *d = &l_rx.var.trg.data[0];
+    bool ok = true;
+
+    switch (l_rx.var.trg.op) {
+        case TRG_OP_DISARM: {
+            QS::trgDisarm();
+            break;
+        }
+        case TRG_OP_ARM: {
+            QSCtr const pre  = static_cast<QSCtr>(rxTrgData_(0U, 4U));
+            QSCtr const post = static_cast<QSCtr>(rxTrgData_(4U, 4U));
+            ok = (pre < QS::priv_.end) && (post < QS::priv_.end - pre);
+            break;
+        }
+        case TRG_OP_SET: {
+            ok = (d[0] < static_cast<uint8_t>(QS_TRG_MAX))
+                 && (d[1] <= static_cast<uint8_t>(QS::TRG_RTC))
+                 && (d[2] < static_cast<uint8_t>(
+                                8U*sizeof(QS::priv_.trgRecs)));
+            if (ok) {
+                QS::trgSet(d[0], d[1], d[2],
+                    static_cast<enum_t>(rxTrgData_(3U, Q_SIGNAL_SIZE)),
+                    reinterpret_cast<void const *>(static_cast<QSObj>(
+                        rxTrgData_(3U + Q_SIGNAL_SIZE, QS_OBJ_PTR_SIZE))),
+                    static_cast<uint32_t>(rxTrgData_(
+                        3U + Q_SIGNAL_SIZE + QS_OBJ_PTR_SIZE, 4U)));
+            }
+            break;
+        }
+        case TRG_OP_FIRE: {
+            QS::trgFire();
+            break;
+        }
+        default: {
+            ok = false;
+            break;
+        }
+    }
+
+    if (ok) {
+        rxReportAck_(QS_RX_TRIGGER);
+        if (l_rx.var.trg.op == static_cast<uint8_t>(TRG_OP_ARM)) {
+            QS::onFlush(); // let the Ack out before the output is held
+            QS::trgArm(static_cast<QSCtr>(rxTrgData_(0U, 4U)),
+                       static_cast<QSCtr>(rxTrgData_(4U, 4U)));
+        }
+    }
+    else {
+        rxReportError_(static_cast<uint8_t>(QS_RX_TRIGGER));
+    }
+}
+#endif // QS_TRIGGER
+
 //============================================================================
 #ifdef Q_UTEST
 
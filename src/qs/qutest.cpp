@@ -98,7 +98,7 @@ bool QActive::post_(QEvt const * const e,
     {
 
         QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_FIFO,
-                         QS::priv_.locFilter[QS::AO_OBJ], this)
+                         QS::AO_OBJ, this)
             QS_TIME_();               // timestamp
             QS_OBJ_(sender);          // the sender object
             QS_SIG_(e->sig);          // the signal of the event
@@ -124,7 +124,7 @@ bool QActive::post_(QEvt const * const e,
         Q_ASSERT_ID(110, margin != QF_NO_MARGIN);
 
         QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_ATTEMPT,
-                         QS::priv_.locFilter[QS::AO_OBJ], this)
+                         QS::AO_OBJ, this)
             QS_TIME_();               // timestamp
             QS_OBJ_(sender);          // the sender object
             QS_SIG_(e->sig);          // the signal of the event
@@ -158,7 +158,7 @@ void QActive::postLIFO(QEvt const * const e) {
     )
 
     QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_LIFO,
-                     QS::priv_.locFilter[QS::AO_OBJ], this)
+                     QS::AO_OBJ, this)
         QS_TIME_();                      // timestamp
         QS_SIG_(e->sig);                 // the signal of this event
         QS_OBJ_(this);                   // this active object
@@ -204,7 +204,7 @@ QTimeEvtCtr QTimeEvt::ctr(void) const {
     QF_CRIT_ENTRY_();
     ret = m_ctr;
 
-    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_CTR, QS::priv_.locFilter[QS::TE_OBJ], this)
+    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_CTR, QS::TE_OBJ, this)
         QS_TIME_();            // timestamp
         QS_OBJ_(this);         // this time event object
         QS_OBJ_(m_act);        // the target AO
@@ -269,7 +269,7 @@ void QTimeEvt::armX(QTimeEvtCtr const nTicks, QTimeEvtCtr const interval) {
     m_ctr = nTicks;
     m_interval = interval;
 
-    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_ARM, QS::priv_.locFilter[QS::TE_OBJ], this)
+    QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_ARM, QS::TE_OBJ, this)
         QS_TIME_();        // timestamp
         QS_OBJ_(this);     // this time event object
         QS_OBJ_(m_act);    // the active object
@@ -291,7 +291,7 @@ bool QTimeEvt::disarm(void) {
         wasArmed = true;
 
         QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_DISARM,
-                         QS::priv_.locFilter[QS::TE_OBJ], this)
+                         QS::TE_OBJ, this)
             QS_TIME_();          // timestamp
             QS_OBJ_(this);       // this time event object
             QS_OBJ_(m_act);      // the target AO
@@ -307,7 +307,7 @@ bool QTimeEvt::disarm(void) {
         wasArmed = false;
 
         QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_DISARM_ATTEMPT,
-                         QS::priv_.locFilter[QS::TE_OBJ], this)
+                         QS::TE_OBJ, this)
             QS_TIME_();          // timestamp
             QS_OBJ_(this);       // this time event object
             QS_OBJ_(m_act);      // the target AO
@@ -358,7 +358,7 @@ bool QTimeEvt::rearm(QTimeEvtCtr const nTicks) {
     m_ctr = nTicks; // re-load the tick counter (shift the phasing)
 
     QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_REARM,
-                     QS::priv_.locFilter[QS::TE_OBJ], this)
+                     QS::TE_OBJ, this)
         QS_TIME_();          // timestamp
         QS_OBJ_(this);       // this time event object
         QS_OBJ_(m_act);      // the target AO
@@ -390,7 +390,7 @@ void QF::tickX_(uint_fast8_t const tickRate, void const * const sender) {
             t->refCtr_ &= static_cast<uint8_t>(0x7F);
 
             QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_AUTO_DISARM,
-                             QS::priv_.locFilter[QS::TE_OBJ], t)
+                             QS::TE_OBJ, t)
                 QS_OBJ_(t);        // this time event object
                 QS_OBJ_(act);      // the target AO
                 QS_U8_(static_cast<uint8_t>(tickRate)); // tick rate
@@ -398,7 +398,7 @@ void QF::tickX_(uint_fast8_t const tickRate, void const * const sender) {
         }
 
         QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_POST,
-                         QS::priv_.locFilter[QS::TE_OBJ], t)
+                         QS::TE_OBJ, t)
             QS_TIME_();            // timestamp
             QS_OBJ_(t);            // the time event object
             QS_SIG_(t->sig);       // signal of this time event
@@ -47,6 +47,11 @@
         head_ = static_cast<QSCtr>(0); \
     }
 
+#ifndef QS_THREAD_RINGS
+
+//! Internal QS macro to access the ring buffer of the current record
+#define QS_RING_ (QS::priv_)
+
 //! Internal QS macro to insert an escaped byte into the QS buffer
 #define QS_INSERT_ESC_BYTE(b_) \
     chksum_ += (b_); \
@@ -59,6 +64,78 @@
         ++priv_.used; \
     }
 
+#else // QS_THREAD_RINGS
+
+//! Internal QS macro to access the ring buffer of the current record
+/// @description
+/// With the per-thread QS rings, every thread writes its records into its
+/// own ring QP::QS::ring_, see QP::QS::QSRing.
+#define QS_RING_ (*QS::ring_)
+
+//! Internal QS macro to insert a byte into the per-thread QS ring
+/// @description
+/// The per-thread rings hold the records un-escaped. The bytes are escaped
+/// and the records are framed only when the rings are merged into the main
+/// QS buffer (see #QS_MERGE_ESC_BYTE).
+#define QS_INSERT_ESC_BYTE(b_) \
+    chksum_ += (b_); \
+    QS_INSERT_BYTE(b_)
+
+//! Internal QS macro to insert an escaped byte into the main QS buffer
+#define QS_MERGE_ESC_BYTE(b_) \
+    chksum_ += (b_); \
+    if (((b_) != QS_FRAME) && ((b_) != QS_ESC)) { \
+        QS_INSERT_BYTE(b_) \
+    } \
+    else { \
+        QS_INSERT_BYTE(QS_ESC) \
+        QS_INSERT_BYTE(static_cast<uint8_t>((b_) ^ QS_ESC_XOR)) \
+        ++priv_.used; \
+    }
+
+#endif // QS_THREAD_RINGS
+
+#ifndef QS_HEAD_PUBLISH_
+
+//! Internal QS macro to publish the head of the QS buffer at the end of
+//! a record (see QP::QS::priv_.headCopy)
+/// @description
+/// A QS port, whose QS buffer is read directly by another process (e.g.,
+/// from shared memory), can define this macro in qs_port.h to store the
+/// head with the release semantics, so that the consumer that loads the
+/// head also sees all the bytes of the records before it.
+#define QS_HEAD_PUBLISH_(ptr_, head_) (*(ptr_) = (head_))
+
+#endif // QS_HEAD_PUBLISH_
+
+#ifndef QS_WMARK_HOOK_
+
+//! Internal QS macro invoked when the QS buffer fills up to the watermark
+//! (see QP::QS::setWatermark())
+/// @description
+/// A QS port with a QS output thread (e.g., the QS flusher in the POSIX
+/// port) can define this macro in qs_port.h to wake up the thread. The
+/// macro is invoked at the end of a record, inside the critical section,
+/// and only once until the watermark is set again.
+#define QS_WMARK_HOOK_() ((void)0)
+
+#endif // QS_WMARK_HOOK_
+
+#ifndef QS_BLOCK_HOOK_
+
+//! Internal QS macro invoked to wait for the QS output to free some room
+//! in the QS buffer (see #QS_BLOCK_PRODUCER)
+/// @description
+/// A QS port with a QS output thread (e.g., the QS flusher in the POSIX
+/// port) can define this macro in qs_port.h to wake up the thread and wait
+/// (for a bounded time) until the used bytes drop to
+/// QP::QS::priv_.dropLevel or below. The macro is invoked inside the
+/// critical section, which the wait may release. Without the macro, the
+/// records that do not fit are dropped right away.
+#define QS_BLOCK_HOOK_() ((void)0)
+
+#endif // QS_BLOCK_HOOK_
+
 //! Internal QS macro to increment the given pointer argument @a ptr_
 ///
 /// @note Incrementing a pointer violates the MISRA-C 2004 Rule 17.4(req),
@@ -93,6 +170,39 @@ uint8_t const QS_GOOD_CHKSUM = static_cast<uint8_t>(0xFF);
 //! send the Target info (object sizes, build time-stamp, QP version)
 void QS_target_info_(uint8_t const isReset);
 
+#ifndef QS_ESC_CHUNK
+
+//! Number of bytes escaped at once by QP::QS_escChunk_()
+/// @description
+/// A QS port can define this macro together with its own (e.g., SIMD)
+/// implementation of QP::QS_escChunk_() in qs_port.h.
+#define QS_ESC_CHUNK 8U
+
+//! Internal QS function to copy a chunk of #QS_ESC_CHUNK bytes
+/// @description
+/// Copies the chunk from @p src to @p dst, stores the (modulo 256) sum of
+/// its bytes in @p pSum and returns true if any of the bytes needs escaping
+/// (is QP::QS_FRAME or QP::QS_ESC).
+inline bool QS_escChunk_(uint8_t * const dst, uint8_t const * const src,
+                         uint8_t * const pSum)
+{
+    uint8_t sum = static_cast<uint8_t>(0);
+    bool esc = false;
+    for (uint_fast8_t i = static_cast<uint_fast8_t>(0);
+         i < static_cast<uint_fast8_t>(QS_ESC_CHUNK);
+         ++i)
+    {
+        uint8_t const b = src[i];
+        dst[i] = b;
+        sum = static_cast<uint8_t>(sum + b);
+        esc = (esc | (b == QS_FRAME) | (b == QS_ESC)); // no branches
+    }
+    *pSum = sum;
+    return esc;
+}
+
+#endif // QS_ESC_CHUNK
+
 } // namespace QP
 
 #endif // qs_pkg_h
@@ -140,7 +140,7 @@ int_t QF::run(void) {
 
 #ifdef Q_SPY
             QS_BEGIN_NOCRIT_(QS_SCHED_NEXT,
-                             QS::priv_.locFilter[QS::AO_OBJ], a)
+                             QS::AO_OBJ, a)
                 QS_TIME_(); // timestamp
                 QS_2U8_(static_cast<uint8_t>(p), // prio of the scheduled AO
                         static_cast<uint8_t>(pprev)); // previous priority
@@ -159,9 +159,11 @@ int_t QF::run(void) {
             //
             QEvt const *e = a->get_();
             a->dispatch(e);
+            QF_LATENCY_DISPATCHED_(a);
             gc(e);
 
             QF_INT_DISABLE();
+            QF_SIG_FILTER_IDLE_(a); // the state of 'a' is stable
 
             if (a->m_eQueue.isEmpty()) { // empty queue?
                 QV_readySet_.remove(p);
@@ -171,7 +173,7 @@ int_t QF::run(void) {
 #ifdef Q_SPY
             if (pprev != static_cast<uint_fast8_t>(0)) {
                 QS_BEGIN_NOCRIT_(QS_SCHED_IDLE,
-                    static_cast<void *>(0), static_cast<void *>(0))
+                    QS::NO_OBJ, static_cast<void *>(0))
                     QS_TIME_();                          // timestamp
                     QS_U8_(static_cast<uint8_t>(pprev)); // previous prio
                 QS_END_NOCRIT_()
@@ -226,6 +228,11 @@ void QActive::start(uint_fast8_t const prio,
                       && (prio <= static_cast<uint_fast8_t>(QF_MAX_ACTIVE))
                       && (stkSto == static_cast<void *>(0)));
 
+#ifdef QF_LATENCY
+    /// @pre the queue must fit the time stamps of the posted events
+    Q_REQUIRE_ID(510, qLen <= static_cast<uint_fast16_t>(QF_LATENCY_QLEN));
+#endif
+
     m_eQueue.init(qSto, qLen); // initialize QEQueue of this AO
     m_prio = static_cast<uint8_t>(prio);  // set the QF prio of this AO
 
@@ -185,6 +185,11 @@ void QActive::start(uint_fast8_t const prio,
         && (stkSto == static_cast<void *>(0))
         && (stkSize == static_cast<uint_fast16_t>(0)));
 
+#ifdef QF_LATENCY
+    /// @pre the queue must fit the time stamps of the posted events
+    Q_REQUIRE_ID(210, qLen <= static_cast<uint_fast16_t>(QF_LATENCY_QLEN));
+#endif
+
     m_eQueue.init(qSto, qLen); // initialize QEQueue of this AO
     m_osObject = static_cast<void *>(0); // no private stack for AO
     m_prio = static_cast<uint8_t>(prio);      // set the QF prio of this AO
@@ -266,7 +271,7 @@ QSchedStatus QXK::schedLock(uint_fast8_t const ceiling) {
         QXK_attr_.lockPrio = static_cast<uint8_t>(ceiling);
 
         QS_BEGIN_NOCRIT_(QS_SCHED_LOCK,
-                         static_cast<void *>(0), static_cast<void *>(0))
+                         QS::NO_OBJ, static_cast<void *>(0))
             QS_TIME_(); // timestamp
             QS_2U8_(static_cast<uint8_t>(stat), /* the previous lock prio */
                     QXK_attr_.lockPrio); // new lock prio
@@ -319,7 +324,7 @@ void QXK::schedUnlock(QSchedStatus const stat) {
                           && (lockPrio > prevPrio));
 
         QS_BEGIN_NOCRIT_(QS_SCHED_UNLOCK,
-                         static_cast<void *>(0), static_cast<void *>(0))
+                         QS::NO_OBJ, static_cast<void *>(0))
             QS_TIME_(); // timestamp
             QS_2U8_(static_cast<uint8_t>(lockPrio),/* prio before unlocking */
                     static_cast<uint8_t>(prevPrio));// prio after unlocking
@@ -388,7 +393,7 @@ uint_fast8_t QXK_sched_(void) {
         else {  // this is an extened-thread
 
             QS_BEGIN_NOCRIT_(QP::QS_SCHED_NEXT,
-                             QP::QS::priv_.locFilter[QP::QS::AO_OBJ],
+                             QP::QS::AO_OBJ,
                              next)
                 QS_TIME_();         // timestamp
                 QS_2U8_(static_cast<uint8_t>(p), /* prio of the next AO */
@@ -406,7 +411,7 @@ uint_fast8_t QXK_sched_(void) {
         if (next != QXK_attr_.curr) {
 
             QS_BEGIN_NOCRIT_(QP::QS_SCHED_NEXT,
-                             QP::QS::priv_.locFilter[QP::QS::AO_OBJ],
+                             QP::QS::AO_OBJ,
                              next)
                 QS_TIME_(); // timestamp
                 QS_2U8_(static_cast<uint8_t>(p), /* next prio */
@@ -457,7 +462,7 @@ void QXK_activate_(void) {
         QXK_attr_.next = static_cast<QP::QActive *>(0); // clear the next AO
 
         QS_BEGIN_NOCRIT_(QP::QS_SCHED_NEXT,
-                         QP::QS::priv_.locFilter[QP::QS::AO_OBJ], a)
+                         QP::QS::AO_OBJ, a)
             QS_TIME_();         // timestamp
             QS_2U8_(static_cast<uint8_t>(p), /* next prio */
                     static_cast<uint8_t>(pprev)); // prev prio
@@ -479,9 +484,11 @@ void QXK_activate_(void) {
         //
         QP::QEvt const *e = a->get_();
         a->dispatch(e);
+        QF_LATENCY_DISPATCHED_(a);
         QP::QF::gc(e);
 
         QF_INT_DISABLE(); // unconditionally disable interrupts
+        QF_SIG_FILTER_IDLE_(a); // the state of 'a' is stable
 
         if (a->m_eQueue.isEmpty()) { // empty queue?
             QXK_attr_.readySet.remove(p);
@@ -515,7 +522,7 @@ void QXK_activate_(void) {
         else {  // next is the-extened thread
 
             QS_BEGIN_NOCRIT_(QP::QS_SCHED_NEXT,
-                             QP::QS::priv_.locFilter[QP::QS::AO_OBJ], a)
+                             QP::QS::AO_OBJ, a)
                 QS_TIME_(); // timestamp
                 QS_2U8_(static_cast<uint8_t>(p), /* next prio */
                         QXK_attr_.actPrio);      // curr prio
@@ -534,7 +541,7 @@ void QXK_activate_(void) {
         a = QP::QF::active_[pin]; // the pointer to the preempted AO
 
         QS_BEGIN_NOCRIT_(QP::QS_SCHED_RESUME,
-                         QP::QS::priv_.locFilter[QP::QS::AO_OBJ], a)
+                         QP::QS::AO_OBJ, a)
             QS_TIME_();  // timestamp
             QS_2U8_(static_cast<uint8_t>(p),      /* resumed prio */
                     static_cast<uint8_t>(pprev)); // previous prio
@@ -542,7 +549,7 @@ void QXK_activate_(void) {
     }
     else {  // resuming priority==0 --> idle
         QS_BEGIN_NOCRIT_(QP::QS_SCHED_IDLE,
-                         static_cast<void *>(0), static_cast<void *>(0))
+                         QP::QS::NO_OBJ, static_cast<void *>(0))
             QS_TIME_(); // timestamp
             QS_U8_(static_cast<uint8_t>(pprev)); // previous prio
         QS_END_NOCRIT_()
@@ -168,7 +168,7 @@ bool QXMutex::lock(uint_fast16_t const nTicks) {
         m_holderPrio = static_cast<uint8_t>(curr->m_startPrio);
 
         QS_BEGIN_NOCRIT_(QS_MUTEX_LOCK,
-            static_cast<void *>(0), static_cast<void *>(0))
+            QS::NO_OBJ, static_cast<void *>(0))
             QS_TIME_();  // timestamp
             QS_2U8_(curr->m_startPrio, /* start prio */
                     m_ceiling); // current ceiling
@@ -285,7 +285,7 @@ bool QXMutex::tryLock(void) {
         m_holderPrio = static_cast<uint8_t>(curr->m_startPrio);
 
         QS_BEGIN_NOCRIT_(QS_MUTEX_LOCK,
-            static_cast<void *>(0), static_cast<void *>(0))
+            QS::NO_OBJ, static_cast<void *>(0))
             QS_TIME_();  // timestamp
             QS_2U8_(static_cast<uint8_t>(curr->m_startPrio), /* start prio */
                     m_ceiling);  // current ceiling
@@ -368,7 +368,7 @@ void QXMutex::unlock(void) {
         // the mutex no longer held by a thread
         m_holderPrio = static_cast<uint8_t>(0);
 
-        QS_BEGIN_NOCRIT_(QS_MUTEX_UNLOCK, static_cast<void *>(0), curr)
+        QS_BEGIN_NOCRIT_(QS_MUTEX_UNLOCK, QS::NO_OBJ, curr)
             QS_TIME_();  // timestamp
             QS_2U8_(static_cast<uint8_t>(curr->m_startPrio), /* start prio */
                     m_ceiling);  // the mutex ceiling
@@ -414,7 +414,7 @@ void QXMutex::unlock(void) {
             // make the thread ready to run
             QXK_attr_.readySet.insert(static_cast<uint_fast8_t>(thr->m_prio));
 
-            QS_BEGIN_NOCRIT_(QS_MUTEX_LOCK, static_cast<void *>(0), thr)
+            QS_BEGIN_NOCRIT_(QS_MUTEX_LOCK, QS::NO_OBJ, thr)
                 QS_TIME_();  // timestamp
                 QS_2U8_(static_cast<uint8_t>(thr->m_startPrio),/*start prio*/
                         m_ceiling);  // ceiling prio
@@ -226,7 +226,7 @@ bool QXThread::post_(QEvt const * const e, uint_fast16_t const margin,
         {
 
             QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_FIFO,
-                             QS::priv_.locFilter[QS::AO_OBJ], this)
+                             QS::AO_OBJ, this)
                 QS_TIME_();        // timestamp
                 QS_OBJ_(sender);   // the sender object
                 QS_SIG_(e->sig);   // the signal of the event
@@ -245,6 +245,7 @@ bool QXThread::post_(QEvt const * const e, uint_fast16_t const margin,
             m_eQueue.m_nFree = nFree;     // update the volatile
             if (m_eQueue.m_nMin > nFree) {
                 m_eQueue.m_nMin = nFree;  // update minimum so far
+                QS_TRG_VALUE_(QS::TRG_QMIN, this, nFree); // trace trigger
             }
 
             // queue empty?
@@ -284,7 +285,7 @@ bool QXThread::post_(QEvt const * const e, uint_fast16_t const margin,
             Q_ASSERT_ID(310, margin != QF_NO_MARGIN);
 
             QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_POST_ATTEMPT,
-                             QS::priv_.locFilter[QS::AO_OBJ], this)
+                             QS::AO_OBJ, this)
                 QS_TIME_();        // timestamp
                 QS_OBJ_(sender);   // the sender object
                 QS_SIG_(e->sig);   // the signal of the event
@@ -398,7 +399,7 @@ QEvt const *QXThread::queueGet(uint_fast16_t const nTicks) {
             --thr->m_eQueue.m_tail;
 
             QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_GET,
-                             QS::priv_.locFilter[QS::AO_OBJ], thr)
+                             QS::AO_OBJ, thr)
                 QS_TIME_();      // timestamp
                 QS_SIG_(e->sig); // the signal of this event
                 QS_OBJ_(&thr);   // this active object
@@ -415,7 +416,7 @@ QEvt const *QXThread::queueGet(uint_fast16_t const nTicks) {
                                        + static_cast<QEQueueCtr>(1)));
 
             QS_BEGIN_NOCRIT_(QS_QF_ACTIVE_GET_LAST,
-                             QS::priv_.locFilter[QS::AO_OBJ], thr)
+                             QS::AO_OBJ, thr)
                 QS_TIME_();      // timestamp
                 QS_SIG_(e->sig); // the signal of this event
                 QS_OBJ_(&thr);   // this active object